@@ -0,0 +1,129 @@
+/*
+  Copyright (C) 2012-2014  Brazil, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <cassert>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "grnxx/db.hpp"
+#include "grnxx/pipeline.hpp"
+#include "grnxx/sorter.hpp"
+
+namespace {
+
+constexpr size_t SIZE = 1000000;
+constexpr size_t LOOP = 32;
+constexpr size_t MAX_NUM_THREADS = 8;
+
+class Timer {
+ public:
+  Timer() : base_(now()) {}
+
+  double elapsed() const {
+    return now() - base_;
+  }
+
+  static double now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + (ts.tv_nsec / 1000000000.0);
+  }
+
+ private:
+  double base_;
+};
+
+// Run a query: filter (A < 128), adjust (B) and sort (_score DESC), limit 10.
+size_t run_query(const grnxx::Table *table) {
+  auto pipeline_builder = grnxx::PipelineBuilder::create(table);
+  pipeline_builder->push_cursor(table->create_cursor());
+  auto expression_builder = grnxx::ExpressionBuilder::create(table);
+  expression_builder->push_column("A");
+  expression_builder->push_constant(grnxx::Int(128));
+  expression_builder->push_operator(GRNXX_LESS);
+  pipeline_builder->push_filter(expression_builder->release());
+  expression_builder->push_column("B");
+  pipeline_builder->push_adjuster(expression_builder->release());
+  grnxx::Array<grnxx::SorterOrder> orders;
+  orders.resize(1);
+  expression_builder->push_score();
+  orders[0].expression = expression_builder->release();
+  orders[0].type = GRNXX_REVERSE_ORDER;
+  grnxx::SorterOptions options;
+  options.limit = 10;
+  pipeline_builder->push_sorter(
+      grnxx::Sorter::create(std::move(orders), options));
+  auto pipeline = pipeline_builder->release();
+  grnxx::Array<grnxx::Record> records;
+  pipeline->flush(&records);
+  return records.size();
+}
+
+void benchmark_grnxx(const grnxx::Table *table, size_t num_threads) {
+  std::cout << "THREADS: " << num_threads;
+  Timer timer;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.push_back(std::thread([table] {
+      for (size_t j = 0; j < LOOP; ++j) {
+        size_t count = run_query(table);
+        assert(count == 10);
+        (void)count;
+      }
+    }));
+  }
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads[i].join();
+  }
+  double elapsed = timer.elapsed();
+  std::cout << ", elapsed [s] = " << elapsed
+            << ", queries/s = " << ((num_threads * LOOP) / elapsed)
+            << std::endl;
+}
+
+void benchmark_grnxx() {
+  std::cout << __PRETTY_FUNCTION__ << std::endl;
+
+  std::mt19937_64 rng;
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto col_a = table->create_column("A", GRNXX_INT);
+  auto col_b = table->create_column("B", GRNXX_FLOAT);
+  for (size_t i = 0; i < SIZE; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    col_a->set(row_id, grnxx::Int(rng() % 256));
+    col_b->set(row_id, grnxx::Float((rng() % 65536) / 256.0));
+  }
+
+  // Queries on the shared table are independent, so that the throughput
+  // should scale linearly with the number of threads up to the number of
+  // cores.
+  for (size_t i = 1; i <= MAX_NUM_THREADS; i *= 2) {
+    benchmark_grnxx(table, i);
+  }
+}
+
+}  // namespace
+
+int main() {
+  benchmark_grnxx();
+
+  return 0;
+}
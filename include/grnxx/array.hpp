@@ -316,6 +316,29 @@ class Array<T, false> {
     size_ = 0;
   }
 
+  // Release unused memory.
+  //
+  // On failure, throws an exception.
+  void shrink_to_fit() {
+    if (size_ == capacity_) {
+      return;
+    }
+    Value *new_buffer = nullptr;
+    if (size_ != 0) {
+      new_buffer = static_cast<Value *>(std::malloc(sizeof(Value) * size_));
+      if (!new_buffer) {
+        throw "Memory allocation failed";  // TODO
+      }
+      for (size_t i = 0; i < size_; ++i) {
+        new (&new_buffer[i]) Value(std::move(buffer()[i]));
+        buffer()[i].~Value();
+      }
+    }
+    std::free(buffer_);
+    buffer_ = new_buffer;
+    capacity_ = size_;
+  }
+
   // Remove the "i"-th value.
   void erase(size_t i) {
     for (size_t j = i + 1; j < size_; ++j) {
@@ -530,6 +553,27 @@ class Array<T, true> {
     size_ = 0;
   }
 
+  // Release unused memory.
+  //
+  // On failure, throws an exception.
+  void shrink_to_fit() {
+    if (size_ == capacity_) {
+      return;
+    }
+    if (size_ == 0) {
+      std::free(buffer_);
+      buffer_ = nullptr;
+    } else {
+      Value *new_buffer =
+          static_cast<Value *>(std::realloc(buffer_, sizeof(Value) * size_));
+      if (!new_buffer) {
+        throw "Memory allocation failed";  // TODO
+      }
+      buffer_ = new_buffer;
+    }
+    capacity_ = size_;
+  }
+
   // Remove the "i"-th value.
   void erase(size_t i) {
     std::memmove(&buffer()[i], &buffer()[i + 1],
@@ -16,7 +16,45 @@ struct ColumnOptions {
   // The referenced (parent) table.
   String reference_table_name;
 
-  ColumnOptions() : reference_table_name() {}
+  // Whether values are dictionary-encoded or not.
+  //
+  // If true, each distinct value is stored only once and rows store small
+  // integer codes, which saves memory for low-cardinality columns.
+  // Values which are no longer referenced are removed from the dictionary.
+  // Only Text columns support dictionary encoding.
+  bool dictionary_encoding;
+
+  // Whether values are encoded per block or not.
+  //
+  // If true, values are split into blocks of 1024 values, and each block
+  // stores the differences from its minimum value in as few bits as
+  // possible, which saves memory for values in narrow ranges, such as
+  // timestamps.
+  // Only Int columns support frame-of-reference encoding.
+  bool frame_of_reference_encoding;
+  // Whether vectors are delta-encoded or not.
+  // If true, each vector stores the differences between adjacent values as
+  // variable-length integers, which saves memory for sorted vectors of small
+  // values, such as tag IDs.
+  // Only Int vector columns support delta encoding.
+  bool delta_encoding;
+
+  // When to compact variable-length values.
+  //
+  // Updates and removals of Text and Vector values leave garbage, which is
+  // reclaimed incrementally once it reaches "compaction_min_garbage_size"
+  // bytes and exceeds "compaction_garbage_ratio" of the stored values.
+  // Other columns ignore these options.
+  size_t compaction_min_garbage_size;
+  double compaction_garbage_ratio;
+
+  ColumnOptions()
+      : reference_table_name(),
+        dictionary_encoding(false),
+        frame_of_reference_encoding(false),
+        delta_encoding(false),
+        compaction_min_garbage_size(1 << 20),
+        compaction_garbage_ratio(0.5) {}
 };
 
 class Column {
@@ -100,6 +138,25 @@ class Column {
   // If not found, returns N/A.
   virtual Int find_one(const Datum &datum) const = 0;
 
+  // Find rows referring to "row_id" through "this".
+  //
+  // The rows are read in ascending order of row ID unless
+  // "options.order_type" is GRNXX_REVERSE_ORDER.
+  //
+  // On success, returns a cursor.
+  // On failure, throws an exception.
+  virtual std::unique_ptr<Cursor> find_referrers(
+      Int row_id,
+      const CursorOptions &options = CursorOptions()) const = 0;
+
+  // Reclaim memory used by overwritten and removed values.
+  //
+  // Text and vector columns also reclaim memory incrementally when more than
+  // half of their value storage is garbage.
+  //
+  // On failure, throws an exception.
+  virtual void compact() = 0;
+
 //  virtual std::unique_ptr<Cursor> create_cursor(
 //      const CursorOptions &options = CursorOptions()) = 0;
 
@@ -39,9 +39,13 @@ typedef enum {
 
 typedef enum {
   // Tree indexes support range search.
+  // Tree indexes on GeoPoint columns support rectangle and circle search.
   GRNXX_TREE_INDEX,
   // Hash indexes support exact match search.
-  GRNXX_HASH_INDEX
+  // Hash indexes on vector columns support search for elements.
+  GRNXX_HASH_INDEX,
+  // Full-text indexes support substring search.
+  GRNXX_FULL_TEXT_INDEX
 } grnxx_index_type;
 
 typedef enum {
@@ -92,12 +96,21 @@ typedef enum {
   // Search operators.
   GRNXX_STARTS_WITH,  // For Text (x @^ y).
   GRNXX_ENDS_WITH,    // For Text (x @$ y).
-  GRNXX_CONTAINS,     // For Text (x @ y).
+  GRNXX_CONTAINS,     // For Text, Vector (x @ y).
 
   // Vector operators.
   GRNXX_SUBSCRIPT,  // For Vector (x[y]).
 
-  // -- TODO: Ternary operators --
+  // Geo operators.
+  GRNXX_GEO_DISTANCE,  // For GeoPoint (distance in meters between x and y).
+
+  // -- Ternary operators --
+
+  // Geo operators.
+  GRNXX_GEO_WITHIN_RECTANGLE,  // For GeoPoint (x is in a rectangle whose
+                               // corners are y and z).
+  GRNXX_GEO_WITHIN_CIRCLE      // For GeoPoint, Float (x is within z meters
+                               // from y).
 } grnxx_operator_type;
 
 typedef enum {
@@ -1,6 +1,7 @@
 #ifndef GRNXX_TYPES_DATUM_HPP
 #define GRNXX_TYPES_DATUM_HPP
 
+#include <memory>
 #include <new>
 #include <utility>
 
@@ -13,12 +14,12 @@ namespace grnxx {
 
 class Datum {
  public:
-  Datum() : type_(GRNXX_NA), na_() {}
+  Datum() : type_(GRNXX_NA), na_(), buffer_() {}
   ~Datum() {
     destruct();
   }
 
-  Datum(const Datum &datum) : type_(), na_() {
+  Datum(const Datum &datum) : type_(), na_(), buffer_() {
     copy_from(datum);
   }
   Datum &operator=(const Datum &datum) & {
@@ -73,10 +74,11 @@ class Datum {
         break;
       }
     }
+    buffer_ = datum.buffer_;
     return *this;
   }
 
-  Datum(Datum &&datum) : type_(), na_() {
+  Datum(Datum &&datum) : type_(), na_(), buffer_() {
     move_from(std::move(datum));
   }
   Datum &operator=(Datum &&datum) & {
@@ -131,41 +133,55 @@ class Datum {
         break;
       }
     }
+    buffer_ = std::move(datum.buffer_);
     return *this;
   }
 
   // Create a N/A object.
-  Datum(NA) : type_(GRNXX_NA), na_() {}
+  Datum(NA) : type_(GRNXX_NA), na_(), buffer_() {}
   // Create a Bool object.
-  Datum(Bool value) : type_(GRNXX_BOOL), bool_(value) {}
+  Datum(Bool value) : type_(GRNXX_BOOL), bool_(value), buffer_() {}
   // Create an Int object.
-  Datum(Int value) : type_(GRNXX_INT), int_(value) {}
+  Datum(Int value) : type_(GRNXX_INT), int_(value), buffer_() {}
   // Create a Float object.
-  Datum(Float value) : type_(GRNXX_FLOAT), float_(value) {}
+  Datum(Float value) : type_(GRNXX_FLOAT), float_(value), buffer_() {}
   // Create a GeoPoint object.
-  Datum(GeoPoint value) : type_(GRNXX_GEO_POINT), geo_point_(value) {}
+  Datum(GeoPoint value) : type_(GRNXX_GEO_POINT), geo_point_(value), buffer_() {}
   // Create a Text object.
-  Datum(const Text &value) : type_(GRNXX_TEXT), text_(value) {}
+  Datum(const Text &value) : type_(GRNXX_TEXT), text_(value), buffer_() {}
   // Create a Vector<Bool> object.
   Datum(const Vector<Bool> &value)
       : type_(GRNXX_BOOL_VECTOR),
-        bool_vector_(value) {}
+        bool_vector_(value),
+        buffer_() {}
   // Create a Vector<Int> object.
   Datum(const Vector<Int> &value)
       : type_(GRNXX_INT_VECTOR),
-        int_vector_(value) {}
+        int_vector_(value),
+        buffer_() {}
+  // Create a Vector<Int> object which refers to "buffer".
+  //
+  // The datum and its copies keep "buffer" alive, so that a decoded value
+  // remains valid as long as the datum.
+  Datum(const Vector<Int> &value, std::shared_ptr<const void> &&buffer)
+      : type_(GRNXX_INT_VECTOR),
+        int_vector_(value),
+        buffer_(std::move(buffer)) {}
   // Create a Vector<Float> object.
   Datum(const Vector<Float> &value)
       : type_(GRNXX_FLOAT_VECTOR),
-        float_vector_(value) {}
+        float_vector_(value),
+        buffer_() {}
   // Create a Vector<GeoPoint> object.
   Datum(const Vector<GeoPoint> &value)
       : type_(GRNXX_GEO_POINT_VECTOR),
-        geo_point_vector_(value) {}
+        geo_point_vector_(value),
+        buffer_() {}
   // Create a Vector<Text> object.
   Datum(const Vector<Text> &value)
       : type_(GRNXX_TEXT_VECTOR),
-        text_vector_(value) {}
+        text_vector_(value),
+        buffer_() {}
 
   // Return the data type.
   DataType type() const {
@@ -333,6 +349,8 @@ class Datum {
     Vector<GeoPoint> geo_point_vector_;
     Vector<Text> text_vector_;
   };
+  // The storage of a value which is not owned by a column.
+  std::shared_ptr<const void> buffer_;
 
   void destruct() {
     switch (type_) {
@@ -384,6 +402,7 @@ class Datum {
   }
   void copy_from(const Datum &datum) {
     type_ = datum.type_;
+    buffer_ = datum.buffer_;
     switch (type_) {
       case GRNXX_NA: {
         new (&na_) NA(datum.na_);
@@ -433,6 +452,7 @@ class Datum {
   }
   void move_from(Datum &&datum) {
     type_ = datum.type_;
+    buffer_ = std::move(datum.buffer_);
     switch (type_) {
       case GRNXX_NA: {
         new (&na_) NA(std::move(datum.na_));
@@ -1,6 +1,7 @@
 #ifndef GRNXX_DATA_TYPES_SCALAR_GEO_POINT_HPP
 #define GRNXX_DATA_TYPES_SCALAR_GEO_POINT_HPP
 
+#include <cmath>
 #include <cstdint>
 #include <limits>
 
@@ -131,6 +132,25 @@ class GeoPoint {
            (raw_longitude_ != rhs.raw_longitude_);
   }
 
+  // Return the great-circle distance in meters.
+  //
+  // The earth is regarded as a sphere whose radius is earth_radius().
+  Float distance(const GeoPoint &rhs) const {
+    if (is_na() || rhs.is_na()) {
+      return Float::na();
+    }
+    double latitude = raw_latitude_ * raw_radians();
+    double rhs_latitude = rhs.raw_latitude_ * raw_radians();
+    double sin_half_latitude_diff = std::sin((rhs_latitude - latitude) / 2);
+    double sin_half_longitude_diff = std::sin(
+        (static_cast<double>(rhs.raw_longitude_) - raw_longitude_) *
+        raw_radians() / 2);
+    double x = (sin_half_latitude_diff * sin_half_latitude_diff) +
+               (std::cos(latitude) * std::cos(rhs_latitude) *
+                sin_half_longitude_diff * sin_half_longitude_diff);
+    return Float(2 * earth_radius() * std::asin(std::sqrt(x < 1.0 ? x : 1.0)));
+  }
+
   static constexpr DataType type() {
     return GRNXX_GEO_POINT;
   }
@@ -183,6 +203,15 @@ class GeoPoint {
     return raw_na();
   }
 
+  // Return the radius of the earth in meters.
+  static constexpr double earth_radius() {
+    return 6371000.0;
+  }
+  // Return the number of radians for a millisecond.
+  static constexpr double raw_radians() {
+    return 3.14159265358979323846 / degrees(180);
+  }
+
  private:
   int32_t raw_latitude_;   // Latitude in milliseconds.
   int32_t raw_longitude_;  // Longitude in milliseconds.
@@ -11,6 +11,11 @@ namespace grnxx {
 struct DBOptions {
 };
 
+// Objects in a database, which are tables, columns and indexes, may be read
+// by multiple threads at the same time as long as no thread updates the
+// database.
+// Cursors, expressions, pipelines, sorters and mergers have their own working
+// buffers, so that each thread must create its own instances.
 class DB {
  public:
   DB() = default;
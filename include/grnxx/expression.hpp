@@ -14,9 +14,12 @@ using OperatorType = grnxx_operator_type;
 
 struct ExpressionOptions {
   // Records are evaluated per block.
+  //
+  // If 0, the block size is chosen automatically so that the intermediate
+  // buffers of the expression fit in the CPU cache.
   size_t block_size;
 
-  ExpressionOptions() : block_size(1024) {}
+  ExpressionOptions() : block_size(0) {}
 };
 
 class Expression {
@@ -103,6 +106,8 @@ class Expression {
   //
   // Evaluates the expression for "records" and stores the results into
   // "*results".
+  // Vector results may refer to memory owned by the expression, which is
+  // valid until the next call.
   //
   // Fails if "T" differs from the result data type.
   //
@@ -132,6 +137,8 @@ class Expression {
   //
   // Evaluates the expression for "records" and stores the results into
   // "results".
+  // Vector results may refer to memory owned by the expression, which is
+  // valid until the next call.
   //
   // Fails if the data type of "records" differs from the result data type.
   // Fails if "records.size()" != "results.size()".
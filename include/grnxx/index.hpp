@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "grnxx/array.hpp"
 #include "grnxx/constants.h"
 #include "grnxx/cursor.hpp"
 #include "grnxx/data_types.hpp"
@@ -63,6 +64,22 @@ class IndexRange {
 using IndexType = grnxx_index_type;
 
 struct IndexOptions {
+  // The number of threads to build an index for existing values.
+  //
+  // If 0, the number of threads is chosen with the number of values and the
+  // number of hardware threads.
+  size_t num_threads;
+
+  // The names of the columns following the owner column in a composite
+  // index.
+  //
+  // If not empty, a tree index orders rows by tuples of the owner column and
+  // these columns, and find_with_prefix() is available.
+  // The owner column must be an Int, Float or Text column, and these
+  // columns must be Bool, Int, Float or Text columns of the same table.
+  Array<String> secondary_column_names;
+
+  IndexOptions() : num_threads(0), secondary_column_names() {}
 };
 
 class Index {
@@ -118,6 +135,22 @@ class Index {
       const IndexRange &range = IndexRange(),
       const CursorOptions &options = CursorOptions()) const = 0;
 
+  // Create a cursor to get records with a prefix of tuples.
+  //
+  // A composite index finds rows whose first "prefix.size()" values are
+  // equal to "prefix" and whose next value is in "range". If "range" has no
+  // end points, N/A is also accepted as the next value. Records are returned
+  // in order of tuples, where N/A follows any other value, and ties in
+  // ascending order of row IDs.
+  // If "prefix" is empty, this is the same as find_in_range().
+  //
+  // On success, returns the cursor.
+  // On failure, throws an exception.
+  virtual std::unique_ptr<Cursor> find_with_prefix(
+      ArrayCRef<Datum> prefix,
+      const IndexRange &range = IndexRange(),
+      const CursorOptions &options = CursorOptions()) const = 0;
+
   // Create a cursor to get records.
   //
   // On success, returns the cursor.
@@ -134,6 +167,60 @@ class Index {
       const Datum &value,
       const CursorOptions &options = CursorOptions()) const = 0;
 
+  // Create a cursor to get records whose values contain "value".
+  //
+  // A full-text index finds texts containing "value" as a substring and
+  // an index of a vector column finds vectors containing "value" as an
+  // element. Records are returned in row ID order.
+  //
+  // On success, returns the cursor.
+  // On failure, throws an exception.
+  virtual std::unique_ptr<Cursor> find_contains(
+      const Datum &value,
+      const CursorOptions &options = CursorOptions()) const = 0;
+
+  // Create a cursor to get records relevant to "query" with scores.
+  //
+  // A full-text index finds texts containing "query", or any element of
+  // "query" if it is a Text vector, and sets their BM25 scores to
+  // Record::score. Records are returned in descending order of scores, ties
+  // in ascending order of row IDs, and the regular order with a limit skips
+  // rows which cannot be in the result. The document frequency of a term
+  // longer than two bytes is estimated as that of its rarest bigram, so that
+  // the rows are verified lazily.
+  //
+  // On success, returns the cursor.
+  // On failure, throws an exception.
+  virtual std::unique_ptr<Cursor> find_relevant(
+      const Datum &query,
+      const CursorOptions &options = CursorOptions()) const = 0;
+
+  // Create a cursor to get records whose values are in a rectangle.
+  //
+  // The rectangle is the range of latitudes and longitudes between
+  // "corner" and "opposite_corner", and does not wrap around the 180th
+  // meridian. Records are returned in row ID order.
+  //
+  // On success, returns the cursor.
+  // On failure, throws an exception.
+  virtual std::unique_ptr<Cursor> find_within_rectangle(
+      const GeoPoint &corner,
+      const GeoPoint &opposite_corner,
+      const CursorOptions &options = CursorOptions()) const = 0;
+
+  // Create a cursor to get records whose values are within "radius" meters
+  // from "center".
+  //
+  // Distances are measured as GeoPoint::distance(). Records are returned in
+  // row ID order.
+  //
+  // On success, returns the cursor.
+  // On failure, throws an exception.
+  virtual std::unique_ptr<Cursor> find_within_circle(
+      const GeoPoint &center,
+      Float radius,
+      const CursorOptions &options = CursorOptions()) const = 0;
+
  protected:
   virtual ~Index() = default;
 };
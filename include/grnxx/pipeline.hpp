@@ -12,7 +12,59 @@
 
 namespace grnxx {
 
+struct PipelineCacheOptions {
+  // The maximum total size of cached records in bytes.
+  //
+  // The least recently used results are removed if the total size exceeds
+  // this limit.
+  size_t max_size;
+
+  PipelineCacheOptions() : max_size(size_t(64) << 20) {}
+};
+
+// A cache of pipeline results.
+//
+// A pipeline with a cache returns the cached results of an equivalent
+// pipeline, which was built with the same sequence of operations, unless
+// the table or the columns read by the pipeline have been changed.
+//
+// A cache can be shared by pipelines running in different threads.
+class PipelineCache {
+ public:
+  // Create a cache.
+  //
+  // On success, returns the cache.
+  // On failure, throws an exception.
+  static std::unique_ptr<PipelineCache> create(
+      const PipelineCacheOptions &options = PipelineCacheOptions());
+
+  PipelineCache() = default;
+  virtual ~PipelineCache() = default;
+
+  // Return the number of cached results.
+  virtual size_t num_entries() const = 0;
+  // Return the total size of cached records in bytes.
+  virtual size_t size() const = 0;
+
+  // Remove all the cached results.
+  virtual void clear() = 0;
+};
+
 struct PipelineOptions {
+  // Records are read per block.
+  //
+  // If 0, the smallest block size of the expressions in the pipeline is
+  // used.
+  size_t block_size;
+
+  // The cache of results, which must be valid while the pipeline is used.
+  //
+  // If nullptr, results are not cached.
+  // NOTE: Results are cached only if the pipeline reads all the rows of the
+  //       table through table cursors without an offset or a limit.
+  PipelineCache *cache;
+
+  PipelineOptions() : block_size(0), cache(nullptr) {}
 };
 
 class Pipeline {
@@ -21,12 +73,23 @@ class Pipeline {
   virtual ~Pipeline() = default;
 
   virtual const Table *table() const = 0;
+  // Return the block size.
+  virtual size_t block_size() const = 0;
 
   // Read all the records through the pipeline.
   //
   // On success, returns true.
   // On failure, throws an exception.
   virtual void flush(Array<Record> *records) = 0;
+
+  // Read all the records through the pipeline.
+  //
+  // The result may be shared with other pipelines through the cache, so
+  // that cached records are returned without copy.
+  //
+  // On success, returns the records.
+  // On failure, throws an exception.
+  virtual std::shared_ptr<const Array<Record>> flush_shared() = 0;
 };
 
 class PipelineBuilder {
@@ -125,6 +125,36 @@ class Table {
   // On failure, throws an exception.
   virtual void remove_row(Int row_id) = 0;
 
+  // Remove rows.
+  //
+  // Rows are removed at once, so that this is faster than removing rows one
+  // by one.
+  // Duplicate row IDs are allowed and such rows are removed once.
+  //
+  // Fails if "row_ids" contains an invalid row ID, and then no row is
+  // removed.
+  //
+  // On failure, throws an exception.
+  virtual void remove_rows(ArrayCRef<Int> row_ids) = 0;
+
+  // Renumber rows densely.
+  //
+  // Valid rows are renumbered in ascending order of their row IDs, so that
+  // the table gets full (see is_full()).
+  // Column values are moved, indexes are rebuilt and references from
+  // referrer columns are rewritten.
+  // If "row_id_map" != nullptr, stores the mapping into "*row_id_map":
+  // "(*row_id_map)[i]" is the new row ID of the "i"-th row, or N/A if the
+  // "i"-th row is invalid.
+  //
+  // NOTE: Pointers to indexes of the table are invalidated because indexes
+  //       are replaced with rebuilt ones.
+  //
+  // Fails if the table is referred to from a key column.
+  //
+  // On failure, throws an exception after undoing the changes.
+  virtual void vacuum(Array<Int> *row_id_map = nullptr) = 0;
+
   // Return whether a row is valid or not.
   virtual bool test_row(Int row_id) const = 0;
 
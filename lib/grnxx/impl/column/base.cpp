@@ -2,11 +2,51 @@
 
 #include "grnxx/impl/column/scalar.hpp"
 #include "grnxx/impl/column/vector.hpp"
+#include "grnxx/impl/db.hpp"
 #include "grnxx/impl/index.hpp"
+#include "grnxx/impl/revision.hpp"
 #include "grnxx/impl/table.hpp"
 
 namespace grnxx {
 namespace impl {
+namespace column_base {
+
+// Detach indexes from a column and attach them again on destruction, so that
+// the indexes are restored even if an exception is thrown.
+class IndexDetacher {
+ public:
+  explicit IndexDetacher(Array<std::unique_ptr<Index>> *indexes)
+      : indexes_(indexes),
+        detached_indexes_(std::move(*indexes)) {}
+  ~IndexDetacher() {
+    *indexes_ = std::move(detached_indexes_);
+  }
+
+ private:
+  Array<std::unique_ptr<Index>> *indexes_;
+  Array<std::unique_ptr<Index>> detached_indexes_;
+};
+
+// Clear the key attribute of a column and set it again on destruction.
+class KeyAttributeDetacher {
+ public:
+  explicit KeyAttributeDetacher(bool *is_key)
+      : is_key_(is_key),
+        detached_is_key_(*is_key) {
+    *is_key_ = false;
+  }
+  ~KeyAttributeDetacher() {
+    *is_key_ = detached_is_key_;
+  }
+
+ private:
+  bool *is_key_;
+  bool detached_is_key_;
+};
+
+}  // namespace column_base
+
+using namespace column_base;
 
 ColumnBase::ColumnBase(Table *table,
                        const String &name,
@@ -17,7 +57,11 @@ ColumnBase::ColumnBase(Table *table,
       data_type_(data_type),
       reference_table_(nullptr),
       is_key_(false),
-      indexes_() {}
+      indexes_(),
+      referrer_index_(),
+      revision_(generate_revision()),
+      compaction_options_{ ColumnOptions().compaction_min_garbage_size,
+                           ColumnOptions().compaction_garbage_ratio } {}
 
 ColumnBase::~ColumnBase() {}
 
@@ -106,6 +150,15 @@ std::unique_ptr<ColumnBase> ColumnBase::create(
     const String &name,
     DataType data_type,
     const ColumnOptions &options) try {
+  if (options.dictionary_encoding && (data_type != GRNXX_TEXT)) {
+    throw "Not supported";  // TODO
+  }
+  if (options.frame_of_reference_encoding && (data_type != GRNXX_INT)) {
+    throw "Not supported";  // TODO
+  }
+  if (options.delta_encoding && (data_type != GRNXX_INT_VECTOR)) {
+    throw "Not supported";  // TODO
+  }
   std::unique_ptr<ColumnBase> column;
   switch (data_type) {
     case GRNXX_BOOL: {
@@ -178,9 +231,138 @@ void ColumnBase::set_key(Int, const Datum &) {
   throw "Not supported";  // TODO
 }
 
-//void ColumnBase::clear_references(Int) {
-//  throw "Not supported";  // TODO
-//}
+void ColumnBase::clear_references(Int) {
+  throw "Not supported";  // TODO
+}
+
+void ColumnBase::unset_rows(ArrayCRef<Int> row_ids) {
+  if (num_indexes() == 0) {
+    for (size_t i = 0; i < row_ids.size(); ++i) {
+      unset(row_ids[i]);
+    }
+    return;
+  }
+  try {
+    for (size_t i = 0; i < num_indexes(); ++i) {
+      indexes_[i]->remove_rows(row_ids);
+    }
+    // The entries have been removed, so that values are unset while indexes
+    // are detached.
+    IndexDetacher detacher(&indexes_);
+    for (size_t i = 0; i < row_ids.size(); ++i) {
+      unset(row_ids[i]);
+    }
+  } catch (...) {
+    // Indexes may have lost the entries of values which remain.
+    rebuild_indexes();
+    throw;
+  }
+}
+
+void ColumnBase::renumber_rows(ArrayCRef<Int> row_id_map) try {
+  // Rows moved to smaller row IDs are processed in ascending order, and then
+  // rows moved to larger row IDs are processed in descending order, so that
+  // the destination row has already been moved or has no value.
+  Array<Int> row_ids;
+  for (size_t i = 0; i < row_id_map.size(); ++i) {
+    if (!row_id_map[i].is_na() &&
+        (static_cast<size_t>(row_id_map[i].raw()) < i)) {
+      row_ids.push_back(Int(i));
+    }
+  }
+  for (size_t i = row_id_map.size(); i > 0; --i) {
+    if (!row_id_map[i - 1].is_na() &&
+        (static_cast<size_t>(row_id_map[i - 1].raw()) > (i - 1))) {
+      row_ids.push_back(Int(i - 1));
+    }
+  }
+  // A value is copied into a buffer column before it is moved, because a
+  // value may refer to the storage which is updated by set().
+  std::unique_ptr<ColumnBase> buffer =
+      create(table_, name_, data_type_, ColumnOptions());
+  // Indexes are detached while values are moved and rebuilt later by
+  // rebuild_indexes().
+  IndexDetacher index_detacher(&indexes_);
+  // Keys are unique before and after the move, so that the uniqueness check
+  // is skipped.
+  KeyAttributeDetacher key_attribute_detacher(&is_key_);
+  size_t num_moved_rows = 0;
+  try {
+    for ( ; num_moved_rows < row_ids.size(); ++num_moved_rows) {
+      Int row_id = row_ids[num_moved_rows];
+      move_value(row_id, row_id_map[row_id.raw()], buffer.get());
+    }
+  } catch (...) {
+    // Moved values are moved back in reverse order.
+    while (num_moved_rows > 0) {
+      Int row_id = row_ids[--num_moved_rows];
+      move_value(row_id_map[row_id.raw()], row_id, buffer.get());
+    }
+    rebuild_zone_map();
+    throw;
+  }
+  rebuild_zone_map();
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void ColumnBase::rebuild_indexes() try {
+  // New indexes are created before any index is replaced.
+  Array<std::unique_ptr<Index>> new_indexes;
+  new_indexes.resize(indexes_.size());
+  for (size_t i = 0; i < indexes_.size(); ++i) {
+    new_indexes[i].reset(Index::create(
+        this, indexes_[i]->name(), indexes_[i]->type(),
+        indexes_[i]->options()));
+  }
+  indexes_ = std::move(new_indexes);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+std::unique_ptr<Cursor> ColumnBase::find_referrers(
+    Int row_id,
+    const CursorOptions &options) const {
+  if (!referrer_index_) {
+    throw "Not reference column";  // TODO
+  }
+  return referrer_index_->find(row_id, options);
+}
+
+void ColumnBase::set_reference_table(const ColumnOptions &options) try {
+  if (options.reference_table_name.is_empty()) {
+    return;
+  }
+  reference_table_ = table_->_db()->find_table(options.reference_table_name);
+  if (!reference_table_) {
+    throw "Table not found";  // TODO
+  }
+  referrer_index_.reset(new ReferrerIndex);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void ColumnBase::set_compaction_options(const ColumnOptions &options) {
+  if (!(options.compaction_garbage_ratio >= 0.0)) {
+    throw "Invalid compaction garbage ratio";  // TODO
+  }
+  compaction_options_.min_garbage_size = options.compaction_min_garbage_size;
+  compaction_options_.garbage_ratio = options.compaction_garbage_ratio;
+}
+
+void ColumnBase::notify_update(Int row_id) {
+  revision_ = generate_revision();
+  table_->update_composite_indexes(this, row_id);
+}
+
+void ColumnBase::move_value(Int row_id, Int new_row_id, ColumnBase *buffer) {
+  Datum datum;
+  get(row_id, &datum);
+  buffer->set(Int(0), datum);
+  buffer->get(Int(0), &datum);
+  set(new_row_id, datum);
+  unset(row_id);
+}
 
 Index *ColumnBase::find_index_with_id(const String &name,
                                       size_t *index_id) const {
@@ -1,9 +1,13 @@
 #ifndef GRNXX_IMPL_COLUMN_BASE_HPP
 #define GRNXX_IMPL_COLUMN_BASE_HPP
 
+#include <cstdint>
 #include <memory>
 
 #include "grnxx/column.hpp"
+#include "grnxx/features.hpp"
+#include "grnxx/impl/column/body_compactor.hpp"
+#include "grnxx/impl/column/referrer_index.hpp"
 #include "grnxx/impl/index.hpp"
 #include "grnxx/table.hpp"
 
@@ -15,6 +19,15 @@ using ColumnInterface = grnxx::Column;
 
 class Table;
 
+// Issue a software prefetch for reading "address".
+inline void prefetch_for_read(const void *address) {
+#ifdef GRNXX_GNUC
+  __builtin_prefetch(address, 0, 3);
+#else  // GRNXX_GNUC
+  (void)address;
+#endif  // GRNXX_GNUC
+}
+
 class ColumnBase : public ColumnInterface {
  public:
   // -- Public API (grnxx/column.hpp) --
@@ -53,6 +66,14 @@ class ColumnBase : public ColumnInterface {
   virtual void set(Int row_id, const Datum &datum) = 0;
   virtual void get(Int row_id, Datum *datum) const = 0;
 
+  std::unique_ptr<Cursor> find_referrers(
+      Int row_id,
+      const CursorOptions &options) const;
+
+  // Fixed-size values leave no garbage, so the default implementation does
+  // nothing.
+  virtual void compact() {}
+
   // -- Internal API --
 
   // Create a new column.
@@ -74,6 +95,15 @@ class ColumnBase : public ColumnInterface {
   Table *_reference_table() const {
     return reference_table_;
   }
+  // Return the reverse index of the reference column.
+  // If "this" is not a reference column, returns nullptr.
+  const ReferrerIndex *_referrer_index() const {
+    return referrer_index_.get();
+  }
+  // Return the revision, which is changed whenever a value is changed.
+  uint64_t revision() const {
+    return revision_;
+  }
 
   // Change the column name.
   //
@@ -99,9 +129,43 @@ class ColumnBase : public ColumnInterface {
 
   // Unset the value.
   virtual void unset(Int row_id) = 0;
+  // Unset the values of "row_ids".
+  //
+  // "row_ids" must be sorted in ascending order without duplicates.
+  // Each index removes the entries of all the rows in one pass.
+  //
+  // On failure, throws an exception.
+  void unset_rows(ArrayCRef<Int> row_ids);
+
+  // Prefetch values for "records".
+  //
+  // NOTE: This is only a hint and the default implementation does nothing.
+  virtual void prefetch(ArrayCRef<Record>) const {}
+  // Rebuild the zone map on the current values, so that the bounds widened
+  // by past updates are narrowed.
+  //
+  // NOTE: The default implementation does nothing.
+  virtual void rebuild_zone_map() {}
 
-//  // Replace references to "row_id" with NULL.
-//  virtual void clear_references(Int row_id);
+  // Replace references to "row_id" with N/A.
+  //
+  // On failure, throws an exception.
+  virtual void clear_references(Int row_id);
+
+  // Move values to renumbered rows.
+  //
+  // "row_id_map[i]" is the new row ID of the "i"-th row, or N/A if the row
+  // has no value to be moved.
+  // The mapping must keep the order of rows, and both old and new row IDs
+  // must be valid during the call.
+  // Indexes are not updated and must be rebuilt by rebuild_indexes().
+  //
+  // On failure, throws an exception after moving values back.
+  void renumber_rows(ArrayCRef<Int> row_id_map);
+  // Rebuild indexes on the current values.
+  //
+  // On failure, throws an exception and indexes are not changed.
+  void rebuild_indexes();
 
  protected:
   Table *table_;
@@ -110,6 +174,35 @@ class ColumnBase : public ColumnInterface {
   Table *reference_table_;
   bool is_key_;
   Array<std::unique_ptr<Index>> indexes_;
+  std::unique_ptr<ReferrerIndex> referrer_index_;
+  uint64_t revision_;
+  // The compaction thresholds of variable-length values, which are shared
+  // by the compactors of the column.
+  CompactionOptions compaction_options_;
+
+  // Set "reference_table_" and create "referrer_index_".
+  //
+  // On failure, throws an exception.
+  void set_reference_table(const ColumnOptions &options);
+
+  // Validate and set the compaction thresholds.
+  //
+  // On failure, throws an exception.
+  void set_compaction_options(const ColumnOptions &options);
+
+  // Update the revision and composite indexes after the value of "row_id"
+  // is changed.
+  //
+  // On failure, throws an exception.
+  void notify_update(Int row_id);
+
+  // Move the value of "row_id" to "new_row_id" through "buffer".
+  //
+  // The value is stored into "new_row_id" before it is removed from
+  // "row_id", so that the value is not lost on failure.
+  //
+  // On failure, throws an exception.
+  void move_value(Int row_id, Int new_row_id, ColumnBase *buffer);
 
  private:
   // Find an index with its ID.
@@ -0,0 +1,245 @@
+#ifndef GRNXX_IMPL_COLUMN_BODY_COMPACTOR_HPP
+#define GRNXX_IMPL_COLUMN_BODY_COMPACTOR_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#include "grnxx/array.hpp"
+#include "grnxx/impl/column/chunked_array.hpp"
+
+namespace grnxx {
+namespace impl {
+
+// Compaction thresholds of a column.
+//
+// Compaction starts when the garbage reaches "min_garbage_size" bytes and
+// exceeds "garbage_ratio" of the stored bodies.
+struct CompactionOptions {
+  size_t min_garbage_size;
+  double garbage_ratio;
+};
+
+// Incremental compactor of variable-length bodies.
+//
+// "T" describes how bodies are stored and must provide the following:
+// - "Header": the header type of a value.
+// - "Storage": the type of the storage of bodies.
+// - "Cursor": the write position of compaction.
+// - "has_body(header)": whether "header" refers to a non-empty body.
+// - "match(lhs, rhs)": whether two headers are the same.
+// - "is_behind(header, cursor)": whether the body is not moved yet.
+// - "get_size(header, storage)": the number of bytes of a body.
+// - "get_total_size(storage)": the number of bytes of "storage".
+// - "move(header, storage, cursor)": slide a body to "*cursor", advance
+//   "*cursor" and return the new header.
+// - "finish(storage, cursor)": drop the storage after "cursor".
+//
+// Bodies are always appended to the end of the storage, so that the bodies
+// recorded by add() are in offset order without sorting.
+// Compaction slides live bodies toward the front in that order, a bounded
+// number of bytes per step, so that moved and not-yet-moved values are both
+// readable between steps.
+template <typename T>
+class BasicBodyCompactor {
+ public:
+  using Header = typename T::Header;
+  using Storage = typename T::Storage;
+  using Cursor = typename T::Cursor;
+
+  // The maximum number of bytes moved per step.
+  static constexpr size_t STEP_SIZE = 1 << 16;
+
+  // "options" must outlive the compactor.
+  explicit BasicBodyCompactor(const CompactionOptions *options)
+      : options_(options),
+        garbage_size_(0),
+        is_running_(false),
+        entries_(),
+        next_entry_(0),
+        num_kept_entries_(0),
+        cursor_() {}
+
+  // Return the number of bytes which are no longer referenced.
+  size_t garbage_size() const {
+    return garbage_size_;
+  }
+  // Return whether compaction is in progress or not.
+  bool is_running() const {
+    return is_running_;
+  }
+
+  // Record that a body has been appended to the storage as the body of
+  // "value_id".
+  //
+  // On failure, throws an exception.
+  void add(size_t value_id, const Header &header) try {
+    if (T::has_body(header)) {
+      entries_.push_back(Entry{ value_id, header });
+    }
+  } catch (const std::bad_alloc &) {
+    throw "Memory allocation failed";  // TODO
+  }
+
+  // Record that the body associated with "header" is no longer referenced.
+  void discard(const Header &header, const Storage &storage) {
+    if (is_running_ && T::is_behind(header, cursor_)) {
+      // The body will be dropped by the running compaction.
+      return;
+    }
+    garbage_size_ += T::get_size(header, storage);
+  }
+
+  // Run a compaction step if compaction is in progress or needed.
+  //
+  // On failure, throws an exception.
+  void maintain(ChunkedArray<Header> *headers, Storage *storage) {
+    if (!is_running_) {
+      if ((garbage_size_ < options_->min_garbage_size) ||
+          (garbage_size_ <=
+           (T::get_total_size(*storage) * options_->garbage_ratio))) {
+        return;
+      }
+      start();
+    }
+    step(headers, storage, STEP_SIZE);
+  }
+
+  // Finish compaction.
+  //
+  // On failure, throws an exception.
+  void compact(ChunkedArray<Header> *headers, Storage *storage) {
+    if (!is_running_) {
+      start();
+    }
+    step(headers, storage, std::numeric_limits<size_t>::max());
+  }
+
+ private:
+  struct Entry {
+    size_t value_id;
+    Header header;
+  };
+
+  const CompactionOptions *options_;
+  size_t garbage_size_;
+  bool is_running_;
+  // Bodies recorded by add() in offset order.
+  // During compaction, "entries_[0, num_kept_entries_)" are the moved live
+  // bodies and "entries_[next_entry_, entries_.size())" are not processed.
+  Array<Entry> entries_;
+  size_t next_entry_;
+  size_t num_kept_entries_;
+  Cursor cursor_;
+
+  // Start compaction.
+  void start() {
+    next_entry_ = 0;
+    num_kept_entries_ = 0;
+    cursor_ = Cursor();
+    // Garbage in the compacted part will be counted by discard().
+    garbage_size_ = 0;
+    is_running_ = true;
+  }
+
+  // Move at most "max_size" bytes.
+  //
+  // Bodies appended during compaction are moved by the same run.
+  //
+  // On failure, throws an exception.
+  void step(ChunkedArray<Header> *headers,
+            Storage *storage,
+            size_t max_size) {
+    size_t budget = max_size;
+    while ((next_entry_ < entries_.size()) && (budget != 0)) {
+      Entry entry = entries_[next_entry_];
+      ++next_entry_;
+      Header &header = (*headers)[entry.value_id];
+      if (!T::match(header, entry.header)) {
+        // The value has been updated or removed.
+        --budget;
+        continue;
+      }
+      size_t size = T::get_size(header, *storage);
+      header = T::move(header, storage, &cursor_);
+      entries_[num_kept_entries_] = Entry{ entry.value_id, header };
+      ++num_kept_entries_;
+      budget -= (size < budget) ? size : budget;
+    }
+    if (next_entry_ < entries_.size()) {
+      return;
+    }
+    entries_.resize(num_kept_entries_);
+    T::finish(storage, cursor_);
+    is_running_ = false;
+  }
+};
+
+// Bodies stored in an Array<T>.
+//
+// A header is (offset << 16) | size.
+// If size is 0xFFFF, the actual size is stored in front of the body.
+template <typename T>
+struct FlatBodies {
+  using Header = uint64_t;
+  using Storage = Array<T>;
+  // The write offset.
+  using Cursor = size_t;
+
+  // The number of values to store the size of a long body.
+  static constexpr size_t PREFIX_SIZE = sizeof(uint64_t) / sizeof(T);
+
+  static bool has_body(uint64_t header) {
+    return (header & 0xFFFF) != 0;
+  }
+  static bool match(uint64_t lhs, uint64_t rhs) {
+    return lhs == rhs;
+  }
+  static bool is_behind(uint64_t header, size_t cursor) {
+    return (header >> 16) >= cursor;
+  }
+  static size_t get_size(uint64_t header, const Array<T> &bodies) {
+    size_t size = header & 0xFFFF;
+    if (size == 0xFFFF) {
+      size = PREFIX_SIZE +
+             *reinterpret_cast<const uint64_t *>(&bodies[header >> 16]);
+    }
+    return sizeof(T) * size;
+  }
+  static size_t get_total_size(const Array<T> &bodies) {
+    return sizeof(T) * bodies.size();
+  }
+  static uint64_t move(uint64_t header, Array<T> *bodies, size_t *cursor) {
+    size_t offset = header >> 16;
+    size_t size = get_size(header, *bodies) / sizeof(T);
+    if ((header & 0xFFFF) == 0xFFFF) {
+      // A long body must be aligned for its size.
+      size_t byte_offset = *cursor * sizeof(T);
+      if ((byte_offset % sizeof(uint64_t)) != 0) {
+        *cursor += (sizeof(uint64_t) -
+                    (byte_offset % sizeof(uint64_t))) / sizeof(T);
+      }
+    }
+    if (*cursor != offset) {
+      std::memmove(static_cast<void *>(&(*bodies)[*cursor]),
+                   static_cast<const void *>(&(*bodies)[offset]),
+                   sizeof(T) * size);
+    }
+    header = (*cursor << 16) | (header & 0xFFFF);
+    *cursor += size;
+    return header;
+  }
+  static void finish(Array<T> *bodies, size_t cursor) {
+    bodies->resize(cursor);
+    bodies->shrink_to_fit();
+  }
+};
+
+template <typename T>
+using BodyCompactor = BasicBodyCompactor<FlatBodies<T>>;
+
+}  // namespace impl
+}  // namespace grnxx
+
+#endif  // GRNXX_IMPL_COLUMN_BODY_COMPACTOR_HPP
@@ -0,0 +1,143 @@
+#ifndef GRNXX_IMPL_COLUMN_CHUNKED_ARRAY_HPP
+#define GRNXX_IMPL_COLUMN_CHUNKED_ARRAY_HPP
+
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "grnxx/array.hpp"
+
+namespace grnxx {
+namespace impl {
+
+// An array which stores values in fixed-size chunks.
+//
+// A chunk directory holds chunks, so that appending values never moves the
+// stored values except in the first chunk, which grows like an Array until
+// it reaches the chunk size.
+// Only the directory, which is CHUNK_SIZE times smaller than the values, is
+// reallocated when the array grows.
+//
+// Arrays indexed by row ID, such as values of Float and GeoPoint columns and
+// headers of Text and vector columns, use this class, so that inserting a
+// row never copies the whole column.
+// NOTE: Bodies of Text and vector columns are kept in one Array, because a
+//       Vector<Text> refers to its texts with offsets from a single base and
+//       BodyCompactor slides bodies across the whole Array. They grow with
+//       the total size of values written, not with the number of rows.
+// NOTE: Int columns are not chunked. Their buffer grows with realloc(),
+//       which remaps large buffers without copying, and a value width
+//       changes at most three times in the life of a column.
+template <typename T>
+class ChunkedArray {
+ public:
+  using Value = T;
+
+  static constexpr size_t CHUNK_SIZE_BITS = 16;
+  static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_SIZE_BITS;
+  static constexpr size_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+  ChunkedArray() : chunks_(), size_(0) {}
+  ~ChunkedArray() = default;
+
+  ChunkedArray(const ChunkedArray &) = delete;
+  ChunkedArray &operator=(const ChunkedArray &) = delete;
+
+  // Return a reference to the "i"-th value.
+  //
+  // If "i" >= "size()", the behavior is undefined.
+  Value &operator[](size_t i) {
+    return chunks_[i >> CHUNK_SIZE_BITS][i & CHUNK_MASK];
+  }
+  // Return a reference to the "i"-th value.
+  //
+  // If "i" >= "size()", the behavior is undefined.
+  const Value &operator[](size_t i) const {
+    return chunks_[i >> CHUNK_SIZE_BITS][i & CHUNK_MASK];
+  }
+
+  // Return the number of values.
+  size_t size() const {
+    return size_;
+  }
+  // Return whether the array is empty or not.
+  bool is_empty() const {
+    return size_ == 0;
+  }
+
+  // Return the number of chunks.
+  size_t num_chunks() const {
+    return chunks_.size();
+  }
+  // Return the values in the "chunk_id"-th chunk.
+  //
+  // The "i"-th value of the "chunk_id"-th chunk is the
+  // ("chunk_id" * CHUNK_SIZE + "i")-th value.
+  //
+  // If "chunk_id" >= "num_chunks()", the behavior is undefined.
+  ArrayCRef<Value> get_chunk(size_t chunk_id) const {
+    return chunks_[chunk_id].cref();
+  }
+
+  // Append "value".
+  //
+  // On failure, throws an exception.
+  void push_back(const Value &value) {
+    resize(size_ + 1, value);
+  }
+
+  // Resize "this" and fill the new values with "value".
+  //
+  // On failure, throws an exception.
+  void resize(size_t new_size, const Value &value) try {
+    size_t new_num_chunks = (new_size + CHUNK_MASK) >> CHUNK_SIZE_BITS;
+    if (new_size < size_) {
+      chunks_.resize(new_num_chunks);
+      if (new_num_chunks != 0) {
+        size_t offset = (new_num_chunks - 1) << CHUNK_SIZE_BITS;
+        chunks_.back().resize(new_size - offset);
+      }
+      size_ = new_size;
+      return;
+    }
+    while (size_ < new_size) {
+      size_t chunk_id = size_ >> CHUNK_SIZE_BITS;
+      if (chunk_id == chunks_.size()) {
+        chunks_.resize(chunk_id + 1);
+      }
+      Array<Value> &chunk = chunks_[chunk_id];
+      size_t offset = chunk_id << CHUNK_SIZE_BITS;
+      size_t chunk_size = new_size - offset;
+      if (chunk_size > CHUNK_SIZE) {
+        chunk_size = CHUNK_SIZE;
+      }
+      if (chunk_size > chunk.capacity()) {
+        // The first chunk grows like an Array while it is small.
+        // Otherwise, a chunk is allocated with the exact chunk size.
+        size_t new_capacity = chunk.capacity() * 2;
+        if ((chunk_id != 0) || (chunk_size > CHUNK_SIZE / 2) ||
+            (new_capacity > CHUNK_SIZE)) {
+          Array<Value> new_chunk;
+          new_chunk.reserve(CHUNK_SIZE);
+          for (size_t i = 0; i < chunk.size(); ++i) {
+            new_chunk.push_back(chunk[i]);
+          }
+          chunk = std::move(new_chunk);
+        }
+      }
+      chunk.resize(chunk_size, value);
+      size_ = offset + chunk_size;
+    }
+  } catch (const std::bad_alloc &) {
+    throw "Memory allocation failed";  // TODO
+  }
+
+ private:
+  Array<Array<Value>> chunks_;
+  size_t size_;
+};
+
+}  // namespace impl
+}  // namespace grnxx
+
+#endif  // GRNXX_IMPL_COLUMN_CHUNKED_ARRAY_HPP
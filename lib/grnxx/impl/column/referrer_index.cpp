@@ -0,0 +1,120 @@
+#include "grnxx/impl/column/referrer_index.hpp"
+
+#include <algorithm>
+#include <new>
+
+#include "grnxx/impl/cursor.hpp"
+
+namespace grnxx {
+namespace impl {
+
+ReferrerIndex::ReferrerIndex()
+    : lists_(),
+      pool_(),
+      num_dead_entries_(0) {}
+
+ReferrerIndex::~ReferrerIndex() {}
+
+void ReferrerIndex::insert(Int value, Int row_id) try {
+  size_t value_id = value.raw();
+  if (value_id >= lists_.size()) {
+    lists_.resize(value_id + 1, List{ 0, 0, 0 });
+  }
+  List &list = lists_[value_id];
+  if (list.size == list.capacity) {
+    size_t new_capacity = (list.capacity != 0) ? (list.capacity * 2) : 1;
+    if ((list.offset + list.capacity) == pool_.size()) {
+      // The list is at the end of the pool and can be extended in place.
+      pool_.resize(list.offset + new_capacity);
+    } else {
+      size_t new_offset = pool_.size();
+      pool_.resize(new_offset + new_capacity);
+      for (size_t i = 0; i < list.size; ++i) {
+        pool_[new_offset + i] = pool_[list.offset + i];
+      }
+      num_dead_entries_ += list.capacity;
+      list.offset = new_offset;
+    }
+    list.capacity = new_capacity;
+  }
+  // Row IDs are usually inserted in ascending order, so that the shift is
+  // rarely needed.
+  size_t pos = list.size;
+  if ((pos != 0) && (pool_[list.offset + pos - 1].raw() > row_id.raw())) {
+    pos = lower_bound(list, row_id);
+    Int *entries = &pool_[list.offset];
+    std::copy_backward(entries + pos, entries + list.size,
+                       entries + list.size + 1);
+  }
+  pool_[list.offset + pos] = row_id;
+  ++list.size;
+  if (num_dead_entries_ > (pool_.size() / 2)) {
+    compact();
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void ReferrerIndex::remove(Int value, Int row_id) {
+  size_t value_id = value.raw();
+  if (value_id >= lists_.size()) {
+    return;
+  }
+  List &list = lists_[value_id];
+  size_t pos = lower_bound(list, row_id);
+  if ((pos == list.size) || pool_[list.offset + pos].unmatch(row_id)) {
+    return;
+  }
+  Int *entries = &pool_[list.offset];
+  std::copy(entries + pos + 1, entries + list.size, entries + pos);
+  --list.size;
+}
+
+std::unique_ptr<Cursor> ReferrerIndex::find(
+    Int value,
+    const CursorOptions &options) const try {
+  ArrayCRef<Int> referrers = get(value);
+  // A vector column may refer to the same row more than once.
+  Array<Int> row_ids;
+  row_ids.reserve(referrers.size());
+  for (size_t i = 0; i < referrers.size(); ++i) {
+    if ((i == 0) || referrers[i].unmatch(referrers[i - 1])) {
+      row_ids.push_back(referrers[i]);
+    }
+  }
+  if (options.order_type == GRNXX_REVERSE_ORDER) {
+    std::reverse(row_ids.buffer(), row_ids.buffer() + row_ids.size());
+  }
+  return std::unique_ptr<Cursor>(
+      new RowIDArrayCursor(std::move(row_ids),
+                           options.offset, options.limit));
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+size_t ReferrerIndex::lower_bound(const List &list, Int row_id) const {
+  const Int *entries = pool_.data() + list.offset;
+  return std::lower_bound(entries, entries + list.size, row_id,
+                          [](Int lhs, Int rhs) {
+                            return lhs.raw() < rhs.raw();
+                          }) - entries;
+}
+
+void ReferrerIndex::compact() {
+  Array<Int> new_pool;
+  new_pool.resize(pool_.size() - num_dead_entries_);
+  size_t new_offset = 0;
+  for (size_t i = 0; i < lists_.size(); ++i) {
+    List &list = lists_[i];
+    for (size_t j = 0; j < list.size; ++j) {
+      new_pool[new_offset + j] = pool_[list.offset + j];
+    }
+    list.offset = new_offset;
+    new_offset += list.capacity;
+  }
+  pool_ = std::move(new_pool);
+  num_dead_entries_ = 0;
+}
+
+}  // namespace impl
+}  // namespace grnxx
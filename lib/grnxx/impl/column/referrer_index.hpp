@@ -0,0 +1,77 @@
+#ifndef GRNXX_IMPL_COLUMN_REFERRER_INDEX_HPP
+#define GRNXX_IMPL_COLUMN_REFERRER_INDEX_HPP
+
+#include <memory>
+
+#include "grnxx/array.hpp"
+#include "grnxx/cursor.hpp"
+#include "grnxx/data_types.hpp"
+
+namespace grnxx {
+namespace impl {
+
+// Reverse index of a reference column.
+//
+// Row IDs referring to each referenced (parent) row are stored in a posting
+// list sorted in ascending order, and all the posting lists share one pool
+// like CSR.
+// A posting list which runs out of its capacity is moved to the end of the
+// pool, and the pool is compacted when more than half of it is dead.
+class ReferrerIndex {
+ public:
+  ReferrerIndex();
+  ~ReferrerIndex();
+
+  // Return the row IDs referring to "value".
+  //
+  // The row IDs are sorted in ascending order and may contain duplicates if
+  // the reference column is a vector column.
+  // The result is invalidated by insert() and remove().
+  ArrayCRef<Int> get(Int value) const {
+    size_t value_id = value.raw();
+    if (value_id >= lists_.size()) {
+      return ArrayCRef<Int>(nullptr, 0);
+    }
+    const List &list = lists_[value_id];
+    return pool_.cref(list.offset, list.size);
+  }
+
+  // Insert "row_id" into the posting list of "value".
+  //
+  // On failure, throws an exception.
+  void insert(Int value, Int row_id);
+  // Remove one "row_id" from the posting list of "value".
+  //
+  // If not found, does nothing.
+  void remove(Int value, Int row_id);
+
+  // Create a cursor to get rows referring to "value".
+  //
+  // On success, returns the cursor.
+  // On failure, throws an exception.
+  std::unique_ptr<Cursor> find(Int value,
+                               const CursorOptions &options) const;
+
+ private:
+  struct List {
+    size_t offset;
+    size_t size;
+    size_t capacity;
+  };
+
+  Array<List> lists_;
+  Array<Int> pool_;
+  size_t num_dead_entries_;
+
+  // Return the position of the first row ID not less than "row_id" in
+  // "list".
+  size_t lower_bound(const List &list, Int row_id) const;
+
+  // Remove dead entries from "pool_".
+  void compact();
+};
+
+}  // namespace impl
+}  // namespace grnxx
+
+#endif  // GRNXX_IMPL_COLUMN_REFERRER_INDEX_HPP
@@ -9,7 +9,8 @@ Column<Bool>::Column(Table *table,
                      const String &name,
                      const ColumnOptions &)
     : ColumnBase(table, name, GRNXX_BOOL),
-      values_() {}
+      value_bits_(),
+      validity_bits_() {}
 
 Column<Bool>::~Column() {}
 
@@ -33,8 +34,11 @@ void Column<Bool>::set(Int row_id, const Datum &datum) {
 //    }
   }
   size_t value_id = row_id.raw();
-  if (value_id >= values_.size()) {
-    values_.resize(value_id + 1, Bool::na());
+  size_t word_id = value_id / 64;
+  if (word_id >= validity_bits_.size()) {
+    // "value_bits_" must not be shorter than "validity_bits_".
+    value_bits_.resize(word_id + 1, 0);
+    validity_bits_.resize(word_id + 1, 0);
   }
   // TODO: Insert the new value into indexes.
 //  for (size_t i = 0; i < num_indexes(); ++i) try {
@@ -45,16 +49,18 @@ void Column<Bool>::set(Int row_id, const Datum &datum) {
 //    }
 //    throw;
 //  }
-  values_[value_id] = new_value;
+  uint64_t bit = uint64_t(1) << (value_id % 64);
+  if (new_value.is_true()) {
+    value_bits_[word_id] |= bit;
+  } else {
+    value_bits_[word_id] &= ~bit;
+  }
+  validity_bits_[word_id] |= bit;
+  notify_update(row_id);
 }
 
 void Column<Bool>::get(Int row_id, Datum *datum) const {
-  size_t value_id = row_id.raw();
-  if (value_id >= values_.size()) {
-    *datum = Bool::na();
-  } else {
-    *datum = values_[value_id];
-  }
+  *datum = get(row_id);
 }
 
 bool Column<Bool>::contains(const Datum &datum) const {
@@ -70,8 +76,22 @@ Int Column<Bool>::find_one(const Datum &datum) const {
 void Column<Bool>::unset(Int row_id) {
   Bool value = get(row_id);
   if (!value.is_na()) {
-    values_[row_id.raw()] = Bool::na();
+    size_t value_id = row_id.raw();
+    uint64_t bit = uint64_t(1) << (value_id % 64);
+    value_bits_[value_id / 64] &= ~bit;
+    validity_bits_[value_id / 64] &= ~bit;
     // TODO: Update indexes if exist.
+    notify_update(row_id);
+  }
+}
+
+void Column<Bool>::prefetch(ArrayCRef<Record> records) const {
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t word_id = records[i].row_id.raw() / 64;
+    if (word_id < validity_bits_.size()) {
+      prefetch_for_read(&value_bits_[word_id]);
+      prefetch_for_read(&validity_bits_[word_id]);
+    }
   }
 }
 
@@ -85,28 +105,80 @@ void Column<Bool>::read(ArrayCRef<Record> records,
   }
 }
 
+void Column<Bool>::filter(ArrayCRef<Record> input_records,
+                          ArrayRef<Record> *output_records) const {
+  size_t count = 0;
+  size_t i = 0;
+  // If 64 records have consecutive row IDs, their value bits are read as a
+  // word and true records are extracted with bit operations.
+  for ( ; (i + 64) <= input_records.size(); i += 64) {
+    int64_t first_row_id = input_records[i].row_id.raw();
+    bool is_consecutive = (first_row_id >= 0);
+    for (size_t j = 1; j < 64; ++j) {
+      is_consecutive &=
+          (input_records[i + j].row_id.raw() == (first_row_id + int64_t(j)));
+    }
+    if (is_consecutive) {
+      // NOTE: Records are moved forward, so "input_records[i + j]" is not
+      //       overwritten before being read.
+      uint64_t word = get_value_word(first_row_id);
+      while (word != 0) {
+        // TODO: ::__builtin_ctzll() is not available on VC++.
+        size_t j = ::__builtin_ctzll(word);
+        (*output_records)[count] = input_records[i + j];
+        ++count;
+        word &= word - 1;
+      }
+    } else {
+      for (size_t j = i; j < (i + 64); ++j) {
+        if (get(input_records[j].row_id).is_true()) {
+          (*output_records)[count] = input_records[j];
+          ++count;
+        }
+      }
+    }
+  }
+  for ( ; i < input_records.size(); ++i) {
+    if (get(input_records[i].row_id).is_true()) {
+      (*output_records)[count] = input_records[i];
+      ++count;
+    }
+  }
+  *output_records = output_records->ref(0, count);
+}
+
 Int Column<Bool>::scan(Bool value) const {
   if (table_->max_row_id().is_na()) {
     return Int::na();
   }
   size_t table_size = table_->max_row_id().raw() + 1;
-  size_t valid_size =
-      (values_.size() < table_size) ? values_.size() : table_size;
-  if (value.is_na()) {
-    if (values_.size() < table_size) {
-      return table_->max_row_id();
+  size_t size = validity_bits_.size() * 64;
+  if (value.is_na() && (size < table_size)) {
+    return table_->max_row_id();
+  }
+  size_t valid_size = (size < table_size) ? size : table_size;
+  size_t num_words = (valid_size + 63) / 64;
+  bool is_full = table_->is_full();
+  for (size_t i = 0; i < num_words; ++i) {
+    // Bits for "value" are extracted per word.
+    uint64_t word;
+    if (value.is_na()) {
+      word = ~validity_bits_[i];
+    } else if (value.is_true()) {
+      word = value_bits_[i];
+    } else {
+      word = validity_bits_[i] & ~value_bits_[i];
     }
-    bool is_full = table_->is_full();
-    for (size_t i = 0; i < valid_size; ++i) {
-      if (values_[i].is_na() && (is_full || table_->_test_row(i))) {
-        return Int(i);
-      }
+    if ((i == (num_words - 1)) && ((valid_size % 64) != 0)) {
+      word &= (uint64_t(1) << (valid_size % 64)) - 1;
     }
-  } else {
-    for (size_t i = 0; i < valid_size; ++i) {
-      if (values_[i].match(value)) {
-        return Int(i);
+    while (word != 0) {
+      // TODO: ::__builtin_ctzll() is not available on VC++.
+      size_t value_id = (i * 64) + ::__builtin_ctzll(word);
+      if (!value.is_na() || is_full || table_->_test_row(value_id)) {
+        return Int(value_id);
       }
+      word &= word - 1;
     }
   }
   return Int::na();
@@ -1,6 +1,8 @@
 #ifndef GRNXX_IMPL_COLUMN_SCALAR_BOOL_HPP
 #define GRNXX_IMPL_COLUMN_SCALAR_BOOL_HPP
 
+#include <cstdint>
+
 #include "grnxx/impl/column/base.hpp"
 
 namespace grnxx {
@@ -26,6 +28,7 @@ class Column<Bool> : public ColumnBase {
 
   // Unset the value.
   void unset(Int row_id);
+  void prefetch(ArrayCRef<Record> records) const;
 
   // -- Internal API --
 
@@ -35,18 +38,44 @@ class Column<Bool> : public ColumnBase {
   // If "row_id" is invalid, returns N/A.
   Bool get(Int row_id) const {
     size_t value_id = row_id.raw();
-    if (value_id >= values_.size()) {
+    size_t word_id = value_id / 64;
+    if (word_id >= validity_bits_.size()) {
+      return Bool::na();
+    }
+    uint64_t bit = uint64_t(1) << (value_id % 64);
+    if ((validity_bits_[word_id] & bit) == 0) {
       return Bool::na();
     }
-    return values_[value_id];
+    return Bool((value_bits_[word_id] & bit) != 0);
   }
   // Read values.
   //
   // On failure, throws an exception.
   void read(ArrayCRef<Record> records, ArrayRef<Bool> values) const;
+  // Extract records whose values are true.
+  //
+  // "input_records" and "output_records" may be the same.
+  void filter(ArrayCRef<Record> input_records,
+              ArrayRef<Record> *output_records) const;
 
  private:
-  Array<Bool> values_;
+  // The "i"-th value is N/A if the "i"-th bit of "validity_bits_" is 0.
+  // Otherwise, the "i"-th bit of "value_bits_" is the value.
+  // The value bit of N/A is always 0, so that it means true or not.
+  Array<uint64_t> value_bits_;
+  Array<uint64_t> validity_bits_;
+
+  // Return the value bits of [value_id, value_id + 64).
+  uint64_t get_value_word(size_t value_id) const {
+    size_t word_id = value_id / 64;
+    size_t shift = value_id % 64;
+    uint64_t word = (word_id < value_bits_.size()) ?
+                    (value_bits_[word_id] >> shift) : 0;
+    if ((shift != 0) && ((word_id + 1) < value_bits_.size())) {
+      word |= value_bits_[word_id + 1] << (64 - shift);
+    }
+    return word;
+  }
 
   // Scan the column to find "value".
   //
@@ -10,7 +10,8 @@ Column<Float>::Column(Table *table,
                       const String &name,
                       const ColumnOptions &)
     : ColumnBase(table, name, GRNXX_FLOAT),
-      values_() {}
+      values_(),
+      zone_map_() {}
 
 Column<Float>::~Column() {}
 
@@ -46,7 +47,12 @@ void Column<Float>::set(Int row_id, const Datum &datum) {
     }
     throw;
   }
+  zone_map_.insert(value_id, new_value);
+  if (!old_value.is_na()) {
+    zone_map_.remove(value_id);
+  }
   values_[value_id] = new_value;
+  notify_update(row_id);
 }
 
 void Column<Float>::get(Int row_id, Datum *datum) const {
@@ -86,7 +92,32 @@ void Column<Float>::unset(Int row_id) {
     for (size_t i = 0; i < num_indexes(); ++i) {
       indexes_[i]->remove(row_id, value);
     }
+    zone_map_.remove(row_id.raw());
     values_[row_id.raw()] = Float::na();
+    notify_update(row_id);
+  }
+}
+
+void Column<Float>::prefetch(ArrayCRef<Record> records) const {
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t value_id = records[i].row_id.raw();
+    if (value_id < values_.size()) {
+      prefetch_for_read(&values_[value_id]);
+    }
+  }
+}
+
+void Column<Float>::rebuild_zone_map() {
+  zone_map_.clear();
+  if (table_->max_row_id().is_na()) {
+    return;
+  }
+  size_t size = table_->max_row_id().raw() + 1;
+  for (size_t i = 0; i < size; ++i) {
+    Float value = get(Int(i));
+    if (!value.is_na()) {
+      zone_map_.insert(i, value);
+    }
   }
 }
 
@@ -107,20 +138,31 @@ Int Column<Float>::scan(Float value) const {
   size_t table_size = table_->max_row_id().raw() + 1;
   size_t valid_size =
       (values_.size() < table_size) ? values_.size() : table_size;
-  if (value.is_na()) {
-    if (values_.size() < table_size) {
-      return table_->max_row_id();
+  if (value.is_na() && (values_.size() < table_size)) {
+    return table_->max_row_id();
+  }
+  bool is_full = table_->is_full();
+  // Values are scanned per chunk.
+  for (size_t i = 0; i < values_.num_chunks(); ++i) {
+    size_t offset = i * ChunkedArray<Float>::CHUNK_SIZE;
+    if (offset >= valid_size) {
+      break;
     }
-    bool is_full = table_->is_full();
-    for (size_t i = 0; i < valid_size; ++i) {
-      if (values_[i].is_na() && (is_full || table_->_test_row(i))) {
-        return Int(i);
-      }
+    ArrayCRef<Float> chunk = values_.get_chunk(i);
+    if (chunk.size() > (valid_size - offset)) {
+      chunk = chunk.cref(0, valid_size - offset);
     }
-  } else {
-    for (size_t i = 0; i < valid_size; ++i) {
-      if (values_[i].match(value)) {
-        return Int(i);
+    if (value.is_na()) {
+      for (size_t j = 0; j < chunk.size(); ++j) {
+        if (chunk[j].is_na() && (is_full || table_->_test_row(offset + j))) {
+          return Int(offset + j);
+        }
+      }
+    } else {
+      for (size_t j = 0; j < chunk.size(); ++j) {
+        if (chunk[j].match(value)) {
+          return Int(offset + j);
+        }
       }
     }
   }
@@ -2,6 +2,8 @@
 #define GRNXX_IMPL_COLUMN_SCALAR_FLOAT_HPP
 
 #include "grnxx/impl/column/base.hpp"
+#include "grnxx/impl/column/chunked_array.hpp"
+#include "grnxx/impl/column/scalar/zone_map.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -26,6 +28,8 @@ class Column<Float> : public ColumnBase {
 
   // Unset the value.
   void unset(Int row_id);
+  void prefetch(ArrayCRef<Record> records) const;
+  void rebuild_zone_map();
 
   // -- Internal API --
 
@@ -45,8 +49,14 @@ class Column<Float> : public ColumnBase {
   // On failure, throws an exception.
   void read(ArrayCRef<Record> records, ArrayRef<Float> values) const;
 
+  // Return the zone map.
+  const ZoneMap<Float> &zone_map() const {
+    return zone_map_;
+  }
+
  private:
-  Array<Float> values_;
+  ChunkedArray<Float> values_;
+  ZoneMap<Float> zone_map_;
 
   // Scan the column to find "value".
   //
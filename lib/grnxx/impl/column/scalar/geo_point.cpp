@@ -1,7 +1,7 @@
 #include "grnxx/impl/column/scalar/geo_point.hpp"
 
 #include "grnxx/impl/table.hpp"
-//#include "grnxx/index.hpp"
+#include "grnxx/impl/index.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -28,25 +28,26 @@ void Column<GeoPoint>::set(Int row_id, const Datum &datum) {
     return;
   }
   if (!old_value.is_na()) {
-    // TODO: Remove the old value from indexes.
-//    for (size_t i = 0; i < num_indexes(); ++i) {
-//      indexes_[i]->remove(row_id, old_value);
-//    }
+    // Remove the old value from indexes.
+    for (size_t i = 0; i < num_indexes(); ++i) {
+      indexes_[i]->remove(row_id, old_value);
+    }
   }
   size_t value_id = row_id.raw();
   if (value_id >= values_.size()) {
     values_.resize(value_id + 1, GeoPoint::na());
   }
-  // TODO: Insert the new value into indexes.
-//  for (size_t i = 0; i < num_indexes(); ++i) try {
-//    indexes_[i]->insert(row_id, datum)) {
-//  } catch (...) {
-//    for (size_t j = 0; j < i; ++i) {
-//      indexes_[j]->remove(row_id, datum);
-//    }
-//    throw;
-//  }
+  // Insert the new value into indexes.
+  for (size_t i = 0; i < num_indexes(); ++i) try {
+    indexes_[i]->insert(row_id, datum);
+  } catch (...) {
+    for (size_t j = 0; j < i; ++j) {
+      indexes_[j]->remove(row_id, datum);
+    }
+    throw;
+  }
   values_[value_id] = new_value;
+  notify_update(row_id);
 }
 
 void Column<GeoPoint>::get(Int row_id, Datum *datum) const {
@@ -59,23 +60,44 @@ void Column<GeoPoint>::get(Int row_id, Datum *datum) const {
 }
 
 bool Column<GeoPoint>::contains(const Datum &datum) const {
-  // TODO: Use an index if exists.
-  return !scan(parse_datum(datum)).is_na();
+  // TODO: Choose the best index.
+  GeoPoint value = parse_datum(datum);
+  if (!indexes_.is_empty()) {
+    if (value.is_na()) {
+      return table_->num_rows() != indexes_[0]->num_entries();
+    }
+    return indexes_[0]->contains(datum);
+  }
+  return !scan(value).is_na();
 }
 
 Int Column<GeoPoint>::find_one(const Datum &datum) const {
-  // TODO: Use an index if exists.
-  return scan(parse_datum(datum));
+  // TODO: Choose the best index.
+  GeoPoint value = parse_datum(datum);
+  if (!value.is_na() && !indexes_.is_empty()) {
+    return indexes_[0]->find_one(datum);
+  }
+  return scan(value);
 }
 
 void Column<GeoPoint>::unset(Int row_id) {
   GeoPoint value = get(row_id);
   if (!value.is_na()) {
-    // TODO: Update indexes if exist.
-//    for (size_t i = 0; i < num_indexes(); ++i) {
-//      indexes_[i]->remove(row_id, value);
-//    }
+    // Update indexes if exist.
+    for (size_t i = 0; i < num_indexes(); ++i) {
+      indexes_[i]->remove(row_id, value);
+    }
     values_[row_id.raw()] = GeoPoint::na();
+    notify_update(row_id);
+  }
+}
+
+void Column<GeoPoint>::prefetch(ArrayCRef<Record> records) const {
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t value_id = records[i].row_id.raw();
+    if (value_id < values_.size()) {
+      prefetch_for_read(&values_[value_id]);
+    }
   }
 }
 
@@ -96,20 +118,31 @@ Int Column<GeoPoint>::scan(GeoPoint value) const {
   size_t table_size = table_->max_row_id().raw() + 1;
   size_t valid_size =
       (values_.size() < table_size) ? values_.size() : table_size;
-  if (value.is_na()) {
-    if (values_.size() < table_size) {
-      return table_->max_row_id();
+  if (value.is_na() && (values_.size() < table_size)) {
+    return table_->max_row_id();
+  }
+  bool is_full = table_->is_full();
+  // Values are scanned per chunk.
+  for (size_t i = 0; i < values_.num_chunks(); ++i) {
+    size_t offset = i * ChunkedArray<GeoPoint>::CHUNK_SIZE;
+    if (offset >= valid_size) {
+      break;
     }
-    bool is_full = table_->is_full();
-    for (size_t i = 0; i < valid_size; ++i) {
-      if (values_[i].is_na() && (is_full || table_->_test_row(i))) {
-        return Int(i);
-      }
+    ArrayCRef<GeoPoint> chunk = values_.get_chunk(i);
+    if (chunk.size() > (valid_size - offset)) {
+      chunk = chunk.cref(0, valid_size - offset);
     }
-  } else {
-    for (size_t i = 0; i < valid_size; ++i) {
-      if (values_[i].match(value)) {
-        return Int(i);
+    if (value.is_na()) {
+      for (size_t j = 0; j < chunk.size(); ++j) {
+        if (chunk[j].is_na() && (is_full || table_->_test_row(offset + j))) {
+          return Int(offset + j);
+        }
+      }
+    } else {
+      for (size_t j = 0; j < chunk.size(); ++j) {
+        if (chunk[j].match(value)) {
+          return Int(offset + j);
+        }
       }
     }
   }
@@ -2,6 +2,7 @@
 #define GRNXX_IMPL_COLUMN_SCALAR_GEO_POINT_HPP
 
 #include "grnxx/impl/column/base.hpp"
+#include "grnxx/impl/column/chunked_array.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -26,6 +27,7 @@ class Column<GeoPoint> : public ColumnBase {
 
   // Unset the value.
   void unset(Int row_id);
+  void prefetch(ArrayCRef<Record> records) const;
 
   // -- Internal API --
 
@@ -46,7 +48,7 @@ class Column<GeoPoint> : public ColumnBase {
   void read(ArrayCRef<Record> records, ArrayRef<GeoPoint> values) const;
 
  private:
-  Array<GeoPoint> values_;
+  ChunkedArray<GeoPoint> values_;
 
   // Scan the column to find "value".
   //
@@ -4,25 +4,100 @@
 #include "grnxx/impl/table.hpp"
 #include "grnxx/impl/index.hpp"
 
+#include <cstring>
+#include <new>
 #include <unordered_set>
 
 namespace grnxx {
 namespace impl {
+namespace int_column {
+
+constexpr size_t BLOCK_SIZE = 1024;
+constexpr size_t GROUP_SIZE = 64;
+
+constexpr uint64_t code_mask(size_t width) {
+  return (width < 64) ? ((uint64_t(1) << width) - 1) : ~uint64_t(0);
+}
+
+// Decode a block whose codes are "WIDTH" bits.
+//
+// "WIDTH" is a constant, so the shifts are fixed per position and the
+// compiler can unroll and vectorize the loop.
+template <size_t WIDTH>
+void decode_block(const uint64_t *words, int64_t base, Int *values) {
+  uint64_t offset = static_cast<uint64_t>(base) - 1;
+  for (size_t group = 0; group < (BLOCK_SIZE / GROUP_SIZE); ++group) {
+    const uint64_t *group_words = words + (group * WIDTH);
+    Int *group_values = values + (group * GROUP_SIZE);
+    for (size_t i = 0; i < GROUP_SIZE; ++i) {
+      size_t pos = i * WIDTH;
+      size_t shift = pos % 64;
+      uint64_t code = group_words[pos / 64] >> shift;
+      if ((shift + WIDTH) > 64) {
+        code |= group_words[(pos / 64) + 1] << (64 - shift);
+      }
+      code &= code_mask(WIDTH);
+      group_values[i] = (code != 0) ?
+          Int(static_cast<int64_t>(offset + code)) : Int::na();
+    }
+  }
+}
+
+using BlockDecoder = void (*)(const uint64_t *, int64_t, Int *);
+
+// Fill "decoders[1]" to "decoders[WIDTH]".
+template <size_t WIDTH>
+struct BlockDecoderTable {
+  static void fill(BlockDecoder *decoders) {
+    decoders[WIDTH] = decode_block<WIDTH>;
+    BlockDecoderTable<WIDTH - 1>::fill(decoders);
+  }
+};
+
+template <>
+struct BlockDecoderTable<0> {
+  static void fill(BlockDecoder *) {}
+};
+
+// Decoders for 0 to 64 bits.
+struct BlockDecoders {
+  BlockDecoder decoders[65];
+
+  BlockDecoders() : decoders() {
+    BlockDecoderTable<64>::fill(decoders);
+  }
+};
+
+// Return the decoder for "width" bits.
+BlockDecoder get_block_decoder(size_t width) {
+  // NOTE: The initialization of a local static object is thread-safe.
+  static const BlockDecoders block_decoders;
+  return block_decoders.decoders[width];
+}
+
+// Return the number of bits required to represent "value".
+size_t get_bit_width(uint64_t value) {
+  size_t width = 0;
+  while (value != 0) {
+    ++width;
+    value >>= 1;
+  }
+  return width;
+}
+
+}  // namespace int_column
 
 Column<Int>::Column(Table *table,
                     const String &name,
                     const ColumnOptions &options)
     : ColumnBase(table, name, GRNXX_INT),
-      value_size_(8),
+      value_size_(options.frame_of_reference_encoding ? 0 : 8),
       buffer_(nullptr),
       size_(0),
-      capacity_(0) {
-  if (!options.reference_table_name.is_empty()) {
-    reference_table_ = table->_db()->find_table(options.reference_table_name);
-    if (!reference_table_) {
-      throw "Table not found";  // TODO
-    }
-  }
+      capacity_(0),
+      packed_blocks_(),
+      zone_map_() {
+  set_reference_table(options);
 }
 
 Column<Int>::~Column() {
@@ -72,7 +147,21 @@ void Column<Int>::set(Int row_id, const Datum &datum) {
     }
     throw;
   }
+  if (referrer_index_) {
+    referrer_index_->insert(new_value, row_id);
+    if (!old_value.is_na()) {
+      referrer_index_->remove(old_value, row_id);
+    }
+  }
+  zone_map_.insert(value_id, new_value);
+  if (!old_value.is_na()) {
+    zone_map_.remove(value_id);
+  }
   switch (value_size_) {
+    case 0: {
+      set_packed(value_id, new_value);
+      break;
+    }
     case 8: {
       values_8_[value_id] = static_cast<int8_t>(new_value.raw());
       break;
@@ -90,6 +179,7 @@ void Column<Int>::set(Int row_id, const Datum &datum) {
       break;
     }
   }
+  notify_update(row_id);
 }
 
 void Column<Int>::get(Int row_id, Datum *datum) const {
@@ -172,6 +262,11 @@ void Column<Int>::set_key(Int row_id, const Datum &key) {
   }
   size_t value_id = row_id.raw();
   Int value = parse_datum(key);
+  if (reference_table_) {
+    if (!reference_table_->test_row(value)) {
+      throw "Invalid reference";  // TODO
+    }
+  }
   reserve(value_id + 1, value);
   // Update indexes if exist.
   for (size_t i = 0; i < num_indexes(); ++i) try {
@@ -182,7 +277,15 @@ void Column<Int>::set_key(Int row_id, const Datum &key) {
     }
     throw;
   }
+  if (referrer_index_) {
+    referrer_index_->insert(value, row_id);
+  }
+  zone_map_.insert(value_id, value);
   switch (value_size_) {
+    case 0: {
+      set_packed(value_id, value);
+      break;
+    }
     case 8: {
       values_8_[value_id] = static_cast<int8_t>(value.raw());
       break;
@@ -200,6 +303,7 @@ void Column<Int>::set_key(Int row_id, const Datum &key) {
       break;
     }
   }
+  notify_update(row_id);
 }
 
 void Column<Int>::unset(Int row_id) {
@@ -209,7 +313,15 @@ void Column<Int>::unset(Int row_id) {
     for (size_t i = 0; i < num_indexes(); ++i) {
       indexes_[i]->remove(row_id, value);
     }
+    if (referrer_index_) {
+      referrer_index_->remove(value, row_id);
+    }
+    zone_map_.remove(row_id.raw());
     switch (value_size_) {
+      case 0: {
+        set_packed(row_id.raw(), Int::na());
+        break;
+      }
       case 8: {
         values_8_[row_id.raw()] = na_value_8();
         break;
@@ -227,6 +339,46 @@ void Column<Int>::unset(Int row_id) {
         break;
       }
     }
+    notify_update(row_id);
+  }
+}
+
+void Column<Int>::prefetch(ArrayCRef<Record> records) const {
+  if (value_size_ == 0) {
+    for (size_t i = 0; i < records.size(); ++i) {
+      size_t value_id = records[i].row_id.raw();
+      if (value_id < size_) {
+        const PackedBlock &block =
+            packed_blocks_[value_id / PACKED_BLOCK_SIZE];
+        if (block.width != 0) {
+          size_t pos = (value_id % PACKED_BLOCK_SIZE) * block.width;
+          prefetch_for_read(&block.words[pos / 64]);
+        }
+      }
+    }
+    return;
+  }
+  size_t value_unit = value_size_ / 8;
+  const char *values = static_cast<const char *>(buffer_);
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t value_id = records[i].row_id.raw();
+    if (value_id < size_) {
+      prefetch_for_read(values + (value_id * value_unit));
+    }
+  }
+}
+
+void Column<Int>::rebuild_zone_map() {
+  zone_map_.clear();
+  if (table_->max_row_id().is_na()) {
+    return;
+  }
+  size_t size = table_->max_row_id().raw() + 1;
+  for (size_t i = 0; i < size; ++i) {
+    Int value = get(Int(i));
+    if (!value.is_na()) {
+      zone_map_.insert(i, value);
+    }
   }
 }
 
@@ -235,6 +387,10 @@ void Column<Int>::read(ArrayCRef<Record> records, ArrayRef<Int> values) const {
     throw "Data size conflict";  // TODO
   }
   switch (value_size_) {
+    case 0: {
+      read_packed(records, values);
+      break;
+    }
     case 8: {
       for (size_t i = 0; i < records.size(); ++i) {
         size_t value_id = records[i].row_id.raw();
@@ -272,52 +428,19 @@ void Column<Int>::read(ArrayCRef<Record> records, ArrayRef<Int> values) const {
   }
 }
 
-//void Column<Int>::clear_references(Int row_id) {
-//  // TODO: Cursor should not be used to avoid errors.
-//  if (indexes_.size() != 0) {
-//    auto cursor = indexes_[0]->find(nullptr, Int(0));
-//    if (!cursor) {
-//      // Error.
-//      return;
-//    }
-//    Array<Record> records;
-//    for ( ; ; ) {
-//      auto result = cursor->read(nullptr, 1024, &records);
-//      if (!result.is_ok) {
-//        // Error.
-//        return;
-//      } else if (result.count == 0) {
-//        return;
-//      }
-//      for (Int i = 0; i < records.size(); ++i) {
-//        set(nullptr, row_id, NULL_ROW_ID);
-//      }
-//      records.clear();
-//    }
-//  } else {
-//    auto cursor = table_->create_cursor(nullptr);
-//    if (!cursor) {
-//      // Error.
-//      return;
-//    }
-//    Array<Record> records;
-//    for ( ; ; ) {
-//      auto result = cursor->read(nullptr, 1024, &records);
-//      if (!result.is_ok) {
-//        // Error.
-//        return;
-//      } else if (result.count == 0) {
-//        return;
-//      }
-//      for (Int i = 0; i < records.size(); ++i) {
-//        if (values_[records.get_row_id(i)] == row_id) {
-//          values_[records.get_row_id(i)] = NULL_ROW_ID;
-//        }
-//      }
-//      records.clear();
-//    }
-//  }
-//}
+void Column<Int>::clear_references(Int row_id) {
+  if (!referrer_index_) {
+    throw "Not reference column";  // TODO
+  }
+  // NOTE: unset() removes entries from the posting list of "row_id".
+  for ( ; ; ) {
+    ArrayCRef<Int> referrers = referrer_index_->get(row_id);
+    if (referrers.size() == 0) {
+      break;
+    }
+    unset(referrers[referrers.size() - 1]);
+  }
+}
 
 Int Column<Int>::scan(Int value) const {
   if (table_->max_row_id().is_na()) {
@@ -325,6 +448,12 @@ Int Column<Int>::scan(Int value) const {
   }
   size_t table_size = table_->max_row_id().raw() + 1;
   size_t valid_size = (size_ < table_size) ? size_ : table_size;
+  if (value_size_ == 0) {
+    if (value.is_na() && (size_ < table_size)) {
+      return table_->max_row_id();
+    }
+    return scan_packed(value, valid_size);
+  }
   if (value.is_na()) {
     if (size_ < table_size) {
       return table_->max_row_id();
@@ -418,6 +547,10 @@ void Column<Int>::reserve(size_t size, Int value) {
   if (!value.is_na()) {
     int64_t raw = value.raw();
     switch (value_size_) {
+      case 0: {
+        reserve_packed(size);
+        break;
+      }
       case 8: {
         if ((raw >= min_value_8()) && (raw <= max_value_8())) {
           reserve_with_same_value_size(size);
@@ -603,6 +736,184 @@ void Column<Int>::reserve_with_different_value_size(size_t size,
   capacity_ = new_capacity;
 }
 
+void Column<Int>::reserve_packed(size_t size) try {
+  size_t num_blocks = (size + PACKED_BLOCK_SIZE - 1) / PACKED_BLOCK_SIZE;
+  while (packed_blocks_.size() < num_blocks) {
+    // A block without words has only N/A.
+    packed_blocks_.push_back(PackedBlock{ 0, 0, Array<uint64_t>() });
+  }
+  if (size > size_) {
+    size_ = size;
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void Column<Int>::set_packed(size_t i, Int value) {
+  size_t block_id = i / PACKED_BLOCK_SIZE;
+  PackedBlock &block = packed_blocks_[block_id];
+  uint64_t code = 0;
+  if (!value.is_na()) {
+    if (value.raw() < block.base) {
+      repack(block_id, i, value);
+      return;
+    }
+    code = static_cast<uint64_t>(value.raw()) -
+           static_cast<uint64_t>(block.base) + 1;
+    if ((block.width == 0) || (code > int_column::code_mask(block.width))) {
+      repack(block_id, i, value);
+      return;
+    }
+  } else if (block.width == 0) {
+    return;
+  }
+  size_t pos = (i % PACKED_BLOCK_SIZE) * block.width;
+  uint64_t *word = &block.words[pos / 64];
+  size_t shift = pos % 64;
+  uint64_t mask = int_column::code_mask(block.width);
+  word[0] = (word[0] & ~(mask << shift)) | (code << shift);
+  if ((shift + block.width) > 64) {
+    word[1] = (word[1] & ~(mask >> (64 - shift))) | (code >> (64 - shift));
+  }
+}
+
+void Column<Int>::repack(size_t block_id, size_t i, Int value) {
+  PackedBlock &block = packed_blocks_[block_id];
+  Int values[PACKED_BLOCK_SIZE];
+  decode_block(block, values);
+  values[i % PACKED_BLOCK_SIZE] = value;
+  int64_t min_value = std::numeric_limits<int64_t>::max();
+  int64_t max_value = std::numeric_limits<int64_t>::min();
+  for (size_t j = 0; j < PACKED_BLOCK_SIZE; ++j) {
+    if (!values[j].is_na()) {
+      if (values[j].raw() < min_value) {
+        min_value = values[j].raw();
+      }
+      if (values[j].raw() > max_value) {
+        max_value = values[j].raw();
+      }
+    }
+  }
+  if (min_value > max_value) {
+    // All the values are N/A.
+    block.base = 0;
+    block.width = 0;
+    block.words = Array<uint64_t>();
+    return;
+  }
+  // A spare bit is added so that growing values such as timestamps do not
+  // re-encode the block every time.
+  uint64_t max_code = static_cast<uint64_t>(max_value) -
+                      static_cast<uint64_t>(min_value) + 1;
+  size_t width = int_column::get_bit_width(max_code) + 1;
+  if (width > 64) {
+    width = 64;
+  }
+  Array<uint64_t> words;
+  words.resize(width * (PACKED_BLOCK_SIZE / 64), 0);
+  for (size_t j = 0; j < PACKED_BLOCK_SIZE; ++j) {
+    if (!values[j].is_na()) {
+      uint64_t code = static_cast<uint64_t>(values[j].raw()) -
+                      static_cast<uint64_t>(min_value) + 1;
+      size_t pos = j * width;
+      size_t shift = pos % 64;
+      words[pos / 64] |= code << shift;
+      if ((shift + width) > 64) {
+        words[(pos / 64) + 1] |= code >> (64 - shift);
+      }
+    }
+  }
+  block.base = min_value;
+  block.width = width;
+  block.words = std::move(words);
+}
+
+void Column<Int>::decode_block(const PackedBlock &block, Int *values) {
+  if (block.width == 0) {
+    for (size_t i = 0; i < PACKED_BLOCK_SIZE; ++i) {
+      values[i] = Int::na();
+    }
+    return;
+  }
+  int_column::get_block_decoder(block.width)(
+      block.words.data(), block.base, values);
+}
+
+void Column<Int>::read_packed(ArrayCRef<Record> records,
+                              ArrayRef<Int> values) const {
+  Int block_values[PACKED_BLOCK_SIZE];
+  size_t i = 0;
+  while (i < records.size()) {
+    size_t value_id = records[i].row_id.raw();
+    if (value_id >= size_) {
+      values[i] = Int::na();
+      ++i;
+      continue;
+    }
+    // Find consecutive row IDs in the same block.
+    size_t block_id = value_id / PACKED_BLOCK_SIZE;
+    size_t block_offset = value_id % PACKED_BLOCK_SIZE;
+    size_t max_count = PACKED_BLOCK_SIZE - block_offset;
+    if (max_count > (records.size() - i)) {
+      max_count = records.size() - i;
+    }
+    size_t count = 1;
+    while ((count < max_count) &&
+           (records[i + count].row_id.raw() ==
+            static_cast<int64_t>(value_id + count))) {
+      ++count;
+    }
+    const PackedBlock &block = packed_blocks_[block_id];
+    if (count == PACKED_BLOCK_SIZE) {
+      decode_block(block, &values[i]);
+    } else if (count >= int_column::GROUP_SIZE) {
+      decode_block(block, block_values);
+      std::memcpy(&values[i], &block_values[block_offset],
+                  sizeof(Int) * count);
+    } else {
+      for (size_t j = 0; j < count; ++j) {
+        uint64_t code = get_code(block, block_offset + j);
+        values[i + j] = (code != 0) ?
+            Int(static_cast<int64_t>(
+                static_cast<uint64_t>(block.base) + (code - 1))) :
+            Int::na();
+      }
+    }
+    i += count;
+  }
+}
+
+Int Column<Int>::scan_packed(Int value, size_t valid_size) const {
+  bool is_full = table_->is_full();
+  for (size_t block_id = 0; block_id < packed_blocks_.size(); ++block_id) {
+    const PackedBlock &block = packed_blocks_[block_id];
+    size_t begin = block_id * PACKED_BLOCK_SIZE;
+    size_t end = begin + PACKED_BLOCK_SIZE;
+    if (end > valid_size) {
+      end = valid_size;
+    }
+    uint64_t code = 0;
+    if (!value.is_na()) {
+      // Skip a block if "value" is out of its range.
+      if ((block.width == 0) || (value.raw() < block.base)) {
+        continue;
+      }
+      code = static_cast<uint64_t>(value.raw()) -
+             static_cast<uint64_t>(block.base) + 1;
+      if (code > int_column::code_mask(block.width)) {
+        continue;
+      }
+    }
+    for (size_t i = begin; i < end; ++i) {
+      if ((get_code(block, i - begin) == code) &&
+          (!value.is_na() || is_full || table_->_test_row(i))) {
+        return Int(i);
+      }
+    }
+  }
+  return Int::na();
+}
+
 Int Column<Int>::parse_datum(const Datum &datum) {
   switch (datum.type()) {
     case GRNXX_NA: {
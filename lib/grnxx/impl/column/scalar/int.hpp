@@ -1,7 +1,11 @@
 #ifndef GRNXX_IMPL_COLUMN_SCALAR_INT_HPP
 #define GRNXX_IMPL_COLUMN_SCALAR_INT_HPP
 
+#include <cstdint>
+#include <limits>
+
 #include "grnxx/impl/column/base.hpp"
+#include "grnxx/impl/column/scalar/zone_map.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -29,6 +33,8 @@ class Column<Int> : public ColumnBase {
 
   void set_key(Int row_id, const Datum &key);
   void unset(Int row_id);
+  void prefetch(ArrayCRef<Record> records) const;
+  void rebuild_zone_map();
   void clear_references(Int row_id);
 
   // -- Internal API --
@@ -49,7 +55,27 @@ class Column<Int> : public ColumnBase {
   // On failure, throws an exception.
   void read(ArrayCRef<Record> records, ArrayRef<Int> values) const;
 
+  // Return the zone map.
+  const ZoneMap<Int> &zone_map() const {
+    return zone_map_;
+  }
+
  private:
+  // A block of values encoded with frame-of-reference and bit-packing.
+  //
+  // A value is stored as (value - base + 1) in "width" bits and 0 means N/A.
+  // Values are packed in groups of 64 values, so that a group occupies
+  // exactly "width" words.
+  struct PackedBlock {
+    int64_t base;
+    size_t width;
+    Array<uint64_t> words;
+  };
+
+  static constexpr size_t PACKED_BLOCK_SIZE = 1024;
+
+  // The number of bits per value.
+  // If values are packed per block, "value_size_" is 0.
   size_t value_size_;
   union {
     void *buffer_;
@@ -60,10 +86,15 @@ class Column<Int> : public ColumnBase {
   };
   size_t size_;
   size_t capacity_;
+  Array<PackedBlock> packed_blocks_;
+  ZoneMap<Int> zone_map_;
 
   // Return the stored value.
   Int _get(size_t i) const {
     switch (value_size_) {
+      case 0: {
+        return get_packed(i);
+      }
       case 8: {
         return (values_8_[i] != na_value_8()) ?
                Int(values_8_[i]) : Int::na();
@@ -82,6 +113,48 @@ class Column<Int> : public ColumnBase {
     }
   }
 
+  // Return the "i"-th code of "block".
+  static uint64_t get_code(const PackedBlock &block, size_t i) {
+    if (block.width == 0) {
+      return 0;
+    }
+    size_t pos = i * block.width;
+    const uint64_t *word = &block.words[pos / 64];
+    size_t shift = pos % 64;
+    uint64_t code = word[0] >> shift;
+    if ((shift + block.width) > 64) {
+      code |= word[1] << (64 - shift);
+    }
+    if (block.width < 64) {
+      code &= (uint64_t(1) << block.width) - 1;
+    }
+    return code;
+  }
+  // Return the packed value.
+  Int get_packed(size_t i) const {
+    const PackedBlock &block = packed_blocks_[i / PACKED_BLOCK_SIZE];
+    uint64_t code = get_code(block, i % PACKED_BLOCK_SIZE);
+    if (code == 0) {
+      return Int::na();
+    }
+    return Int(static_cast<int64_t>(
+        static_cast<uint64_t>(block.base) + (code - 1)));
+  }
+  // Store a value into a block.
+  //
+  // On failure, throws an exception.
+  void set_packed(size_t i, Int value);
+  // Re-encode a block with a new value.
+  //
+  // On failure, throws an exception.
+  void repack(size_t block_id, size_t i, Int value);
+  // Decode values in a block.
+  static void decode_block(const PackedBlock &block, Int *values);
+  // Read packed values.
+  void read_packed(ArrayCRef<Record> records, ArrayRef<Int> values) const;
+  // Scan packed values to find "value".
+  Int scan_packed(Int value, size_t valid_size) const;
+
   // Scan the column to find "value".
   //
   // If found, returns the row ID.
@@ -95,6 +168,7 @@ class Column<Int> : public ColumnBase {
   void reserve(size_t size, Int value);
   void reserve_with_same_value_size(size_t size);
   void reserve_with_different_value_size(size_t size, size_t value_size);
+  void reserve_packed(size_t size);
 
   // Parse "datum" as Int.
   //
@@ -1,6 +1,8 @@
 #include "grnxx/impl/column/scalar/text.hpp"
 
+#include <cstdint>
 #include <cstring>
+#include <new>
 #include <set>
 
 #include "grnxx/impl/table.hpp"
@@ -11,10 +13,21 @@ namespace impl {
 
 Column<Text>::Column(Table *table,
                      const String &name,
-                     const ColumnOptions &)
+                     const ColumnOptions &options)
     : ColumnBase(table, name, GRNXX_TEXT),
       headers_(),
-      bodies_() {}
+      bodies_(),
+      compactor_(&compaction_options_),
+      is_dictionary_encoded_(options.dictionary_encoding),
+      code_size_(1),
+      num_codes_(0),
+      codes_(),
+      dictionary_slots_(),
+      code_counts_(),
+      free_codes_(),
+      zone_map_() {
+  set_compaction_options(options);
+}
 
 Column<Text>::~Column() {}
 
@@ -46,8 +59,10 @@ void Column<Text>::set(Int row_id, const Datum &datum) {
     }
   }
   size_t value_id = row_id.raw();
-  if (value_id >= headers_.size()) {
-    headers_.resize(value_id + 1, na_header());
+  uint32_t code = na_code();
+  if (is_dictionary_encoded_) {
+    // Hash indexes look up the code of the new value.
+    code = find_or_insert_code(new_value);
   }
   // Insert the new value into indexes.
   for (size_t i = 0; i < num_indexes(); ++i) try {
@@ -56,28 +71,14 @@ void Column<Text>::set(Int row_id, const Datum &datum) {
     for (size_t j = 0; j < i; ++i) {
       indexes_[j]->remove(row_id, datum);
     }
+    if (is_dictionary_encoded_) {
+      discard_code_if_unused(code);
+    }
     throw;
   }
   // TODO: Error handling.
-  size_t offset = bodies_.size();
-  size_t size = new_value.raw_size();
-  uint64_t header;
-  if (size < 0xFFFF) {
-    bodies_.resize(offset + size);
-    std::memcpy(&bodies_[offset], new_value.raw_data(), size);
-    header = (offset << 16) | size;
-  } else {
-    // The size of a long text is stored in front of the body.
-    if ((offset % sizeof(uint64_t)) != 0) {
-      offset += sizeof(uint64_t) - (offset % sizeof(uint64_t));
-    }
-    bodies_.resize(offset + sizeof(uint64_t) + size);
-    *reinterpret_cast<uint64_t *>(&bodies_[offset]) = size;
-    std::memcpy(&bodies_[offset + sizeof(uint64_t)],
-                new_value.raw_data(), size);
-    header = (offset << 16) | 0xFFFF;
-  }
-  headers_[value_id] = header;
+  store(value_id, new_value);
+  notify_update(row_id);
 }
 
 //bool Column<Text>::set(Error *error, Int row_id, const Datum &datum) {
@@ -134,7 +135,7 @@ void Column<Text>::set(Int row_id, const Datum &datum) {
 
 void Column<Text>::get(Int row_id, Datum *datum) const {
   size_t value_id = row_id.raw();
-  if (value_id >= headers_.size()) {
+  if (value_id >= num_values()) {
     *datum = Text::na();
   } else {
     // TODO
@@ -212,10 +213,12 @@ void Column<Text>::set_key(Int row_id, const Datum &key) {
     throw "Key already exists";  // TODO
   }
   size_t value_id = row_id.raw();
-  if (value_id >= headers_.size()) {
-    headers_.resize(value_id + 1, na_header());
-  }
   Text value = parse_datum(key);
+  uint32_t code = na_code();
+  if (is_dictionary_encoded_) {
+    // Hash indexes look up the code of the new value.
+    code = find_or_insert_code(value);
+  }
   // Update indexes if exist.
   for (size_t i = 0; i < num_indexes(); ++i) try {
     indexes_[i]->insert(row_id, value);
@@ -223,27 +226,14 @@ void Column<Text>::set_key(Int row_id, const Datum &key) {
     for (size_t j = 0; j < i; ++j) {
       indexes_[j]->remove(row_id, value);
     }
+    if (is_dictionary_encoded_) {
+      discard_code_if_unused(code);
+    }
     throw;
   }
   // TODO: Error handling.
-  size_t offset = bodies_.size();
-  size_t size = value.raw_size();
-  uint64_t header;
-  if (size < 0xFFFF) {
-    bodies_.resize(offset + size);
-    std::memcpy(&bodies_[offset], value.raw_data(), size);
-    header = (offset << 16) | size;
-  } else {
-    // The size of a long text is stored in front of the body.
-    if ((offset % sizeof(uint64_t)) != 0) {
-      offset += sizeof(uint64_t) - (offset % sizeof(uint64_t));
-    }
-    bodies_.resize(offset + sizeof(uint64_t) + size);
-    *reinterpret_cast<uint64_t *>(&bodies_[offset]) = size;
-    std::memcpy(&bodies_[offset + sizeof(uint64_t)], value.raw_data(), size);
-    header = (offset << 16) | 0xFFFF;
-  }
-  headers_[value_id] = header;
+  store(value_id, value);
+  notify_update(row_id);
 }
 
 //bool Column<Text>::set_initial_key(Error *error,
@@ -296,6 +286,10 @@ void Column<Text>::set_key(Int row_id, const Datum &key) {
 //  return true;
 //}
 
+void Column<Text>::compact() {
+  compactor_.compact(&headers_, &bodies_);
+}
+
 void Column<Text>::unset(Int row_id) {
   Text value = get(row_id);
   if (!value.is_na()) {
@@ -303,7 +297,44 @@ void Column<Text>::unset(Int row_id) {
     for (size_t i = 0; i < num_indexes(); ++i) {
       indexes_[i]->remove(row_id, value);
     }
-    headers_[row_id.raw()] = na_header();
+    zone_map_.remove(row_id.raw());
+    if (is_dictionary_encoded_) {
+      uint32_t code = get_code(row_id.raw());
+      set_code(row_id.raw(), na_code());
+      release_code(code);
+    } else {
+      compactor_.discard(headers_[row_id.raw()], bodies_);
+      headers_[row_id.raw()] = na_header();
+      compactor_.maintain(&headers_, &bodies_);
+    }
+    notify_update(row_id);
+  }
+}
+
+void Column<Text>::prefetch(ArrayCRef<Record> records) const {
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t value_id = records[i].row_id.raw();
+    if (value_id < num_values()) {
+      if (is_dictionary_encoded_) {
+        prefetch_for_read(&codes_[value_id * code_size_]);
+      } else {
+        prefetch_for_read(&headers_[value_id]);
+      }
+    }
+  }
+}
+
+void Column<Text>::rebuild_zone_map() {
+  zone_map_.clear();
+  if (table_->max_row_id().is_na()) {
+    return;
+  }
+  size_t size = table_->max_row_id().raw() + 1;
+  for (size_t i = 0; i < size; ++i) {
+    Text value = get(Int(i));
+    if (!value.is_na()) {
+      zone_map_.insert(i, value);
+    }
   }
 }
 
@@ -317,20 +348,81 @@ void Column<Text>::read(ArrayCRef<Record> records,
   }
 }
 
+void Column<Text>::match(ArrayCRef<Record> records,
+                         const TextPattern &pattern,
+                         ArrayRef<Bool> results) const {
+  for (size_t i = 0; i < records.size(); ++i) {
+    Text value = get(records[i].row_id);
+    results[i] = value.is_na() ? Bool::na() : Bool(pattern.match(value));
+  }
+}
+
+void Column<Text>::filter(ArrayCRef<Record> input_records,
+                          const TextPattern &pattern,
+                          ArrayRef<Record> *output_records) const try {
+  size_t count = 0;
+  if (is_dictionary_encoded_ && (headers_.size() <= input_records.size())) {
+    // Each distinct value is tested at most once if the dictionary is not
+    // larger than the input.
+    // "results" has 0 for untested codes, 1 for false and 2 for true.
+    Array<uint8_t> results;
+    results.resize(headers_.size(), 0);
+    for (size_t i = 0; i < input_records.size(); ++i) {
+      size_t value_id = input_records[i].row_id.raw();
+      if (value_id >= num_codes_) {
+        continue;
+      }
+      uint32_t code = get_code(value_id);
+      if (code == na_code()) {
+        continue;
+      }
+      if (results[code] == 0) {
+        results[code] = pattern.match(get_body(headers_[code])) ? 2 : 1;
+      }
+      if (results[code] == 2) {
+        (*output_records)[count] = input_records[i];
+        ++count;
+      }
+    }
+  } else {
+    for (size_t i = 0; i < input_records.size(); ++i) {
+      Text value = get(input_records[i].row_id);
+      if (!value.is_na() && pattern.match(value)) {
+        (*output_records)[count] = input_records[i];
+        ++count;
+      }
+    }
+  }
+  *output_records = output_records->ref(0, count);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
 Int Column<Text>::scan(const Text &value) const {
   if (table_->max_row_id().is_na()) {
     return Int::na();
   }
   size_t table_size = table_->max_row_id().raw() + 1;
   size_t valid_size =
-      (headers_.size() < table_size) ? headers_.size() : table_size;
+      (num_values() < table_size) ? num_values() : table_size;
   if (value.is_na()) {
-    if (headers_.size() < table_size) {
+    if (num_values() < table_size) {
       return table_->max_row_id();
     }
     bool is_full = table_->is_full();
     for (size_t i = 0; i < valid_size; ++i) {
-      if (headers_[i] == na_header() && (is_full || table_->_test_row(i))) {
+      if (is_na_at(i) && (is_full || table_->_test_row(i))) {
+        return Int(i);
+      }
+    }
+  } else if (is_dictionary_encoded_) {
+    // Codes are compared instead of values.
+    uint32_t code = find_code(value);
+    if (code == na_code()) {
+      return Int::na();
+    }
+    for (size_t i = 0; i < valid_size; ++i) {
+      if (get_code(i) == code) {
         return Int(i);
       }
     }
@@ -350,10 +442,228 @@ size_t Column<Text>::get_valid_size() const {
     return 0;
   }
   size_t table_size = table_->max_row_id().raw() + 1;
-  if (table_size < headers_.size()) {
+  if (table_size < num_values()) {
     return table_size;
   }
-  return headers_.size();
+  return num_values();
+}
+
+uint32_t Column<Text>::find_code(const Text &value) const {
+  if (!is_dictionary_encoded_) {
+    throw "Not dictionary-encoded";  // TODO
+  }
+  if (value.is_na() || dictionary_slots_.is_empty()) {
+    return na_code();
+  }
+  size_t mask = dictionary_slots_.size() - 1;
+  size_t pos = value.hash() & mask;
+  for ( ; ; ) {
+    uint32_t code = dictionary_slots_[pos];
+    if ((code == na_code()) || get_body(headers_[code]).match(value)) {
+      return code;
+    }
+    pos = (pos + 1) & mask;
+  }
+}
+
+void Column<Text>::read_codes(ArrayCRef<Record> records,
+                              ArrayRef<uint32_t> codes) const {
+  if (!is_dictionary_encoded_) {
+    throw "Not dictionary-encoded";  // TODO
+  }
+  if (records.size() != codes.size()) {
+    throw "Data size conflict";  // TODO
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t value_id = records[i].row_id.raw();
+    codes[i] = (value_id < num_codes_) ? get_code(value_id) : na_code();
+  }
+}
+
+uint64_t Column<Text>::append_body(const Text &value) {
+  size_t offset = bodies_.size();
+  size_t size = value.raw_size();
+  if (size < 0xFFFF) {
+    bodies_.resize(offset + size);
+    std::memcpy(&bodies_[offset], value.raw_data(), size);
+    return (offset << 16) | size;
+  } else {
+    // The size of a long text is stored in front of the body.
+    if ((offset % sizeof(uint64_t)) != 0) {
+      offset += sizeof(uint64_t) - (offset % sizeof(uint64_t));
+    }
+    bodies_.resize(offset + sizeof(uint64_t) + size);
+    *reinterpret_cast<uint64_t *>(&bodies_[offset]) = size;
+    std::memcpy(&bodies_[offset + sizeof(uint64_t)], value.raw_data(), size);
+    return (offset << 16) | 0xFFFF;
+  }
+}
+
+void Column<Text>::write_code(uint8_t *codes,
+                              size_t code_size,
+                              size_t i,
+                              uint32_t code) {
+  switch (code_size) {
+    case 1: {
+      codes[i] = (code != na_code()) ? static_cast<uint8_t>(code) : UINT8_MAX;
+      break;
+    }
+    case 2: {
+      reinterpret_cast<uint16_t *>(codes)[i] =
+          (code != na_code()) ? static_cast<uint16_t>(code) : UINT16_MAX;
+      break;
+    }
+    default: {
+      reinterpret_cast<uint32_t *>(codes)[i] = code;
+      break;
+    }
+  }
+}
+
+void Column<Text>::reserve_codes(size_t size, uint32_t max_code) {
+  size_t new_code_size = code_size_;
+  if (max_code != na_code()) {
+    if ((new_code_size == 1) && (max_code >= UINT8_MAX)) {
+      new_code_size = 2;
+    }
+    if ((new_code_size == 2) && (max_code >= UINT16_MAX)) {
+      new_code_size = 4;
+    }
+  }
+  if (new_code_size != code_size_) {
+    // Widen the stored codes.
+    Array<uint8_t> new_codes;
+    new_codes.resize(num_codes_ * new_code_size);
+    for (size_t i = 0; i < num_codes_; ++i) {
+      write_code(new_codes.buffer(), new_code_size, i, get_code(i));
+    }
+    codes_ = std::move(new_codes);
+    code_size_ = new_code_size;
+  }
+  if (size > num_codes_) {
+    // The maximum value of each size represents N/A.
+    codes_.resize(size * code_size_, UINT8_MAX);
+    num_codes_ = size;
+  }
+}
+
+uint32_t Column<Text>::find_or_insert_code(const Text &value) try {
+  uint32_t code = find_code(value);
+  if (code != na_code()) {
+    return code;
+  }
+  if (free_codes_.is_empty() && (headers_.size() >= (na_code() - 1))) {
+    throw "Too many distinct values";  // TODO
+  }
+  size_t num_used_codes = headers_.size() - free_codes_.size();
+  if (((num_used_codes + 1) * 2) > dictionary_slots_.size()) {
+    // Rebuild the hash table.
+    size_t new_size = dictionary_slots_.is_empty() ?
+                      16 : (dictionary_slots_.size() * 2);
+    dictionary_slots_.resize(new_size);
+    for (size_t i = 0; i < new_size; ++i) {
+      dictionary_slots_[i] = na_code();
+    }
+    for (size_t i = 0; i < headers_.size(); ++i) {
+      if (headers_[i] != na_header()) {
+        insert_slot(static_cast<uint32_t>(i));
+      }
+    }
+  }
+  uint64_t header = append_body(value);
+  if (!free_codes_.is_empty()) {
+    code = free_codes_[free_codes_.size() - 1];
+    free_codes_.pop_back();
+    headers_[code] = header;
+  } else {
+    code = static_cast<uint32_t>(headers_.size());
+    code_counts_.resize(headers_.size() + 1, 0);
+    headers_.push_back(header);
+  }
+  compactor_.add(code, header);
+  insert_slot(code);
+  return code;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void Column<Text>::insert_slot(uint32_t code) {
+  size_t mask = dictionary_slots_.size() - 1;
+  size_t pos = get_body(headers_[code]).hash() & mask;
+  while (dictionary_slots_[pos] != na_code()) {
+    pos = (pos + 1) & mask;
+  }
+  dictionary_slots_[pos] = code;
+}
+
+void Column<Text>::release_code(uint32_t code) {
+  --code_counts_[code];
+  discard_code_if_unused(code);
+}
+
+void Column<Text>::discard_code_if_unused(uint32_t code) try {
+  if (code_counts_[code] != 0) {
+    return;
+  }
+  free_codes_.push_back(code);
+  // Remove the slot and move back the following slots in the same cluster,
+  // so that every code remains reachable from its home slot.
+  size_t mask = dictionary_slots_.size() - 1;
+  size_t pos = get_body(headers_[code]).hash() & mask;
+  while (dictionary_slots_[pos] != code) {
+    pos = (pos + 1) & mask;
+  }
+  for (size_t next = (pos + 1) & mask;
+       dictionary_slots_[next] != na_code(); next = (next + 1) & mask) {
+    uint32_t next_code = dictionary_slots_[next];
+    size_t home = get_body(headers_[next_code]).hash() & mask;
+    // "next_code" can be moved unless its home is in (pos, next].
+    bool is_movable = (pos < next) ? ((home <= pos) || (home > next)) :
+                                     ((home <= pos) && (home > next));
+    if (is_movable) {
+      dictionary_slots_[pos] = next_code;
+      pos = next;
+    }
+  }
+  dictionary_slots_[pos] = na_code();
+  compactor_.discard(headers_[code], bodies_);
+  headers_[code] = na_header();
+  compactor_.maintain(&headers_, &bodies_);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void Column<Text>::store(size_t i, const Text &value) {
+  zone_map_.insert(i, value);
+  if ((i < num_values()) && !is_na_at(i)) {
+    zone_map_.remove(i);
+  }
+  if (is_dictionary_encoded_) {
+    uint32_t code = find_or_insert_code(value);
+    try {
+      reserve_codes(i + 1, code);
+    } catch (...) {
+      discard_code_if_unused(code);
+      throw;
+    }
+    uint32_t old_code = get_code(i);
+    set_code(i, code);
+    ++code_counts_[code];
+    if (old_code != na_code()) {
+      release_code(old_code);
+    }
+  } else {
+    if (i >= headers_.size()) {
+      headers_.resize(i + 1, na_header());
+    }
+    uint64_t header = append_body(value);
+    if (headers_[i] != na_header()) {
+      compactor_.discard(headers_[i], bodies_);
+    }
+    headers_[i] = header;
+    compactor_.add(i, header);
+    compactor_.maintain(&headers_, &bodies_);
+  }
 }
 
 Text Column<Text>::parse_datum(const Datum &datum) {
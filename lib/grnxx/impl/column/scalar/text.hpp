@@ -5,6 +5,10 @@
 #include <cstdint>
 
 #include "grnxx/impl/column/base.hpp"
+#include "grnxx/impl/column/body_compactor.hpp"
+#include "grnxx/impl/column/chunked_array.hpp"
+#include "grnxx/impl/column/scalar/text_pattern.hpp"
+#include "grnxx/impl/column/scalar/zone_map.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -25,6 +29,8 @@ class Column<Text> : public ColumnBase {
   bool contains(const Datum &datum) const;
   Int find_one(const Datum &datum) const;
 
+  void compact();
+
   // -- Internal API (grnxx/impl/column/base.hpp) --
 
   void set_key_attribute();
@@ -32,6 +38,8 @@ class Column<Text> : public ColumnBase {
 
   void set_key(Int row_id, const Datum &key);
   void unset(Int row_id);
+  void prefetch(ArrayCRef<Record> records) const;
+  void rebuild_zone_map();
 
   // -- Internal API --
 
@@ -43,17 +51,106 @@ class Column<Text> : public ColumnBase {
   // TODO: Text cannot reuse allocated memory because of this interface.
   Text get(Int row_id) const {
     size_t value_id = row_id.raw();
+    if (is_dictionary_encoded_) {
+      if (value_id >= num_codes_) {
+        return Text::na();
+      }
+      uint32_t code = get_code(value_id);
+      if (code == na_code()) {
+        return Text::na();
+      }
+      return get_body(headers_[code]);
+    }
     if (value_id >= headers_.size()) {
       return Text::na();
     }
     if (headers_[value_id] == na_header()) {
       return Text::na();
     }
-    size_t size = headers_[value_id] & 0xFFFF;
+    return get_body(headers_[value_id]);
+  }
+  // Read values.
+  //
+  // On failure, throws an exception.
+  void read(ArrayCRef<Record> records, ArrayRef<Text> values) const;
+  // Test values against "pattern".
+  //
+  // N/A values yield N/A.
+  void match(ArrayCRef<Record> records,
+             const TextPattern &pattern,
+             ArrayRef<Bool> results) const;
+  // Extract records whose values match "pattern".
+  //
+  // "input_records" and "output_records" may be the same.
+  //
+  // On failure, throws an exception.
+  void filter(ArrayCRef<Record> input_records,
+              const TextPattern &pattern,
+              ArrayRef<Record> *output_records) const;
+
+  // Return whether values are dictionary-encoded or not.
+  bool is_dictionary_encoded() const {
+    return is_dictionary_encoded_;
+  }
+  // Find the dictionary code of "value".
+  //
+  // If found, returns the code.
+  // If not found or "value" is N/A, returns na_code().
+  //
+  // Fails if values are not dictionary-encoded.
+  uint32_t find_code(const Text &value) const;
+  // Return the value of "code", which must be in use.
+  Text decode(uint32_t code) const {
+    return get_body(headers_[code]);
+  }
+  // Read dictionary codes.
+  //
+  // N/A is read as na_code().
+  //
+  // Fails if values are not dictionary-encoded.
+  //
+  // On failure, throws an exception.
+  void read_codes(ArrayCRef<Record> records, ArrayRef<uint32_t> codes) const;
+
+  static constexpr uint32_t na_code() {
+    return std::numeric_limits<uint32_t>::max();
+  }
+
+  // Return the zone map.
+  const ZoneMap<Text> &zone_map() const {
+    return zone_map_;
+  }
+
+ private:
+  // If "is_dictionary_encoded_" is false, "headers_" has a header per row.
+  // Otherwise, "headers_" has a header per distinct value (code) and
+  // "codes_" has a code per row.
+  // The header of an unused code is na_header().
+  ChunkedArray<uint64_t> headers_;
+  Array<char> bodies_;
+  BodyCompactor<char> compactor_;
+  bool is_dictionary_encoded_;
+  // Codes are stored in 1, 2 or 4 bytes, and the maximum value of each size
+  // represents N/A.
+  size_t code_size_;
+  size_t num_codes_;
+  Array<uint8_t> codes_;
+  // Open addressing hash table to find a code from a value.
+  Array<uint32_t> dictionary_slots_;
+  // "code_counts_[code]" is the number of rows which refer to "code".
+  // A code is discarded when its count falls to zero, and discarded codes
+  // are reused, so that codes in use never change.
+  Array<size_t> code_counts_;
+  Array<uint32_t> free_codes_;
+  ZoneMap<Text> zone_map_;
+
+  // Return the text associated with "header".
+  Text get_body(uint64_t header) const {
+    size_t size = header & 0xFFFF;
     if (size == 0) {
       return Text(nullptr, 0);
     }
-    size_t offset = headers_[value_id] >> 16;
+    size_t offset = header >> 16;
     if (size < 0xFFFF) {
       return Text(&bodies_[offset], size);
     } else {
@@ -62,14 +159,71 @@ class Column<Text> : public ColumnBase {
       return Text(&bodies_[offset + sizeof(uint64_t)], size);
     }
   }
-  // Read values.
+  // Append "value" to "bodies_" and return its header.
   //
   // On failure, throws an exception.
-  void read(ArrayCRef<Record> records, ArrayRef<Text> values) const;
+  uint64_t append_body(const Text &value);
+
+  // Return the "i"-th code.
+  uint32_t get_code(size_t i) const {
+    switch (code_size_) {
+      case 1: {
+        return (codes_[i] != UINT8_MAX) ? codes_[i] : na_code();
+      }
+      case 2: {
+        uint16_t code = reinterpret_cast<const uint16_t *>(codes_.data())[i];
+        return (code != UINT16_MAX) ? code : na_code();
+      }
+      default: {
+        return reinterpret_cast<const uint32_t *>(codes_.data())[i];
+      }
+    }
+  }
+  // Set the "i"-th code.
+  //
+  // "code" must be na_code() or less than the maximum value of the size.
+  void set_code(size_t i, uint32_t code) {
+    write_code(codes_.buffer(), code_size_, i, code);
+  }
+  // Write "code" as the "i"-th code of "code_size" bytes.
+  static void write_code(uint8_t *codes,
+                         size_t code_size,
+                         size_t i,
+                         uint32_t code);
+  // Reserve memory for "size" codes, which may be up to "max_code".
+  //
+  // On failure, throws an exception.
+  void reserve_codes(size_t size, uint32_t max_code);
 
- private:
-  Array<uint64_t> headers_;
-  Array<char> bodies_;
+  // Find the code of "value" or add "value" to the dictionary.
+  //
+  // On success, returns the code.
+  // On failure, throws an exception.
+  uint32_t find_or_insert_code(const Text &value);
+  // Insert "code" into "dictionary_slots_".
+  void insert_slot(uint32_t code);
+  // Decrement the count of "code" and discard it if no longer referenced.
+  //
+  // On failure, throws an exception.
+  void release_code(uint32_t code);
+  // Discard "code" if no row refers to it.
+  //
+  // On failure, throws an exception.
+  void discard_code_if_unused(uint32_t code);
+
+  // Store "value" as the "i"-th value.
+  //
+  // On failure, throws an exception.
+  void store(size_t i, const Text &value);
+  // Return the number of stored values.
+  size_t num_values() const {
+    return is_dictionary_encoded_ ? num_codes_ : headers_.size();
+  }
+  // Return whether the "i"-th value is N/A or not.
+  bool is_na_at(size_t i) const {
+    return is_dictionary_encoded_ ?
+           (get_code(i) == na_code()) : (headers_[i] == na_header());
+  }
 
   static constexpr uint64_t na_header() {
     return std::numeric_limits<uint64_t>::max();
@@ -0,0 +1,135 @@
+#ifndef GRNXX_IMPL_COLUMN_SCALAR_TEXT_PATTERN_HPP
+#define GRNXX_IMPL_COLUMN_SCALAR_TEXT_PATTERN_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include "grnxx/data_types.hpp"
+#include "grnxx/expression.hpp"
+
+namespace grnxx {
+namespace impl {
+
+// A pattern for prefix, suffix or substring search.
+//
+// A pattern is preprocessed once and then tested against many values.
+// Substring search compares the first and the last bytes of 8 candidate
+// positions at once, and only positions whose first and last bytes match
+// are compared byte by byte.
+class TextPattern {
+ public:
+  // "operator_type" must be GRNXX_STARTS_WITH, GRNXX_ENDS_WITH or
+  // GRNXX_CONTAINS.
+  // "pattern" must not be N/A and must be valid while the object is used.
+  TextPattern(OperatorType operator_type, const Text &pattern)
+      : operator_type_(operator_type),
+        data_(pattern.raw_data()),
+        size_(pattern.raw_size()),
+        first_byte_(0),
+        last_byte_(0),
+        first_word_(0),
+        last_word_(0) {
+    if (size_ != 0) {
+      first_byte_ = data_[0];
+      last_byte_ = data_[size_ - 1];
+      first_word_ = broadcast(first_byte_);
+      last_word_ = broadcast(last_byte_);
+    }
+  }
+  ~TextPattern() = default;
+
+  // Return whether "value" matches the pattern.
+  //
+  // "value" must not be N/A.
+  bool match(const Text &value) const {
+    size_t size = value.raw_size();
+    if (size < size_) {
+      return false;
+    } else if (size_ == 0) {
+      return true;
+    }
+    const char *data = value.raw_data();
+    switch (operator_type_) {
+      case GRNXX_STARTS_WITH: {
+        return (data[0] == first_byte_) &&
+               (std::memcmp(data, data_, size_) == 0);
+      }
+      case GRNXX_ENDS_WITH: {
+        data += size - size_;
+        return (data[0] == first_byte_) &&
+               (std::memcmp(data, data_, size_) == 0);
+      }
+      default: {
+        return find(data, size);
+      }
+    }
+  }
+
+ private:
+  OperatorType operator_type_;
+  const char *data_;
+  size_t size_;
+  char first_byte_;
+  char last_byte_;
+  uint64_t first_word_;
+  uint64_t last_word_;
+
+  // Return a word filled with "byte".
+  static uint64_t broadcast(char byte) {
+    return uint64_t(0x0101010101010101ULL) * static_cast<uint8_t>(byte);
+  }
+  // Read a word from unaligned "data".
+  static uint64_t load(const char *data) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+  }
+  // Return a word whose bytes are 0x80 if the bytes of "word" are 0 and
+  // 0x00 otherwise.
+  static uint64_t get_zero_bytes(uint64_t word) {
+    constexpr uint64_t LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+    return ~(((word & LOW_BITS) + LOW_BITS) | word | LOW_BITS);
+  }
+
+  // Return whether "data[offset]" starts the pattern.
+  bool match_at(const char *data, size_t offset) const {
+    return (data[offset] == first_byte_) &&
+           (data[offset + size_ - 1] == last_byte_) &&
+           (std::memcmp(data + offset + 1, data_ + 1, size_ - 1) == 0);
+  }
+  // Return whether "data" contains the pattern.
+  //
+  // "size" must not be less than the pattern size and the pattern must not
+  // be empty.
+  bool find(const char *data, size_t size) const {
+    if (size_ == 1) {
+      return std::memchr(data, first_byte_, size) != nullptr;
+    }
+    size_t num_offsets = size - size_ + 1;
+    const char *last_data = data + size_ - 1;
+    size_t offset = 0;
+    for ( ; (offset + 8) <= num_offsets; offset += 8) {
+      uint64_t candidates =
+          get_zero_bytes(load(data + offset) ^ first_word_) &
+          get_zero_bytes(load(last_data + offset) ^ last_word_);
+      if (candidates != 0) {
+        for (size_t i = offset; i < (offset + 8); ++i) {
+          if (match_at(data, i)) {
+            return true;
+          }
+        }
+      }
+    }
+    for ( ; offset < num_offsets; ++offset) {
+      if (match_at(data, offset)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+}  // namespace impl
+}  // namespace grnxx
+
+#endif  // GRNXX_IMPL_COLUMN_SCALAR_TEXT_PATTERN_HPP
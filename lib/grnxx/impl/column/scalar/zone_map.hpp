@@ -0,0 +1,172 @@
+#ifndef GRNXX_IMPL_COLUMN_SCALAR_ZONE_MAP_HPP
+#define GRNXX_IMPL_COLUMN_SCALAR_ZONE_MAP_HPP
+
+#include <cstdint>
+#include <new>
+
+#include "grnxx/array.hpp"
+#include "grnxx/data_types.hpp"
+#include "grnxx/expression.hpp"
+
+namespace grnxx {
+namespace impl {
+
+// The number of rows per zone.
+//
+// A zone map keeps a synopsis per zone and a zone with row IDs in
+// [zone_id * ZONE_SIZE, (zone_id + 1) * ZONE_SIZE) can be skipped if its
+// synopsis shows that no row satisfies a predicate.
+constexpr size_t ZONE_SIZE = 1024;
+
+// A zone map key is a value or an order-preserving summary of a value.
+template <typename T>
+struct ZoneMapKey;
+
+template <>
+struct ZoneMapKey<Int> {
+  using Key = int64_t;
+  // Keys are exactly the values.
+  static constexpr bool IS_EXACT = true;
+  static Key get(Int value) {
+    return value.raw();
+  }
+};
+
+template <>
+struct ZoneMapKey<Float> {
+  using Key = double;
+  // Keys are exactly the values.
+  static constexpr bool IS_EXACT = true;
+  static Key get(Float value) {
+    return value.raw();
+  }
+};
+
+template <>
+struct ZoneMapKey<Text> {
+  using Key = uint64_t;
+  // Keys are the first 8 bytes in big-endian, so that (x <= y) implies
+  // (key(x) <= key(y)), but not vice versa.
+  static constexpr bool IS_EXACT = false;
+  static Key get(const Text &value) {
+    Key key = 0;
+    size_t size = value.raw_size();
+    for (size_t i = 0; i < sizeof(Key); ++i) {
+      key <<= 8;
+      if (i < size) {
+        key |= static_cast<uint8_t>(value.raw_data()[i]);
+      }
+    }
+    return key;
+  }
+};
+
+// Per-zone minimum, maximum and the number of non-N/A values.
+//
+// The minimum and the maximum are widened by insert() but not narrowed by
+// remove(), so they are bounds rather than exact values.
+template <typename T>
+class ZoneMap {
+ public:
+  using Value = T;
+  using Key = typename ZoneMapKey<T>::Key;
+
+  ZoneMap() : zones_() {}
+  ~ZoneMap() = default;
+
+  // Return the number of N/A in a zone.
+  size_t num_nas(size_t zone_id) const {
+    if (zone_id >= zones_.size()) {
+      return ZONE_SIZE;
+    }
+    return ZONE_SIZE - zones_[zone_id].num_values;
+  }
+
+  // Record that "value" is stored in the "value_id"-th row.
+  //
+  // "value" must not be N/A.
+  //
+  // On failure, throws an exception.
+  void insert(size_t value_id, const Value &value) try {
+    size_t zone_id = value_id / ZONE_SIZE;
+    if (zone_id >= zones_.size()) {
+      zones_.resize(zone_id + 1, Zone{ Key(), Key(), 0 });
+    }
+    Zone &zone = zones_[zone_id];
+    Key key = ZoneMapKey<T>::get(value);
+    if (zone.num_values == 0) {
+      zone.min = key;
+      zone.max = key;
+    } else if (key < zone.min) {
+      zone.min = key;
+    } else if (key > zone.max) {
+      zone.max = key;
+    }
+    ++zone.num_values;
+  } catch (const std::bad_alloc &) {
+    throw "Memory allocation failed";  // TODO
+  }
+  // Record that a non-N/A value is removed from the "value_id"-th row.
+  void remove(size_t value_id) {
+    --zones_[value_id / ZONE_SIZE].num_values;
+  }
+  // Remove all the values.
+  //
+  // Zones are kept, so that insert() into the existing zones never fails.
+  void clear() {
+    for (size_t i = 0; i < zones_.size(); ++i) {
+      zones_[i] = Zone{ Key(), Key(), 0 };
+    }
+  }
+
+  // Return whether a zone may have a value "x" such that "x op value".
+  //
+  // "operator_type" must be a comparison operator or an equality operator.
+  bool may_match(size_t zone_id,
+                 OperatorType operator_type,
+                 const Key &key) const {
+    if ((zone_id >= zones_.size()) || (zones_[zone_id].num_values == 0)) {
+      // Comparisons with N/A are never true.
+      return false;
+    }
+    const Zone &zone = zones_[zone_id];
+    bool is_exact = ZoneMapKey<T>::IS_EXACT;
+    switch (operator_type) {
+      case GRNXX_EQUAL: {
+        return (key >= zone.min) && (key <= zone.max);
+      }
+      case GRNXX_NOT_EQUAL: {
+        return !is_exact || (zone.min != key) || (zone.max != key);
+      }
+      case GRNXX_LESS: {
+        return is_exact ? (zone.min < key) : (zone.min <= key);
+      }
+      case GRNXX_LESS_EQUAL: {
+        return zone.min <= key;
+      }
+      case GRNXX_GREATER: {
+        return is_exact ? (zone.max > key) : (zone.max >= key);
+      }
+      case GRNXX_GREATER_EQUAL: {
+        return zone.max >= key;
+      }
+      default: {
+        return true;
+      }
+    }
+  }
+
+ private:
+  struct Zone {
+    Key min;
+    Key max;
+    size_t num_values;
+  };
+
+  Array<Zone> zones_;
+};
+
+}  // namespace impl
+}  // namespace grnxx
+
+#endif  // GRNXX_IMPL_COLUMN_SCALAR_ZONE_MAP_HPP
@@ -11,10 +11,13 @@ namespace impl {
 
 Column<Vector<Bool>>::Column(Table *table,
                              const String &name,
-                             const ColumnOptions &)
+                             const ColumnOptions &options)
     : ColumnBase(table, name, GRNXX_BOOL_VECTOR),
       headers_(),
-      bodies_() {}
+      bodies_(),
+      compactor_(&compaction_options_) {
+  set_compaction_options(options);
+}
 
 Column<Vector<Bool>>::~Column() {}
 
@@ -65,11 +68,17 @@ void Column<Vector<Bool>>::set(Int row_id, const Datum &datum) {
     }
     bodies_.resize(offset + sizeof(uint64_t) + size);
     *reinterpret_cast<uint64_t *>(&bodies_[offset]) = size;
-    std::memcpy(&bodies_[offset + sizeof(uint64_t)],
+    std::memcpy(static_cast<void *>(&bodies_[offset + sizeof(uint64_t)]),
                 new_value.raw_data(), size);
     header = (offset << 16) | 0xFFFF;
   }
+  if (headers_[value_id] != na_header()) {
+    compactor_.discard(headers_[value_id], bodies_);
+  }
   headers_[value_id] = header;
+  compactor_.add(value_id, header);
+  compactor_.maintain(&headers_, &bodies_);
+  notify_update(row_id);
 }
 
 void Column<Vector<Bool>>::get(Int row_id, Datum *datum) const {
@@ -92,6 +101,10 @@ Int Column<Vector<Bool>>::find_one(const Datum &datum) const {
   return scan(parse_datum(datum));
 }
 
+void Column<Vector<Bool>>::compact() {
+  compactor_.compact(&headers_, &bodies_);
+}
+
 void Column<Vector<Bool>>::unset(Int row_id) {
   Vector<Bool> value = get(row_id);
   if (!value.is_na()) {
@@ -99,7 +112,10 @@ void Column<Vector<Bool>>::unset(Int row_id) {
 //    for (size_t i = 0; i < num_indexes(); ++i) {
 //      indexes_[i]->remove(row_id, value);
 //    }
+    compactor_.discard(headers_[row_id.raw()], bodies_);
     headers_[row_id.raw()] = na_header();
+    compactor_.maintain(&headers_, &bodies_);
+    notify_update(row_id);
   }
 }
 
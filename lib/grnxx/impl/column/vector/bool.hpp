@@ -5,6 +5,8 @@
 #include <cstdint>
 
 #include "grnxx/impl/column/base.hpp"
+#include "grnxx/impl/column/body_compactor.hpp"
+#include "grnxx/impl/column/chunked_array.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -25,6 +27,8 @@ class Column<Vector<Bool>> : public ColumnBase {
   bool contains(const Datum &datum) const;
   Int find_one(const Datum &datum) const;
 
+  void compact();
+
   // -- Internal API (grnxx/impl/column/base.hpp) --
 
   void unset(Int row_id);
@@ -64,8 +68,9 @@ class Column<Vector<Bool>> : public ColumnBase {
   void read(ArrayCRef<Record> records, ArrayRef<Vector<Bool>> values) const;
 
  private:
-  Array<uint64_t> headers_;
+  ChunkedArray<uint64_t> headers_;
   Array<Bool> bodies_;
+  BodyCompactor<Bool> compactor_;
 
   static constexpr uint64_t na_header() {
     return std::numeric_limits<uint64_t>::max();
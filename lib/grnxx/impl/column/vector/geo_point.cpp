@@ -11,10 +11,13 @@ namespace impl {
 
 Column<Vector<GeoPoint>>::Column(Table *table,
                                  const String &name,
-                                 const ColumnOptions &)
+                                 const ColumnOptions &options)
     : ColumnBase(table, name, GRNXX_GEO_POINT_VECTOR),
       headers_(),
-      bodies_() {}
+      bodies_(),
+      compactor_(&compaction_options_) {
+  set_compaction_options(options);
+}
 
 Column<Vector<GeoPoint>>::~Column() {}
 
@@ -64,13 +67,19 @@ void Column<Vector<GeoPoint>>::set(Int row_id, const Datum &datum) {
     if ((offset % sizeof(uint64_t)) != 0) {
       offset += sizeof(uint64_t) - (offset % sizeof(uint64_t));
     }
-    bodies_.resize(offset + sizeof(uint64_t) + size);
+    bodies_.resize(offset + 1 + size);
     *reinterpret_cast<uint64_t *>(&bodies_[offset]) = size;
-    std::memcpy(&bodies_[offset + sizeof(uint64_t)],
+    std::memcpy(&bodies_[offset + 1],
                 new_value.raw_data(), sizeof(GeoPoint) * size);
     header = (offset << 16) | 0xFFFF;
   }
+  if (headers_[value_id] != na_header()) {
+    compactor_.discard(headers_[value_id], bodies_);
+  }
   headers_[value_id] = header;
+  compactor_.add(value_id, header);
+  compactor_.maintain(&headers_, &bodies_);
+  notify_update(row_id);
 }
 
 void Column<Vector<GeoPoint>>::get(Int row_id, Datum *datum) const {
@@ -93,6 +102,10 @@ Int Column<Vector<GeoPoint>>::find_one(const Datum &datum) const {
   return scan(parse_datum(datum));
 }
 
+void Column<Vector<GeoPoint>>::compact() {
+  compactor_.compact(&headers_, &bodies_);
+}
+
 void Column<Vector<GeoPoint>>::unset(Int row_id) {
   Vector<GeoPoint> value = get(row_id);
   if (!value.is_na()) {
@@ -100,7 +113,10 @@ void Column<Vector<GeoPoint>>::unset(Int row_id) {
 //    for (size_t i = 0; i < num_indexes(); ++i) {
 //      indexes_[i]->remove(row_id, value);
 //    }
+    compactor_.discard(headers_[row_id.raw()], bodies_);
     headers_[row_id.raw()] = na_header();
+    compactor_.maintain(&headers_, &bodies_);
+    notify_update(row_id);
   }
 }
 
@@ -1,26 +1,74 @@
 #include "grnxx/impl/column/vector/int.hpp"
 
 #include <cstring>
+#include <memory>
+#include <new>
 
 #include "grnxx/impl/db.hpp"
 #include "grnxx/impl/table.hpp"
-//#include "grnxx/impl/index.hpp"
+#include "grnxx/impl/varint.hpp"
+#include "grnxx/impl/index.hpp"
 
 namespace grnxx {
 namespace impl {
+namespace int_vector_column {
+
+// Map a signed difference to an unsigned integer so that small differences
+// in both directions become small.
+inline uint64_t encode_zigzag(uint64_t diff) {
+  return (diff << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(diff) >> 63);
+}
+inline uint64_t decode_zigzag(uint64_t code) {
+  return (code >> 1) ^ (~(code & 1) + 1);
+}
+
+// Decode "size" differences in [begin, end) and store values into "values".
+void decode_values(const uint8_t *begin,
+                   const uint8_t *end,
+                   size_t size,
+                   Int *values) {
+  uint64_t value = 0;
+  size_t i = 0;
+  while (i < size) {
+    if (((size - i) >= 8) && ((end - begin) >= 8)) {
+      // If the next 8 bytes have no continuation bits, they are 8 small
+      // differences and decoded without branches.
+      uint64_t word;
+      std::memcpy(&word, begin, sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0) {
+        for (size_t j = 0; j < 8; ++j) {
+          value += decode_zigzag(begin[j]);
+          values[i + j] = Int(static_cast<int64_t>(value));
+        }
+        begin += 8;
+        i += 8;
+        continue;
+      }
+    }
+    uint64_t code;
+    begin = read_varint(begin, &code);
+    value += decode_zigzag(code);
+    values[i] = Int(static_cast<int64_t>(value));
+    ++i;
+  }
+}
+
+}  // namespace int_vector_column
+
+using namespace int_vector_column;
 
 Column<Vector<Int>>::Column(Table *table,
                             const String &name,
                             const ColumnOptions &options)
     : ColumnBase(table, name, GRNXX_INT_VECTOR),
       headers_(),
-      bodies_() {
-  if (!options.reference_table_name.is_empty()) {
-    reference_table_ = table->_db()->find_table(options.reference_table_name);
-    if (!reference_table_) {
-      throw "Table not found";  // TODO
-    }
-  }
+      bodies_(),
+      compactor_(&compaction_options_),
+      is_delta_encoded_(options.delta_encoding),
+      encoded_bodies_(),
+      encoded_compactor_(&compaction_options_) {
+  set_reference_table(options);
+  set_compaction_options(options);
 }
 
 Column<Vector<Int>>::~Column() {}
@@ -42,30 +90,52 @@ void Column<Vector<Int>>::set(Int row_id, const Datum &datum) {
       }
     }
   }
-  Vector<Int> old_value = get(row_id);
+  // NOTE: "new_value" may refer to the datum buffer.
+  Array<Int> old_value_buffer;
+  Vector<Int> old_value = get(row_id, &old_value_buffer);
   if (old_value.match(new_value)) {
     return;
   }
   if (!old_value.is_na()) {
-    // TODO: Remove the old value from indexes.
-//    for (size_t i = 0; i < num_indexes(); ++i) {
-//      indexes_[i]->remove(row_id, old_value);
-//    }
+    // Remove the old value from indexes.
+    for (size_t i = 0; i < num_indexes(); ++i) {
+      indexes_[i]->remove(row_id, old_value);
+    }
+    if (referrer_index_) {
+      remove_referrers(row_id, old_value);
+    }
   }
   size_t value_id = row_id.raw();
   if (value_id >= headers_.size()) {
     headers_.resize(value_id + 1, na_header());
   }
-  // TODO: Insert the new value into indexes.
-//  for (size_t i = 0; i < num_indexes(); ++i) try {
-//    indexes_[i]->insert(row_id, datum)) {
-//  } catch (...) {
-//    for (size_t j = 0; j < i; ++i) {
-//      indexes_[j]->remove(row_id, datum);
-//    }
-//    throw;
-//  }
+  // Insert the new value into indexes.
+  for (size_t i = 0; i < num_indexes(); ++i) try {
+    indexes_[i]->insert(row_id, new_value);
+  } catch (...) {
+    for (size_t j = 0; j < i; ++j) {
+      indexes_[j]->remove(row_id, new_value);
+    }
+    throw;
+  }
   // TODO: Error handling.
+  if (is_delta_encoded_) {
+    uint64_t header = append_encoded(new_value);
+    if (headers_[value_id] != na_header()) {
+      encoded_compactor_.discard(headers_[value_id], encoded_bodies_);
+    }
+    headers_[value_id] = header;
+    encoded_compactor_.add(value_id, header);
+    if (referrer_index_) {
+      size_t value_size = new_value.raw_size();
+      for (size_t i = 0; i < value_size; ++i) {
+        referrer_index_->insert(new_value[i], row_id);
+      }
+    }
+    encoded_compactor_.maintain(&headers_, &encoded_bodies_);
+    notify_update(row_id);
+    return;
+  }
   size_t offset = bodies_.size();
   size_t size = new_value.raw_size();
   uint64_t header;
@@ -78,23 +148,44 @@ void Column<Vector<Int>>::set(Int row_id, const Datum &datum) {
     if ((offset % sizeof(uint64_t)) != 0) {
       offset += sizeof(uint64_t) - (offset % sizeof(uint64_t));
     }
-    bodies_.resize(offset + sizeof(uint64_t) + size);
+    bodies_.resize(offset + 1 + size);
     *reinterpret_cast<uint64_t *>(&bodies_[offset]) = size;
-    std::memcpy(&bodies_[offset + sizeof(uint64_t)],
+    std::memcpy(&bodies_[offset + 1],
                 new_value.raw_data(), sizeof(Int) * size);
     header = (offset << 16) | 0xFFFF;
   }
+  if (headers_[value_id] != na_header()) {
+    compactor_.discard(headers_[value_id], bodies_);
+  }
   headers_[value_id] = header;
+  compactor_.add(value_id, header);
+  if (referrer_index_) {
+    Array<Int> value_buffer;
+    Vector<Int> value = get(row_id, &value_buffer);
+    size_t value_size = value.raw_size();
+    for (size_t i = 0; i < value_size; ++i) {
+      referrer_index_->insert(value[i], row_id);
+    }
+  }
+  compactor_.maintain(&headers_, &bodies_);
+  notify_update(row_id);
 }
 
-void Column<Vector<Int>>::get(Int row_id, Datum *datum) const {
+void Column<Vector<Int>>::get(Int row_id, Datum *datum) const try {
   size_t value_id = row_id.raw();
   if (value_id >= headers_.size()) {
     *datum = Vector<Int>::na();
+  } else if (is_delta_encoded_) {
+    // A decoded value is owned by the datum.
+    std::shared_ptr<Array<Int>> buffer(new Array<Int>);
+    Vector<Int> value = get(row_id, buffer.get());
+    *datum = Datum(value, std::move(buffer));
   } else {
     // TODO
-    *datum = get(row_id);
+    *datum = get(row_id, static_cast<Array<Int> *>(nullptr));
   }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
 }
 
 bool Column<Vector<Int>>::contains(const Datum &datum) const {
@@ -107,25 +198,114 @@ Int Column<Vector<Int>>::find_one(const Datum &datum) const {
   return scan(parse_datum(datum));
 }
 
+void Column<Vector<Int>>::compact() {
+  if (is_delta_encoded_) {
+    encoded_compactor_.compact(&headers_, &encoded_bodies_);
+  } else {
+    compactor_.compact(&headers_, &bodies_);
+  }
+}
+
 void Column<Vector<Int>>::unset(Int row_id) {
-  Vector<Int> value = get(row_id);
+  Array<Int> value_buffer;
+  Vector<Int> value = get(row_id, &value_buffer);
   if (!value.is_na()) {
-    // TODO: Update indexes if exist.
-//    for (size_t i = 0; i < num_indexes(); ++i) {
-//      indexes_[i]->remove(row_id, value);
-//    }
-    headers_[row_id.raw()] = na_header();
+    // Update indexes if exist.
+    for (size_t i = 0; i < num_indexes(); ++i) {
+      indexes_[i]->remove(row_id, value);
+    }
+    if (referrer_index_) {
+      remove_referrers(row_id, value);
+    }
+    if (is_delta_encoded_) {
+      encoded_compactor_.discard(headers_[row_id.raw()], encoded_bodies_);
+      headers_[row_id.raw()] = na_header();
+      encoded_compactor_.maintain(&headers_, &encoded_bodies_);
+    } else {
+      compactor_.discard(headers_[row_id.raw()], bodies_);
+      headers_[row_id.raw()] = na_header();
+      compactor_.maintain(&headers_, &bodies_);
+    }
+    notify_update(row_id);
+  }
+}
+
+Int Column<Vector<Int>>::get_element(Int row_id, Int index) const {
+  if (!is_delta_encoded_) {
+    // "buffer" is not used because values are not delta-encoded.
+    Array<Int> *buffer = nullptr;
+    return get(row_id, buffer)[index];
+  }
+  size_t value_id = row_id.raw();
+  if ((value_id >= headers_.size()) || (headers_[value_id] == na_header())) {
+    return Int::na();
+  }
+  const uint8_t *begin;
+  const uint8_t *end;
+  get_encoded_body(headers_[value_id], &begin, &end);
+  uint64_t size;
+  begin = read_varint(begin, &size);
+  size_t i = index.raw();
+  if (i >= size) {
+    // "index" is out of range, negative or N/A.
+    return Int::na();
+  }
+  uint64_t value = 0;
+  for (size_t j = 0; j <= i; ++j) {
+    uint64_t code;
+    begin = read_varint(begin, &code);
+    value += decode_zigzag(code);
   }
+  return Int(static_cast<int64_t>(value));
 }
 
 void Column<Vector<Int>>::read(ArrayCRef<Record> records,
-                               ArrayRef<Vector<Int>> values) const {
+                               ArrayRef<Vector<Int>> values,
+                               Array<Int> *pool) const try {
   if (records.size() != values.size()) {
     throw "Data size conflict";  // TODO
   }
+  if (!is_delta_encoded_) {
+    for (size_t i = 0; i < records.size(); ++i) {
+      values.set(i, get(records[i].row_id, pool));
+    }
+    return;
+  }
+  // The sizes are read first so that "*pool" is never reallocated while
+  // values refer to it.
+  size_t total_size = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t value_id = records[i].row_id.raw();
+    if ((value_id < headers_.size()) &&
+        (headers_[value_id] != na_header())) {
+      const uint8_t *begin;
+      const uint8_t *end;
+      get_encoded_body(headers_[value_id], &begin, &end);
+      uint64_t size;
+      read_varint(begin, &size);
+      total_size += size;
+    }
+  }
+  pool->resize(total_size);
+  size_t offset = 0;
   for (size_t i = 0; i < records.size(); ++i) {
-    values.set(i, get(records[i].row_id));
+    size_t value_id = records[i].row_id.raw();
+    if ((value_id >= headers_.size()) ||
+        (headers_[value_id] == na_header())) {
+      values.set(i, Vector<Int>::na());
+      continue;
+    }
+    const uint8_t *begin;
+    const uint8_t *end;
+    get_encoded_body(headers_[value_id], &begin, &end);
+    uint64_t size;
+    begin = read_varint(begin, &size);
+    decode_values(begin, end, size, pool->buffer() + offset);
+    values.set(i, Vector<Int>(pool->buffer() + offset, size));
+    offset += size;
   }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
 }
 
 Int Column<Vector<Int>>::scan(const Vector<Int> &value) const {
@@ -146,9 +326,11 @@ Int Column<Vector<Int>>::scan(const Vector<Int> &value) const {
       }
     }
   } else {
+    // NOTE: "value" may refer to the datum buffer.
+    Array<Int> buffer;
     for (size_t i = 0; i < valid_size; ++i) {
       // TODO: Improve this (get() checks the range of its argument).
-      if (get(Int(i)).match(value)) {
+      if (get(Int(i), &buffer).match(value)) {
         return Int(i);
       }
     }
@@ -181,52 +363,90 @@ Vector<Int> Column<Vector<Int>>::parse_datum(const Datum &datum) {
   }
 }
 
-//void Column<Vector<Int>>::clear_references(Int row_id) {
-//  auto cursor = table_->create_cursor(nullptr);
-//  if (!cursor) {
-//    // Error.
-//    return;
-//  }
-//  Array<Record> records;
-//  for ( ; ; ) {
-//    auto result = cursor->read(nullptr, 1024, &records);
-//    if (!result.is_ok) {
-//      // Error.
-//      return;
-//    } else if (result.count == 0) {
-//      return;
-//    }
-//    for (Int i = 0; i < records.size(); ++i) {
-//      Int value_row_id = records.get_row_id(i);
-//      Int value_size = static_cast<Int>(headers_[value_row_id] & 0xFFFF);
-//      if (value_size == 0) {
-//        continue;
-//      }
-//      Int value_offset = static_cast<Int>(headers_[value_row_id] >> 16);
-//      if (value_size >= 0xFFFF) {
-//        value_size = bodies_[value_offset];
-//        ++value_offset;
-//      }
-//      Int count = 0;
-//      for (Int j = 0; j < value_size; ++j) {
-//        if (bodies_[value_offset + j] != row_id) {
-//          bodies_[value_offset + count] = bodies_[value_offset + j];
-//          ++count;
-//        }
-//      }
-//      if (count < value_size) {
-//        if (count == 0) {
-//          headers_[value_row_id] = 0;
-//        } else if (count < 0xFFFF) {
-//          headers_[value_row_id] = count | (value_offset << 16);
-//        } else {
-//          bodies_[value_offset - 1] = count;
-//        }
-//      }
-//    }
-//    records.clear();
-//  }
-//}
+void Column<Vector<Int>>::clear_references(Int row_id) try {
+  if (!referrer_index_) {
+    throw "Not reference column";  // TODO
+  }
+  // NOTE: set() removes entries from the posting list of "row_id".
+  Array<Int> old_value_buffer;
+  Array<Int> new_value;
+  for ( ; ; ) {
+    ArrayCRef<Int> referrers = referrer_index_->get(row_id);
+    if (referrers.size() == 0) {
+      break;
+    }
+    Int referrer = referrers[referrers.size() - 1];
+    Vector<Int> old_value = get(referrer, &old_value_buffer);
+    size_t old_value_size = old_value.raw_size();
+    new_value.clear();
+    for (size_t i = 0; i < old_value_size; ++i) {
+      if (old_value[i].unmatch(row_id)) {
+        new_value.push_back(old_value[i]);
+      }
+    }
+    set(referrer, Vector<Int>(new_value.data(), new_value.size()));
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+Vector<Int> Column<Vector<Int>>::decode(uint64_t header,
+                                        Array<Int> *buffer) const try {
+  const uint8_t *begin;
+  const uint8_t *end;
+  get_encoded_body(header, &begin, &end);
+  uint64_t size;
+  begin = read_varint(begin, &size);
+  if (size == 0) {
+    return Vector<Int>(nullptr, 0);
+  }
+  buffer->resize(size);
+  decode_values(begin, end, size, buffer->buffer());
+  return Vector<Int>(buffer->data(), size);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+uint64_t Column<Vector<Int>>::append_encoded(const Vector<Int> &value) try {
+  size_t size = value.raw_size();
+  size_t offset = encoded_bodies_.size();
+  // Space for the worst case is reserved as if the body is long, and then
+  // the body is moved if it is short.
+  size_t long_offset = offset;
+  if ((long_offset % sizeof(uint64_t)) != 0) {
+    long_offset += sizeof(uint64_t) - (long_offset % sizeof(uint64_t));
+  }
+  size_t body_offset = long_offset + sizeof(uint64_t);
+  encoded_bodies_.resize(body_offset + (MAX_VARINT_SIZE * (size + 1)));
+  uint8_t *body = &encoded_bodies_[body_offset];
+  size_t body_size = write_varint(size, body);
+  uint64_t prev_value = 0;
+  for (size_t i = 0; i < size; ++i) {
+    uint64_t raw_value = static_cast<uint64_t>(value[i].raw());
+    body_size += write_varint(encode_zigzag(raw_value - prev_value),
+                              body + body_size);
+    prev_value = raw_value;
+  }
+  if (body_size < 0xFFFF) {
+    std::memmove(&encoded_bodies_[offset], body, body_size);
+    encoded_bodies_.resize(offset + body_size);
+    return (offset << 16) | body_size;
+  }
+  // The size of a long body is stored in front of the body.
+  *reinterpret_cast<uint64_t *>(&encoded_bodies_[long_offset]) = body_size;
+  encoded_bodies_.resize(body_offset + body_size);
+  return (long_offset << 16) | 0xFFFF;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void Column<Vector<Int>>::remove_referrers(Int row_id,
+                                           const Vector<Int> &value) {
+  size_t value_size = value.raw_size();
+  for (size_t i = 0; i < value_size; ++i) {
+    referrer_index_->remove(value[i], row_id);
+  }
+}
 
 }  // namespace impl
 }  // namespace grnxx
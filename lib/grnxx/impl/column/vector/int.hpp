@@ -5,6 +5,8 @@
 #include <cstdint>
 
 #include "grnxx/impl/column/base.hpp"
+#include "grnxx/impl/column/body_compactor.hpp"
+#include "grnxx/impl/column/chunked_array.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -25,19 +27,30 @@ class Column<Vector<Int>> : public ColumnBase {
   bool contains(const Datum &datum) const;
   Int find_one(const Datum &datum) const;
 
+  void compact();
+
   // -- Internal API (grnxx/impl/column/base.hpp) --
 
   void unset(Int row_id);
+  void clear_references(Int row_id);
 
   // -- Internal API --
 
+  // Return whether values are delta-encoded or not.
+  bool is_delta_encoded() const {
+    return is_delta_encoded_;
+  }
+
   // Return a value.
   //
   // If "row_id" is valid, returns the stored value.
   // If "row_id" is invalid, returns N/A.
   //
-  // TODO: Vector cannot reuse allocated memory because of this interface.
-  Vector<Int> get(Int row_id) const {
+  // If values are delta-encoded, the value is decoded into "*buffer" and the
+  // result refers to "*buffer". Otherwise, "buffer" is not used.
+  //
+  // On failure, throws an exception.
+  Vector<Int> get(Int row_id, Array<Int> *buffer) const {
     size_t value_id = row_id.raw();
     if (value_id >= headers_.size()) {
       return Vector<Int>::na();
@@ -45,6 +58,9 @@ class Column<Vector<Int>> : public ColumnBase {
     if (headers_[value_id] == na_header()) {
       return Vector<Int>::na();
     }
+    if (is_delta_encoded_) {
+      return decode(headers_[value_id], buffer);
+    }
     size_t size = headers_[value_id] & 0xFFFF;
     if (size == 0) {
       return Vector<Int>(nullptr, 0);
@@ -58,19 +74,62 @@ class Column<Vector<Int>> : public ColumnBase {
       return Vector<Int>(&bodies_[offset + 1], size);
     }
   }
+  // Return the "index"-th element of a value.
+  //
+  // If the value or the element does not exist, returns N/A.
+  // If values are delta-encoded, only the elements up to "index" are
+  // decoded.
+  Int get_element(Int row_id, Int index) const;
   // Read values.
   //
+  // If values are delta-encoded, they are decoded into "*pool" and the
+  // results refer to "*pool". Otherwise, "pool" is not used.
+  //
   // On failure, throws an exception.
-  void read(ArrayCRef<Record> records, ArrayRef<Vector<Int>> values) const;
+  void read(ArrayCRef<Record> records,
+            ArrayRef<Vector<Int>> values,
+            Array<Int> *pool) const;
 
  private:
-  Array<uint64_t> headers_;
+  ChunkedArray<uint64_t> headers_;
   Array<Int> bodies_;
+  BodyCompactor<Int> compactor_;
+  // If "is_delta_encoded_" is true, "headers_" refers to "encoded_bodies_"
+  // and the size in a header is the number of bytes.
+  // An encoded body is the number of values followed by the differences
+  // between adjacent values, all in zigzag varint.
+  bool is_delta_encoded_;
+  Array<uint8_t> encoded_bodies_;
+  BodyCompactor<uint8_t> encoded_compactor_;
 
   static constexpr uint64_t na_header() {
     return std::numeric_limits<uint64_t>::max();
   }
 
+  // Return the encoded body associated with "header".
+  void get_encoded_body(uint64_t header,
+                        const uint8_t **begin,
+                        const uint8_t **end) const {
+    size_t offset = header >> 16;
+    size_t size = header & 0xFFFF;
+    if (size == 0xFFFF) {
+      // The size of a long body is stored in front of the body.
+      size = *reinterpret_cast<const uint64_t *>(&encoded_bodies_[offset]);
+      offset += sizeof(uint64_t);
+    }
+    *begin = &encoded_bodies_[offset];
+    *end = *begin + size;
+  }
+  // Decode the value associated with "header" into "*buffer".
+  //
+  // On failure, throws an exception.
+  Vector<Int> decode(uint64_t header, Array<Int> *buffer) const;
+  // Encode "value" and append it to "encoded_bodies_".
+  //
+  // On success, returns the header.
+  // On failure, throws an exception.
+  uint64_t append_encoded(const Vector<Int> &value);
+
   // Scan the column to find "value".
   //
   // If found, returns the row ID.
@@ -80,6 +139,9 @@ class Column<Vector<Int>> : public ColumnBase {
   // Return the active column size.
   size_t get_valid_size() const;
 
+  // Remove "row_id" from the posting lists of references in "value".
+  void remove_referrers(Int row_id, const Vector<Int> &value);
+
   // Parse "datum" as Vector<Int>.
   //
   // On success, returns the result.
@@ -4,17 +4,20 @@
 
 #include "grnxx/impl/db.hpp"
 #include "grnxx/impl/table.hpp"
-//#include "grnxx/impl/index.hpp"
+#include "grnxx/impl/index.hpp"
 
 namespace grnxx {
 namespace impl {
 
 Column<Vector<Text>>::Column(Table *table,
                              const String &name,
-                             const ColumnOptions &)
+                             const ColumnOptions &options)
     : ColumnBase(table, name, GRNXX_TEXT_VECTOR),
       headers_(),
-      bodies_() {}
+      bodies_(),
+      compactor_(&compaction_options_) {
+  set_compaction_options(options);
+}
 
 Column<Vector<Text>>::~Column() {}
 
@@ -32,46 +35,54 @@ void Column<Vector<Text>>::set(Int row_id, const Datum &datum) {
     return;
   }
   if (!old_value.is_na()) {
-    // TODO: Remove the old value from indexes.
-//    for (size_t i = 0; i < num_indexes(); ++i) {
-//      indexes_[i]->remove(row_id, old_value);
-//    }
+    // Remove the old value from indexes.
+    for (size_t i = 0; i < num_indexes(); ++i) {
+      indexes_[i]->remove(row_id, old_value);
+    }
   }
   size_t value_id = row_id.raw();
   if (value_id >= headers_.size()) {
     headers_.resize(value_id + 1, na_header());
   }
-  // TODO: Insert the new value into indexes.
-//  for (size_t i = 0; i < num_indexes(); ++i) try {
-//    indexes_[i]->insert(row_id, datum)) {
-//  } catch (...) {
-//    for (size_t j = 0; j < i; ++i) {
-//      indexes_[j]->remove(row_id, datum);
-//    }
-//    throw;
-//  }
+  // Insert the new value into indexes.
+  for (size_t i = 0; i < num_indexes(); ++i) try {
+    indexes_[i]->insert(row_id, new_value);
+  } catch (...) {
+    for (size_t j = 0; j < i; ++j) {
+      indexes_[j]->remove(row_id, new_value);
+    }
+    throw;
+  }
   // TODO: Error handling.
   size_t new_value_size = new_value.raw_size();
-  size_t text_headers_offset = text_headers_.size();
-  text_headers_.resize(text_headers_offset + new_value_size);
+  size_t text_headers_offset = bodies_.text_headers.size();
+  bodies_.text_headers.resize(text_headers_offset + new_value_size);
   size_t total_size = 0;
   for (size_t i = 0; i < new_value_size; ++i) {
     if (!new_value[i].is_na()) {
       total_size += new_value[i].raw_size();
     }
   }
-  size_t bodies_offset = bodies_.size();
-  bodies_.resize(bodies_offset + total_size);
-  headers_[value_id] = Header{ text_headers_offset, new_value.size() };
+  size_t texts_offset = bodies_.texts.size();
+  bodies_.texts.resize(texts_offset + total_size);
   for (size_t i = 0; i < new_value_size; ++i) {
-    text_headers_[text_headers_offset + i].offset = bodies_offset;
-    text_headers_[text_headers_offset + i].size = new_value[i].size();
+    Header &text_header = bodies_.text_headers[text_headers_offset + i];
+    text_header.offset = texts_offset;
+    text_header.size = new_value[i].size();
     if (!new_value[i].is_na()) {
-      std::memcpy(&bodies_[bodies_offset],
+      std::memcpy(&bodies_.texts[texts_offset],
                   new_value[i].raw_data(), new_value[i].raw_size());
-      bodies_offset += new_value[i].raw_size();
+      texts_offset += new_value[i].raw_size();
     }
   }
+  if (!headers_[value_id].size.is_na()) {
+    compactor_.discard(headers_[value_id], bodies_);
+  }
+  Header header = Header{ text_headers_offset, new_value.size() };
+  headers_[value_id] = header;
+  compactor_.add(value_id, header);
+  compactor_.maintain(&headers_, &bodies_);
+  notify_update(row_id);
 }
 
 void Column<Vector<Text>>::get(Int row_id, Datum *datum) const {
@@ -94,14 +105,21 @@ Int Column<Vector<Text>>::find_one(const Datum &datum) const {
   return scan(parse_datum(datum));
 }
 
+void Column<Vector<Text>>::compact() {
+  compactor_.compact(&headers_, &bodies_);
+}
+
 void Column<Vector<Text>>::unset(Int row_id) {
   Vector<Text> value = get(row_id);
   if (!value.is_na()) {
-    // TODO: Update indexes if exist.
-//    for (size_t i = 0; i < num_indexes(); ++i) {
-//      indexes_[i]->remove(row_id, value);
-//    }
+    // Update indexes if exist.
+    for (size_t i = 0; i < num_indexes(); ++i) {
+      indexes_[i]->remove(row_id, value);
+    }
+    compactor_.discard(headers_[row_id.raw()], bodies_);
     headers_[row_id.raw()] = na_header();
+    compactor_.maintain(&headers_, &bodies_);
+    notify_update(row_id);
   }
 }
 
@@ -154,6 +172,50 @@ size_t Column<Vector<Text>>::get_valid_size() const {
   return headers_.size();
 }
 
+size_t Column<Vector<Text>>::BodyTraits::get_size(const Header &header,
+                                                  const Bodies &bodies) {
+  size_t num_texts = header.size.raw();
+  size_t size = sizeof(Header) * num_texts;
+  for (size_t i = 0; i < num_texts; ++i) {
+    const Header &text_header = bodies.text_headers[header.offset + i];
+    if (!text_header.size.is_na()) {
+      size += text_header.size.raw();
+    }
+  }
+  return size;
+}
+
+auto Column<Vector<Text>>::BodyTraits::move(const Header &header,
+                                            Bodies *bodies,
+                                            Cursor *cursor) -> Header {
+  size_t num_texts = header.size.raw();
+  if (num_texts != 0) {
+    size_t texts_offset = bodies->text_headers[header.offset].offset;
+    size_t size = get_size(header, *bodies) - (sizeof(Header) * num_texts);
+    if ((size != 0) && (cursor->texts_offset != texts_offset)) {
+      std::memmove(&bodies->texts[cursor->texts_offset],
+                   &bodies->texts[texts_offset], size);
+    }
+    for (size_t i = 0; i < num_texts; ++i) {
+      Header text_header = bodies->text_headers[header.offset + i];
+      text_header.offset -= texts_offset - cursor->texts_offset;
+      bodies->text_headers[cursor->text_headers_offset + i] = text_header;
+    }
+    cursor->texts_offset += size;
+  }
+  Header new_header = Header{ cursor->text_headers_offset, header.size };
+  cursor->text_headers_offset += num_texts;
+  return new_header;
+}
+
+void Column<Vector<Text>>::BodyTraits::finish(Bodies *bodies,
+                                              const Cursor &cursor) {
+  bodies->text_headers.resize(cursor.text_headers_offset);
+  bodies->text_headers.shrink_to_fit();
+  bodies->texts.resize(cursor.texts_offset);
+  bodies->texts.shrink_to_fit();
+}
+
 Vector<Text> Column<Vector<Text>>::parse_datum(const Datum &datum) {
   switch (datum.type()) {
     case GRNXX_NA: {
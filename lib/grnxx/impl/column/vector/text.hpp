@@ -2,6 +2,7 @@
 #define GRNXX_IMPL_COLUMN_VECTOR_TEXT_HPP
 
 #include "grnxx/impl/column/base.hpp"
+#include "grnxx/impl/column/chunked_array.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -22,6 +23,8 @@ class Column<Vector<Text>> : public ColumnBase {
   bool contains(const Datum &datum) const;
   Int find_one(const Datum &datum) const;
 
+  void compact();
+
   // -- Internal API (grnxx/impl/column/base.hpp) --
 
   void unset(Int row_id);
@@ -42,8 +45,8 @@ class Column<Vector<Text>> : public ColumnBase {
     if (headers_[value_id].size.is_na()) {
       return Vector<Text>::na();
     }
-    return Vector<Text>(&text_headers_[headers_[value_id].offset],
-                        bodies_.data(), headers_[value_id].size);
+    return Vector<Text>(&bodies_.text_headers[headers_[value_id].offset],
+                        bodies_.texts.data(), headers_[value_id].size);
   }
   // Read values.
   //
@@ -55,9 +58,41 @@ class Column<Vector<Text>> : public ColumnBase {
     size_t offset;
     Int size;
   };
-  Array<Header> headers_;
-  Array<Header> text_headers_;
-  Array<char> bodies_;
+  // Texts of a value are stored contiguously in "texts".
+  struct Bodies {
+    Array<Header> text_headers;
+    Array<char> texts;
+  };
+  // Describes "Bodies" for BasicBodyCompactor, which moves "text_headers"
+  // and "texts" together.
+  struct BodyTraits {
+    using Header = Column::Header;
+    using Storage = Bodies;
+    struct Cursor {
+      size_t text_headers_offset;
+      size_t texts_offset;
+    };
+
+    static bool has_body(const Header &header) {
+      return !header.size.is_na();
+    }
+    static bool match(const Header &lhs, const Header &rhs) {
+      return (lhs.offset == rhs.offset) && lhs.size.match(rhs.size);
+    }
+    static bool is_behind(const Header &header, const Cursor &cursor) {
+      return header.offset >= cursor.text_headers_offset;
+    }
+    static size_t get_size(const Header &header, const Bodies &bodies);
+    static size_t get_total_size(const Bodies &bodies) {
+      return (sizeof(Header) * bodies.text_headers.size()) +
+             bodies.texts.size();
+    }
+    static Header move(const Header &header, Bodies *bodies, Cursor *cursor);
+    static void finish(Bodies *bodies, const Cursor &cursor);
+  };
+  ChunkedArray<Header> headers_;
+  Bodies bodies_;
+  BasicBodyCompactor<BodyTraits> compactor_;
 
   static constexpr Header na_header() {
     return Header{ 0, Int::na() };
@@ -1,11 +1,36 @@
 #ifndef GRNXX_IMPL_CURSOR_HPP
 #define GRNXX_IMPL_CURSOR_HPP
 
+#include "grnxx/array.hpp"
 #include "grnxx/cursor.hpp"
 
 namespace grnxx {
+
+class Expression;
+class Table;
+
 namespace impl {
 
+// Cursor to read rows of a table in row ID order.
+class TableCursor : public Cursor {
+ public:
+  TableCursor() = default;
+  virtual ~TableCursor() = default;
+
+  // Skip zones where no row satisfies "expression".
+  //
+  // "expression" must be a filter to be applied to all the rows read by the
+  // cursor, and is ignored if the cursor has an offset or a limit.
+  virtual void set_zone_filter(const grnxx::Expression *expression) = 0;
+
+  // Return whether the cursor reads all the rows of "table" or not.
+  //
+  // Returns false if the cursor has an offset or a limit.
+  virtual bool reads_all_rows(const grnxx::Table *table) const = 0;
+  // Return the order of row IDs.
+  virtual CursorOrderType order_type() const = 0;
+};
+
 class EmptyCursor : public Cursor {
  public:
   // -- Public API (grnxx/cursor.hpp) --
@@ -18,6 +43,76 @@ class EmptyCursor : public Cursor {
   }
 };
 
+// Cursor to read row IDs stored in an array.
+class RowIDArrayCursor : public Cursor {
+ public:
+  // -- Public API (grnxx/cursor.hpp) --
+
+  // "row_ids" must be arranged in the order to be read.
+  RowIDArrayCursor(Array<Int> &&row_ids, size_t offset, size_t limit)
+      : Cursor(),
+        row_ids_(std::move(row_ids)),
+        pos_(0),
+        end_(0) {
+    size_t size = row_ids_.size();
+    pos_ = (offset < size) ? offset : size;
+    end_ = ((size - pos_) > limit) ? (pos_ + limit) : size;
+  }
+  ~RowIDArrayCursor() = default;
+
+  size_t read(ArrayRef<Record> records) {
+    size_t count = records.size();
+    if (count > (end_ - pos_)) {
+      count = end_ - pos_;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      records[i] = Record(row_ids_[pos_ + i], Float(0.0));
+    }
+    pos_ += count;
+    return count;
+  }
+
+ private:
+  Array<Int> row_ids_;
+  size_t pos_;
+  size_t end_;
+};
+
+// Cursor to read records stored in an array.
+class RecordArrayCursor : public Cursor {
+ public:
+  // -- Public API (grnxx/cursor.hpp) --
+
+  // "records" must be arranged in the order to be read.
+  RecordArrayCursor(Array<Record> &&records, size_t offset, size_t limit)
+      : Cursor(),
+        records_(std::move(records)),
+        pos_(0),
+        end_(0) {
+    size_t size = records_.size();
+    pos_ = (offset < size) ? offset : size;
+    end_ = ((size - pos_) > limit) ? (pos_ + limit) : size;
+  }
+  ~RecordArrayCursor() = default;
+
+  size_t read(ArrayRef<Record> records) {
+    size_t count = records.size();
+    if (count > (end_ - pos_)) {
+      count = end_ - pos_;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      records[i] = records_[pos_ + i];
+    }
+    pos_ += count;
+    return count;
+  }
+
+ private:
+  Array<Record> records_;
+  size_t pos_;
+  size_t end_;
+};
+
 }  // namespace impl
 }  // namespace grnxx
 
@@ -1,6 +1,10 @@
 #include "grnxx/impl/expression.hpp"
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <cctype>
+#include <limits>
 #include <new>
 #include <string>
 
@@ -16,6 +20,64 @@ enum NodeType {
   OPERATOR_NODE
 };
 
+// -- Block size --
+
+constexpr size_t DEFAULT_CACHE_SIZE = size_t(1) << 18;  // 256KiB
+constexpr size_t MIN_BLOCK_SIZE     = 64;
+constexpr size_t MAX_BLOCK_SIZE     = 16384;
+
+// Return the approximate number of bytes touched per value.
+//
+// Text and Vector values refer to bodies stored in columns and the bodies
+// are also read during evaluation, so their average sizes are estimated.
+template <typename T>
+struct ValueFootprint {
+  static constexpr size_t value = sizeof(T);
+};
+template <>
+struct ValueFootprint<Text> {
+  static constexpr size_t value = sizeof(Text) + 32;
+};
+template <typename T>
+struct ValueFootprint<Vector<T>> {
+  static constexpr size_t value =
+      sizeof(Vector<T>) + (8 * ValueFootprint<T>::value);
+};
+
+// Detect the size of the L2 cache.
+//
+// If not available, returns the default size.
+size_t detect_cache_size() {
+  long size = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+  size = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif  // _SC_LEVEL2_CACHE_SIZE
+  return (size > 0) ? static_cast<size_t>(size) : DEFAULT_CACHE_SIZE;
+}
+
+// Return the size of the L2 cache.
+size_t get_cache_size() {
+  static const size_t cache_size = detect_cache_size();
+  return cache_size;
+}
+
+// Return the block size which keeps "bytes_per_record" bytes per record in
+// the half of the L2 cache.
+//
+// The result is a power of two in [MIN_BLOCK_SIZE, MAX_BLOCK_SIZE].
+size_t choose_block_size(size_t bytes_per_record) {
+  if (bytes_per_record == 0) {
+    bytes_per_record = 1;
+  }
+  size_t max_block_size = (get_cache_size() / 2) / bytes_per_record;
+  size_t block_size = MIN_BLOCK_SIZE;
+  while (((block_size * 2) <= max_block_size) &&
+         ((block_size * 2) <= MAX_BLOCK_SIZE)) {
+    block_size *= 2;
+  }
+  return block_size;
+}
+
 // -- Node --
 
 class Node {
@@ -31,6 +93,55 @@ class Node {
   virtual const Table *reference_table() const {
     return nullptr;
   }
+  // Return the approximate number of bytes of intermediate buffers per
+  // record, including those of descendants.
+  virtual size_t buffer_size() const {
+    return 0;
+  }
+
+  // Prefetch values to be read in evaluation for "records".
+  //
+  // NOTE: This is only a hint and the default implementation does nothing.
+  virtual void prefetch(ArrayCRef<Record>) {}
+  // Return whether the subtree refers to scores or not.
+  virtual bool depends_on_score() const {
+    return false;
+  }
+  // Prepare for filtering "num_records" records in succession.
+  //
+  // On failure, throws an exception.
+  virtual void prepare(size_t) {}
+  // Return whether the subtree can tell zones which never satisfy it.
+  virtual bool uses_zone_maps() const {
+    return false;
+  }
+  // Return whether no row in the "zone_id"-th zone satisfies the subtree.
+  //
+  // NOTE: Returning false is always safe.
+  virtual bool can_skip_zone(size_t) const {
+    return false;
+  }
+  // Release values kept alive for results of previous evaluations.
+  virtual void release_results() {}
+  // If the subtree is a conjunction of comparisons between columns and
+  // constants, append the comparisons to "*conditions".
+  //
+  // On success, returns true.
+  // If the subtree is not such a conjunction, returns false.
+  // On failure, throws an exception.
+  virtual bool get_conditions(Array<ExpressionCondition> *) const {
+    return false;
+  }
+  // If the node is a dereference "arg1.(arg2)", move its arguments and the
+  // columns read by "arg2" to "*arg1", "*arg2" and "*columns".
+  //
+  // On success, returns true.
+  // If the node is not a dereference, returns false.
+  virtual bool release_dereference(std::unique_ptr<Node> *,
+                                   std::unique_ptr<Node> *,
+                                   Array<const ColumnBase *> *) {
+    return false;
+  }
 
   // -- Public API (grnxx/expression.hpp) --
 
@@ -155,6 +266,10 @@ class ConstantNode : public TypedNode<T> {
     return CONSTANT_NODE;
   }
 
+  const Value &value() const {
+    return value_;
+  }
+
   void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results) {
     for (size_t i = 0; i < records.size(); ++i) {
       results[i] = value_;
@@ -218,6 +333,10 @@ class ConstantNode<Float> : public TypedNode<Float> {
     return CONSTANT_NODE;
   }
 
+  Value value() const {
+    return value_;
+  }
+
   void adjust(ArrayRef<Record> records) {
     for (size_t i = 0; i < records.size(); ++i) {
       records[i].score = value_;
@@ -250,6 +369,10 @@ class ConstantNode<Text> : public TypedNode<Text> {
     return CONSTANT_NODE;
   }
 
+  Value value() const {
+    return Text(value_.data(), value_.size());
+  }
+
   void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results) {
     for (size_t i = 0; i < records.size(); ++i) {
       results[i] = Text(value_.data(), value_.size());
@@ -358,6 +481,9 @@ class ScoreNode : public TypedNode<Float> {
   NodeType node_type() const {
     return SCORE_NODE;
   }
+  bool depends_on_score() const {
+    return true;
+  }
 
   void adjust(ArrayRef<Record>) {
     // Nothing to do.
@@ -387,7 +513,13 @@ class ColumnNode : public TypedNode<T> {
   const Table *reference_table() const {
     return column_->_reference_table();
   }
+  const impl::Column<Value> *column() const {
+    return column_;
+  }
 
+  void prefetch(ArrayCRef<Record> records) {
+    column_->prefetch(records);
+  }
   void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results) {
     column_->read(records, results);
   }
@@ -410,6 +542,9 @@ class ColumnNode<Bool> : public TypedNode<Bool> {
     return COLUMN_NODE;
   }
 
+  void prefetch(ArrayCRef<Record> records) {
+    column_->prefetch(records);
+  }
   void filter(ArrayCRef<Record> input_records,
               ArrayRef<Record> *output_records);
   void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results) {
@@ -422,14 +557,7 @@ class ColumnNode<Bool> : public TypedNode<Bool> {
 
 void ColumnNode<Bool>::filter(ArrayCRef<Record> input_records,
                               ArrayRef<Record> *output_records) {
-  size_t count = 0;
-  for (size_t i = 0; i < input_records.size(); ++i) {
-    if (column_->get(input_records[i].row_id).is_true()) {
-      (*output_records)[count] = input_records[i];
-      ++count;
-    }
-  }
-  *output_records = output_records->ref(0, count);
+  column_->filter(input_records, output_records);
 }
 
 template <>
@@ -445,7 +573,13 @@ class ColumnNode<Float> : public TypedNode<Float> {
   NodeType node_type() const {
     return COLUMN_NODE;
   }
+  const impl::Column<Value> *column() const {
+    return column_;
+  }
 
+  void prefetch(ArrayCRef<Record> records) {
+    column_->prefetch(records);
+  }
   void adjust(ArrayRef<Record> records) {
     for (size_t i = 0; i < records.size(); ++i) {
       records[i].score = column_->get(records[i].row_id);
@@ -459,6 +593,59 @@ class ColumnNode<Float> : public TypedNode<Float> {
   const impl::Column<Value> *column_;
 };
 
+template <>
+class ColumnNode<Vector<Int>> : public TypedNode<Vector<Int>> {
+ public:
+  using Value = Vector<Int>;
+
+  explicit ColumnNode(const ColumnBase *column)
+      : TypedNode<Value>(),
+        column_(static_cast<const impl::Column<Value> *>(column)),
+        pools_(),
+        num_pools_(0) {}
+  ~ColumnNode() = default;
+
+  NodeType node_type() const {
+    return COLUMN_NODE;
+  }
+  const Table *reference_table() const {
+    return column_->_reference_table();
+  }
+  const impl::Column<Value> *column() const {
+    return column_;
+  }
+
+  void prefetch(ArrayCRef<Record> records) {
+    column_->prefetch(records);
+  }
+  void release_results() {
+    num_pools_ = 0;
+  }
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
+
+ private:
+  const impl::Column<Value> *column_;
+  // Delta-encoded values are decoded into pools which are in use until
+  // release_results() is called.
+  // The first "num_pools_" pools are in use and the others are kept for
+  // reuse.
+  Array<Array<Int>> pools_;
+  size_t num_pools_;
+};
+
+void ColumnNode<Vector<Int>>::evaluate(ArrayCRef<Record> records,
+                                       ArrayRef<Value> results) {
+  if (!column_->is_delta_encoded()) {
+    column_->read(records, results, nullptr);
+    return;
+  }
+  if (num_pools_ == pools_.size()) {
+    pools_.resize(num_pools_ + 1);
+  }
+  column_->read(records, results, &pools_[num_pools_]);
+  ++num_pools_;
+}
+
 // -- OperatorNode --
 
 template <typename T>
@@ -515,6 +702,22 @@ class UnaryNode : public OperatorNode<T> {
         arg_values_() {}
   virtual ~UnaryNode() = default;
 
+  size_t buffer_size() const {
+    return ValueFootprint<Arg>::value + arg_->buffer_size();
+  }
+  void prefetch(ArrayCRef<Record> records) {
+    arg_->prefetch(records);
+  }
+  bool depends_on_score() const {
+    return arg_->depends_on_score();
+  }
+  void prepare(size_t num_records) {
+    arg_->prepare(num_records);
+  }
+  void release_results() {
+    arg_->release_results();
+  }
+
  protected:
   std::unique_ptr<TypedNode<Arg>> arg_;
   Array<Arg> arg_values_;
@@ -767,6 +970,26 @@ class BinaryNode : public OperatorNode<T> {
         arg2_values_() {}
   virtual ~BinaryNode() = default;
 
+  size_t buffer_size() const {
+    return ValueFootprint<Arg1>::value + arg1_->buffer_size() +
+           ValueFootprint<Arg2>::value + arg2_->buffer_size();
+  }
+  void prefetch(ArrayCRef<Record> records) {
+    arg1_->prefetch(records);
+    arg2_->prefetch(records);
+  }
+  bool depends_on_score() const {
+    return arg1_->depends_on_score() || arg2_->depends_on_score();
+  }
+  void prepare(size_t num_records) {
+    arg1_->prepare(num_records);
+    arg2_->prepare(num_records);
+  }
+  void release_results() {
+    arg1_->release_results();
+    arg2_->release_results();
+  }
+
  protected:
   std::unique_ptr<TypedNode<Arg1>> arg1_;
   std::unique_ptr<TypedNode<Arg2>> arg2_;
@@ -796,6 +1019,17 @@ class LogicalAndNode : public BinaryNode<Bool, Bool, Bool> {
         temp_records_() {}
   ~LogicalAndNode() = default;
 
+  bool uses_zone_maps() const {
+    return arg1_->uses_zone_maps() || arg2_->uses_zone_maps();
+  }
+  bool can_skip_zone(size_t zone_id) const {
+    return arg1_->can_skip_zone(zone_id) || arg2_->can_skip_zone(zone_id);
+  }
+  bool get_conditions(Array<ExpressionCondition> *conditions) const {
+    return arg1_->get_conditions(conditions) &&
+           arg2_->get_conditions(conditions);
+  }
+
   void filter(ArrayCRef<Record> input_records,
               ArrayRef<Record> *output_records) {
     arg1_->filter(input_records, output_records);
@@ -851,6 +1085,13 @@ class LogicalOrNode : public BinaryNode<Bool, Bool, Bool> {
         temp_records_() {}
   ~LogicalOrNode() = default;
 
+  bool uses_zone_maps() const {
+    return arg1_->uses_zone_maps() && arg2_->uses_zone_maps();
+  }
+  bool can_skip_zone(size_t zone_id) const {
+    return arg1_->can_skip_zone(zone_id) && arg2_->can_skip_zone(zone_id);
+  }
+
   void filter(ArrayCRef<Record> input_records,
               ArrayRef<Record> *output_records);
   void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
@@ -1085,6 +1326,108 @@ struct NotEqualOperator {
 template <typename T>
 using NotEqualNode = GenericBinaryNode<NotEqualOperator<T>>;
 
+// ----- DictionaryEqualNode -----
+
+// Return whether "node" is a ColumnNode<Text> of a dictionary-encoded column.
+inline bool is_dictionary_encoded_column_node(const Node *node) {
+  return (node->node_type() == COLUMN_NODE) &&
+         (node->data_type() == GRNXX_TEXT) &&
+         static_cast<const ColumnNode<Text> *>(node)->column()
+             ->is_dictionary_encoded();
+}
+
+// Equality test between a dictionary-encoded Text column and a constant.
+//
+// The constant is translated into a code and compared with codes, so that
+// values are never decoded.
+class DictionaryEqualNode : public BinaryNode<Bool, Text, Text> {
+ public:
+  using Value = Bool;
+  using Arg1 = Text;
+  using Arg2 = Text;
+
+  // "arg1" must be a dictionary-encoded ColumnNode<Text> and "arg2" must be
+  // a ConstantNode<Text>.
+  DictionaryEqualNode(std::unique_ptr<Node> &&arg1,
+                      std::unique_ptr<Node> &&arg2,
+                      bool is_not_equal)
+      : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)),
+        column_(static_cast<ColumnNode<Text> *>(arg1_.get())->column()),
+        is_not_equal_(is_not_equal),
+        codes_() {}
+  ~DictionaryEqualNode() = default;
+
+  size_t buffer_size() const {
+    return sizeof(uint32_t);
+  }
+
+  void filter(ArrayCRef<Record> input_records,
+              ArrayRef<Record> *output_records);
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
+
+ private:
+  const impl::Column<Text> *column_;
+  bool is_not_equal_;
+  Array<uint32_t> codes_;
+
+  // Fill "codes_" with the codes of "records".
+  void fill_codes(ArrayCRef<Record> records) {
+    if (codes_.size() < records.size()) {
+      codes_.resize(records.size());
+    }
+    column_->read_codes(records, codes_.ref(0, records.size()));
+  }
+  // Return the constant value.
+  Text constant() const {
+    return static_cast<const ConstantNode<Text> *>(arg2_.get())->value();
+  }
+};
+
+void DictionaryEqualNode::filter(ArrayCRef<Record> input_records,
+                                 ArrayRef<Record> *output_records) {
+  Text value = constant();
+  if (value.is_na()) {
+    *output_records = output_records->ref(0, 0);
+    return;
+  }
+  // The code is looked up every time because values may be added.
+  uint32_t code = column_->find_code(value);
+  if ((code == impl::Column<Text>::na_code()) && !is_not_equal_) {
+    *output_records = output_records->ref(0, 0);
+    return;
+  }
+  fill_codes(input_records);
+  size_t count = 0;
+  for (size_t i = 0; i < input_records.size(); ++i) {
+    if ((codes_[i] != impl::Column<Text>::na_code()) &&
+        ((codes_[i] == code) != is_not_equal_)) {
+      (*output_records)[count] = input_records[i];
+      ++count;
+    }
+  }
+  *output_records = output_records->ref(0, count);
+}
+
+void DictionaryEqualNode::evaluate(ArrayCRef<Record> records,
+                                   ArrayRef<Value> results) {
+  Text value = constant();
+  if (value.is_na()) {
+    for (size_t i = 0; i < records.size(); ++i) {
+      results[i] = Bool::na();
+    }
+    return;
+  }
+  uint32_t code = column_->find_code(value);
+  fill_codes(records);
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (codes_[i] == impl::Column<Text>::na_code()) {
+      results[i] = Bool::na();
+    } else {
+      results[i] = Bool((codes_[i] == code) != is_not_equal_);
+    }
+  }
+}
+
 // ----- LessNode -----
 
 template <typename T>
@@ -1145,6 +1488,85 @@ struct GreaterEqualOperator {
 template <typename T>
 using GreaterEqualNode = GenericBinaryNode<GreaterEqualOperator<T>>;
 
+// ----- ZoneMapNode -----
+
+// Comparison between a column and a constant, which tells zones to be skipped
+// with the zone map of the column.
+//
+// Evaluation is delegated to the wrapped comparison node.
+template <typename T>
+class ZoneMapNode : public TypedNode<Bool> {
+ public:
+  using Value = Bool;
+  using Key = typename ZoneMap<T>::Key;
+
+  // "node" must be "column op value" and "operator_type" must be "op".
+  ZoneMapNode(std::unique_ptr<Node> &&node,
+              const Column<T> *column,
+              OperatorType operator_type,
+              const T &value)
+      : TypedNode<Value>(),
+        node_(static_cast<TypedNode<Bool> *>(node.release())),
+        column_(column),
+        zone_map_(&column->zone_map()),
+        operator_type_(operator_type),
+        value_(value),
+        key_(ZoneMapKey<T>::get(value)) {}
+  ~ZoneMapNode() = default;
+
+  NodeType node_type() const {
+    return node_->node_type();
+  }
+  size_t buffer_size() const {
+    return node_->buffer_size();
+  }
+  void prefetch(ArrayCRef<Record> records) {
+    node_->prefetch(records);
+  }
+  bool depends_on_score() const {
+    return node_->depends_on_score();
+  }
+  void prepare(size_t num_records) {
+    node_->prepare(num_records);
+  }
+  void release_results() {
+    node_->release_results();
+  }
+  bool uses_zone_maps() const {
+    return true;
+  }
+  bool can_skip_zone(size_t zone_id) const {
+    return !zone_map_->may_match(zone_id, operator_type_, key_);
+  }
+  bool get_conditions(Array<ExpressionCondition> *conditions) const try {
+    if (operator_type_ == GRNXX_NOT_EQUAL) {
+      return false;
+    }
+    // NOTE: "value_" refers to the constant owned by "node_".
+    conditions->push_back(
+        ExpressionCondition{ column_, operator_type_, Datum(value_) });
+    return true;
+  } catch (const std::bad_alloc &) {
+    throw "Memory allocation failed";  // TODO
+  }
+
+  void filter(ArrayCRef<Record> input_records,
+              ArrayRef<Record> *output_records) {
+    node_->filter(input_records, output_records);
+  }
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results) {
+    node_->evaluate(records, results);
+  }
+
+ private:
+  std::unique_ptr<TypedNode<Bool>> node_;
+  const Column<T> *column_;
+  const ZoneMap<T> *zone_map_;
+  OperatorType operator_type_;
+  T value_;
+  Key key_;
+};
+
 // ----- BitwiseAndNode -----
 
 template <typename T>
@@ -1308,82 +1730,543 @@ struct ContainsOperator {
 };
 
 template <typename T>
-using ContainsNode = GenericBinaryNode<ContainsOperator<T>>;
-
-// ---- SubscriptNode ----
-
-template <typename T>
-class SubscriptNode : public BinaryNode<T, Vector<T>, Int> {
- public:
-  using Value = T;
+struct ContainsOperator<Vector<T>> {
+  using Value = Bool;
   using Arg1 = Vector<T>;
-  using Arg2 = Int;
-
-  SubscriptNode(std::unique_ptr<Node> &&arg1, std::unique_ptr<Node> &&arg2)
-      : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)) {}
-  ~SubscriptNode() = default;
-
-  const Table *reference_table() const {
-    return this->arg1_->reference_table();
+  using Arg2 = T;
+  Value operator()(const Arg1 &arg1, const Arg2 &arg2) const {
+    if (arg1.is_na() || arg2.is_na()) {
+      return Bool::na();
+    }
+    size_t size = arg1.raw_size();
+    for (size_t i = 0; i < size; ++i) {
+      if (arg1[Int(i)].match(arg2)) {
+        return Bool(true);
+      }
+    }
+    return Bool(false);
   }
-
-  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
 };
 
 template <typename T>
-void SubscriptNode<T>::evaluate(ArrayCRef<Record> records,
-                                ArrayRef<Value> results) {
-  this->fill_arg1_values(records);
-  this->fill_arg2_values(records);
-  for (size_t i = 0; i < records.size(); ++i) {
-    results[i] = this->arg1_values_[i][this->arg2_values_[i]];
-  }
-}
+using ContainsNode = GenericBinaryNode<ContainsOperator<T>>;
 
-template <>
-class SubscriptNode<Bool> : public BinaryNode<Bool, Vector<Bool>, Int> {
+// ----- TextPatternNode -----
+
+// Prefix, suffix or substring search between a Text column and a constant.
+//
+// The constant is preprocessed once and values are tested in the column
+// storage, so that values are never copied.
+class TextPatternNode : public BinaryNode<Bool, Text, Text> {
  public:
   using Value = Bool;
-  using Arg1 = Vector<Bool>;
-  using Arg2 = Int;
+  using Arg1 = Text;
+  using Arg2 = Text;
 
-  SubscriptNode(std::unique_ptr<Node> &&arg1, std::unique_ptr<Node> &&arg2)
-      : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)) {}
-  ~SubscriptNode() = default;
+  // "arg1" must be a ColumnNode<Text> and "arg2" must be a
+  // ConstantNode<Text>.
+  TextPatternNode(OperatorType operator_type,
+                  std::unique_ptr<Node> &&arg1,
+                  std::unique_ptr<Node> &&arg2)
+      : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)),
+        column_(static_cast<ColumnNode<Text> *>(arg1_.get())->column()),
+        is_na_(constant().is_na()),
+        pattern_(operator_type,
+                 is_na_ ? Text(nullptr, 0) : constant()) {}
+  ~TextPatternNode() = default;
 
-  void filter(ArrayCRef<Record> input_records,
-              ArrayRef<Record> *output_records);
-  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
-};
+  size_t buffer_size() const {
+    return 0;
+  }
 
-void SubscriptNode<Bool>::filter(ArrayCRef<Record> input_records,
-                                 ArrayRef<Record> *output_records) {
-  this->fill_arg1_values(input_records);
-  this->fill_arg2_values(input_records);
-  size_t count = 0;
-  for (size_t i = 0; i < input_records.size(); ++i) {
-    if (this->arg1_values_[i][this->arg2_values_[i]].is_true()) {
-      (*output_records)[count] = input_records[i];
-      ++count;
+  void filter(ArrayCRef<Record> input_records,
+              ArrayRef<Record> *output_records) {
+    if (is_na_) {
+      *output_records = output_records->ref(0, 0);
+      return;
     }
+    column_->filter(input_records, pattern_, output_records);
+  }
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results) {
+    if (is_na_) {
+      for (size_t i = 0; i < records.size(); ++i) {
+        results[i] = Bool::na();
+      }
+      return;
+    }
+    column_->match(records, pattern_, results);
   }
-  *output_records = output_records->ref(0, count);
-}
 
-void SubscriptNode<Bool>::evaluate(ArrayCRef<Record> records,
-                                   ArrayRef<Value> results) {
-  this->fill_arg1_values(records);
-  this->fill_arg2_values(records);
-  for (size_t i = 0; i < records.size(); ++i) {
-    results[i] = this->arg1_values_[i][this->arg2_values_[i]];
+ private:
+  const impl::Column<Text> *column_;
+  bool is_na_;
+  TextPattern pattern_;
+
+  // Return the constant value.
+  Text constant() const {
+    return static_cast<const ConstantNode<Text> *>(arg2_.get())->value();
   }
-}
+};
 
-template <>
-class SubscriptNode<Float> : public BinaryNode<Float, Vector<Float>, Int> {
- public:
+// ----- GeoDistanceNode -----
+
+struct GeoDistanceOperator {
   using Value = Float;
-  using Arg1 = Vector<Float>;
+  using Arg1 = GeoPoint;
+  using Arg2 = GeoPoint;
+  Value operator()(const Arg1 &arg1, const Arg2 &arg2) const {
+    return arg1.distance(arg2);
+  }
+};
+
+using GeoDistanceNode = GenericBinaryNode<GeoDistanceOperator>;
+
+// --- TernaryNode ---
+
+template <typename T, typename U, typename V, typename W>
+class TernaryNode : public OperatorNode<T> {
+ public:
+  using Value = T;
+  using Arg1 = U;
+  using Arg2 = V;
+  using Arg3 = W;
+
+  TernaryNode(std::unique_ptr<Node> &&arg1,
+              std::unique_ptr<Node> &&arg2,
+              std::unique_ptr<Node> &&arg3)
+      : OperatorNode<Value>(),
+        arg1_(static_cast<TypedNode<Arg1> *>(arg1.release())),
+        arg2_(static_cast<TypedNode<Arg2> *>(arg2.release())),
+        arg3_(static_cast<TypedNode<Arg3> *>(arg3.release())),
+        arg1_values_(),
+        arg2_values_(),
+        arg3_values_() {}
+  virtual ~TernaryNode() = default;
+
+  size_t buffer_size() const {
+    return ValueFootprint<Arg1>::value + arg1_->buffer_size() +
+           ValueFootprint<Arg2>::value + arg2_->buffer_size() +
+           ValueFootprint<Arg3>::value + arg3_->buffer_size();
+  }
+  void prefetch(ArrayCRef<Record> records) {
+    arg1_->prefetch(records);
+    arg2_->prefetch(records);
+    arg3_->prefetch(records);
+  }
+  bool depends_on_score() const {
+    return arg1_->depends_on_score() || arg2_->depends_on_score() ||
+           arg3_->depends_on_score();
+  }
+  void prepare(size_t num_records) {
+    arg1_->prepare(num_records);
+    arg2_->prepare(num_records);
+    arg3_->prepare(num_records);
+  }
+  void release_results() {
+    arg1_->release_results();
+    arg2_->release_results();
+    arg3_->release_results();
+  }
+
+ protected:
+  std::unique_ptr<TypedNode<Arg1>> arg1_;
+  std::unique_ptr<TypedNode<Arg2>> arg2_;
+  std::unique_ptr<TypedNode<Arg3>> arg3_;
+  Array<Arg1> arg1_values_;
+  Array<Arg2> arg2_values_;
+  Array<Arg3> arg3_values_;
+
+  // Fill "arg1_values_" with the evaluation results of "arg1_".
+  void fill_arg1_values(ArrayCRef<Record> records) {
+    fill_node_arg_values(records, arg1_.get(), &arg1_values_);
+  }
+  // Fill "arg2_values_" with the evaluation results of "arg2_".
+  void fill_arg2_values(ArrayCRef<Record> records) {
+    fill_node_arg_values(records, arg2_.get(), &arg2_values_);
+  }
+  // Fill "arg3_values_" with the evaluation results of "arg3_".
+  void fill_arg3_values(ArrayCRef<Record> records) {
+    fill_node_arg_values(records, arg3_.get(), &arg3_values_);
+  }
+};
+
+// ---- GenericTernaryNode ----
+
+template <typename T,
+          typename U = typename T::Value,
+          typename V = typename T::Arg1,
+          typename W = typename T::Arg2,
+          typename X = typename T::Arg3>
+class GenericTernaryNode;
+
+template <typename T, typename V, typename W, typename X>
+class GenericTernaryNode<T, Bool, V, W, X>
+    : public TernaryNode<Bool, V, W, X> {
+ public:
+  using Operator = T;
+  using Value = Bool;
+  using Arg1 = V;
+  using Arg2 = W;
+  using Arg3 = X;
+
+  GenericTernaryNode(std::unique_ptr<Node> &&arg1,
+                     std::unique_ptr<Node> &&arg2,
+                     std::unique_ptr<Node> &&arg3)
+      : TernaryNode<Value, Arg1, Arg2, Arg3>(std::move(arg1),
+                                             std::move(arg2),
+                                             std::move(arg3)),
+        operator_() {}
+  ~GenericTernaryNode() = default;
+
+  void filter(ArrayCRef<Record> input_records,
+              ArrayRef<Record> *output_records);
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
+
+ private:
+  Operator operator_;
+};
+
+template <typename T, typename V, typename W, typename X>
+void GenericTernaryNode<T, Bool, V, W, X>::filter(
+    ArrayCRef<Record> input_records,
+    ArrayRef<Record> *output_records) {
+  this->fill_arg1_values(input_records);
+  this->fill_arg2_values(input_records);
+  this->fill_arg3_values(input_records);
+  size_t count = 0;
+  for (size_t i = 0; i < input_records.size(); ++i) {
+    if (operator_(this->arg1_values_[i], this->arg2_values_[i],
+                  this->arg3_values_[i]).is_true()) {
+      (*output_records)[count] = input_records[i];
+      ++count;
+    }
+  }
+  *output_records = output_records->ref(0, count);
+}
+
+template <typename T, typename V, typename W, typename X>
+void GenericTernaryNode<T, Bool, V, W, X>::evaluate(
+    ArrayCRef<Record> records,
+    ArrayRef<Value> results) {
+  this->fill_arg1_values(records);
+  this->fill_arg2_values(records);
+  this->fill_arg3_values(records);
+  for (size_t i = 0; i < records.size(); ++i) {
+    results[i] = operator_(this->arg1_values_[i], this->arg2_values_[i],
+                           this->arg3_values_[i]);
+  }
+}
+
+// ----- GeoWithinRectangleNode -----
+
+struct GeoWithinRectangleOperator {
+  using Value = Bool;
+  using Arg1 = GeoPoint;
+  using Arg2 = GeoPoint;
+  using Arg3 = GeoPoint;
+  Value operator()(const Arg1 &arg1,
+                   const Arg2 &arg2,
+                   const Arg3 &arg3) const {
+    if (arg1.is_na() || arg2.is_na() || arg3.is_na()) {
+      return Bool::na();
+    }
+    int64_t latitude = arg1.raw_latitude();
+    int64_t longitude = arg1.raw_longitude();
+    return Bool((latitude >= std::min(arg2.raw_latitude(),
+                                      arg3.raw_latitude())) &&
+                (latitude <= std::max(arg2.raw_latitude(),
+                                      arg3.raw_latitude())) &&
+                (longitude >= std::min(arg2.raw_longitude(),
+                                       arg3.raw_longitude())) &&
+                (longitude <= std::max(arg2.raw_longitude(),
+                                       arg3.raw_longitude())));
+  }
+};
+
+using GeoWithinRectangleNode = GenericTernaryNode<GeoWithinRectangleOperator>;
+
+// ----- GeoWithinCircleNode -----
+
+struct GeoWithinCircleOperator {
+  using Value = Bool;
+  using Arg1 = GeoPoint;
+  using Arg2 = GeoPoint;
+  using Arg3 = Float;
+  Value operator()(const Arg1 &arg1,
+                   const Arg2 &arg2,
+                   const Arg3 &arg3) const {
+    return arg1.distance(arg2) <= arg3;
+  }
+};
+
+using GeoWithinCircleNode = GenericTernaryNode<GeoWithinCircleOperator>;
+
+// ----- IndexedNode -----
+
+// A node to filter records with row IDs found with an index.
+//
+// If "verifies" is true, records found with the index are candidates and
+// verified by the wrapped node.
+// Evaluation is delegated to the wrapped node.
+class IndexedNode : public TypedNode<Bool> {
+ public:
+  using Value = Bool;
+
+  IndexedNode(std::unique_ptr<Node> &&node,
+              const ColumnBase *column,
+              IndexType index_type,
+              bool verifies)
+      : TypedNode<Value>(),
+        node_(static_cast<TypedNode<Bool> *>(node.release())),
+        column_(column),
+        index_type_(index_type),
+        verifies_(verifies),
+        is_prepared_(false),
+        prepared_index_(nullptr),
+        prepared_revision_(0),
+        row_ids_() {}
+  virtual ~IndexedNode() = default;
+
+  NodeType node_type() const {
+    return node_->node_type();
+  }
+  size_t buffer_size() const {
+    return node_->buffer_size();
+  }
+  void prefetch(ArrayCRef<Record> records) {
+    node_->prefetch(records);
+  }
+  bool depends_on_score() const {
+    return node_->depends_on_score();
+  }
+  void prepare(size_t num_records);
+  void release_results() {
+    node_->release_results();
+  }
+
+  void filter(ArrayCRef<Record> input_records,
+              ArrayRef<Record> *output_records);
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results) {
+    node_->evaluate(records, results);
+  }
+
+ protected:
+  // Create a cursor to read records found with "index".
+  //
+  // On failure, throws an exception.
+  virtual std::unique_ptr<Cursor> find(const Index *index) const = 0;
+
+ private:
+  std::unique_ptr<TypedNode<Bool>> node_;
+  const ColumnBase *column_;
+  IndexType index_type_;
+  bool verifies_;
+  bool is_prepared_;
+  // The index and the column revision which "row_ids_" is found with.
+  const Index *prepared_index_;
+  uint64_t prepared_revision_;
+  // Row IDs found with the index in ascending order.
+  Array<Int> row_ids_;
+};
+
+void IndexedNode::prepare(size_t num_records) {
+  node_->prepare(num_records);
+  // The index may be created or removed after the node is created.
+  const Index *index = nullptr;
+  for (size_t i = 0; i < column_->num_indexes(); ++i) {
+    if (column_->get_index(i)->type() == index_type_) {
+      index = column_->get_index(i);
+      break;
+    }
+  }
+  if (!index) {
+    is_prepared_ = false;
+    return;
+  }
+  // prepare() is called per block, so row IDs are found only once and
+  // reused until the column is updated.
+  if (is_prepared_ && (index == prepared_index_) &&
+      (column_->revision() == prepared_revision_)) {
+    return;
+  }
+  is_prepared_ = false;
+  Array<Record> records;
+  find(index)->read_all(&records);
+  row_ids_.resize(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    row_ids_[i] = records[i].row_id;
+  }
+  prepared_index_ = index;
+  prepared_revision_ = column_->revision();
+  is_prepared_ = true;
+}
+
+void IndexedNode::filter(ArrayCRef<Record> input_records,
+                         ArrayRef<Record> *output_records) {
+  if (!is_prepared_) {
+    node_->filter(input_records, output_records);
+    return;
+  }
+  const Int *begin = row_ids_.data();
+  const Int *end = begin + row_ids_.size();
+  const Int *it = begin;
+  size_t count = 0;
+  for (size_t i = 0; i < input_records.size(); ++i) {
+    Int row_id = input_records[i].row_id;
+    // Records are mostly in row ID order, so the search starts from the
+    // last position.
+    if ((it == begin) || (it[-1].raw() < row_id.raw())) {
+      it = std::lower_bound(it, end, row_id, [](Int lhs, Int rhs) {
+        return lhs.raw() < rhs.raw();
+      });
+    } else {
+      it = std::lower_bound(begin, it, row_id, [](Int lhs, Int rhs) {
+        return lhs.raw() < rhs.raw();
+      });
+    }
+    if ((it != end) && it->match(row_id)) {
+      (*output_records)[count] = input_records[i];
+      ++count;
+    }
+  }
+  *output_records = output_records->ref(0, count);
+  if (verifies_) {
+    node_->filter(*output_records, output_records);
+  }
+}
+
+// A node to filter records with an index which supports find_contains().
+class IndexedContainsNode : public IndexedNode {
+ public:
+  // "node" must be "column @ value", or "column @^ value" or
+  // "column @$ value" with "verifies" being true.
+  IndexedContainsNode(std::unique_ptr<Node> &&node,
+                      const ColumnBase *column,
+                      IndexType index_type,
+                      const Datum &value,
+                      bool verifies)
+      : IndexedNode(std::move(node), column, index_type, verifies),
+        value_(value) {}
+  ~IndexedContainsNode() = default;
+
+ protected:
+  std::unique_ptr<Cursor> find(const Index *index) const {
+    return index->find_contains(value_);
+  }
+
+ private:
+  Datum value_;
+};
+
+// A node to filter records with a tree index of a GeoPoint column.
+//
+// The geo search runs in IndexedNode::prepare(), which keeps its result
+// across blocks until the column is updated.
+class IndexedGeoNode : public IndexedNode {
+ public:
+  // "node" must test whether values of "column" are within a rectangle
+  // whose corners are "point" and "arg" or within a circle whose center is
+  // "point" and radius is "arg".
+  IndexedGeoNode(std::unique_ptr<Node> &&node,
+                 const ColumnBase *column,
+                 OperatorType operator_type,
+                 const GeoPoint &point,
+                 const Datum &arg)
+      : IndexedNode(std::move(node), column, GRNXX_TREE_INDEX, false),
+        operator_type_(operator_type),
+        point_(point),
+        arg_(arg) {}
+  ~IndexedGeoNode() = default;
+
+ protected:
+  std::unique_ptr<Cursor> find(const Index *index) const {
+    if (operator_type_ == GRNXX_GEO_WITHIN_RECTANGLE) {
+      return index->find_within_rectangle(point_, arg_.as_geo_point());
+    } else {
+      return index->find_within_circle(point_, arg_.as_float());
+    }
+  }
+
+ private:
+  OperatorType operator_type_;
+  GeoPoint point_;
+  Datum arg_;
+};
+
+// ---- SubscriptNode ----
+
+template <typename T>
+class SubscriptNode : public BinaryNode<T, Vector<T>, Int> {
+ public:
+  using Value = T;
+  using Arg1 = Vector<T>;
+  using Arg2 = Int;
+
+  SubscriptNode(std::unique_ptr<Node> &&arg1, std::unique_ptr<Node> &&arg2)
+      : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)) {}
+  ~SubscriptNode() = default;
+
+  const Table *reference_table() const {
+    return this->arg1_->reference_table();
+  }
+
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
+};
+
+template <typename T>
+void SubscriptNode<T>::evaluate(ArrayCRef<Record> records,
+                                ArrayRef<Value> results) {
+  this->fill_arg1_values(records);
+  this->fill_arg2_values(records);
+  for (size_t i = 0; i < records.size(); ++i) {
+    results[i] = this->arg1_values_[i][this->arg2_values_[i]];
+  }
+}
+
+template <>
+class SubscriptNode<Bool> : public BinaryNode<Bool, Vector<Bool>, Int> {
+ public:
+  using Value = Bool;
+  using Arg1 = Vector<Bool>;
+  using Arg2 = Int;
+
+  SubscriptNode(std::unique_ptr<Node> &&arg1, std::unique_ptr<Node> &&arg2)
+      : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)) {}
+  ~SubscriptNode() = default;
+
+  void filter(ArrayCRef<Record> input_records,
+              ArrayRef<Record> *output_records);
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
+};
+
+void SubscriptNode<Bool>::filter(ArrayCRef<Record> input_records,
+                                 ArrayRef<Record> *output_records) {
+  this->fill_arg1_values(input_records);
+  this->fill_arg2_values(input_records);
+  size_t count = 0;
+  for (size_t i = 0; i < input_records.size(); ++i) {
+    if (this->arg1_values_[i][this->arg2_values_[i]].is_true()) {
+      (*output_records)[count] = input_records[i];
+      ++count;
+    }
+  }
+  *output_records = output_records->ref(0, count);
+}
+
+void SubscriptNode<Bool>::evaluate(ArrayCRef<Record> records,
+                                   ArrayRef<Value> results) {
+  this->fill_arg1_values(records);
+  this->fill_arg2_values(records);
+  for (size_t i = 0; i < records.size(); ++i) {
+    results[i] = this->arg1_values_[i][this->arg2_values_[i]];
+  }
+}
+
+template <>
+class SubscriptNode<Float> : public BinaryNode<Float, Vector<Float>, Int> {
+ public:
+  using Value = Float;
+  using Arg1 = Vector<Float>;
   using Arg2 = Int;
 
   SubscriptNode(std::unique_ptr<Node> &&arg1, std::unique_ptr<Node> &&arg2)
@@ -1411,8 +2294,171 @@ void SubscriptNode<Float>::evaluate(ArrayCRef<Record> records,
   }
 }
 
+// A subscript to a delta-encoded column decodes only the elements up to the
+// subscript instead of the whole vectors.
+class DeltaSubscriptNode : public BinaryNode<Int, Vector<Int>, Int> {
+ public:
+  using Value = Int;
+  using Arg1 = Vector<Int>;
+  using Arg2 = Int;
+
+  // "arg1" must be a ColumnNode<Vector<Int>> of a delta-encoded column.
+  DeltaSubscriptNode(std::unique_ptr<Node> &&arg1,
+                     std::unique_ptr<Node> &&arg2)
+      : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)),
+        column_(static_cast<ColumnNode<Arg1> *>(
+                    this->arg1_.get())->column()) {}
+  ~DeltaSubscriptNode() = default;
+
+  const Table *reference_table() const {
+    return this->arg1_->reference_table();
+  }
+
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
+
+ private:
+  const impl::Column<Arg1> *column_;
+};
+
+void DeltaSubscriptNode::evaluate(ArrayCRef<Record> records,
+                                  ArrayRef<Value> results) {
+  this->fill_arg2_values(records);
+  for (size_t i = 0; i < records.size(); ++i) {
+    results[i] = column_->get_element(records[i].row_id,
+                                      this->arg2_values_[i]);
+  }
+}
+
+// ---- Gatherer ----
+
+// The minimum number of records for sorted gather.
+constexpr size_t MIN_SORTED_GATHER_SIZE = 64;
+
+// Evaluate a subexpression for referenced rows.
+//
+// If it pays off, records referring to the same row with the same score are
+// evaluated only once and the referenced rows are read in ascending order of
+// row ID, so that many references to few rows and references to a table
+// larger than the cache don't cause random accesses.
+// Otherwise, values are prefetched and read in the given order.
+template <typename T>
+class Gatherer {
+ public:
+  using Value = T;
+
+  Gatherer()
+      : positions_(),
+        unique_records_(),
+        unique_ids_(),
+        unique_values_() {}
+  ~Gatherer() = default;
+
+  // Evaluate "*node" for "records" referring to "table".
+  //
+  // The evaluation results are stored into "results".
+  //
+  // On failure, throws an exception.
+  void gather(const Table *table,
+              TypedNode<Value> *node,
+              ArrayCRef<Record> records,
+              ArrayRef<Value> results);
+
+ private:
+  Array<size_t> positions_;
+  Array<Record> unique_records_;
+  Array<size_t> unique_ids_;
+  Array<Value> unique_values_;
+
+  // Return whether sorted gather is expected to pay off or not.
+  static bool is_sort_preferred(const Table *table,
+                                const TypedNode<Value> *node,
+                                size_t num_records);
+};
+
+template <typename T>
+void Gatherer<T>::gather(const Table *table,
+                         TypedNode<Value> *node,
+                         ArrayCRef<Record> records,
+                         ArrayRef<Value> results) {
+  if (!is_sort_preferred(table, node, records.size())) {
+    node->prefetch(records);
+    node->evaluate(records, results);
+    return;
+  }
+  if (positions_.size() < records.size()) {
+    positions_.resize(records.size());
+    unique_records_.resize(records.size());
+    unique_ids_.resize(records.size());
+    unique_values_.resize(records.size());
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    positions_[i] = i;
+  }
+  std::sort(positions_.buffer(), positions_.buffer() + records.size(),
+            [&records](size_t lhs, size_t rhs) {
+    return records[lhs].row_id.raw() < records[rhs].row_id.raw();
+  });
+  size_t num_unique_records = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    const Record &record = records[positions_[i]];
+    if ((num_unique_records == 0) ||
+        record.row_id.unmatch(
+            unique_records_[num_unique_records - 1].row_id) ||
+        record.score.unmatch(
+            unique_records_[num_unique_records - 1].score)) {
+      unique_records_[num_unique_records] = record;
+      ++num_unique_records;
+    }
+    unique_ids_[positions_[i]] = num_unique_records - 1;
+  }
+  ArrayCRef<Record> unique_records =
+      unique_records_.cref(0, num_unique_records);
+  node->prefetch(unique_records);
+  node->evaluate(unique_records, unique_values_.ref(0, num_unique_records));
+  for (size_t i = 0; i < records.size(); ++i) {
+    results[i] = unique_values_[unique_ids_[i]];
+  }
+}
+
+template <typename T>
+bool Gatherer<T>::is_sort_preferred(const Table *table,
+                                    const TypedNode<Value> *node,
+                                    size_t num_records) {
+  if (num_records < MIN_SORTED_GATHER_SIZE) {
+    return false;
+  }
+  switch (node->node_type()) {
+    case COLUMN_NODE: {
+      // Reading a column pays off only if it does not fit in the cache.
+      if (table->max_row_id().is_na()) {
+        return false;
+      }
+      size_t table_size = table->max_row_id().raw() + 1;
+      return (table_size * ValueFootprint<Value>::value) > get_cache_size();
+    }
+    case OPERATOR_NODE: {
+      // Deduplication saves evaluation of the subtree.
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
 // ---- DereferenceNode ----
 
+// Copy "columns" to "*new_columns".
+//
+// On failure, throws an exception.
+void copy_columns(ArrayCRef<const ColumnBase *> columns,
+                  Array<const ColumnBase *> *new_columns) {
+  new_columns->resize(columns.size());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    (*new_columns)[i] = columns[i];
+  }
+}
+
 template <typename T>
 class DereferenceNode : public BinaryNode<T, Int, T> {
  public:
@@ -1420,20 +2466,43 @@ class DereferenceNode : public BinaryNode<T, Int, T> {
   using Arg1 = Int;
   using Arg2 = T;
 
+  // "columns" must be the columns read by "arg2".
   DereferenceNode(std::unique_ptr<Node> &&arg1,
-                  std::unique_ptr<Node> &&arg2)
+                  std::unique_ptr<Node> &&arg2,
+                  ArrayCRef<const ColumnBase *> columns)
       : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)),
-        temp_records_() {}
+        temp_records_(),
+        gatherer_(),
+        columns_() {
+    copy_columns(columns, &columns_);
+  }
   ~DereferenceNode() = default;
 
   const Table *reference_table() const {
     return this->arg1_->reference_table();
   }
+  size_t buffer_size() const {
+    return sizeof(Record) + BinaryNode<Value, Arg1, Arg2>::buffer_size();
+  }
+  void prefetch(ArrayCRef<Record> records) {
+    // "arg2_" is evaluated for referenced rows.
+    this->arg1_->prefetch(records);
+  }
+  bool release_dereference(std::unique_ptr<Node> *arg1,
+                           std::unique_ptr<Node> *arg2,
+                           Array<const ColumnBase *> *columns) {
+    arg1->reset(this->arg1_.release());
+    arg2->reset(this->arg2_.release());
+    *columns = std::move(columns_);
+    return true;
+  }
 
   void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
 
  private:
   Array<Record> temp_records_;
+  Gatherer<Arg2> gatherer_;
+  Array<const ColumnBase *> columns_;
 };
 
 template <typename T>
@@ -1447,7 +2516,207 @@ void DereferenceNode<T>::evaluate(ArrayCRef<Record> records,
     temp_records_[i].row_id = this->arg1_values_[i];
     temp_records_[i].score = records[i].score;
   }
-  this->arg2_->evaluate(temp_records_.ref(0, records.size()), results);
+  gatherer_.gather(reference_table(), this->arg2_.get(),
+                   temp_records_.cref(0, records.size()), results);
+}
+
+// The number of referenced rows filtered at once for a semi-join.
+constexpr size_t SEMI_JOIN_BLOCK_SIZE = 1024;
+
+// A filter on a referenced table is evaluated as a semi-join once more
+// records have been probed than the referenced table has rows.
+// Then, the referenced table is filtered once into a bitmap and the input
+// records are filtered by probing the bitmap with references.
+//
+// prepare() is called per block, so the bitmap is kept until the referenced
+// table or a column read by the filter is updated.
+template <>
+class DereferenceNode<Bool> : public BinaryNode<Bool, Int, Bool> {
+ public:
+  using Value = Bool;
+  using Arg1 = Int;
+  using Arg2 = Bool;
+
+  // "columns" must be the columns read by "arg2".
+  DereferenceNode(std::unique_ptr<Node> &&arg1,
+                  std::unique_ptr<Node> &&arg2,
+                  ArrayCRef<const ColumnBase *> columns)
+      : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)),
+        temp_records_(),
+        gatherer_(),
+        columns_(),
+        bitmap_(),
+        na_result_(false),
+        is_semi_join_(false),
+        num_probes_(0),
+        revisions_() {
+    copy_columns(columns, &columns_);
+  }
+  ~DereferenceNode() = default;
+
+  const Table *reference_table() const {
+    return arg1_->reference_table();
+  }
+  size_t buffer_size() const {
+    return sizeof(Record) + BinaryNode<Value, Arg1, Arg2>::buffer_size();
+  }
+  void prefetch(ArrayCRef<Record> records) {
+    // "arg2_" is evaluated for referenced rows.
+    arg1_->prefetch(records);
+  }
+  void prepare(size_t num_records);
+  bool release_dereference(std::unique_ptr<Node> *arg1,
+                           std::unique_ptr<Node> *arg2,
+                           Array<const ColumnBase *> *columns) {
+    arg1->reset(arg1_.release());
+    arg2->reset(arg2_.release());
+    *columns = std::move(columns_);
+    return true;
+  }
+
+  void filter(ArrayCRef<Record> input_records,
+              ArrayRef<Record> *output_records);
+  void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
+
+ private:
+  Array<Record> temp_records_;
+  Gatherer<Arg2> gatherer_;
+  Array<const ColumnBase *> columns_;
+  Array<uint64_t> bitmap_;
+  bool na_result_;
+  bool is_semi_join_;
+  // The number of records probed since the referenced rows were updated.
+  size_t num_probes_;
+  // The revisions of the referenced table and "columns_".
+  Array<uint64_t> revisions_;
+
+  // Update "revisions_".
+  //
+  // If the revisions are changed, returns true.
+  // Otherwise, returns false.
+  //
+  // On failure, throws an exception.
+  bool update_revisions();
+  // Filter the referenced table and store the results into "bitmap_".
+  void build_bitmap();
+};
+
+void DereferenceNode<Bool>::prepare(size_t num_records) {
+  arg1_->prepare(num_records);
+  if (arg2_->depends_on_score()) {
+    is_semi_join_ = false;
+    arg2_->prepare(num_records);
+    return;
+  }
+  if (update_revisions()) {
+    is_semi_join_ = false;
+    num_probes_ = 0;
+  }
+  if (is_semi_join_) {
+    return;
+  }
+  // The bitmap costs as much as probing all the referenced rows, so it is
+  // built after as many records are probed without it.
+  size_t num_parent_rows = reference_table()->num_rows();
+  num_probes_ += num_records;
+  if (num_probes_ <= num_parent_rows) {
+    arg2_->prepare(num_records);
+    return;
+  }
+  arg2_->prepare(num_parent_rows);
+  build_bitmap();
+  is_semi_join_ = true;
+}
+
+bool DereferenceNode<Bool>::update_revisions() {
+  size_t size = 1 + (columns_.size() * 2);
+  bool is_updated = (revisions_.size() != size);
+  if (is_updated) {
+    revisions_.resize(size);
+  }
+  // Inserting and removing rows update the table revisions.
+  uint64_t revision = reference_table()->revision();
+  is_updated |= (revisions_[0] != revision);
+  revisions_[0] = revision;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    revision = columns_[i]->_table()->revision();
+    is_updated |= (revisions_[(i * 2) + 1] != revision);
+    revisions_[(i * 2) + 1] = revision;
+    revision = columns_[i]->revision();
+    is_updated |= (revisions_[(i * 2) + 2] != revision);
+    revisions_[(i * 2) + 2] = revision;
+  }
+  return is_updated;
+}
+
+void DereferenceNode<Bool>::filter(ArrayCRef<Record> input_records,
+                                   ArrayRef<Record> *output_records) {
+  if (!is_semi_join_) {
+    TypedNode<Bool>::filter(input_records, output_records);
+    return;
+  }
+  fill_arg1_values(input_records);
+  size_t bitmap_size = bitmap_.size() * 64;
+  size_t count = 0;
+  for (size_t i = 0; i < input_records.size(); ++i) {
+    bool is_hit;
+    if (arg1_values_[i].is_na()) {
+      is_hit = na_result_;
+    } else {
+      size_t row_id = arg1_values_[i].raw();
+      is_hit = (row_id < bitmap_size) &&
+               ((bitmap_[row_id / 64] >> (row_id % 64)) & 1);
+    }
+    if (is_hit) {
+      (*output_records)[count] = input_records[i];
+      ++count;
+    }
+  }
+  *output_records = output_records->ref(0, count);
+}
+
+void DereferenceNode<Bool>::evaluate(ArrayCRef<Record> records,
+                                     ArrayRef<Value> results) {
+  fill_arg1_values(records);
+  if (temp_records_.size() < records.size()) {
+    temp_records_.resize(records.size());
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    temp_records_[i].row_id = arg1_values_[i];
+    temp_records_[i].score = records[i].score;
+  }
+  gatherer_.gather(reference_table(), arg2_.get(),
+                   temp_records_.cref(0, records.size()), results);
+}
+
+void DereferenceNode<Bool>::build_bitmap() {
+  const Table *table = reference_table();
+  size_t table_size = table->max_row_id().is_na() ?
+                      0 : (table->max_row_id().raw() + 1);
+  bitmap_.resize((table_size + 63) / 64);
+  for (size_t i = 0; i < bitmap_.size(); ++i) {
+    bitmap_[i] = 0;
+  }
+  auto cursor = table->create_cursor(CursorOptions());
+  Array<Record> records;
+  for ( ; ; ) {
+    records.clear();
+    if (cursor->read(SEMI_JOIN_BLOCK_SIZE, &records) == 0) {
+      break;
+    }
+    ArrayRef<Record> output = records.ref();
+    arg2_->filter(records, &output);
+    for (size_t i = 0; i < output.size(); ++i) {
+      size_t row_id = output[i].row_id.raw();
+      bitmap_[row_id / 64] |= uint64_t(1) << (row_id % 64);
+    }
+  }
+  // A N/A reference is evaluated as is.
+  Record na_record(Int::na(), Float(0.0));
+  Value na_value;
+  arg2_->evaluate(ArrayCRef<Record>(&na_record, 1),
+                  ArrayRef<Value>(&na_value, 1));
+  na_result_ = na_value.is_true();
 }
 
 // ---- VectorDereferenceNode ----
@@ -1465,18 +2734,33 @@ class VectorDereferenceNode : public BinaryNode<Vector<T>, Vector<Int>, T> {
       : BinaryNode<Value, Arg1, Arg2>(std::move(arg1), std::move(arg2)),
         temp_records_(),
         result_pools_(),
-        block_size_(options.block_size) {}
+        gatherer_(),
+        block_size_(options.block_size) {
+    if (block_size_ == 0) {
+      block_size_ = choose_block_size(
+          sizeof(Record) + ValueFootprint<Arg2>::value +
+          this->arg2_->buffer_size());
+    }
+  }
   ~VectorDereferenceNode() = default;
 
   const Table *reference_table() const {
     return this->arg1_->reference_table();
   }
+  size_t buffer_size() const {
+    return sizeof(Record) + BinaryNode<Value, Arg1, Arg2>::buffer_size();
+  }
+  void prefetch(ArrayCRef<Record> records) {
+    // "arg2_" is evaluated for referenced rows.
+    this->arg1_->prefetch(records);
+  }
 
   void evaluate(ArrayCRef<Record> records, ArrayRef<Value> results);
 
  private:
   Array<Record> temp_records_;
   Array<Array<Arg2>> result_pools_;
+  Gatherer<Arg2> gatherer_;
   size_t block_size_;
 };
 
@@ -1489,43 +2773,137 @@ void VectorDereferenceNode<T>::evaluate(ArrayCRef<Record> records,
     if (!this->arg1_values_[i].is_na()) {
       total_size += this->arg1_values_[i].raw_size();
     }
-  }
-  temp_records_.resize(block_size_);
-  Array<Arg2> result_pool;
-  result_pool.resize(total_size);
-  size_t offset = 0;
-  size_t count = 0;
-  for (size_t i = 0; i < records.size(); ++i) {
-    if (this->arg1_values_[i].is_na()) {
-      continue;
+  }
+  temp_records_.resize(block_size_);
+  Array<Arg2> result_pool;
+  result_pool.resize(total_size);
+  size_t offset = 0;
+  size_t count = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (this->arg1_values_[i].is_na()) {
+      continue;
+    }
+    Float score = records[i].score;
+    size_t value_size = this->arg1_values_[i].raw_size();
+    for (size_t j = 0; j < value_size; ++j) {
+      temp_records_[count] = Record(this->arg1_values_[i][j], score);
+      ++count;
+      if (count >= block_size_) {
+        gatherer_.gather(reference_table(), this->arg2_.get(),
+                         temp_records_, result_pool.ref(offset, count));
+        offset += count;
+        count = 0;
+      }
+    }
+  }
+  if (count != 0) {
+    gatherer_.gather(reference_table(), this->arg2_.get(),
+                     temp_records_.cref(0, count),
+                     result_pool.ref(offset, count));
+  }
+  offset = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (this->arg1_values_[i].is_na()) {
+      results[i] = Value::na();
+    } else {
+      size_t size = this->arg1_values_[i].raw_size();
+      results[i] = Value(&result_pool[offset], size);
+      offset += size;
+    }
+  }
+  result_pools_.push_back(std::move(result_pool));
+}
+
+// -- Description --
+
+// A description consists of tokens appended in the order of the builder
+// operations, and the size of each variable-length token is stored in front
+// of it, so that different sequences of operations never have the same
+// description.
+
+// Append the bytes of "value" to "description".
+template <typename T>
+void append_bytes(const T &value, String *description) {
+  description->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void append_value(Bool value, String *description) {
+  append_bytes(value.raw(), description);
+}
+void append_value(Int value, String *description) {
+  append_bytes(value.raw(), description);
+}
+void append_value(Float value, String *description) {
+  append_bytes(value.raw(), description);
+}
+void append_value(GeoPoint value, String *description) {
+  append_bytes(value.raw_latitude(), description);
+  append_bytes(value.raw_longitude(), description);
+}
+void append_value(const Text &value, String *description) {
+  append_bytes(value.size().raw(), description);
+  if (!value.is_na()) {
+    description->append(value.raw_data(), value.raw_size());
+  }
+}
+template <typename T>
+void append_value(const Vector<T> &value, String *description) {
+  append_bytes(value.size().raw(), description);
+  size_t size = value.is_na() ? 0 : value.raw_size();
+  for (size_t i = 0; i < size; ++i) {
+    append_value(value[Int(i)], description);
+  }
+}
+
+// Append the type and the value of "datum" to "description".
+void append_datum(const Datum &datum, String *description) {
+  append_bytes(datum.type(), description);
+  switch (datum.type()) {
+    case GRNXX_BOOL: {
+      return append_value(datum.as_bool(), description);
+    }
+    case GRNXX_INT: {
+      return append_value(datum.as_int(), description);
+    }
+    case GRNXX_FLOAT: {
+      return append_value(datum.as_float(), description);
+    }
+    case GRNXX_GEO_POINT: {
+      return append_value(datum.as_geo_point(), description);
+    }
+    case GRNXX_TEXT: {
+      return append_value(datum.as_text(), description);
+    }
+    case GRNXX_BOOL_VECTOR: {
+      return append_value(datum.as_bool_vector(), description);
+    }
+    case GRNXX_INT_VECTOR: {
+      return append_value(datum.as_int_vector(), description);
+    }
+    case GRNXX_FLOAT_VECTOR: {
+      return append_value(datum.as_float_vector(), description);
+    }
+    case GRNXX_GEO_POINT_VECTOR: {
+      return append_value(datum.as_geo_point_vector(), description);
+    }
+    case GRNXX_TEXT_VECTOR: {
+      return append_value(datum.as_text_vector(), description);
     }
-    Float score = records[i].score;
-    size_t value_size = this->arg1_values_[i].raw_size();
-    for (size_t j = 0; j < value_size; ++j) {
-      temp_records_[count] = Record(this->arg1_values_[i][j], score);
-      ++count;
-      if (count >= block_size_) {
-        this->arg2_->evaluate(temp_records_, result_pool.ref(offset, count));
-        offset += count;
-        count = 0;
-      }
+    default: {
+      return;
     }
   }
-  if (count != 0) {
-    this->arg2_->evaluate(temp_records_.ref(0, count),
-                          result_pool.ref(offset, count));
-  }
-  offset = 0;
-  for (size_t i = 0; i < records.size(); ++i) {
-    if (this->arg1_values_[i].is_na()) {
-      results[i] = Value::na();
-    } else {
-      size_t size = this->arg1_values_[i].raw_size();
-      results[i] = Value(&result_pool[offset], size);
-      offset += size;
+}
+
+// Append "column" to "columns" unless it is already included.
+void append_column(const ColumnBase *column,
+                   Array<const ColumnBase *> *columns) {
+  for (size_t i = 0; i < columns->size(); ++i) {
+    if ((*columns)[i] == column) {
+      return;
     }
   }
-  result_pools_.push_back(std::move(result_pool));
+  columns->push_back(column);
 }
 
 }  // namespace expression
@@ -1536,11 +2914,69 @@ using namespace expression;
 
 Expression::Expression(const Table *table,
                        std::unique_ptr<Node> &&root,
-                       const ExpressionOptions &options)
+                       const ExpressionOptions &options,
+                       String &&description,
+                       Array<const ColumnBase *> &&columns)
     : ExpressionInterface(),
       table_(table),
       root_(std::move(root)),
-      block_size_(options.block_size) {}
+      block_size_(options.block_size),
+      uses_zone_maps_(root_->uses_zone_maps()),
+      description_(std::move(description)),
+      columns_(std::move(columns)) {
+  if (block_size_ == 0) {
+    // Input records, results and intermediate buffers are evaluated per
+    // block, so all of them should fit in the cache.
+    size_t result_size = 0;
+    switch (data_type()) {
+      case GRNXX_BOOL: {
+        result_size = ValueFootprint<Bool>::value;
+        break;
+      }
+      case GRNXX_INT: {
+        result_size = ValueFootprint<Int>::value;
+        break;
+      }
+      case GRNXX_FLOAT: {
+        result_size = ValueFootprint<Float>::value;
+        break;
+      }
+      case GRNXX_GEO_POINT: {
+        result_size = ValueFootprint<GeoPoint>::value;
+        break;
+      }
+      case GRNXX_TEXT: {
+        result_size = ValueFootprint<Text>::value;
+        break;
+      }
+      case GRNXX_BOOL_VECTOR: {
+        result_size = ValueFootprint<Vector<Bool>>::value;
+        break;
+      }
+      case GRNXX_INT_VECTOR: {
+        result_size = ValueFootprint<Vector<Int>>::value;
+        break;
+      }
+      case GRNXX_FLOAT_VECTOR: {
+        result_size = ValueFootprint<Vector<Float>>::value;
+        break;
+      }
+      case GRNXX_GEO_POINT_VECTOR: {
+        result_size = ValueFootprint<Vector<GeoPoint>>::value;
+        break;
+      }
+      case GRNXX_TEXT_VECTOR: {
+        result_size = ValueFootprint<Vector<Text>>::value;
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+    block_size_ = choose_block_size(
+        sizeof(Record) + result_size + root_->buffer_size());
+  }
+}
 
 Expression::~Expression() {}
 
@@ -1560,7 +2996,9 @@ void Expression::filter(Array<Record> *records,
                         size_t input_offset,
                         size_t output_offset,
                         size_t output_limit) {
+  root_->release_results();
   ArrayCRef<Record> input = records->cref(input_offset);
+  root_->prepare(input.size());
   ArrayRef<Record> output = records->ref(input_offset);
   size_t count = 0;
   while ((input.size() > 0) && (output_limit > 0)) {
@@ -1568,7 +3006,7 @@ void Expression::filter(Array<Record> *records,
                        input.size() : block_size_;
     ArrayCRef<Record> next_input = input.cref(0, next_size);
     ArrayRef<Record> next_output = output.ref(0, next_size);
-    root_->filter(next_input, &next_output);
+    filter_block(next_input, &next_output);
     input = input.cref(next_size);
 
     if (output_offset > 0) {
@@ -1596,18 +3034,20 @@ void Expression::filter(Array<Record> *records,
 
 void Expression::filter(ArrayCRef<Record> input_records,
                         ArrayRef<Record> *output_records) {
+  root_->release_results();
   ArrayCRef<Record> input = input_records;
+  root_->prepare(input.size());
   ArrayRef<Record> output = *output_records;
   size_t count = 0;
   while (input.size() > block_size_) {
     ArrayCRef<Record> input_block = input.cref(0, block_size_);
     ArrayRef<Record> output_block = output.ref(0, block_size_);
-    root_->filter(input_block, &output_block);
+    filter_block(input_block, &output_block);
     input = input.cref(block_size_);
     output = output.ref(output_block.size());
     count += output_block.size();
   }
-  root_->filter(input, &output);
+  filter_block(input, &output);
   count += output.size();
   *output_records = output_records->ref(0, count);
 }
@@ -1616,7 +3056,9 @@ void Expression::filter(ArrayCRef<Record> input_records,
                         ArrayRef<Record> *output_records,
                         size_t offset,
                         size_t limit) {
+  root_->release_results();
   ArrayCRef<Record> input = input_records;
+  root_->prepare(input.size());
   ArrayRef<Record> output = *output_records;
   size_t count = 0;
   while ((input.size() > 0) && (limit > 0)) {
@@ -1624,7 +3066,7 @@ void Expression::filter(ArrayCRef<Record> input_records,
                        input.size() : block_size_;
     ArrayCRef<Record> next_input = input.cref(0, next_size);
     ArrayRef<Record> next_output = output.ref(0, next_size);
-    root_->filter(next_input, &next_output);
+    filter_block(next_input, &next_output);
     input = input.cref(next_size);
 
     if (offset > 0) {
@@ -1650,15 +3092,76 @@ void Expression::filter(ArrayCRef<Record> input_records,
   *output_records = output_records->ref(0, count);
 }
 
+bool Expression::can_skip_zone(size_t zone_id) const {
+  return uses_zone_maps_ && root_->can_skip_zone(zone_id);
+}
+
+bool Expression::get_conditions(
+    Array<ExpressionCondition> *conditions) const {
+  conditions->clear();
+  return root_->get_conditions(conditions);
+}
+
+const ColumnBase *Expression::column() const {
+  if (root_->node_type() != COLUMN_NODE) {
+    return nullptr;
+  }
+  switch (root_->data_type()) {
+    case GRNXX_INT: {
+      return static_cast<const ColumnNode<Int> *>(root_.get())->column();
+    }
+    case GRNXX_FLOAT: {
+      return static_cast<const ColumnNode<Float> *>(root_.get())->column();
+    }
+    case GRNXX_TEXT: {
+      return static_cast<const ColumnNode<Text> *>(root_.get())->column();
+    }
+    default: {
+      return nullptr;
+    }
+  }
+}
+
+void Expression::filter_block(ArrayCRef<Record> input_records,
+                              ArrayRef<Record> *output_records) {
+  // Intermediate results are not used after the block.
+  root_->release_results();
+  if (!uses_zone_maps_) {
+    root_->filter(input_records, output_records);
+    return;
+  }
+  // Drop records in zones which never satisfy the expression.
+  // Records are mostly in row ID order, so the last decision is reused.
+  size_t zone_id = std::numeric_limits<size_t>::max();
+  bool is_skipped = false;
+  size_t count = 0;
+  for (size_t i = 0; i < input_records.size(); ++i) {
+    size_t next_zone_id = input_records[i].row_id.raw() / ZONE_SIZE;
+    if (next_zone_id != zone_id) {
+      zone_id = next_zone_id;
+      is_skipped = root_->can_skip_zone(zone_id);
+    }
+    if (!is_skipped) {
+      (*output_records)[count] = input_records[i];
+      ++count;
+    }
+  }
+  *output_records = output_records->ref(0, count);
+  // "output_records" never exceeds the input, so filtering in place is safe.
+  root_->filter(*output_records, output_records);
+}
+
 void Expression::adjust(Array<Record> *records, size_t offset) {
   adjust(records->ref(offset));
 }
 
 void Expression::adjust(ArrayRef<Record> records) {
   while (records.size() > block_size_) {
+    root_->release_results();
     root_->adjust(records.ref(0, block_size_));
     records = records.ref(block_size_);
   }
+  root_->release_results();
   root_->adjust(records);
 }
 
@@ -1776,6 +3279,10 @@ void Expression::_evaluate(ArrayCRef<Record> records, ArrayRef<T> results) {
   if (records.size() != results.size()) {
     throw "Size conflict";  // TODO
   }
+  root_->release_results();
+  // Int vectors may refer to decoded values which must be kept alive until
+  // the next call, while other intermediate results are released per block.
+  bool keeps_results = (T::type() == GRNXX_INT_VECTOR);
   TypedNode<T> *typed_root = static_cast<TypedNode<T> *>(root_.get());
   while (records.size() > block_size_) {
     ArrayCRef<Record> input = records.cref(0, block_size_);
@@ -1783,6 +3290,9 @@ void Expression::_evaluate(ArrayCRef<Record> records, ArrayRef<T> results) {
     typed_root->evaluate(input, output);
     records = records.cref(block_size_);
     results = results.ref(block_size_);
+    if (!keeps_results) {
+      root_->release_results();
+    }
   }
   typed_root->evaluate(records, results);
 }
@@ -1793,7 +3303,9 @@ ExpressionBuilder::ExpressionBuilder(const Table *table)
     : ExpressionBuilderInterface(),
       table_(table),
       node_stack_(),
-      subexpression_builder_() {}
+      subexpression_builder_(),
+      description_(),
+      columns_() {}
 
 ExpressionBuilder::~ExpressionBuilder() {}
 
@@ -1802,6 +3314,8 @@ void ExpressionBuilder::push_constant(const Datum &datum) {
     subexpression_builder_->push_constant(datum);
   } else {
     node_stack_.push_back(std::unique_ptr<Node>(create_constant_node(datum)));
+    description_.append('C');
+    append_datum(datum, &description_);
   }
 }
 
@@ -1810,6 +3324,7 @@ void ExpressionBuilder::push_row_id() try {
     subexpression_builder_->push_row_id();
   } else {
     node_stack_.push_back(std::unique_ptr<Node>(new RowIDNode()));
+    description_.append('I');
   }
 } catch (const std::bad_alloc &) {
   throw "Memory allocation failed";  // TODO
@@ -1820,6 +3335,7 @@ void ExpressionBuilder::push_score() try {
     subexpression_builder_->push_score();
   } else {
     node_stack_.push_back(std::unique_ptr<Node>(new ScoreNode()));
+    description_.append('S');
   }
 } catch (const std::bad_alloc &) {
   throw "Memory allocation failed";  // TODO
@@ -1834,6 +3350,9 @@ void ExpressionBuilder::push_column(const String &name) {
       throw "Column not found";  // TODO
     }
     node_stack_.push_back(std::unique_ptr<Node>(create_column_node(column)));
+    description_.append('K');
+    append_value(Text(name), &description_);
+    append_column(column, &columns_);
   }
 }
 
@@ -1848,7 +3367,8 @@ void ExpressionBuilder::push_operator(OperatorType operator_type) {
       case GRNXX_NEGATIVE:
       case GRNXX_TO_INT:
       case GRNXX_TO_FLOAT: {
-        return push_unary_operator(operator_type);
+        push_unary_operator(operator_type);
+        break;
       }
       case GRNXX_LOGICAL_AND:
       case GRNXX_LOGICAL_OR:
@@ -1869,13 +3389,22 @@ void ExpressionBuilder::push_operator(OperatorType operator_type) {
       case GRNXX_STARTS_WITH:
       case GRNXX_ENDS_WITH:
       case GRNXX_CONTAINS:
-      case GRNXX_SUBSCRIPT: {
-        return push_binary_operator(operator_type);
+      case GRNXX_SUBSCRIPT:
+      case GRNXX_GEO_DISTANCE: {
+        push_binary_operator(operator_type);
+        break;
+      }
+      case GRNXX_GEO_WITHIN_RECTANGLE:
+      case GRNXX_GEO_WITHIN_CIRCLE: {
+        push_ternary_operator(operator_type);
+        break;
       }
       default: {
         throw "Not supported yet";  // TODO
       }
     }
+    description_.append('O');
+    append_bytes(operator_type, &description_);
   }
 }
 
@@ -1907,7 +3436,15 @@ void ExpressionBuilder::end_subexpression(const ExpressionOptions &options) {
       throw "Incomplete subexpression";  // TODO
     }
     node_stack_.push_back(std::move(subexpression_builder_->node_stack_[0]));
-    push_dereference(options);
+    push_dereference(subexpression_builder_->columns_, options);
+    // The subexpression is appended with its size.
+    const String &description = subexpression_builder_->description_;
+    description_.append('D');
+    append_bytes(description.size(), &description_);
+    description_.append(description);
+    for (size_t i = 0; i < subexpression_builder_->columns_.size(); ++i) {
+      append_column(subexpression_builder_->columns_[i], &columns_);
+    }
     subexpression_builder_.reset();
   }
 }
@@ -1915,6 +3452,8 @@ void ExpressionBuilder::end_subexpression(const ExpressionOptions &options) {
 void ExpressionBuilder::clear() {
   node_stack_.clear();
   subexpression_builder_.reset();
+  description_.clear();
+  columns_.clear();
 }
 
 std::unique_ptr<ExpressionInterface> ExpressionBuilder::release(
@@ -1927,8 +3466,12 @@ std::unique_ptr<ExpressionInterface> ExpressionBuilder::release(
   }
   std::unique_ptr<Node> root = std::move(node_stack_[0]);
   node_stack_.clear();
-  return std::unique_ptr<ExpressionInterface>(
-      new Expression(table_, std::move(root), options));
+  std::unique_ptr<ExpressionInterface> expression(
+      new Expression(table_, std::move(root), options,
+                     std::move(description_), std::move(columns_)));
+  // NOTE: A moved String still refers to the moved buffer.
+  description_ = String();
+  return expression;
 } catch (const std::bad_alloc &) {
   throw "Memory allocation failed";  // TODO
 }
@@ -1951,20 +3494,75 @@ void ExpressionBuilder::push_binary_operator(OperatorType operator_type) {
   std::unique_ptr<Node> arg1 = std::move(node_stack_[node_stack_.size() - 2]);
   std::unique_ptr<Node> arg2 = std::move(node_stack_[node_stack_.size() - 1]);
   node_stack_.resize(node_stack_.size() - 2);
+  switch (operator_type) {
+    case GRNXX_EQUAL:
+    case GRNXX_NOT_EQUAL:
+    case GRNXX_LESS:
+    case GRNXX_LESS_EQUAL:
+    case GRNXX_GREATER:
+    case GRNXX_GREATER_EQUAL: {
+      // "ref.(x) op constant" is evaluated as "ref.(x op constant)", so
+      // that the comparison can be a semi-join.
+      std::unique_ptr<Node> reference;
+      std::unique_ptr<Node> subexpression;
+      Array<const ColumnBase *> columns;
+      if ((arg2->node_type() == CONSTANT_NODE) &&
+          arg1->release_dereference(&reference, &subexpression, &columns)) {
+        node_stack_.push_back(std::move(reference));
+        node_stack_.push_back(std::move(subexpression));
+        node_stack_.push_back(std::move(arg2));
+        push_binary_operator(operator_type);
+        push_dereference(columns, ExpressionOptions());
+        return;
+      }
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+  // The arguments are owned by the new node, but still valid.
+  const Node *arg1_node = arg1.get();
+  const Node *arg2_node = arg2.get();
   std::unique_ptr<Node> node(
       create_binary_node(operator_type, std::move(arg1), std::move(arg2)));
+  node.reset(create_zone_map_node(operator_type, std::move(node),
+                                  arg1_node, arg2_node));
+  node.reset(create_index_node(operator_type, std::move(node),
+                               arg1_node, arg2_node));
+  node_stack_.push_back(std::move(node));
+}
+
+void ExpressionBuilder::push_ternary_operator(OperatorType operator_type) {
+  if (node_stack_.size() < 3) {
+    throw "Not enough operands";  // TODO
+  }
+  std::unique_ptr<Node> arg1 = std::move(node_stack_[node_stack_.size() - 3]);
+  std::unique_ptr<Node> arg2 = std::move(node_stack_[node_stack_.size() - 2]);
+  std::unique_ptr<Node> arg3 = std::move(node_stack_[node_stack_.size() - 1]);
+  node_stack_.resize(node_stack_.size() - 3);
+  // The arguments are owned by the new node, but still valid.
+  const Node *arg1_node = arg1.get();
+  const Node *arg2_node = arg2.get();
+  const Node *arg3_node = arg3.get();
+  std::unique_ptr<Node> node(create_ternary_node(
+      operator_type, std::move(arg1), std::move(arg2), std::move(arg3)));
+  node.reset(create_geo_index_node(operator_type, std::move(node),
+                                   arg1_node, arg2_node, arg3_node));
   node_stack_.push_back(std::move(node));
 }
 
-void ExpressionBuilder::push_dereference(const ExpressionOptions &options) {
+void ExpressionBuilder::push_dereference(
+    ArrayCRef<const ColumnBase *> columns,
+    const ExpressionOptions &options) {
   if (node_stack_.size() < 2) {
     throw "Not enough operands";  // TODO
   }
   std::unique_ptr<Node> arg1 = std::move(node_stack_[node_stack_.size() - 2]);
   std::unique_ptr<Node> arg2 = std::move(node_stack_[node_stack_.size() - 1]);
   node_stack_.resize(node_stack_.size() - 2);
-  std::unique_ptr<Node> node(
-      create_dereference_node(std::move(arg1), std::move(arg2), options));
+  std::unique_ptr<Node> node(create_dereference_node(
+      std::move(arg1), std::move(arg2), columns, options));
   node_stack_.push_back(std::move(node));
 }
 
@@ -2168,6 +3766,17 @@ Node *ExpressionBuilder::create_binary_node(
             operator_type, std::move(arg1), std::move(arg2));
         }
         case GRNXX_TEXT: {
+          if ((arg1->node_type() == CONSTANT_NODE) &&
+              (arg2->node_type() == COLUMN_NODE)) {
+            arg1.swap(arg2);
+          }
+          if (is_dictionary_encoded_column_node(arg1.get()) &&
+              (arg2->node_type() == CONSTANT_NODE) &&
+              (arg2->data_type() == GRNXX_TEXT)) {
+            return new DictionaryEqualNode(
+                std::move(arg1), std::move(arg2),
+                operator_type == GRNXX_NOT_EQUAL);
+          }
           return create_equality_test_node<Text>(
             operator_type, std::move(arg1), std::move(arg2));
         }
@@ -2259,10 +3868,35 @@ Node *ExpressionBuilder::create_binary_node(
     case GRNXX_CONTAINS: {
       switch (arg1->data_type()) {
         case GRNXX_TEXT: {
+          if ((arg1->node_type() == COLUMN_NODE) &&
+              (arg2->node_type() == CONSTANT_NODE) &&
+              (arg2->data_type() == GRNXX_TEXT)) {
+            return new TextPatternNode(
+                operator_type, std::move(arg1), std::move(arg2));
+          }
           return create_search_node<Text>(
               operator_type, std::move(arg1), std::move(arg2));
         }
-        // TODO: Search nodes can support Vector.
+        case GRNXX_BOOL_VECTOR: {
+          return create_membership_node<Bool>(
+              operator_type, std::move(arg1), std::move(arg2));
+        }
+        case GRNXX_INT_VECTOR: {
+          return create_membership_node<Int>(
+              operator_type, std::move(arg1), std::move(arg2));
+        }
+        case GRNXX_FLOAT_VECTOR: {
+          return create_membership_node<Float>(
+              operator_type, std::move(arg1), std::move(arg2));
+        }
+        case GRNXX_GEO_POINT_VECTOR: {
+          return create_membership_node<GeoPoint>(
+              operator_type, std::move(arg1), std::move(arg2));
+        }
+        case GRNXX_TEXT_VECTOR: {
+          return create_membership_node<Text>(
+              operator_type, std::move(arg1), std::move(arg2));
+        }
         default: {
           throw "Invalid data type";  // TODO
         }
@@ -2271,6 +3905,45 @@ Node *ExpressionBuilder::create_binary_node(
     case GRNXX_SUBSCRIPT: {
       return create_subscript_node(std::move(arg1), std::move(arg2));
     }
+    case GRNXX_GEO_DISTANCE: {
+      if ((arg1->data_type() != GRNXX_GEO_POINT) ||
+          (arg2->data_type() != GRNXX_GEO_POINT)) {
+        throw "Invalid data type";  // TODO
+      }
+      return new GeoDistanceNode(std::move(arg1), std::move(arg2));
+    }
+    default: {
+      throw "Not supported yet";  // TODO
+    }
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+Node *ExpressionBuilder::create_ternary_node(
+    OperatorType operator_type,
+    std::unique_ptr<Node> &&arg1,
+    std::unique_ptr<Node> &&arg2,
+    std::unique_ptr<Node> &&arg3) try {
+  switch (operator_type) {
+    case GRNXX_GEO_WITHIN_RECTANGLE: {
+      if ((arg1->data_type() != GRNXX_GEO_POINT) ||
+          (arg2->data_type() != GRNXX_GEO_POINT) ||
+          (arg3->data_type() != GRNXX_GEO_POINT)) {
+        throw "Invalid data type";  // TODO
+      }
+      return new GeoWithinRectangleNode(
+          std::move(arg1), std::move(arg2), std::move(arg3));
+    }
+    case GRNXX_GEO_WITHIN_CIRCLE: {
+      if ((arg1->data_type() != GRNXX_GEO_POINT) ||
+          (arg2->data_type() != GRNXX_GEO_POINT) ||
+          (arg3->data_type() != GRNXX_FLOAT)) {
+        throw "Invalid data type";  // TODO
+      }
+      return new GeoWithinCircleNode(
+          std::move(arg1), std::move(arg2), std::move(arg3));
+    }
     default: {
       throw "Not supported yet";  // TODO
     }
@@ -2279,6 +3952,194 @@ Node *ExpressionBuilder::create_binary_node(
   throw "Memory allocation failed";  // TODO
 }
 
+Node *ExpressionBuilder::create_zone_map_node(
+    OperatorType operator_type,
+    std::unique_ptr<Node> &&node,
+    const Node *arg1,
+    const Node *arg2) try {
+  if ((arg1->node_type() == CONSTANT_NODE) &&
+      (arg2->node_type() == COLUMN_NODE)) {
+    // "value op column" is rewritten as "column op' value".
+    std::swap(arg1, arg2);
+    switch (operator_type) {
+      case GRNXX_LESS: {
+        operator_type = GRNXX_GREATER;
+        break;
+      }
+      case GRNXX_LESS_EQUAL: {
+        operator_type = GRNXX_GREATER_EQUAL;
+        break;
+      }
+      case GRNXX_GREATER: {
+        operator_type = GRNXX_LESS;
+        break;
+      }
+      case GRNXX_GREATER_EQUAL: {
+        operator_type = GRNXX_LESS_EQUAL;
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+  if ((arg1->node_type() != COLUMN_NODE) ||
+      (arg2->node_type() != CONSTANT_NODE)) {
+    return node.release();
+  }
+  switch (operator_type) {
+    case GRNXX_EQUAL:
+    case GRNXX_NOT_EQUAL:
+    case GRNXX_LESS:
+    case GRNXX_LESS_EQUAL:
+    case GRNXX_GREATER:
+    case GRNXX_GREATER_EQUAL: {
+      break;
+    }
+    default: {
+      return node.release();
+    }
+  }
+  switch (arg1->data_type()) {
+    case GRNXX_INT: {
+      Int value = static_cast<const ConstantNode<Int> *>(arg2)->value();
+      if (value.is_na()) {
+        break;
+      }
+      return new ZoneMapNode<Int>(
+          std::move(node),
+          static_cast<const ColumnNode<Int> *>(arg1)->column(),
+          operator_type, value);
+    }
+    case GRNXX_FLOAT: {
+      Float value = static_cast<const ConstantNode<Float> *>(arg2)->value();
+      if (value.is_na()) {
+        break;
+      }
+      return new ZoneMapNode<Float>(
+          std::move(node),
+          static_cast<const ColumnNode<Float> *>(arg1)->column(),
+          operator_type, value);
+    }
+    case GRNXX_TEXT: {
+      Text value = static_cast<const ConstantNode<Text> *>(arg2)->value();
+      if (value.is_na()) {
+        break;
+      }
+      return new ZoneMapNode<Text>(
+          std::move(node),
+          static_cast<const ColumnNode<Text> *>(arg1)->column(),
+          operator_type, value);
+    }
+    default: {
+      break;
+    }
+  }
+  return node.release();
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+Node *ExpressionBuilder::create_index_node(
+    OperatorType operator_type,
+    std::unique_ptr<Node> &&node,
+    const Node *arg1,
+    const Node *arg2) try {
+  if ((arg1->node_type() != COLUMN_NODE) ||
+      (arg2->node_type() != CONSTANT_NODE)) {
+    return node.release();
+  }
+  if (arg1->data_type() == GRNXX_TEXT) {
+    // A full-text index finds texts containing "value", which are
+    // candidates for prefix and suffix search.
+    switch (operator_type) {
+      case GRNXX_CONTAINS:
+      case GRNXX_STARTS_WITH:
+      case GRNXX_ENDS_WITH: {
+        Text value = static_cast<const ConstantNode<Text> *>(arg2)->value();
+        // A value shorter than a bigram would make the index scan all the
+        // texts, so it is tested without the index.
+        if (value.is_na() || (value.raw_size() < 2)) {
+          break;
+        }
+        return new IndexedContainsNode(
+            std::move(node),
+            static_cast<const ColumnNode<Text> *>(arg1)->column(),
+            GRNXX_FULL_TEXT_INDEX, value,
+            operator_type != GRNXX_CONTAINS);
+      }
+      default: {
+        break;
+      }
+    }
+    return node.release();
+  } else if (operator_type != GRNXX_CONTAINS) {
+    return node.release();
+  }
+  switch (arg1->data_type()) {
+    case GRNXX_INT_VECTOR: {
+      Int value = static_cast<const ConstantNode<Int> *>(arg2)->value();
+      if (value.is_na()) {
+        break;
+      }
+      return new IndexedContainsNode(
+          std::move(node),
+          static_cast<const ColumnNode<Vector<Int>> *>(arg1)->column(),
+          GRNXX_HASH_INDEX, value, false);
+    }
+    case GRNXX_TEXT_VECTOR: {
+      Text value = static_cast<const ConstantNode<Text> *>(arg2)->value();
+      if (value.is_na()) {
+        break;
+      }
+      return new IndexedContainsNode(
+          std::move(node),
+          static_cast<const ColumnNode<Vector<Text>> *>(arg1)->column(),
+          GRNXX_HASH_INDEX, value, false);
+    }
+    default: {
+      break;
+    }
+  }
+  return node.release();
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+Node *ExpressionBuilder::create_geo_index_node(
+    OperatorType operator_type,
+    std::unique_ptr<Node> &&node,
+    const Node *arg1,
+    const Node *arg2,
+    const Node *arg3) try {
+  if ((arg1->node_type() != COLUMN_NODE) ||
+      (arg2->node_type() != CONSTANT_NODE) ||
+      (arg3->node_type() != CONSTANT_NODE)) {
+    return node.release();
+  }
+  GeoPoint point = static_cast<const ConstantNode<GeoPoint> *>(arg2)->value();
+  Datum arg;
+  switch (operator_type) {
+    case GRNXX_GEO_WITHIN_RECTANGLE: {
+      arg = static_cast<const ConstantNode<GeoPoint> *>(arg3)->value();
+      break;
+    }
+    case GRNXX_GEO_WITHIN_CIRCLE: {
+      arg = static_cast<const ConstantNode<Float> *>(arg3)->value();
+      break;
+    }
+    default: {
+      return node.release();
+    }
+  }
+  return new IndexedGeoNode(
+      std::move(node),
+      static_cast<const ColumnNode<GeoPoint> *>(arg1)->column(),
+      operator_type, point, arg);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
 // Create a node associated with an equality test operator.
 template <typename T>
 Node *ExpressionBuilder::create_equality_test_node(
@@ -2405,6 +4266,20 @@ Node *ExpressionBuilder::create_search_node(OperatorType operator_type,
   }
 }
 
+template <typename T>
+Node *ExpressionBuilder::create_membership_node(
+    OperatorType operator_type,
+    std::unique_ptr<Node> &&arg1,
+    std::unique_ptr<Node> &&arg2) {
+  if (operator_type != GRNXX_CONTAINS) {
+    throw "Invalid operator";  // TODO
+  }
+  if (arg2->data_type() != T::type()) {
+    throw "Data type conflict";  // TODO
+  }
+  return new ContainsNode<Vector<T>>(std::move(arg1), std::move(arg2));
+}
+
 Node *ExpressionBuilder::create_subscript_node(std::unique_ptr<Node> &&arg1,
                                                std::unique_ptr<Node> &&arg2) {
   if (arg2->data_type() != GRNXX_INT) {
@@ -2415,6 +4290,11 @@ Node *ExpressionBuilder::create_subscript_node(std::unique_ptr<Node> &&arg1,
       return new SubscriptNode<Bool>(std::move(arg1), std::move(arg2));
     }
     case GRNXX_INT_VECTOR: {
+      if ((arg1->node_type() == COLUMN_NODE) &&
+          static_cast<const ColumnNode<Vector<Int>> *>(
+              arg1.get())->column()->is_delta_encoded()) {
+        return new DeltaSubscriptNode(std::move(arg1), std::move(arg2));
+      }
       return new SubscriptNode<Int>(std::move(arg1), std::move(arg2));
     }
     case GRNXX_FLOAT_VECTOR: {
@@ -2435,49 +4315,50 @@ Node *ExpressionBuilder::create_subscript_node(std::unique_ptr<Node> &&arg1,
 Node *ExpressionBuilder::create_dereference_node(
     std::unique_ptr<Node> &&arg1,
     std::unique_ptr<Node> &&arg2,
+    ArrayCRef<const ColumnBase *> columns,
     const ExpressionOptions &options) {
   switch (arg1->data_type()) {
     case GRNXX_INT: {
       switch (arg2->data_type()) {
         case GRNXX_BOOL: {
           return new DereferenceNode<Bool>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_INT: {
           return new DereferenceNode<Int>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_FLOAT: {
           return new DereferenceNode<Float>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_GEO_POINT: {
           return new DereferenceNode<GeoPoint>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_TEXT: {
           return new DereferenceNode<Text>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_BOOL_VECTOR: {
           return new DereferenceNode<Vector<Bool>>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_INT_VECTOR: {
           return new DereferenceNode<Vector<Int>>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_FLOAT_VECTOR: {
           return new DereferenceNode<Vector<Float>>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_GEO_POINT_VECTOR: {
           return new DereferenceNode<Vector<GeoPoint>>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         case GRNXX_TEXT_VECTOR: {
           return new DereferenceNode<Vector<Text>>(
-              std::move(arg1), std::move(arg2));
+              std::move(arg1), std::move(arg2), columns);
         }
         default: {
           throw "Invalid data type";  // TODO
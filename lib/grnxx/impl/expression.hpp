@@ -17,6 +17,14 @@ class Builder;
 using ExpressionInterface = grnxx::Expression;
 using ExpressionBuilderInterface = grnxx::ExpressionBuilder;
 
+// A comparison "column op value" where "op" is EQUAL, LESS, LESS_EQUAL,
+// GREATER or GREATER_EQUAL and "value" is not N/A.
+struct ExpressionCondition {
+  const ColumnBase *column;
+  OperatorType operator_type;
+  Datum value;
+};
+
 class Expression : public ExpressionInterface {
  public:
   using Node = expression::Node;
@@ -25,7 +33,9 @@ class Expression : public ExpressionInterface {
 
   Expression(const Table *table,
              std::unique_ptr<Node> &&root,
-             const ExpressionOptions &options);
+             const ExpressionOptions &options,
+             String &&description,
+             Array<const ColumnBase *> &&columns);
   ~Expression();
 
   const Table *table() const {
@@ -74,10 +84,54 @@ class Expression : public ExpressionInterface {
   void evaluate(ArrayCRef<Record> records, ArrayRef<Vector<GeoPoint>> results);
   void evaluate(ArrayCRef<Record> records, ArrayRef<Vector<Text>> results);
 
+  // -- Internal API --
+
+  // Return whether no row in the "zone_id"-th zone satisfies the expression.
+  //
+  // Rows in a zone are in [zone_id * ZONE_SIZE, (zone_id + 1) * ZONE_SIZE).
+  // NOTE: false does not mean that there is a row to satisfy it.
+  bool can_skip_zone(size_t zone_id) const;
+
+  // If the expression is a conjunction of comparisons between Int, Float or
+  // Text columns and constants, store the comparisons into "*conditions".
+  //
+  // "*conditions" refers to constants owned by the expression.
+  //
+  // On success, returns true.
+  // If the expression is not such a conjunction, returns false.
+  // On failure, throws an exception.
+  bool get_conditions(Array<ExpressionCondition> *conditions) const;
+
+  // Return the column if the expression is an Int, Float or Text column.
+  //
+  // Otherwise, returns nullptr.
+  const ColumnBase *column() const;
+
+  // Return the description of the expression.
+  //
+  // Expressions built with the same sequence of operations on the same
+  // table have the same description.
+  const String &description() const {
+    return description_;
+  }
+  // Return the columns read by the expression.
+  ArrayCRef<const ColumnBase *> columns() const {
+    return columns_.cref();
+  }
+
  private:
   const Table *table_;
   std::unique_ptr<Node> root_;
   size_t block_size_;
+  bool uses_zone_maps_;
+  String description_;
+  Array<const ColumnBase *> columns_;
+
+  // Filter a block of records with zone maps and "root_".
+  //
+  // On failure, throws an exception.
+  void filter_block(ArrayCRef<Record> input_records,
+                    ArrayRef<Record> *output_records);
 
   template <typename T>
   void _evaluate(ArrayCRef<Record> records, Array<T> *results);
@@ -116,6 +170,8 @@ class ExpressionBuilder : public ExpressionBuilderInterface {
   const Table *table_;
   Array<std::unique_ptr<Node>> node_stack_;
   std::unique_ptr<ExpressionBuilder> subexpression_builder_;
+  String description_;
+  Array<const ColumnBase *> columns_;
 
   // Push a node associated with a unary operator.
   //
@@ -127,10 +183,18 @@ class ExpressionBuilder : public ExpressionBuilderInterface {
   // On failure, throws an exception.
   void push_binary_operator(OperatorType operator_type);
 
+  // Push a node associated with a ternary operator.
+  //
+  // On failure, throws an exception.
+  void push_ternary_operator(OperatorType operator_type);
+
   // Push a node associated with the dereference operator.
   //
+  // "columns" must be the columns read by the subexpression.
+  //
   // On failure, throws an exception.
-  void push_dereference(const ExpressionOptions &options);
+  void push_dereference(ArrayCRef<const ColumnBase *> columns,
+                        const ExpressionOptions &options);
 
   // Create a node associated with a constant.
   //
@@ -155,6 +219,51 @@ class ExpressionBuilder : public ExpressionBuilderInterface {
                                   std::unique_ptr<Node> &&arg1,
                                   std::unique_ptr<Node> &&arg2);
 
+  // Create a node associated with a ternary operator.
+  //
+  // On failure, throws an exception.
+  static Node *create_ternary_node(OperatorType operator_type,
+                                   std::unique_ptr<Node> &&arg1,
+                                   std::unique_ptr<Node> &&arg2,
+                                   std::unique_ptr<Node> &&arg3);
+
+  // Wrap "node" with a node to skip zones if "node" compares a column with
+  // a constant.
+  //
+  // "arg1" and "arg2" must be the arguments of "node".
+  //
+  // On failure, throws an exception.
+  static Node *create_zone_map_node(OperatorType operator_type,
+                                    std::unique_ptr<Node> &&node,
+                                    const Node *arg1,
+                                    const Node *arg2);
+
+  // Wrap "node" with a node to filter records with an index if "node" tests
+  // whether an indexed vector column contains a constant, or whether a
+  // column with a full-text index contains, starts with or ends with a
+  // constant.
+  //
+  // "arg1" and "arg2" must be the arguments of "node".
+  //
+  // On failure, throws an exception.
+  static Node *create_index_node(OperatorType operator_type,
+                                 std::unique_ptr<Node> &&node,
+                                 const Node *arg1,
+                                 const Node *arg2);
+
+  // Wrap "node" with a node to filter records with an index if "node" tests
+  // whether values of an indexed GeoPoint column are within a rectangle or
+  // a circle given by constants.
+  //
+  // "arg1", "arg2" and "arg3" must be the arguments of "node".
+  //
+  // On failure, throws an exception.
+  static Node *create_geo_index_node(OperatorType operator_type,
+                                     std::unique_ptr<Node> &&node,
+                                     const Node *arg1,
+                                     const Node *arg2,
+                                     const Node *arg3);
+
   // Create a node associated with an equality test operator.
   //
   // On failure, throws an exception.
@@ -195,6 +304,14 @@ class ExpressionBuilder : public ExpressionBuilderInterface {
                                   std::unique_ptr<Node> &&arg1,
                                   std::unique_ptr<Node> &&arg2);
 
+  // Create a node associated with a vector membership operator.
+  //
+  // On failure, throws an exception.
+  template <typename T>
+  static Node *create_membership_node(OperatorType operator_type,
+                                      std::unique_ptr<Node> &&arg1,
+                                      std::unique_ptr<Node> &&arg2);
+
   // Create a node associated with a subscript operator.
   //
   // On failure, throws an exception.
@@ -204,9 +321,11 @@ class ExpressionBuilder : public ExpressionBuilderInterface {
   // Create a node associated with a dereference operator.
   //
   // On failure, throws an exception.
-  static Node *create_dereference_node(std::unique_ptr<Node> &&arg1,
-                                       std::unique_ptr<Node> &&arg2,
-                                       const ExpressionOptions &options);
+  static Node *create_dereference_node(
+      std::unique_ptr<Node> &&arg1,
+      std::unique_ptr<Node> &&arg2,
+      ArrayCRef<const ColumnBase *> columns,
+      const ExpressionOptions &options);
 };
 
 enum ExpressionTokenType {
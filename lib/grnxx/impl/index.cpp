@@ -1,11 +1,21 @@
 #include "grnxx/impl/index.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <limits>
 #include <map>
 #include <set>
+#include <system_error>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "grnxx/impl/column.hpp"
 #include "grnxx/impl/cursor.hpp"
+#include "grnxx/impl/table.hpp"
+#include "grnxx/impl/varint.hpp"
 
 namespace grnxx {
 namespace impl {
@@ -30,6 +40,24 @@ std::unique_ptr<Cursor> create_empty_cursor() try {
   throw "Memory allocation failed";  // TODO
 }
 
+// -- RowIDArrayCursor --
+
+// Helper function to create a cursor to read "*row_ids" in ascending order.
+//
+// If "options.order_type" is GRNXX_REVERSE_ORDER, "*row_ids" are read in
+// descending order.
+std::unique_ptr<Cursor> create_row_id_array_cursor(
+    Array<Int> *row_ids,
+    const CursorOptions &options) try {
+  if (options.order_type == GRNXX_REVERSE_ORDER) {
+    std::reverse(row_ids->buffer(), row_ids->buffer() + row_ids->size());
+  }
+  return std::unique_ptr<Cursor>(new RowIDArrayCursor(
+      std::move(*row_ids), options.offset, options.limit));
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
 // -- ExactMatchCursor --
 
 template <typename T>
@@ -291,6 +319,245 @@ std::unique_ptr<Cursor> create_prefix_cursor(
 
 // -- TreeIndex --
 
+// -- IndexBuilder --
+
+// An entry of an index.
+template <typename T>
+struct IndexEntry {
+  T key;
+  Int row_id;
+};
+
+// Compare index keys.
+struct IndexKeyLess {
+  bool operator()(Int lhs, Int rhs) const {
+    return lhs.raw() < rhs.raw();
+  }
+  bool operator()(Float lhs, Float rhs) const {
+    return lhs.raw() < rhs.raw();
+  }
+  bool operator()(const Text &lhs, const Text &rhs) const {
+    return String(lhs.raw_data(), lhs.raw_size()) <
+           String(rhs.raw_data(), rhs.raw_size());
+  }
+  bool operator()(const String &lhs, const String &rhs) const {
+    return lhs < rhs;
+  }
+  bool operator()(uint64_t lhs, uint64_t rhs) const {
+    return lhs < rhs;
+  }
+};
+
+// Compare index entries by keys and row IDs.
+struct IndexEntryLess {
+  template <typename T>
+  bool operator()(const IndexEntry<T> &lhs, const IndexEntry<T> &rhs) const {
+    IndexKeyLess less;
+    if (less(lhs.key, rhs.key)) {
+      return true;
+    } else if (less(rhs.key, lhs.key)) {
+      return false;
+    }
+    return lhs.row_id.raw() < rhs.row_id.raw();
+  }
+};
+
+// Return the number of threads to build an index for "num_values" values.
+size_t get_num_build_threads(size_t num_values, const IndexOptions &options) {
+  if (options.num_threads != 0) {
+    return options.num_threads;
+  }
+  // Small indexes are not worth the thread creation.
+  constexpr size_t MIN_NUM_VALUES_PER_THREAD = 1 << 16;
+  size_t num_threads = std::thread::hardware_concurrency();
+  if (num_threads > (num_values / MIN_NUM_VALUES_PER_THREAD)) {
+    num_threads = num_values / MIN_NUM_VALUES_PER_THREAD;
+  }
+  return (num_threads != 0) ? num_threads : 1;
+}
+
+// Call "function(i)" for each "i" in [0, "num_threads") in parallel.
+//
+// If a thread is not available, the remaining calls are done in the calling
+// thread.
+//
+// On failure, throws an exception.
+template <typename T>
+void run_in_parallel(size_t num_threads, const T &function) try {
+  if (num_threads <= 1) {
+    function(0);
+    return;
+  }
+  Array<std::exception_ptr> errors;
+  errors.resize(num_threads);
+  auto run = [&function, &errors](size_t i) {
+    try {
+      function(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+  Array<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  try {
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.push_back(std::thread(run, i));
+    }
+  } catch (const std::system_error &) {
+    for (size_t i = threads.size() + 1; i < num_threads; ++i) {
+      run(i);
+    }
+  }
+  run(0);
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  for (size_t i = 0; i < num_threads; ++i) {
+    if (errors[i]) {
+      std::rethrow_exception(errors[i]);
+    }
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+// Read entries of an index from "column" and sort them by keys and row IDs.
+//
+// "get_key(value)" must return the key of "value".
+// Rows are split into ranges and each thread reads and sorts the entries of
+// a range. Then, the sorted ranges are merged in parallel.
+//
+// On failure, throws an exception.
+template <typename T, typename U, typename V>
+void read_index_entries(const Column<T> *column,
+                        const IndexOptions &options,
+                        const U &get_key,
+                        Array<IndexEntry<V>> *entries) try {
+  Array<Record> records;
+  auto cursor = column->table()->create_cursor();
+  cursor->read_all(&records);
+  size_t num_records = records.size();
+  size_t num_threads = get_num_build_threads(num_records, options);
+  if (num_threads > num_records) {
+    num_threads = (num_records != 0) ? num_records : 1;
+  }
+  entries->resize(num_records);
+  IndexEntry<V> *buffer = entries->buffer();
+
+  // "bounds[i]" and "sizes[i]" are the offset and the number of entries of
+  // the "i"-th range.
+  Array<size_t> bounds;
+  Array<size_t> sizes;
+  bounds.resize(num_threads + 1);
+  sizes.resize(num_threads);
+  for (size_t i = 0; i <= num_threads; ++i) {
+    bounds[i] = num_records * i / num_threads;
+  }
+  run_in_parallel(num_threads, [&](size_t thread_id) {
+    constexpr size_t BLOCK_SIZE = 1024;
+    Array<T> values;
+    size_t begin = bounds[thread_id];
+    size_t end = bounds[thread_id + 1];
+    size_t size = 0;
+    for (size_t offset = begin; offset < end; offset += BLOCK_SIZE) {
+      size_t block_size = end - offset;
+      if (block_size > BLOCK_SIZE) {
+        block_size = BLOCK_SIZE;
+      }
+      values.resize(block_size);
+      column->read(records.cref(offset, block_size), values.ref());
+      for (size_t i = 0; i < block_size; ++i) {
+        if (!values[i].is_na()) {
+          IndexEntry<V> &entry = buffer[begin + size];
+          entry.key = get_key(values[i]);
+          entry.row_id = records[offset + i].row_id;
+          ++size;
+        }
+      }
+    }
+    std::sort(buffer + begin, buffer + begin + size, IndexEntryLess());
+    sizes[thread_id] = size;
+  });
+
+  // Remove gaps made by N/A values.
+  size_t num_entries = 0;
+  for (size_t i = 0; i < num_threads; ++i) {
+    if (bounds[i] != num_entries) {
+      std::move(buffer + bounds[i], buffer + bounds[i] + sizes[i],
+                buffer + num_entries);
+      bounds[i] = num_entries;
+    }
+    num_entries += sizes[i];
+  }
+  bounds[num_threads] = num_entries;
+
+  // Merge pairs of adjacent ranges until only one range remains.
+  for (size_t num_ranges = num_threads; num_ranges > 1; ) {
+    size_t num_merges = num_ranges / 2;
+    run_in_parallel(num_merges, [&](size_t merge_id) {
+      std::inplace_merge(buffer + bounds[merge_id * 2],
+                         buffer + bounds[(merge_id * 2) + 1],
+                         buffer + bounds[(merge_id * 2) + 2],
+                         IndexEntryLess());
+    });
+    for (size_t i = 0; i < num_merges; ++i) {
+      bounds[i] = bounds[i * 2];
+    }
+    if ((num_ranges % 2) != 0) {
+      bounds[num_merges] = bounds[num_ranges - 1];
+    }
+    num_ranges -= num_merges;
+    bounds[num_ranges] = num_entries;
+  }
+  entries->resize(num_entries);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+// Reserve buckets of a hash table.
+template <typename T>
+void reserve_index_map(size_t, T *) {}
+template <typename T, typename U, typename V>
+void reserve_index_map(size_t size, std::unordered_map<T, U, V> *map) {
+  map->reserve(size);
+}
+
+// Build "*map" from sorted entries.
+//
+// Keys are inserted in ascending order, so that a tree is built without
+// searching, and each set of row IDs is built in the same way.
+// "get_map_key(key)" must return the key of "*map" for "key".
+//
+// On success, returns the number of entries.
+// On failure, throws an exception.
+template <typename T, typename U, typename V>
+size_t build_index_map(ArrayCRef<IndexEntry<T>> entries,
+                       const U &get_map_key,
+                       V *map) try {
+  IndexKeyLess less;
+  size_t num_keys = 0;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if ((i == 0) || less(entries[i - 1].key, entries[i].key)) {
+      ++num_keys;
+    }
+  }
+  reserve_index_map(num_keys, map);
+  for (size_t i = 0; i < entries.size(); ) {
+    auto map_it = map->emplace_hint(map->end(), get_map_key(entries[i].key),
+                                    typename V::mapped_type());
+    auto &set = map_it->second;
+    size_t j = i;
+    do {
+      set.emplace_hint(set.end(), entries[j].row_id);
+      ++j;
+    } while ((j < entries.size()) && !less(entries[i].key, entries[j].key));
+    i = j;
+  }
+  return entries.size();
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
 template <typename T> class TreeIndex;
 
 // -- TreeIndex<Int> --
@@ -337,28 +604,16 @@ class TreeIndex<Int> : public Index {
 
 TreeIndex<Int>::TreeIndex(ColumnBase *column,
                           const String &name,
-                          const IndexOptions &)
+                          const IndexOptions &options)
     : Index(column, name),
       map_(),
       num_entries_(0) {
-  auto cursor = column->table()->create_cursor();
-  auto typed_column = static_cast<Column<Int> *>(column);
-  Array<Record> records;
-  Array<Value> values;
-  for ( ; ; ) {
-    size_t count = cursor->read(1024, &records);
-    if (count == 0) {
-      break;
-    }
-    values.resize(records.size());
-    typed_column->read(records, values.ref());
-    for (size_t i = 0; i < count; ++i) {
-      if (!values[i].is_na()) {
-        insert(records[i].row_id, values[i]);
-      }
-    }
-    records.clear();
-  }
+  // Entries are sorted and then inserted in order.
+  Array<IndexEntry<Int>> entries;
+  read_index_entries(static_cast<Column<Int> *>(column), options,
+                     [](Int value) { return value; }, &entries);
+  num_entries_ = build_index_map(entries.cref(),
+                                 [](Int key) { return key; }, &map_);
 }
 
 bool TreeIndex<Int>::test_uniqueness() const {
@@ -517,28 +772,16 @@ class TreeIndex<Float> : public Index {
 
 TreeIndex<Float>::TreeIndex(ColumnBase *column,
                             const String &name,
-                            const IndexOptions &)
+                            const IndexOptions &options)
     : Index(column, name),
       map_(),
       num_entries_(0) {
-  auto cursor = column->table()->create_cursor();
-  auto typed_column = static_cast<Column<Float> *>(column);
-  Array<Record> records;
-  Array<Value> values;
-  for ( ; ; ) {
-    size_t count = cursor->read(1024, &records);
-    if (count == 0) {
-      break;
-    }
-    values.resize(records.size());
-    typed_column->read(records, values.ref());
-    for (size_t i = 0; i < count; ++i) {
-      if (!values[i].is_na()) {
-        insert(records[i].row_id, values[i]);
-      }
-    }
-    records.clear();
-  }
+  // Entries are sorted and then inserted in order.
+  Array<IndexEntry<Float>> entries;
+  read_index_entries(static_cast<Column<Float> *>(column), options,
+                     [](Float value) { return value; }, &entries);
+  num_entries_ = build_index_map(entries.cref(),
+                                 [](Float key) { return key; }, &map_);
 }
 
 bool TreeIndex<Float>::test_uniqueness() const {
@@ -702,28 +945,19 @@ class TreeIndex<Text> : public Index {
 
 TreeIndex<Text>::TreeIndex(ColumnBase *column,
                            const String &name,
-                           const IndexOptions &)
+                           const IndexOptions &options)
     : Index(column, name),
       map_(),
       num_entries_(0) {
-  auto cursor = column->table()->create_cursor();
-  auto typed_column = static_cast<Column<Text> *>(column);
-  Array<Record> records;
-  Array<Value> values;
-  for ( ; ; ) {
-    size_t count = cursor->read(1024, &records);
-    if (count == 0) {
-      break;
-    }
-    values.resize(records.size());
-    typed_column->read(records, values.ref());
-    for (size_t i = 0; i < count; ++i) {
-      if (!values[i].is_na()) {
-        insert(records[i].row_id, values[i]);
-      }
-    }
-    records.clear();
-  }
+  // Entries are sorted and then inserted in order.
+  Array<IndexEntry<Text>> entries;
+  read_index_entries(static_cast<Column<Text> *>(column), options,
+                     [](const Text &value) { return value; }, &entries);
+  num_entries_ = build_index_map(entries.cref(), [](const Text &key) {
+    String string;
+    string.assign(key.raw_data(), key.raw_size());
+    return string;
+  }, &map_);
 }
 
 bool TreeIndex<Text>::test_uniqueness() const {
@@ -912,42 +1146,28 @@ std::unique_ptr<Cursor> TreeIndex<Text>::find_prefixes(
   return create_prefix_cursor(std::move(array), options.offset, options.limit);
 }
 
-// -- HashIndex --
-
-template <typename T> class HashIndex;
-
-// -- HashIndex<Int> --
+// -- TreeIndex<GeoPoint> --
 
+// A tree index on a GeoPoint column is keyed by Z-order codes, which
+// interleave the bits of latitudes and longitudes, so that points in a
+// quadrant have consecutive keys.
+//
+// A rectangle is covered by the key ranges of quadrants and the keys in the
+// ranges are decoded and tested against the rectangle.
 template <>
-class HashIndex<Int> : public Index {
+class TreeIndex<GeoPoint> : public Index {
  public:
-  struct Less {
-    bool operator()(Int lhs, Int rhs) const {
-      return lhs.raw() < rhs.raw();
-    }
-  };
-  struct Hash {
-    uint64_t operator()(Int value) const {
-      return value.hash();
-    }
-  };
-  struct Equal {
-    bool operator()(Int lhs, Int rhs) const {
-      return lhs.match(rhs);
-    }
-  };
-
-  using Value = Int;
-  using Set = std::set<Int, Less>;
-  using Map = std::unordered_map<Value, Set, Hash, Equal>;
+  using Value = GeoPoint;
+  using Set = std::set<Int, RowIDLess>;
+  using Map = std::map<uint64_t, Set>;
 
-  HashIndex(ColumnBase *column,
+  TreeIndex(ColumnBase *column,
             const String &name,
             const IndexOptions &options);
-  ~HashIndex() = default;
+  ~TreeIndex() = default;
 
   IndexType type() const {
-    return GRNXX_HASH_INDEX;
+    return GRNXX_TREE_INDEX;
   }
   size_t num_entries() const {
     return num_entries_;
@@ -960,39 +1180,108 @@ class HashIndex<Int> : public Index {
 
   std::unique_ptr<Cursor> find(const Datum &value,
                                const CursorOptions &options) const;
+  std::unique_ptr<Cursor> find_within_rectangle(
+      const GeoPoint &corner,
+      const GeoPoint &opposite_corner,
+      const CursorOptions &options) const;
+  std::unique_ptr<Cursor> find_within_circle(
+      const GeoPoint &center,
+      Float radius,
+      const CursorOptions &options) const;
 
  private:
+  // A rectangle in milliseconds, which includes the boundaries.
+  struct Rectangle {
+    int64_t min_latitude;
+    int64_t max_latitude;
+    int64_t min_longitude;
+    int64_t max_longitude;
+  };
+  // A range of keys, which includes the boundaries.
+  struct KeyRange {
+    uint64_t begin;
+    uint64_t end;
+  };
+
   mutable Map map_;
   size_t num_entries_;
+
+  // Spread the bits of "x" to the even bits.
+  static uint64_t spread(uint32_t x) {
+    uint64_t bits = x;
+    bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFULL;
+    bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFULL;
+    bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    bits = (bits | (bits << 2)) & 0x3333333333333333ULL;
+    bits = (bits | (bits << 1)) & 0x5555555555555555ULL;
+    return bits;
+  }
+  // Gather the even bits of "bits".
+  static uint32_t gather(uint64_t bits) {
+    bits &= 0x5555555555555555ULL;
+    bits = (bits | (bits >> 1)) & 0x3333333333333333ULL;
+    bits = (bits | (bits >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    bits = (bits | (bits >> 4)) & 0x00FF00FF00FF00FFULL;
+    bits = (bits | (bits >> 8)) & 0x0000FFFF0000FFFFULL;
+    bits = (bits | (bits >> 16)) & 0x00000000FFFFFFFFULL;
+    return static_cast<uint32_t>(bits);
+  }
+  // Map a signed coordinate to an unsigned one in the same order.
+  static uint32_t to_unsigned(int64_t raw) {
+    return static_cast<uint32_t>(raw) ^ 0x80000000U;
+  }
+  static int64_t to_signed(uint32_t x) {
+    return static_cast<int32_t>(x ^ 0x80000000U);
+  }
+  // Return the key of a point.
+  static uint64_t get_key(int64_t raw_latitude, int64_t raw_longitude) {
+    return (spread(to_unsigned(raw_latitude)) << 1) |
+           spread(to_unsigned(raw_longitude));
+  }
+
+  // Append the key ranges of quadrants covering "rectangle" to "*ranges".
+  //
+  // The quadrant has the "level" lower bits free and starts at ("x", "y")
+  // in unsigned coordinates. Quadrants at "min_level" or lower are not
+  // divided.
+  //
+  // On failure, throws an exception.
+  static void cover(const Rectangle &rectangle,
+                    uint64_t x,
+                    uint64_t y,
+                    size_t level,
+                    size_t min_level,
+                    Array<KeyRange> *ranges);
+  // Find rows in "rectangle" and append the row IDs to "*row_ids".
+  //
+  // If "center" is not nullptr, rows farther than "radius" meters from
+  // "*center" are skipped.
+  //
+  // On failure, throws an exception.
+  void find_rows(const Rectangle &rectangle,
+                 const GeoPoint *center,
+                 double radius,
+                 Array<Int> *row_ids) const;
 };
 
-HashIndex<Int>::HashIndex(ColumnBase *column,
-                          const String &name,
-                          const IndexOptions &)
+TreeIndex<GeoPoint>::TreeIndex(ColumnBase *column,
+                               const String &name,
+                               const IndexOptions &options)
     : Index(column, name),
       map_(),
       num_entries_(0) {
-  auto cursor = column->table()->create_cursor();
-  auto typed_column = static_cast<Column<Int> *>(column);
-  Array<Record> records;
-  Array<Value> values;
-  for ( ; ; ) {
-    size_t count = cursor->read(1024, &records);
-    if (count == 0) {
-      break;
-    }
-    values.resize(records.size());
-    typed_column->read(records, values.ref());
-    for (size_t i = 0; i < count; ++i) {
-      if (!values[i].is_na()) {
-        insert(records[i].row_id, values[i]);
-      }
-    }
-    records.clear();
-  }
+  // Entries are sorted and then inserted in order.
+  Array<IndexEntry<uint64_t>> entries;
+  auto get_point_key = [](const GeoPoint &value) {
+    return get_key(value.raw_latitude(), value.raw_longitude());
+  };
+  read_index_entries(static_cast<Column<GeoPoint> *>(column), options,
+                     get_point_key, &entries);
+  num_entries_ = build_index_map(entries.cref(),
+                                 [](uint64_t key) { return key; }, &map_);
 }
 
-bool HashIndex<Int>::test_uniqueness() const {
+bool TreeIndex<GeoPoint>::test_uniqueness() const {
   for (const auto &it : map_) {
     if (it.second.size() > 1) {
       return false;
@@ -1001,16 +1290,19 @@ bool HashIndex<Int>::test_uniqueness() const {
   return true;
 }
 
-void HashIndex<Int>::insert(Int row_id, const Datum &value) {
-  auto result = map_[value.as_int()].insert(row_id);
+void TreeIndex<GeoPoint>::insert(Int row_id, const Datum &value) {
+  GeoPoint point = value.as_geo_point();
+  auto result =
+      map_[get_key(point.raw_latitude(), point.raw_longitude())].insert(row_id);
   if (!result.second) {
     throw "Entry already exists";  // TODO
   }
   ++num_entries_;
 }
 
-void HashIndex<Int>::remove(Int row_id, const Datum &value) {
-  auto map_it = map_.find(value.as_int());
+void TreeIndex<GeoPoint>::remove(Int row_id, const Datum &value) {
+  GeoPoint point = value.as_geo_point();
+  auto map_it = map_.find(get_key(point.raw_latitude(), point.raw_longitude()));
   if (map_it == map_.end()) {
     throw "Entry not found";  // TODO
   }
@@ -1025,15 +1317,19 @@ void HashIndex<Int>::remove(Int row_id, const Datum &value) {
   --num_entries_;
 }
 
-std::unique_ptr<Cursor> HashIndex<Int>::find(
+std::unique_ptr<Cursor> TreeIndex<GeoPoint>::find(
     const Datum &value,
     const CursorOptions &options) const {
   if (value.type() == GRNXX_NA) {
     return create_empty_cursor();
-  } else if (value.type() != GRNXX_INT) {
+  } else if (value.type() != GRNXX_GEO_POINT) {
     throw "Data type conflict";  // TODO
   }
-  auto map_it = map_.find(value.as_int());
+  GeoPoint point = value.as_geo_point();
+  if (point.is_na()) {
+    return create_empty_cursor();
+  }
+  auto map_it = map_.find(get_key(point.raw_latitude(), point.raw_longitude()));
   if (map_it == map_.end()) {
     return create_empty_cursor();
   } else {
@@ -1049,73 +1345,1484 @@ std::unique_ptr<Cursor> HashIndex<Int>::find(
   }
 }
 
-// -- HashIndex<Float> --
-
-template <>
-class HashIndex<Float> : public Index {
- public:
-  struct Less {
-    bool operator()(Int lhs, Int rhs) const {
-      return lhs.raw() < rhs.raw();
-    }
+std::unique_ptr<Cursor> TreeIndex<GeoPoint>::find_within_rectangle(
+    const GeoPoint &corner,
+    const GeoPoint &opposite_corner,
+    const CursorOptions &options) const {
+  if (corner.is_na() || opposite_corner.is_na()) {
+    return create_empty_cursor();
+  }
+  Rectangle rectangle = {
+    std::min(corner.raw_latitude(), opposite_corner.raw_latitude()),
+    std::max(corner.raw_latitude(), opposite_corner.raw_latitude()),
+    std::min(corner.raw_longitude(), opposite_corner.raw_longitude()),
+    std::max(corner.raw_longitude(), opposite_corner.raw_longitude())
   };
-  struct Hash {
-    uint64_t operator()(Float value) const {
-      return value.hash();
-    }
+  Array<Int> row_ids;
+  find_rows(rectangle, nullptr, 0.0, &row_ids);
+  std::sort(row_ids.buffer(), row_ids.buffer() + row_ids.size(),
+            RowIDLess());
+  return create_row_id_array_cursor(&row_ids, options);
+}
+
+std::unique_ptr<Cursor> TreeIndex<GeoPoint>::find_within_circle(
+    const GeoPoint &center,
+    Float radius,
+    const CursorOptions &options) const {
+  // N/A (NaN) is rejected because a comparison for NaN returns false.
+  if (center.is_na() || !(radius.raw() >= 0.0)) {
+    return create_empty_cursor();
+  }
+  // The circle is covered by a rectangle, which is widened by a millisecond
+  // to absorb rounding errors.
+  double angle = radius.raw() / GeoPoint::earth_radius();
+  int64_t latitude_diff =
+      static_cast<int64_t>(angle / GeoPoint::raw_radians()) + 1;
+  Rectangle rectangle = {
+    std::max(center.raw_latitude() - latitude_diff,
+             GeoPoint::raw_min_latitude()),
+    std::min(center.raw_latitude() + latitude_diff,
+             GeoPoint::raw_max_latitude()),
+    GeoPoint::raw_min_longitude(),
+    GeoPoint::raw_max_longitude() - 1
   };
-  struct Equal {
-    bool operator()(Float lhs, Float rhs) const {
-      return lhs.match(rhs);
+  // The longitude range is limited unless the circle contains a pole.
+  double x = std::sin(angle) /
+             std::cos(center.raw_latitude() * GeoPoint::raw_radians());
+  bool has_pole =
+      (rectangle.min_latitude == GeoPoint::raw_min_latitude()) ||
+      (rectangle.max_latitude == GeoPoint::raw_max_latitude());
+  Array<Int> row_ids;
+  if (has_pole || (angle >= (3.14159265358979323846 / 2)) || (x >= 1.0)) {
+    find_rows(rectangle, &center, radius.raw(), &row_ids);
+  } else {
+    int64_t longitude_diff =
+        static_cast<int64_t>(std::asin(x) / GeoPoint::raw_radians()) + 1;
+    int64_t min_longitude = center.raw_longitude() - longitude_diff;
+    int64_t max_longitude = center.raw_longitude() + longitude_diff;
+    int64_t round = GeoPoint::raw_max_longitude() -
+                    GeoPoint::raw_min_longitude();
+    if (min_longitude < GeoPoint::raw_min_longitude()) {
+      // The circle crosses the 180th meridian.
+      rectangle.min_longitude = min_longitude + round;
+      find_rows(rectangle, &center, radius.raw(), &row_ids);
+      min_longitude = GeoPoint::raw_min_longitude();
+    } else if (max_longitude >= GeoPoint::raw_max_longitude()) {
+      rectangle.max_longitude = max_longitude - round;
+      find_rows(rectangle, &center, radius.raw(), &row_ids);
+      max_longitude = GeoPoint::raw_max_longitude() - 1;
     }
-  };
-
-  using Value = Float;
-  using Set = std::set<Int, Less>;
-  using Map = std::unordered_map<Value, Set, Hash, Equal>;
-
-  HashIndex(ColumnBase *column,
-            const String &name,
-            const IndexOptions &options);
-  ~HashIndex() = default;
+    rectangle.min_longitude = min_longitude;
+    rectangle.max_longitude = max_longitude;
+    find_rows(rectangle, &center, radius.raw(), &row_ids);
+  }
+  std::sort(row_ids.buffer(), row_ids.buffer() + row_ids.size(),
+            RowIDLess());
+  return create_row_id_array_cursor(&row_ids, options);
+}
 
-  IndexType type() const {
-    return GRNXX_HASH_INDEX;
+void TreeIndex<GeoPoint>::cover(const Rectangle &rectangle,
+                                uint64_t x,
+                                uint64_t y,
+                                size_t level,
+                                size_t min_level,
+                                Array<KeyRange> *ranges) try {
+  uint64_t size = uint64_t(1) << level;
+  uint64_t min_x = to_unsigned(rectangle.min_latitude);
+  uint64_t max_x = to_unsigned(rectangle.max_latitude);
+  uint64_t min_y = to_unsigned(rectangle.min_longitude);
+  uint64_t max_y = to_unsigned(rectangle.max_longitude);
+  if ((x > max_x) || ((x + size - 1) < min_x) ||
+      (y > max_y) || ((y + size - 1) < min_y)) {
+    return;
   }
-  size_t num_entries() const {
-    return num_entries_;
+  bool is_inside = (x >= min_x) && ((x + size - 1) <= max_x) &&
+                   (y >= min_y) && ((y + size - 1) <= max_y);
+  if (is_inside || (level <= min_level)) {
+    uint64_t begin = (spread(static_cast<uint32_t>(x)) << 1) |
+                     spread(static_cast<uint32_t>(y));
+    uint64_t end = begin + ((level >= 32) ?
+        std::numeric_limits<uint64_t>::max() :
+        ((uint64_t(1) << (level * 2)) - 1));
+    if ((ranges->size() != 0) && ((ranges->back().end + 1) == begin)) {
+      ranges->back().end = end;
+    } else {
+      ranges->push_back(KeyRange{ begin, end });
+    }
+    return;
   }
+  // Quadrants are visited in ascending order of keys.
+  uint64_t half = size / 2;
+  cover(rectangle, x, y, level - 1, min_level, ranges);
+  cover(rectangle, x, y + half, level - 1, min_level, ranges);
+  cover(rectangle, x + half, y, level - 1, min_level, ranges);
+  cover(rectangle, x + half, y + half, level - 1, min_level, ranges);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
 
-  bool test_uniqueness() const;
-
-  void insert(Int row_id, const Datum &value);
-  void remove(Int row_id, const Datum &value);
-
-  std::unique_ptr<Cursor> find(const Datum &value,
-                               const CursorOptions &options) const;
+void TreeIndex<GeoPoint>::find_rows(const Rectangle &rectangle,
+                                    const GeoPoint *center,
+                                    double radius,
+                                    Array<Int> *row_ids) const try {
+  // Quadrants are divided until they are about 1/8 of the rectangle, so
+  // that the number of key ranges is bounded.
+  uint64_t width = std::max(
+      rectangle.max_latitude - rectangle.min_latitude,
+      rectangle.max_longitude - rectangle.min_longitude) + 1;
+  size_t min_level = 0;
+  while ((uint64_t(8) << min_level) < width) {
+    ++min_level;
+  }
+  Array<KeyRange> ranges;
+  cover(rectangle, 0, 0, 32, min_level, &ranges);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    auto it = map_.lower_bound(ranges[i].begin);
+    for ( ; (it != map_.end()) && (it->first <= ranges[i].end); ++it) {
+      int64_t raw_latitude = to_signed(gather(it->first >> 1));
+      int64_t raw_longitude = to_signed(gather(it->first));
+      if ((raw_latitude < rectangle.min_latitude) ||
+          (raw_latitude > rectangle.max_latitude) ||
+          (raw_longitude < rectangle.min_longitude) ||
+          (raw_longitude > rectangle.max_longitude)) {
+        continue;
+      }
+      if (center) {
+        GeoPoint point = GeoPoint(Int(raw_latitude), Int(raw_longitude));
+        if (!(point.distance(*center).raw() <= radius)) {
+          continue;
+        }
+      }
+      for (Int row_id : it->second) {
+        row_ids->push_back(row_id);
+      }
+    }
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+// -- CompositeTreeIndex --
+
+// Return whether "value" is N/A or not.
+bool is_na_datum(const Datum &value) {
+  switch (value.type()) {
+    case GRNXX_BOOL: {
+      return value.as_bool().is_na();
+    }
+    case GRNXX_INT: {
+      return value.as_int().is_na();
+    }
+    case GRNXX_FLOAT: {
+      return value.as_float().is_na();
+    }
+    case GRNXX_GEO_POINT: {
+      return value.as_geo_point().is_na();
+    }
+    case GRNXX_TEXT: {
+      return value.as_text().is_na();
+    }
+    case GRNXX_BOOL_VECTOR: {
+      return value.as_bool_vector().is_na();
+    }
+    case GRNXX_INT_VECTOR: {
+      return value.as_int_vector().is_na();
+    }
+    case GRNXX_FLOAT_VECTOR: {
+      return value.as_float_vector().is_na();
+    }
+    case GRNXX_GEO_POINT_VECTOR: {
+      return value.as_geo_point_vector().is_na();
+    }
+    case GRNXX_TEXT_VECTOR: {
+      return value.as_text_vector().is_na();
+    }
+    default: {
+      return true;
+    }
+  }
+}
+
+// Append "bits" to "*key" in big-endian order.
+void append_composite_key_bits(uint64_t bits, String *key) {
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    key->append(static_cast<char>((bits >> shift) & 0xFF));
+  }
+}
+
+// Append the encoded "value" to "*key".
+//
+// Encoded values are compared as byte strings in the same order as the
+// values, and no encoded value is a prefix of another one.
+// N/A is encoded as 0xFF and the other values start with 0x01, so that N/A
+// follows any other value.
+void append_composite_key(const Datum &value, String *key) {
+  if (is_na_datum(value)) {
+    key->append('\xFF');
+    return;
+  }
+  key->append('\x01');
+  switch (value.type()) {
+    case GRNXX_BOOL: {
+      key->append(value.as_bool().is_true() ? '\x01' : '\x00');
+      break;
+    }
+    case GRNXX_INT: {
+      uint64_t bits = static_cast<uint64_t>(value.as_int().raw());
+      append_composite_key_bits(bits ^ (uint64_t(1) << 63), key);
+      break;
+    }
+    case GRNXX_FLOAT: {
+      double raw = value.as_float().raw();
+      if (raw == 0.0) {
+        // -0.0 is normalized to 0.0.
+        raw = 0.0;
+      }
+      uint64_t bits;
+      std::memcpy(&bits, &raw, sizeof(bits));
+      if ((bits >> 63) != 0) {
+        bits = ~bits;
+      } else {
+        bits |= uint64_t(1) << 63;
+      }
+      append_composite_key_bits(bits, key);
+      break;
+    }
+    default: {
+      // 0x00 is escaped as 0x00 0xFF and 0x00 0x00 terminates the value.
+      Text text = value.as_text();
+      for (size_t i = 0; i < text.raw_size(); ++i) {
+        key->append(text.raw_data()[i]);
+        if (text.raw_data()[i] == '\0') {
+          key->append('\xFF');
+        }
+      }
+      key->append('\0');
+      key->append('\0');
+      break;
+    }
+  }
+}
+
+// Return the size of the first encoded value in "key".
+size_t get_composite_key_value_size(const String &key, DataType data_type) {
+  if (static_cast<unsigned char>(key[0]) == 0xFF) {
+    return 1;
+  }
+  switch (data_type) {
+    case GRNXX_BOOL: {
+      return 2;
+    }
+    case GRNXX_INT:
+    case GRNXX_FLOAT: {
+      return 9;
+    }
+    default: {
+      size_t i = 1;
+      while (key[i] != '\0' || key[i + 1] != '\0') {
+        i += (key[i] == '\0') ? 2 : 1;
+      }
+      return i + 2;
+    }
+  }
+}
+
+// Make "*key" the least string greater than any string starting with "*key".
+//
+// On success, returns true.
+// On failure, returns false.
+bool make_composite_key_successor(String *key) {
+  while (!key->is_empty() &&
+         (static_cast<unsigned char>(key->back()) == 0xFF)) {
+    key->resize(key->size() - 1);
+  }
+  if (key->is_empty()) {
+    return false;
+  }
+  ++key->back();
+  return true;
+}
+
+// An index which orders rows by tuples of values of columns.
+//
+// The owner column is the first column and rows whose owner values are N/A
+// are not indexed.
+// Values of the owner column are given by insert() and remove(), and changes
+// of the other columns are notified by update_row().
+class CompositeTreeIndex : public Index {
+ public:
+  using Set = std::set<Int, RowIDLess>;
+  using Map = std::map<String, Set>;
+
+  CompositeTreeIndex(ColumnBase *column,
+                     const String &name,
+                     const IndexOptions &options);
+  ~CompositeTreeIndex();
+
+  IndexType type() const {
+    return GRNXX_TREE_INDEX;
+  }
+  size_t num_entries() const {
+    return num_entries_;
+  }
+
+  bool test_uniqueness() const;
+
+  void insert(Int row_id, const Datum &value);
+  void remove(Int row_id, const Datum &value);
+
+  std::unique_ptr<Cursor> find(const Datum &value,
+                               const CursorOptions &options) const;
+  std::unique_ptr<Cursor> find_in_range(const IndexRange &range,
+                                        const CursorOptions &options) const;
+  std::unique_ptr<Cursor> find_with_prefix(
+      ArrayCRef<Datum> prefix,
+      const IndexRange &range,
+      const CursorOptions &options) const;
+
+  IndexOptions options() const;
+  bool depends_on(const ColumnBase *column) const;
+  void update_row(const ColumnBase *column, Int row_id);
+
+ private:
+  Table *table_;
+  mutable Map map_;
+  // "columns_[0]" is the owner column.
+  Array<ColumnBase *> columns_;
+  // "row_entries_[i]" is the entry of the "i"-th row, or "map_.end()" if the
+  // row is not indexed.
+  Array<Map::iterator> row_entries_;
+  size_t num_entries_;
+
+  // Return the key of "row_id" whose owner value is "value".
+  String get_key(Int row_id, const Datum &value) const;
+  // Insert an entry.
+  void insert_entry(Int row_id, String &&key);
+  // Remove the entry of "row_id" if exists.
+  //
+  // If the entry exists, returns true.
+  // Otherwise, returns false.
+  bool remove_entry(Int row_id);
+};
+
+CompositeTreeIndex::CompositeTreeIndex(ColumnBase *column,
+                                       const String &name,
+                                       const IndexOptions &options) try
+    : Index(column, name),
+      table_(column->_table()),
+      map_(),
+      columns_(),
+      row_entries_(),
+      num_entries_(0) {
+  columns_.push_back(column);
+  for (size_t i = 0; i < options.secondary_column_names.size(); ++i) {
+    ColumnBase *secondary_column =
+        table_->find_column(options.secondary_column_names[i]);
+    if (!secondary_column) {
+      throw "Column not found";  // TODO
+    }
+    switch (secondary_column->data_type()) {
+      case GRNXX_BOOL:
+      case GRNXX_INT:
+      case GRNXX_FLOAT:
+      case GRNXX_TEXT: {
+        break;
+      }
+      default: {
+        throw "Not supported yet";  // TODO
+      }
+    }
+    if (depends_on(secondary_column)) {
+      throw "Column already exists";  // TODO
+    }
+    columns_.push_back(secondary_column);
+  }
+
+  // Entries are sorted and then inserted in order.
+  Array<Record> records;
+  auto cursor = table_->create_cursor(CursorOptions());
+  cursor->read_all(&records);
+  Array<IndexEntry<String>> entries;
+  entries.reserve(records.size());
+  Datum value;
+  for (size_t i = 0; i < records.size(); ++i) {
+    Int row_id = records[i].row_id;
+    column->get(row_id, &value);
+    if (!is_na_datum(value)) {
+      IndexEntry<String> entry;
+      entry.key = get_key(row_id, value);
+      entry.row_id = row_id;
+      entries.push_back(std::move(entry));
+    }
+  }
+  std::sort(entries.buffer(), entries.buffer() + entries.size(),
+            IndexEntryLess());
+  num_entries_ = build_index_map(entries.cref(), [](const String &key) {
+    return key.clone();
+  }, &map_);
+  if (!table_->max_row_id().is_na()) {
+    row_entries_.resize(table_->max_row_id().raw() + 1, map_.end());
+  }
+  for (auto map_it = map_.begin(); map_it != map_.end(); ++map_it) {
+    for (auto set_it : map_it->second) {
+      row_entries_[set_it.raw()] = map_it;
+    }
+  }
+  table_->append_composite_index(this);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+CompositeTreeIndex::~CompositeTreeIndex() {
+  table_->remove_composite_index(this);
+}
+
+bool CompositeTreeIndex::test_uniqueness() const {
+  // Keys are sorted, so that rows with the same owner value are adjacent.
+  DataType data_type = columns_[0]->data_type();
+  String prev_value;
+  for (const auto &it : map_) {
+    if (it.second.size() > 1) {
+      return false;
+    }
+    String value = it.first.substring(
+        0, get_composite_key_value_size(it.first, data_type));
+    if (!prev_value.is_empty() && (value == prev_value)) {
+      return false;
+    }
+    prev_value = value;
+  }
+  return true;
+}
+
+void CompositeTreeIndex::insert(Int row_id, const Datum &value) {
+  if (!is_na_datum(value)) {
+    insert_entry(row_id, get_key(row_id, value));
+  }
+}
+
+void CompositeTreeIndex::remove(Int row_id, const Datum &value) {
+  if (!is_na_datum(value) && !remove_entry(row_id)) {
+    throw "Entry not found";  // TODO
+  }
+}
+
+std::unique_ptr<Cursor> CompositeTreeIndex::find(
+    const Datum &value,
+    const CursorOptions &options) const {
+  return find_with_prefix(ArrayCRef<Datum>(&value, 1), IndexRange(), options);
+}
+
+std::unique_ptr<Cursor> CompositeTreeIndex::find_in_range(
+    const IndexRange &range,
+    const CursorOptions &options) const {
+  return find_with_prefix(ArrayCRef<Datum>(), range, options);
+}
+
+std::unique_ptr<Cursor> CompositeTreeIndex::find_with_prefix(
+    ArrayCRef<Datum> prefix,
+    const IndexRange &range,
+    const CursorOptions &options) const {
+  if (prefix.size() > columns_.size()) {
+    throw "Too many values";  // TODO
+  }
+  String prefix_key;
+  for (size_t i = 0; i < prefix.size(); ++i) {
+    if ((prefix[i].type() != GRNXX_NA) &&
+        (prefix[i].type() != columns_[i]->data_type())) {
+      throw "Data type conflict";  // TODO
+    }
+    append_composite_key(prefix[i], &prefix_key);
+  }
+  const Datum &lower_bound_value = range.lower_bound().value;
+  const Datum &upper_bound_value = range.upper_bound().value;
+  bool has_lower_bound = !is_na_datum(lower_bound_value);
+  bool has_upper_bound = !is_na_datum(upper_bound_value);
+  if (has_lower_bound || has_upper_bound) {
+    if (prefix.size() == columns_.size()) {
+      throw "Too many values";  // TODO
+    }
+    DataType data_type = columns_[prefix.size()]->data_type();
+    if ((has_lower_bound && (lower_bound_value.type() != data_type)) ||
+        (has_upper_bound && (upper_bound_value.type() != data_type))) {
+      throw "Data type conflict";  // TODO
+    }
+  }
+
+  // Keys in ["lower_bound_key", "upper_bound_key") are read.
+  String lower_bound_key = prefix_key.clone();
+  if (has_lower_bound) {
+    append_composite_key(lower_bound_value, &lower_bound_key);
+    if (range.lower_bound().type == EXCLUSIVE_END_POINT) {
+      make_composite_key_successor(&lower_bound_key);
+    }
+  }
+  String upper_bound_key = prefix_key.clone();
+  if (has_upper_bound) {
+    append_composite_key(upper_bound_value, &upper_bound_key);
+    if (range.upper_bound().type == INCLUSIVE_END_POINT) {
+      make_composite_key_successor(&upper_bound_key);
+    }
+  } else if (has_lower_bound) {
+    // N/A is not in a bounded range.
+    upper_bound_key.append('\xFF');
+  } else if (!make_composite_key_successor(&upper_bound_key)) {
+    upper_bound_key.clear();
+  }
+  bool has_upper_bound_key = !upper_bound_key.is_empty();
+  if (has_upper_bound_key && (lower_bound_key >= upper_bound_key)) {
+    return create_empty_cursor();
+  }
+
+  auto begin = map_.lower_bound(lower_bound_key);
+  auto end = has_upper_bound_key ?
+      map_.lower_bound(upper_bound_key) : map_.end();
+  if (options.order_type == GRNXX_REGULAR_ORDER) {
+    return create_range_cursor(
+        begin, end, options.offset, options.limit);
+  } else {
+    return create_reverse_range_cursor(
+        begin, end, options.offset, options.limit);
+  }
+}
+
+IndexOptions CompositeTreeIndex::options() const try {
+  IndexOptions options;
+  for (size_t i = 1; i < columns_.size(); ++i) {
+    options.secondary_column_names.push_back(columns_[i]->name().clone());
+  }
+  return options;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+bool CompositeTreeIndex::depends_on(const ColumnBase *column) const {
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    if (column == columns_[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CompositeTreeIndex::update_row(const ColumnBase *column, Int row_id) {
+  // Changes of the owner column are given by insert() and remove().
+  if ((column == columns_[0]) || !depends_on(column)) {
+    return;
+  }
+  remove_entry(row_id);
+  Datum value;
+  columns_[0]->get(row_id, &value);
+  insert(row_id, value);
+}
+
+String CompositeTreeIndex::get_key(Int row_id, const Datum &value) const {
+  String key;
+  append_composite_key(value, &key);
+  Datum secondary_value;
+  for (size_t i = 1; i < columns_.size(); ++i) {
+    columns_[i]->get(row_id, &secondary_value);
+    append_composite_key(secondary_value, &key);
+  }
+  return key;
+}
+
+void CompositeTreeIndex::insert_entry(Int row_id, String &&key) try {
+  size_t value_id = row_id.raw();
+  if (value_id >= row_entries_.size()) {
+    row_entries_.resize(value_id + 1, map_.end());
+  } else if (row_entries_[value_id] != map_.end()) {
+    throw "Entry already exists";  // TODO
+  }
+  auto map_it = map_.emplace(std::move(key), Set()).first;
+  map_it->second.insert(row_id);
+  row_entries_[value_id] = map_it;
+  ++num_entries_;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+bool CompositeTreeIndex::remove_entry(Int row_id) {
+  size_t value_id = row_id.raw();
+  if ((value_id >= row_entries_.size()) ||
+      (row_entries_[value_id] == map_.end())) {
+    return false;
+  }
+  auto map_it = row_entries_[value_id];
+  map_it->second.erase(row_id);
+  if (map_it->second.size() == 0) {
+    map_.erase(map_it);
+  }
+  row_entries_[value_id] = map_.end();
+  --num_entries_;
+  return true;
+}
+
+// -- HashIndex --
+
+template <typename T> class HashIndex;
+
+// -- HashIndex<Int> --
+
+template <>
+class HashIndex<Int> : public Index {
+ public:
+  struct Less {
+    bool operator()(Int lhs, Int rhs) const {
+      return lhs.raw() < rhs.raw();
+    }
+  };
+  struct Hash {
+    uint64_t operator()(Int value) const {
+      return value.hash();
+    }
+  };
+  struct Equal {
+    bool operator()(Int lhs, Int rhs) const {
+      return lhs.match(rhs);
+    }
+  };
+
+  using Value = Int;
+  using Set = std::set<Int, Less>;
+  using Map = std::unordered_map<Value, Set, Hash, Equal>;
+
+  HashIndex(ColumnBase *column,
+            const String &name,
+            const IndexOptions &options);
+  ~HashIndex() = default;
+
+  IndexType type() const {
+    return GRNXX_HASH_INDEX;
+  }
+  size_t num_entries() const {
+    return num_entries_;
+  }
+
+  bool test_uniqueness() const;
+
+  void insert(Int row_id, const Datum &value);
+  void remove(Int row_id, const Datum &value);
+
+  std::unique_ptr<Cursor> find(const Datum &value,
+                               const CursorOptions &options) const;
+
+ private:
+  mutable Map map_;
+  size_t num_entries_;
+};
+
+HashIndex<Int>::HashIndex(ColumnBase *column,
+                          const String &name,
+                          const IndexOptions &options)
+    : Index(column, name),
+      map_(),
+      num_entries_(0) {
+  // Entries are sorted and then inserted in order.
+  Array<IndexEntry<Int>> entries;
+  read_index_entries(static_cast<Column<Int> *>(column), options,
+                     [](Int value) { return value; }, &entries);
+  num_entries_ = build_index_map(entries.cref(),
+                                 [](Int key) { return key; }, &map_);
+}
+
+bool HashIndex<Int>::test_uniqueness() const {
+  for (const auto &it : map_) {
+    if (it.second.size() > 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashIndex<Int>::insert(Int row_id, const Datum &value) {
+  auto result = map_[value.as_int()].insert(row_id);
+  if (!result.second) {
+    throw "Entry already exists";  // TODO
+  }
+  ++num_entries_;
+}
+
+void HashIndex<Int>::remove(Int row_id, const Datum &value) {
+  auto map_it = map_.find(value.as_int());
+  if (map_it == map_.end()) {
+    throw "Entry not found";  // TODO
+  }
+  auto set_it = map_it->second.find(row_id);
+  if (set_it == map_it->second.end()) {
+    throw "Entry not found";  // TODO
+  }
+  map_it->second.erase(set_it);
+  if (map_it->second.size() == 0) {
+    map_.erase(map_it);
+  }
+  --num_entries_;
+}
+
+std::unique_ptr<Cursor> HashIndex<Int>::find(
+    const Datum &value,
+    const CursorOptions &options) const {
+  if (value.type() == GRNXX_NA) {
+    return create_empty_cursor();
+  } else if (value.type() != GRNXX_INT) {
+    throw "Data type conflict";  // TODO
+  }
+  auto map_it = map_.find(value.as_int());
+  if (map_it == map_.end()) {
+    return create_empty_cursor();
+  } else {
+    auto set_begin = map_it->second.begin();
+    auto set_end = map_it->second.end();
+    if (options.order_type == GRNXX_REGULAR_ORDER) {
+      return create_exact_match_cursor(
+          set_begin, set_end, options.offset, options.limit);
+    } else {
+      return create_reverse_exact_match_cursor(
+          set_begin, set_end, options.offset, options.limit);
+    }
+  }
+}
+
+// -- HashIndex<Float> --
+
+template <>
+class HashIndex<Float> : public Index {
+ public:
+  struct Less {
+    bool operator()(Int lhs, Int rhs) const {
+      return lhs.raw() < rhs.raw();
+    }
+  };
+  struct Hash {
+    uint64_t operator()(Float value) const {
+      return value.hash();
+    }
+  };
+  struct Equal {
+    bool operator()(Float lhs, Float rhs) const {
+      return lhs.match(rhs);
+    }
+  };
+
+  using Value = Float;
+  using Set = std::set<Int, Less>;
+  using Map = std::unordered_map<Value, Set, Hash, Equal>;
+
+  HashIndex(ColumnBase *column,
+            const String &name,
+            const IndexOptions &options);
+  ~HashIndex() = default;
+
+  IndexType type() const {
+    return GRNXX_HASH_INDEX;
+  }
+  size_t num_entries() const {
+    return num_entries_;
+  }
+
+  bool test_uniqueness() const;
+
+  void insert(Int row_id, const Datum &value);
+  void remove(Int row_id, const Datum &value);
+
+  std::unique_ptr<Cursor> find(const Datum &value,
+                               const CursorOptions &options) const;
+
+ private:
+  mutable Map map_;
+  size_t num_entries_;
+};
+
+HashIndex<Float>::HashIndex(ColumnBase *column,
+                            const String &name,
+                            const IndexOptions &options)
+    : Index(column, name),
+      map_(),
+      num_entries_(0) {
+  // Entries are sorted and then inserted in order.
+  Array<IndexEntry<Float>> entries;
+  read_index_entries(static_cast<Column<Float> *>(column), options,
+                     [](Float value) { return value; }, &entries);
+  num_entries_ = build_index_map(entries.cref(),
+                                 [](Float key) { return key; }, &map_);
+}
+
+bool HashIndex<Float>::test_uniqueness() const {
+  for (const auto &it : map_) {
+    if (it.second.size() > 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashIndex<Float>::insert(Int row_id, const Datum &value) {
+  auto result = map_[value.as_float()].insert(row_id);
+  if (!result.second) {
+    throw "Entry already exists";  // TODO
+  }
+  ++num_entries_;
+}
+
+void HashIndex<Float>::remove(Int row_id, const Datum &value) {
+  auto map_it = map_.find(value.as_float());
+  if (map_it == map_.end()) {
+    throw "Entry not found";  // TODO
+  }
+  auto set_it = map_it->second.find(row_id);
+  if (set_it == map_it->second.end()) {
+    throw "Entry not found";  // TODO
+  }
+  map_it->second.erase(set_it);
+  if (map_it->second.size() == 0) {
+    map_.erase(map_it);
+  }
+  --num_entries_;
+}
+
+std::unique_ptr<Cursor> HashIndex<Float>::find(
+    const Datum &value,
+    const CursorOptions &options) const {
+  if (value.type() == GRNXX_NA) {
+    return create_empty_cursor();
+  } else if (value.type() != GRNXX_FLOAT) {
+    throw "Data type conflict";  // TODO
+  }
+  auto map_it = map_.find(value.as_float());
+  if (map_it == map_.end()) {
+    return create_empty_cursor();
+  } else {
+    auto set_begin = map_it->second.begin();
+    auto set_end = map_it->second.end();
+    if (options.order_type == GRNXX_REGULAR_ORDER) {
+      return create_exact_match_cursor(
+          set_begin, set_end, options.offset, options.limit);
+    } else {
+      return create_reverse_exact_match_cursor(
+          set_begin, set_end, options.offset, options.limit);
+    }
+  }
+}
+
+// -- HashIndex<Text> --
+
+// If the column is dictionary-encoded, entries are keyed on codes instead of
+// values.
+// Codes in use never change, so that the entries remain valid.
+template <>
+class HashIndex<Text> : public Index {
+ public:
+  struct Hash {
+    uint64_t operator()(const String &value) const {
+      return Text(value).hash();
+    }
+  };
+
+  using Value = Text;
+  using Set = std::set<Int, RowIDLess>;
+  using Map = std::unordered_map<String, Set, Hash>;
+  using CodeMap = std::unordered_map<uint32_t, Set>;
+
+  HashIndex(ColumnBase *column,
+            const String &name,
+            const IndexOptions &options);
+  ~HashIndex() = default;
+
+  IndexType type() const {
+    return GRNXX_HASH_INDEX;
+  }
+  size_t num_entries() const {
+    return num_entries_;
+  }
+
+  bool test_uniqueness() const;
+
+  void insert(Int row_id, const Datum &value);
+  void remove(Int row_id, const Datum &value);
+
+  std::unique_ptr<Cursor> find(const Datum &value,
+                               const CursorOptions &options) const;
+
+ private:
+  const Column<Text> *column_;
+  mutable Map map_;
+  mutable CodeMap code_map_;
+  size_t num_entries_;
+
+  // Return the set of row IDs for "text", or nullptr if not found.
+  Set *find_set(const Text &text) const;
+  // Remove the set of row IDs for "text".
+  void erase_set(const Text &text);
+};
+
+HashIndex<Text>::HashIndex(ColumnBase *column,
+                           const String &name,
+                           const IndexOptions &options)
+    : Index(column, name),
+      column_(static_cast<Column<Text> *>(column)),
+      map_(),
+      code_map_(),
+      num_entries_(0) {
+  if (column_->is_dictionary_encoded()) {
+    // Rows are read in ascending order of row IDs, so that each set of row
+    // IDs is built without searching.
+    Array<Record> records;
+    column_->table()->create_cursor()->read_all(&records);
+    Array<uint32_t> codes;
+    codes.resize(records.size());
+    column_->read_codes(records.cref(), codes.ref());
+    for (size_t i = 0; i < records.size(); ++i) {
+      if (codes[i] != Column<Text>::na_code()) {
+        Set &set = code_map_[codes[i]];
+        set.emplace_hint(set.end(), records[i].row_id);
+        ++num_entries_;
+      }
+    }
+    return;
+  }
+  // Entries are sorted and then inserted in order.
+  Array<IndexEntry<Text>> entries;
+  read_index_entries(column_, options,
+                     [](const Text &value) { return value; }, &entries);
+  num_entries_ = build_index_map(entries.cref(), [](const Text &key) {
+    String string;
+    string.assign(key.raw_data(), key.raw_size());
+    return string;
+  }, &map_);
+}
+
+bool HashIndex<Text>::test_uniqueness() const {
+  for (const auto &it : map_) {
+    if (it.second.size() > 1) {
+      return false;
+    }
+  }
+  for (const auto &it : code_map_) {
+    if (it.second.size() > 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashIndex<Text>::insert(Int row_id, const Datum &value) {
+  Text text = value.as_text();
+  std::pair<Set::iterator, bool> result;
+  if (column_->is_dictionary_encoded()) {
+    // The column adds the value to the dictionary before this call.
+    uint32_t code = column_->find_code(text);
+    if (code == Column<Text>::na_code()) {
+      throw "Code not found";  // TODO
+    }
+    result = code_map_[code].insert(row_id);
+  } else {
+    String string;
+    string.assign(text.raw_data(), text.raw_size());
+    result = map_[std::move(string)].insert(row_id);
+  }
+  if (!result.second) {
+    throw "Entry already exists";  // TODO
+  }
+  ++num_entries_;
+}
+
+void HashIndex<Text>::remove(Int row_id, const Datum &value) {
+  Text text = value.as_text();
+  Set *set = find_set(text);
+  if (!set) {
+    throw "Entry not found";  // TODO
+  }
+  auto set_it = set->find(row_id);
+  if (set_it == set->end()) {
+    throw "Entry not found";  // TODO
+  }
+  set->erase(set_it);
+  if (set->size() == 0) {
+    erase_set(text);
+  }
+  --num_entries_;
+}
+
+std::unique_ptr<Cursor> HashIndex<Text>::find(
+    const Datum &value,
+    const CursorOptions &options) const {
+  if (value.type() == GRNXX_NA) {
+    return create_empty_cursor();
+  } else if (value.type() != GRNXX_TEXT) {
+    throw "Data type conflict";  // TODO
+  }
+  const Set *set = find_set(value.as_text());
+  if (!set) {
+    return create_empty_cursor();
+  } else {
+    auto set_begin = set->begin();
+    auto set_end = set->end();
+    if (options.order_type == GRNXX_REGULAR_ORDER) {
+      return create_exact_match_cursor(
+          set_begin, set_end, options.offset, options.limit);
+    } else {
+      return create_reverse_exact_match_cursor(
+          set_begin, set_end, options.offset, options.limit);
+    }
+  }
+}
+
+HashIndex<Text>::Set *HashIndex<Text>::find_set(const Text &text) const {
+  if (column_->is_dictionary_encoded()) {
+    auto map_it = code_map_.find(column_->find_code(text));
+    return (map_it != code_map_.end()) ? &map_it->second : nullptr;
+  }
+  auto map_it = map_.find(String(text.raw_data(), text.raw_size()));
+  return (map_it != map_.end()) ? &map_it->second : nullptr;
+}
+
+void HashIndex<Text>::erase_set(const Text &text) {
+  if (column_->is_dictionary_encoded()) {
+    code_map_.erase(column_->find_code(text));
+  } else {
+    map_.erase(String(text.raw_data(), text.raw_size()));
+  }
+}
+
+// -- PostingList --
+
+// Posting lists are split into blocks of at most "MAX_POSTING_BLOCK_SIZE"
+// rows, so that an update decodes and encodes only one block.
+constexpr size_t MAX_POSTING_BLOCK_SIZE = 128;
+
+// A block of a posting list, which keeps entries in ascending order of row
+// ID. The row ID of an entry is stored as the difference from the previous
+// row ID in the block, and the first row ID is stored as is.
+struct PostingBlock {
+  Array<uint8_t> bytes;
+  size_t size;
+  int64_t last_row_id;
+
+  PostingBlock() : bytes(), size(0), last_row_id(0) {}
+};
+
+// Return the position of the first block whose last row ID is "row_id" or
+// greater.
+size_t find_posting_block(const Array<PostingBlock> &blocks, int64_t row_id) {
+  const PostingBlock *begin = blocks.data();
+  const PostingBlock *end = begin + blocks.size();
+  return std::lower_bound(begin, end, row_id,
+                          [](const PostingBlock &lhs, int64_t rhs) {
+    return lhs.last_row_id < rhs;
+  }) - begin;
+}
+
+// Insert "block" into "*blocks" at "pos".
+//
+// On failure, throws an exception.
+void insert_posting_block(Array<PostingBlock> *blocks,
+                          size_t pos,
+                          PostingBlock &&block) {
+  blocks->push_back(PostingBlock());
+  for (size_t i = blocks->size() - 1; i > pos; --i) {
+    (*blocks)[i] = std::move((*blocks)[i - 1]);
+  }
+  (*blocks)[pos] = std::move(block);
+}
+
+// Append the row ID of an entry to "*block".
+//
+// "extra_size" is the maximum size of the remaining part of the entry.
+// On success, returns a pointer to the remaining part.
+//
+// On failure, throws an exception.
+uint8_t *append_posting_entry(int64_t row_id,
+                              size_t extra_size,
+                              PostingBlock *block) try {
+  int64_t diff = (block->size == 0) ? row_id : (row_id - block->last_row_id);
+  size_t offset = block->bytes.size();
+  block->bytes.resize(offset + MAX_VARINT_SIZE + extra_size);
+  uint8_t *buf = &block->bytes[offset];
+  size_t size = write_varint(static_cast<uint64_t>(diff), buf);
+  block->last_row_id = row_id;
+  ++block->size;
+  return buf + size;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+// Remove entries of "row_ids" from "*blocks".
+//
+// "row_ids" must be sorted in ascending order of row ID.
+// "remove_entries(block, row_ids, new_block)" is called for each block which
+// may contain some of "row_ids", and creates "*new_block" from the remaining
+// entries and returns the number of removed entries.
+// Blocks are replaced after all the new blocks are created, so that
+// "*blocks" is not changed on failure.
+//
+// On success, returns the number of removed entries.
+// On failure, throws an exception.
+template <typename T>
+size_t remove_posting_entries(Array<PostingBlock> *blocks,
+                              ArrayCRef<Int> row_ids,
+                              T remove_entries) try {
+  Array<size_t> block_ids;
+  Array<PostingBlock> new_blocks;
+  size_t count = 0;
+  size_t begin = 0;
+  while (begin < row_ids.size()) {
+    size_t block_id = find_posting_block(*blocks, row_ids[begin].raw());
+    if (block_id == blocks->size()) {
+      break;
+    }
+    // "row_ids[begin, end)" may be in the block.
+    int64_t last_row_id = (*blocks)[block_id].last_row_id;
+    size_t end = begin + 1;
+    while ((end < row_ids.size()) && (row_ids[end].raw() <= last_row_id)) {
+      ++end;
+    }
+    PostingBlock new_block;
+    size_t num_removed = remove_entries((*blocks)[block_id],
+                                        row_ids.cref(begin, end - begin),
+                                        &new_block);
+    if (num_removed != 0) {
+      block_ids.push_back(block_id);
+      new_blocks.push_back(std::move(new_block));
+      count += num_removed;
+    }
+    begin = end;
+  }
+  bool has_empty_block = false;
+  for (size_t i = 0; i < block_ids.size(); ++i) {
+    (*blocks)[block_ids[i]] = std::move(new_blocks[i]);
+    has_empty_block |= ((*blocks)[block_ids[i]].size == 0);
+  }
+  if (has_empty_block) {
+    size_t num_blocks = 0;
+    for (size_t i = 0; i < blocks->size(); ++i) {
+      if ((*blocks)[i].size != 0) {
+        if (i != num_blocks) {
+          (*blocks)[num_blocks] = std::move((*blocks)[i]);
+        }
+        ++num_blocks;
+      }
+    }
+    blocks->resize(num_blocks);
+  }
+  return count;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+// A posting list keeps row IDs in ascending order as varints of the
+// differences between adjacent row IDs.
+//
+// Row IDs are mostly inserted in ascending order, so appending is fast and
+// the other updates rebuild only the block of the row.
+class PostingList {
+ public:
+  PostingList() : blocks_(), size_(0) {}
+  ~PostingList() = default;
+
+  PostingList(PostingList &&) = default;
+  PostingList &operator=(PostingList &&) = default;
+
+  // Return the number of row IDs.
+  size_t size() const {
+    return size_;
+  }
+
+  // Insert "row_id".
+  //
+  // If inserted, returns true.
+  // If already exists, returns false.
+  //
+  // On failure, throws an exception.
+  bool insert(Int row_id);
+  // Remove "row_id".
+  //
+  // If removed, returns true.
+  // If not found, returns false.
+  //
+  // On failure, throws an exception.
+  bool remove(Int row_id);
+  // Remove "row_ids" in ascending order.
+  //
+  // Returns the number of removed row IDs.
+  //
+  // On failure, throws an exception.
+  size_t remove_rows(ArrayCRef<Int> row_ids);
+
+  // Append row IDs to "*row_ids".
+  //
+  // On failure, throws an exception.
+  void decode(Array<Int> *row_ids) const;
+
+ private:
+  Array<PostingBlock> blocks_;
+  size_t size_;
+
+  // Append row IDs in "block" to "*row_ids".
+  //
+  // On failure, throws an exception.
+  static void decode_block(const PostingBlock &block, Array<Int> *row_ids);
+  // Create a block of "row_ids".
+  //
+  // On failure, throws an exception.
+  static PostingBlock encode_block(ArrayCRef<Int> row_ids);
+  // Append "row_id" which is greater than "block->last_row_id".
+  //
+  // On failure, throws an exception.
+  static void append(int64_t row_id, PostingBlock *block);
+};
+
+bool PostingList::insert(Int row_id) {
+  if ((size_ == 0) || (row_id.raw() > blocks_.back().last_row_id)) {
+    if ((size_ != 0) && (blocks_.back().size < MAX_POSTING_BLOCK_SIZE)) {
+      append(row_id.raw(), &blocks_.back());
+    } else {
+      PostingBlock block;
+      append(row_id.raw(), &block);
+      blocks_.push_back(std::move(block));
+    }
+    ++size_;
+    return true;
+  }
+  size_t block_id = find_posting_block(blocks_, row_id.raw());
+  Array<Int> row_ids;
+  decode_block(blocks_[block_id], &row_ids);
+  Int *begin = row_ids.buffer();
+  Int *end = begin + row_ids.size();
+  Int *it = std::lower_bound(begin, end, row_id, RowIDLess());
+  if ((it != end) && it->match(row_id)) {
+    return false;
+  }
+  size_t pos = it - begin;
+  row_ids.push_back(row_id);
+  for (size_t i = row_ids.size() - 1; i > pos; --i) {
+    row_ids[i] = row_ids[i - 1];
+  }
+  row_ids[pos] = row_id;
+  if (row_ids.size() > MAX_POSTING_BLOCK_SIZE) {
+    // A full block is split into halves.
+    size_t half = row_ids.size() / 2;
+    PostingBlock first_half = encode_block(row_ids.cref(0, half));
+    PostingBlock second_half = encode_block(row_ids.cref(half));
+    insert_posting_block(&blocks_, block_id + 1, std::move(second_half));
+    blocks_[block_id] = std::move(first_half);
+  } else {
+    blocks_[block_id] = encode_block(row_ids);
+  }
+  ++size_;
+  return true;
+}
+
+bool PostingList::remove(Int row_id) {
+  if ((size_ == 0) || (row_id.raw() > blocks_.back().last_row_id)) {
+    return false;
+  }
+  size_t block_id = find_posting_block(blocks_, row_id.raw());
+  Array<Int> row_ids;
+  decode_block(blocks_[block_id], &row_ids);
+  Int *begin = row_ids.buffer();
+  Int *end = begin + row_ids.size();
+  Int *it = std::lower_bound(begin, end, row_id, RowIDLess());
+  if ((it == end) || it->unmatch(row_id)) {
+    return false;
+  }
+  if (row_ids.size() == 1) {
+    blocks_.erase(block_id);
+  } else {
+    row_ids.erase(it - begin);
+    blocks_[block_id] = encode_block(row_ids);
+  }
+  --size_;
+  return true;
+}
+
+size_t PostingList::remove_rows(ArrayCRef<Int> row_ids) {
+  Array<Int> block_row_ids;
+  size_t count = remove_posting_entries(&blocks_, row_ids,
+      [&block_row_ids](const PostingBlock &block,
+                       ArrayCRef<Int> removed_row_ids,
+                       PostingBlock *new_block) {
+    block_row_ids.clear();
+    decode_block(block, &block_row_ids);
+    // Both are sorted, so remaining row IDs are found by merging them.
+    size_t num_row_ids = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < block_row_ids.size(); ++i) {
+      int64_t row_id = block_row_ids[i].raw();
+      while ((j < removed_row_ids.size()) &&
+             (removed_row_ids[j].raw() < row_id)) {
+        ++j;
+      }
+      if ((j < removed_row_ids.size()) &&
+          (removed_row_ids[j].raw() == row_id)) {
+        continue;
+      }
+      block_row_ids[num_row_ids] = block_row_ids[i];
+      ++num_row_ids;
+    }
+    *new_block = encode_block(block_row_ids.cref(0, num_row_ids));
+    return block_row_ids.size() - num_row_ids;
+  });
+  size_ -= count;
+  return count;
+}
+
+void PostingList::decode(Array<Int> *row_ids) const try {
+  row_ids->reserve(row_ids->size() + size_);
+  for (size_t i = 0; i < blocks_.size(); ++i) {
+    decode_block(blocks_[i], row_ids);
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void PostingList::decode_block(const PostingBlock &block,
+                               Array<Int> *row_ids) try {
+  size_t offset = row_ids->size();
+  row_ids->resize(offset + block.size);
+  const uint8_t *it = block.bytes.data();
+  uint64_t row_id = 0;
+  for (size_t i = 0; i < block.size; ++i) {
+    uint64_t diff;
+    it = read_varint(it, &diff);
+    row_id += diff;
+    (*row_ids)[offset + i] = Int(static_cast<int64_t>(row_id));
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+PostingBlock PostingList::encode_block(ArrayCRef<Int> row_ids) {
+  PostingBlock block;
+  for (size_t i = 0; i < row_ids.size(); ++i) {
+    append(row_ids[i].raw(), &block);
+  }
+  return block;
+}
+
+void PostingList::append(int64_t row_id, PostingBlock *block) {
+  uint8_t *end = append_posting_entry(row_id, 0, block);
+  block->bytes.resize(end - block->bytes.data());
+}
+
+// -- InvertedIndex --
+
+// An inverted index of a vector column maps each element to a posting list
+// of rows having the element.
+template <typename T> struct InvertedIndexKey;
+
+template <>
+struct InvertedIndexKey<Int> {
+  using Key = int64_t;
+  using Hash = std::hash<int64_t>;
+  static Key get(Int value) {
+    return value.raw();
+  }
+  // Return a key which can be stored.
+  static Key get_stored(Int value) {
+    return value.raw();
+  }
+};
+
+template <>
+struct InvertedIndexKey<Text> {
+  using Key = String;
+  struct Hash {
+    uint64_t operator()(const String &value) const {
+      return Text(value).hash();
+    }
+  };
+  // Return a key which refers to "value".
+  static Key get(const Text &value) {
+    return String(value.raw_data(), value.raw_size());
+  }
+  // Return a key which can be stored.
+  static Key get_stored(const Text &value) {
+    Key key;
+    key.assign(value.raw_data(), value.raw_size());
+    return key;
+  }
+};
+
+// Read values of a vector column.
+//
+// Delta-encoded values are decoded into "*pool" and the results refer to
+// "*pool".
+//
+// On failure, throws an exception.
+void read_vector_values(const Column<Vector<Int>> *column,
+                        ArrayCRef<Record> records,
+                        ArrayRef<Vector<Int>> values,
+                        Array<Int> *pool) {
+  column->read(records, values, pool);
+}
+void read_vector_values(const Column<Vector<Text>> *column,
+                        ArrayCRef<Record> records,
+                        ArrayRef<Vector<Text>> values,
+                        Array<Int> *) {
+  column->read(records, values);
+}
+
+template <typename T>
+class InvertedIndex : public Index {
+ public:
+  using Value = Vector<T>;
+  using Element = T;
+  using Key = typename InvertedIndexKey<T>::Key;
+  using Hash = typename InvertedIndexKey<T>::Hash;
+  using Map = std::unordered_map<Key, PostingList, Hash>;
+
+  InvertedIndex(ColumnBase *column,
+                const String &name,
+                const IndexOptions &options);
+  ~InvertedIndex() = default;
+
+  IndexType type() const {
+    return GRNXX_HASH_INDEX;
+  }
+  size_t num_entries() const {
+    return num_entries_;
+  }
+
+  bool test_uniqueness() const;
+
+  void insert(Int row_id, const Datum &value);
+  void remove(Int row_id, const Datum &value);
+  void remove_rows(ArrayCRef<Int> row_ids);
+
+  std::unique_ptr<Cursor> find(const Datum &value,
+                               const CursorOptions &options) const;
+  std::unique_ptr<Cursor> find_contains(const Datum &value,
+                                        const CursorOptions &options) const {
+    return find(value, options);
+  }
 
  private:
-  mutable Map map_;
+  Map map_;
   size_t num_entries_;
+
+  // Return "datum" as a vector.
+  static Value get_value(const Datum &datum);
 };
 
-HashIndex<Float>::HashIndex(ColumnBase *column,
-                            const String &name,
-                            const IndexOptions &)
+template <typename T>
+InvertedIndex<T>::InvertedIndex(ColumnBase *column,
+                                const String &name,
+                                const IndexOptions &)
     : Index(column, name),
       map_(),
       num_entries_(0) {
   auto cursor = column->table()->create_cursor();
-  auto typed_column = static_cast<Column<Float> *>(column);
+  auto typed_column = static_cast<Column<Value> *>(column);
   Array<Record> records;
   Array<Value> values;
+  Array<Int> pool;
   for ( ; ; ) {
     size_t count = cursor->read(1024, &records);
     if (count == 0) {
       break;
     }
     values.resize(records.size());
-    typed_column->read(records, values.ref());
+    read_vector_values(typed_column, records, values.ref(), &pool);
     for (size_t i = 0; i < count; ++i) {
       if (!values[i].is_na()) {
         insert(records[i].row_id, values[i]);
@@ -1125,7 +2832,8 @@ HashIndex<Float>::HashIndex(ColumnBase *column,
   }
 }
 
-bool HashIndex<Float>::test_uniqueness() const {
+template <typename T>
+bool InvertedIndex<T>::test_uniqueness() const {
   for (const auto &it : map_) {
     if (it.second.size() > 1) {
       return false;
@@ -1134,76 +2842,766 @@ bool HashIndex<Float>::test_uniqueness() const {
   return true;
 }
 
-void HashIndex<Float>::insert(Int row_id, const Datum &value) {
-  auto result = map_[value.as_float()].insert(row_id);
-  if (!result.second) {
-    throw "Entry already exists";  // TODO
+template <typename T>
+void InvertedIndex<T>::insert(Int row_id, const Datum &value) try {
+  Value vector = get_value(value);
+  size_t size = vector.raw_size();
+  for (size_t i = 0; i < size; ++i) {
+    Element element = vector[Int(i)];
+    if (element.is_na()) {
+      continue;
+    }
+    auto it = map_.find(InvertedIndexKey<T>::get(element));
+    if (it == map_.end()) {
+      it = map_.emplace(InvertedIndexKey<T>::get_stored(element),
+                        PostingList()).first;
+    }
+    // NOTE: An element may appear more than once in a vector.
+    if (it->second.insert(row_id)) {
+      ++num_entries_;
+    }
   }
-  ++num_entries_;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
 }
 
-void HashIndex<Float>::remove(Int row_id, const Datum &value) {
-  auto map_it = map_.find(value.as_float());
-  if (map_it == map_.end()) {
-    throw "Entry not found";  // TODO
+template <typename T>
+void InvertedIndex<T>::remove(Int row_id, const Datum &value) {
+  Value vector = get_value(value);
+  size_t size = vector.raw_size();
+  for (size_t i = 0; i < size; ++i) {
+    Element element = vector[Int(i)];
+    if (element.is_na()) {
+      continue;
+    }
+    auto it = map_.find(InvertedIndexKey<T>::get(element));
+    if (it == map_.end()) {
+      // NOTE: An element may appear more than once in a vector.
+      continue;
+    }
+    if (it->second.remove(row_id)) {
+      --num_entries_;
+      if (it->second.size() == 0) {
+        map_.erase(it);
+      }
+    }
   }
-  auto set_it = map_it->second.find(row_id);
-  if (set_it == map_it->second.end()) {
-    throw "Entry not found";  // TODO
+}
+
+template <typename T>
+void InvertedIndex<T>::remove_rows(ArrayCRef<Int> row_ids) try {
+  // Row IDs are grouped by posting lists, so that each posting list is
+  // updated in one pass.
+  struct Group {
+    typename Map::iterator it;
+    Array<Int> row_ids;
+  };
+  std::unordered_map<const PostingList *, Group> groups;
+  auto typed_column = static_cast<const Column<Value> *>(_column());
+  Array<Record> records;
+  Array<Value> values;
+  Array<Int> pool;
+  for (size_t offset = 0; offset < row_ids.size(); offset += 1024) {
+    size_t block_size = row_ids.size() - offset;
+    if (block_size > 1024) {
+      block_size = 1024;
+    }
+    records.resize(block_size);
+    for (size_t i = 0; i < block_size; ++i) {
+      records[i] = Record(row_ids[offset + i], Float(0.0));
+    }
+    values.resize(block_size);
+    read_vector_values(typed_column, records, values.ref(), &pool);
+    for (size_t i = 0; i < block_size; ++i) {
+      size_t size = values[i].is_na() ? 0 : values[i].raw_size();
+      for (size_t j = 0; j < size; ++j) {
+        Element element = values[i][Int(j)];
+        if (element.is_na()) {
+          continue;
+        }
+        auto it = map_.find(InvertedIndexKey<T>::get(element));
+        if (it == map_.end()) {
+          continue;
+        }
+        Group &group = groups[&it->second];
+        group.it = it;
+        // NOTE: An element may appear more than once in a vector.
+        if (group.row_ids.is_empty() ||
+            group.row_ids.back().unmatch(records[i].row_id)) {
+          group.row_ids.push_back(records[i].row_id);
+        }
+      }
+    }
   }
-  map_it->second.erase(set_it);
-  if (map_it->second.size() == 0) {
-    map_.erase(map_it);
+  for (auto &it : groups) {
+    Group &group = it.second;
+    num_entries_ -= group.it->second.remove_rows(group.row_ids);
+    if (group.it->second.size() == 0) {
+      map_.erase(group.it);
+    }
   }
-  --num_entries_;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
 }
 
-std::unique_ptr<Cursor> HashIndex<Float>::find(
+template <typename T>
+std::unique_ptr<Cursor> InvertedIndex<T>::find(
     const Datum &value,
-    const CursorOptions &options) const {
+    const CursorOptions &options) const try {
   if (value.type() == GRNXX_NA) {
     return create_empty_cursor();
-  } else if (value.type() != GRNXX_FLOAT) {
+  } else if (value.type() != Element::type()) {
     throw "Data type conflict";  // TODO
   }
-  auto map_it = map_.find(value.as_float());
-  if (map_it == map_.end()) {
+  Element element;
+  value.force(&element);
+  if (element.is_na()) {
+    return create_empty_cursor();
+  }
+  auto it = map_.find(InvertedIndexKey<T>::get(element));
+  if (it == map_.end()) {
     return create_empty_cursor();
+  }
+  Array<Int> row_ids;
+  it->second.decode(&row_ids);
+  if (options.order_type == GRNXX_REVERSE_ORDER) {
+    std::reverse(row_ids.buffer(), row_ids.buffer() + row_ids.size());
+  }
+  return std::unique_ptr<Cursor>(new RowIDArrayCursor(
+      std::move(row_ids), options.offset, options.limit));
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+template <typename T>
+Vector<T> InvertedIndex<T>::get_value(const Datum &datum) {
+  if (datum.type() == GRNXX_NA) {
+    return Value::na();
+  } else if (datum.type() != Value::type()) {
+    throw "Data type conflict";  // TODO
+  }
+  Value value;
+  datum.force(&value);
+  return value;
+}
+
+// -- PositionalPostingList --
+
+// Rows and positions read from a positional posting list.
+//
+// The positions of the "i"-th row are
+// [positions[offsets[i]], positions[offsets[i + 1]]).
+struct PositionalPostings {
+  Array<Int> row_ids;
+  Array<size_t> offsets;
+  Array<uint64_t> positions;
+};
+
+// A positional posting list keeps entries in ascending order of row ID.
+// An entry is the difference from the previous row ID, the number of
+// positions and the differences between adjacent positions, all in varint.
+//
+// Like PostingList, entries are split into blocks, so that an update in the
+// middle rebuilds only one block.
+class PositionalPostingList {
+ public:
+  class Iterator;
+
+  PositionalPostingList() : blocks_(), size_(0) {}
+  ~PositionalPostingList() = default;
+
+  PositionalPostingList(PositionalPostingList &&) = default;
+  PositionalPostingList &operator=(PositionalPostingList &&) = default;
+
+  // Return the number of rows.
+  size_t size() const {
+    return size_;
+  }
+
+  // Insert "row_id" with "positions" in ascending order.
+  //
+  // On failure, throws an exception.
+  void insert(Int row_id, ArrayCRef<uint64_t> positions);
+  // Remove "row_id".
+  //
+  // If removed, returns true.
+  // If not found, returns false.
+  //
+  // On failure, throws an exception.
+  bool remove(Int row_id);
+  // Remove "row_ids" in ascending order.
+  //
+  // Returns the number of removed rows.
+  //
+  // On failure, throws an exception.
+  size_t remove_rows(ArrayCRef<Int> row_ids);
+
+  // Read rows and positions into "*postings".
+  //
+  // On failure, throws an exception.
+  void decode(PositionalPostings *postings) const;
+
+ private:
+  Array<PostingBlock> blocks_;
+  size_t size_;
+
+  // Append rows and positions in "block" to "*postings".
+  //
+  // On failure, throws an exception.
+  static void decode_block(const PostingBlock &block,
+                           PositionalPostings *postings);
+  // Create a block of the "begin"-th to the "end - 1"-th entries of
+  // "postings".
+  //
+  // On failure, throws an exception.
+  static PostingBlock encode_block(const PositionalPostings &postings,
+                                   size_t begin,
+                                   size_t end);
+  // Append an entry whose row ID is greater than "block->last_row_id".
+  //
+  // On failure, throws an exception.
+  static void append(int64_t row_id,
+                     ArrayCRef<uint64_t> positions,
+                     PostingBlock *block);
+};
+
+void PositionalPostingList::insert(Int row_id,
+                                   ArrayCRef<uint64_t> positions) {
+  if ((size_ == 0) || (row_id.raw() > blocks_.back().last_row_id)) {
+    if ((size_ != 0) && (blocks_.back().size < MAX_POSTING_BLOCK_SIZE)) {
+      append(row_id.raw(), positions, &blocks_.back());
+    } else {
+      PostingBlock block;
+      append(row_id.raw(), positions, &block);
+      blocks_.push_back(std::move(block));
+    }
+    ++size_;
+    return;
+  }
+  size_t block_id = find_posting_block(blocks_, row_id.raw());
+  PositionalPostings postings;
+  postings.offsets.push_back(0);
+  decode_block(blocks_[block_id], &postings);
+  size_t pos = std::lower_bound(
+      postings.row_ids.data(),
+      postings.row_ids.data() + postings.row_ids.size(),
+      row_id, RowIDLess()) - postings.row_ids.data();
+  if ((pos != postings.row_ids.size()) &&
+      postings.row_ids[pos].match(row_id)) {
+    throw "Entry already exists";  // TODO
+  }
+  // Build the new entries from the entries before and after "row_id".
+  PositionalPostings new_postings;
+  new_postings.offsets.push_back(0);
+  for (size_t i = 0; i <= postings.row_ids.size(); ++i) {
+    ArrayCRef<uint64_t> entry_positions = positions;
+    Int entry_row_id = row_id;
+    if (i != pos) {
+      size_t j = (i < pos) ? i : (i - 1);
+      entry_row_id = postings.row_ids[j];
+      entry_positions = postings.positions.cref(
+          postings.offsets[j], postings.offsets[j + 1] - postings.offsets[j]);
+    }
+    new_postings.row_ids.push_back(entry_row_id);
+    for (size_t k = 0; k < entry_positions.size(); ++k) {
+      new_postings.positions.push_back(entry_positions[k]);
+    }
+    new_postings.offsets.push_back(new_postings.positions.size());
+  }
+  size_t size = new_postings.row_ids.size();
+  if (size > MAX_POSTING_BLOCK_SIZE) {
+    // A full block is split into halves.
+    PostingBlock first_half = encode_block(new_postings, 0, size / 2);
+    PostingBlock second_half = encode_block(new_postings, size / 2, size);
+    insert_posting_block(&blocks_, block_id + 1, std::move(second_half));
+    blocks_[block_id] = std::move(first_half);
   } else {
-    auto set_begin = map_it->second.begin();
-    auto set_end = map_it->second.end();
-    if (options.order_type == GRNXX_REGULAR_ORDER) {
-      return create_exact_match_cursor(
-          set_begin, set_end, options.offset, options.limit);
+    blocks_[block_id] = encode_block(new_postings, 0, size);
+  }
+  ++size_;
+}
+
+bool PositionalPostingList::remove(Int row_id) {
+  if ((size_ == 0) || (row_id.raw() > blocks_.back().last_row_id)) {
+    return false;
+  }
+  size_t block_id = find_posting_block(blocks_, row_id.raw());
+  PositionalPostings postings;
+  postings.offsets.push_back(0);
+  decode_block(blocks_[block_id], &postings);
+  size_t pos = std::lower_bound(
+      postings.row_ids.data(),
+      postings.row_ids.data() + postings.row_ids.size(),
+      row_id, RowIDLess()) - postings.row_ids.data();
+  if ((pos == postings.row_ids.size()) ||
+      postings.row_ids[pos].unmatch(row_id)) {
+    return false;
+  }
+  if (postings.row_ids.size() == 1) {
+    blocks_.erase(block_id);
+  } else {
+    PostingBlock block = encode_block(postings, 0, pos);
+    for (size_t i = pos + 1; i < postings.row_ids.size(); ++i) {
+      size_t begin = postings.offsets[i];
+      size_t end = postings.offsets[i + 1];
+      append(postings.row_ids[i].raw(),
+             postings.positions.cref(begin, end - begin), &block);
+    }
+    blocks_[block_id] = std::move(block);
+  }
+  --size_;
+  return true;
+}
+
+size_t PositionalPostingList::remove_rows(ArrayCRef<Int> row_ids) {
+  PositionalPostings postings;
+  size_t count = remove_posting_entries(&blocks_, row_ids,
+      [&postings](const PostingBlock &block,
+                  ArrayCRef<Int> removed_row_ids,
+                  PostingBlock *new_block) {
+    postings.row_ids.clear();
+    postings.offsets.resize(1);
+    postings.offsets[0] = 0;
+    postings.positions.clear();
+    decode_block(block, &postings);
+    // Both are sorted, so remaining entries are found by merging them.
+    size_t num_removed = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < postings.row_ids.size(); ++i) {
+      int64_t row_id = postings.row_ids[i].raw();
+      while ((j < removed_row_ids.size()) &&
+             (removed_row_ids[j].raw() < row_id)) {
+        ++j;
+      }
+      if ((j < removed_row_ids.size()) &&
+          (removed_row_ids[j].raw() == row_id)) {
+        ++num_removed;
+        continue;
+      }
+      size_t begin = postings.offsets[i];
+      size_t end = postings.offsets[i + 1];
+      append(row_id, postings.positions.cref(begin, end - begin), new_block);
+    }
+    return num_removed;
+  });
+  size_ -= count;
+  return count;
+}
+
+void PositionalPostingList::decode(PositionalPostings *postings) const try {
+  postings->row_ids.clear();
+  postings->offsets.resize(1);
+  postings->positions.clear();
+  postings->offsets[0] = 0;
+  postings->row_ids.reserve(size_);
+  postings->offsets.reserve(size_ + 1);
+  for (size_t i = 0; i < blocks_.size(); ++i) {
+    decode_block(blocks_[i], postings);
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void PositionalPostingList::decode_block(const PostingBlock &block,
+                                         PositionalPostings *postings) try {
+  const uint8_t *it = block.bytes.data();
+  uint64_t row_id = 0;
+  for (size_t i = 0; i < block.size; ++i) {
+    uint64_t diff;
+    it = read_varint(it, &diff);
+    row_id += diff;
+    postings->row_ids.push_back(Int(static_cast<int64_t>(row_id)));
+    uint64_t num_positions;
+    it = read_varint(it, &num_positions);
+    uint64_t position = 0;
+    for (uint64_t j = 0; j < num_positions; ++j) {
+      it = read_varint(it, &diff);
+      position += diff;
+      postings->positions.push_back(position);
+    }
+    postings->offsets.push_back(postings->positions.size());
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+PostingBlock PositionalPostingList::encode_block(
+    const PositionalPostings &postings,
+    size_t begin,
+    size_t end) {
+  PostingBlock block;
+  for (size_t i = begin; i < end; ++i) {
+    size_t positions_begin = postings.offsets[i];
+    size_t positions_end = postings.offsets[i + 1];
+    append(postings.row_ids[i].raw(),
+           postings.positions.cref(positions_begin,
+                                   positions_end - positions_begin),
+           &block);
+  }
+  return block;
+}
+
+void PositionalPostingList::append(int64_t row_id,
+                                   ArrayCRef<uint64_t> positions,
+                                   PostingBlock *block) {
+  uint8_t *buf = append_posting_entry(
+      row_id, MAX_VARINT_SIZE * (positions.size() + 1), block);
+  buf += write_varint(positions.size(), buf);
+  uint64_t prev_position = 0;
+  for (size_t i = 0; i < positions.size(); ++i) {
+    buf += write_varint(positions[i] - prev_position, buf);
+    prev_position = positions[i];
+  }
+  block->bytes.resize(buf - block->bytes.data());
+}
+
+// An iterator over entries of a positional posting list in ascending order of
+// row ID, which decodes one block at a time, so that blocks skipped by
+// seek() are never decoded.
+class PositionalPostingList::Iterator {
+ public:
+  Iterator() : list_(nullptr), block_id_(0), postings_(), pos_(0) {}
+  // Move to the first entry of "list".
+  //
+  // On failure, throws an exception.
+  explicit Iterator(const PositionalPostingList *list)
+      : list_(list),
+        block_id_(0),
+        postings_(),
+        pos_(0) {
+    load(0);
+  }
+  ~Iterator() = default;
+
+  Iterator(Iterator &&) = default;
+  Iterator &operator=(Iterator &&) = default;
+
+  // Return the current row ID or INT64_MAX if the end is reached.
+  int64_t row_id() const {
+    return (pos_ < postings_.row_ids.size()) ?
+           postings_.row_ids[pos_].raw() :
+           std::numeric_limits<int64_t>::max();
+  }
+  // Return the positions of the current entry.
+  ArrayCRef<uint64_t> positions() const {
+    size_t begin = postings_.offsets[pos_];
+    return postings_.positions.cref(begin,
+                                    postings_.offsets[pos_ + 1] - begin);
+  }
+
+  // Move to the next entry.
+  //
+  // On failure, throws an exception.
+  void next() {
+    if (++pos_ == postings_.row_ids.size()) {
+      load(block_id_ + 1);
+    }
+  }
+  // Move to the first entry whose row ID is "row_id" or greater.
+  //
+  // On failure, throws an exception.
+  void seek(int64_t row_id) {
+    if (row_id <= this->row_id()) {
+      return;
+    }
+    if (row_id > list_->blocks_[block_id_].last_row_id) {
+      // Blocks whose last row IDs are less than "row_id" are skipped.
+      load(find_posting_block(list_->blocks_, row_id));
+      if (block_id_ == list_->blocks_.size()) {
+        return;
+      }
+    }
+    pos_ = std::lower_bound(
+        postings_.row_ids.data() + pos_,
+        postings_.row_ids.data() + postings_.row_ids.size(),
+        Int(row_id), RowIDLess()) - postings_.row_ids.data();
+  }
+
+ private:
+  const PositionalPostingList *list_;
+  size_t block_id_;
+  PositionalPostings postings_;
+  size_t pos_;
+
+  // Decode the "block_id"-th block.
+  //
+  // On failure, throws an exception.
+  void load(size_t block_id) {
+    block_id_ = block_id;
+    postings_.row_ids.clear();
+    postings_.offsets.resize(1);
+    postings_.offsets[0] = 0;
+    postings_.positions.clear();
+    pos_ = 0;
+    if (block_id < list_->blocks_.size()) {
+      decode_block(list_->blocks_[block_id], &postings_);
+    }
+  }
+};
+
+// -- FullTextIndex --
+
+// Parameters of BM25.
+//
+// "BM25_K1" controls how fast the score saturates as a term occurs more
+// often and "BM25_B" controls how much the score is normalized by the text
+// length.
+constexpr double BM25_K1 = 1.2;
+constexpr double BM25_B = 0.75;
+
+// An iterator over rows containing a text in ascending order of row ID.
+//
+// Rows are found by seeking the positional posting lists of the bigrams in
+// the text, the shortest list first, and verified only if all the lists
+// contain them, so that rows skipped by seek() are neither decoded nor
+// verified. A text shorter than a bigram has no posting lists and its rows
+// are given in advance.
+class TextIterator {
+ public:
+  TextIterator()
+      : iterators_(),
+        offsets_(),
+        max_size_(0),
+        row_ids_(),
+        frequencies_(),
+        pos_(0),
+        candidates_(),
+        next_candidates_(),
+        row_id_(-1),
+        frequency_(0) {}
+  ~TextIterator() = default;
+
+  TextIterator(TextIterator &&) = default;
+  TextIterator &operator=(TextIterator &&) = default;
+
+  // Set the posting lists of the bigrams in the text and their offsets in
+  // the text, and move to the first row.
+  //
+  // On failure, throws an exception.
+  void reset(ArrayCRef<const PositionalPostingList *> lists,
+             ArrayCRef<size_t> offsets);
+  // Set rows and the numbers of occurrences, and move to the first row.
+  void reset(Array<Int> &&row_ids, Array<uint32_t> &&frequencies);
+
+  // Return the upper bound of the number of rows.
+  size_t max_size() const {
+    return (iterators_.size() != 0) ?
+           max_size_ : row_ids_.size();
+  }
+  // Return the current row ID or INT64_MAX if the end is reached.
+  int64_t row_id() const {
+    return row_id_;
+  }
+  // Return the number of occurrences, including overlapping ones, in the
+  // current row.
+  uint32_t frequency() const {
+    return frequency_;
+  }
+
+  // Move to the next row.
+  //
+  // On failure, throws an exception.
+  void next() {
+    find(row_id_ + 1);
+  }
+  // Move to the first row whose ID is "row_id" or greater.
+  //
+  // On failure, throws an exception.
+  void seek(int64_t row_id) {
+    if (row_id > row_id_) {
+      find(row_id);
+    }
+  }
+
+ private:
+  Array<PositionalPostingList::Iterator> iterators_;
+  Array<size_t> offsets_;
+  size_t max_size_;
+  Array<Int> row_ids_;
+  Array<uint32_t> frequencies_;
+  size_t pos_;
+  // Positions where the text may start in the current row.
+  Array<uint64_t> candidates_;
+  Array<uint64_t> next_candidates_;
+  int64_t row_id_;
+  uint32_t frequency_;
+
+  // Move to the first row whose ID is "row_id" or greater.
+  //
+  // On failure, throws an exception.
+  void find(int64_t row_id);
+  // Return the number of occurrences in the row where all the iterators
+  // are.
+  //
+  // On failure, throws an exception.
+  uint32_t count_occurrences();
+};
+
+void TextIterator::reset(ArrayCRef<const PositionalPostingList *> lists,
+                         ArrayCRef<size_t> offsets) try {
+  // The lists are sought in ascending order of size.
+  Array<size_t> order;
+  order.resize(lists.size());
+  for (size_t i = 0; i < lists.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.buffer(), order.buffer() + order.size(),
+            [&lists](size_t lhs, size_t rhs) {
+    return lists[lhs]->size() < lists[rhs]->size();
+  });
+  iterators_.clear();
+  offsets_.clear();
+  for (size_t i = 0; i < order.size(); ++i) {
+    iterators_.push_back(PositionalPostingList::Iterator(lists[order[i]]));
+    offsets_.push_back(offsets[order[i]]);
+  }
+  max_size_ = lists[order[0]]->size();
+  row_id_ = -1;
+  find(0);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void TextIterator::reset(Array<Int> &&row_ids,
+                         Array<uint32_t> &&frequencies) {
+  iterators_.clear();
+  offsets_.clear();
+  row_ids_ = std::move(row_ids);
+  frequencies_ = std::move(frequencies);
+  pos_ = 0;
+  row_id_ = -1;
+  find(0);
+}
+
+void TextIterator::find(int64_t row_id) {
+  constexpr int64_t END = std::numeric_limits<int64_t>::max();
+  if (iterators_.size() == 0) {
+    pos_ = std::lower_bound(row_ids_.data() + pos_,
+                            row_ids_.data() + row_ids_.size(),
+                            Int(row_id), RowIDLess()) - row_ids_.data();
+    if (pos_ == row_ids_.size()) {
+      row_id_ = END;
+      frequency_ = 0;
     } else {
-      return create_reverse_exact_match_cursor(
-          set_begin, set_end, options.offset, options.limit);
+      row_id_ = row_ids_[pos_].raw();
+      frequency_ = frequencies_[pos_];
+    }
+    return;
+  }
+  for ( ; ; ) {
+    // Find a row contained in all the lists.
+    iterators_[0].seek(row_id);
+    row_id = iterators_[0].row_id();
+    size_t i = 1;
+    while ((row_id != END) && (i < iterators_.size())) {
+      iterators_[i].seek(row_id);
+      if (iterators_[i].row_id() != row_id) {
+        row_id = iterators_[i].row_id();
+        break;
+      }
+      ++i;
+    }
+    if (row_id == END) {
+      row_id_ = END;
+      frequency_ = 0;
+      return;
+    }
+    if (i != iterators_.size()) {
+      continue;
+    }
+    frequency_ = count_occurrences();
+    if (frequency_ != 0) {
+      row_id_ = row_id;
+      return;
+    }
+    ++row_id;
+  }
+}
+
+uint32_t TextIterator::count_occurrences() try {
+  // Keep start positions "p" such that "p + offset" is in every list.
+  candidates_.clear();
+  ArrayCRef<uint64_t> positions = iterators_[0].positions();
+  for (size_t i = 0; i < positions.size(); ++i) {
+    if (positions[i] >= offsets_[0]) {
+      candidates_.push_back(positions[i] - offsets_[0]);
+    }
+  }
+  for (size_t i = 1; (i < iterators_.size()) &&
+                     (candidates_.size() != 0); ++i) {
+    positions = iterators_[i].positions();
+    next_candidates_.clear();
+    size_t x = 0;
+    size_t y = 0;
+    while ((x < candidates_.size()) && (y < positions.size())) {
+      uint64_t position = candidates_[x] + offsets_[i];
+      if (position < positions[y]) {
+        ++x;
+      } else if (position > positions[y]) {
+        ++y;
+      } else {
+        next_candidates_.push_back(candidates_[x]);
+        ++x;
+        ++y;
+      }
+    }
+    std::swap(candidates_, next_candidates_);
+  }
+  return static_cast<uint32_t>(candidates_.size());
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+// A query term for relevance search.
+struct RelevanceTerm {
+  // Rows containing the term.
+  TextIterator iterator;
+  // The inverse document frequency and the upper bound of the score.
+  double idf;
+  double max_score;
+
+  // Return the current row ID or INT64_MAX if the end is reached.
+  int64_t row_id() const {
+    return iterator.row_id();
+  }
+};
+
+// Return whether "lhs" ranks higher than "rhs" in relevance search.
+//
+// Records are ranked in descending order of scores and then in ascending
+// order of row IDs.
+struct RelevanceGreater {
+  bool operator()(const Record &lhs, const Record &rhs) const {
+    if (lhs.score.raw() != rhs.score.raw()) {
+      return lhs.score.raw() > rhs.score.raw();
     }
+    return lhs.row_id.raw() < rhs.row_id.raw();
   }
-}
-
-// -- HashIndex<Text> --
+};
 
-template <>
-class HashIndex<Text> : public Index {
+// A full-text index maps each bigram, a pair of adjacent bytes, to a
+// positional posting list.
+//
+// Texts containing a query are found by intersecting the posting lists of
+// the bigrams in the query and checking that the bigrams appear at
+// consecutive positions. Queries shorter than a bigram are verified
+// against all the texts.
+//
+// Relevance search scores rows with BM25, where the text length is the
+// number of bytes, and skips rows which cannot enter the top records with
+// WAND (weak AND).
+class FullTextIndex : public Index {
  public:
-  struct Hash {
-    uint64_t operator()(const String &value) const {
-      return Text(value).hash();
-    }
-  };
-
   using Value = Text;
-  using Set = std::set<Int, RowIDLess>;
-  using Map = std::unordered_map<String, Set, Hash>;
+  using Map = std::unordered_map<uint16_t, PositionalPostingList>;
 
-  HashIndex(ColumnBase *column,
-            const String &name,
-            const IndexOptions &options);
-  ~HashIndex() = default;
+  FullTextIndex(ColumnBase *column,
+                const String &name,
+                const IndexOptions &options);
+  ~FullTextIndex() = default;
 
   IndexType type() const {
-    return GRNXX_HASH_INDEX;
+    return GRNXX_FULL_TEXT_INDEX;
   }
   size_t num_entries() const {
     return num_entries_;
@@ -1213,21 +3611,62 @@ class HashIndex<Text> : public Index {
 
   void insert(Int row_id, const Datum &value);
   void remove(Int row_id, const Datum &value);
+  void remove_rows(ArrayCRef<Int> row_ids);
 
   std::unique_ptr<Cursor> find(const Datum &value,
                                const CursorOptions &options) const;
+  std::unique_ptr<Cursor> find_contains(const Datum &value,
+                                        const CursorOptions &options) const;
+  std::unique_ptr<Cursor> find_relevant(const Datum &query,
+                                        const CursorOptions &options) const;
 
  private:
-  mutable Map map_;
+  Map map_;
   size_t num_entries_;
+  // The total length of indexed texts.
+  uint64_t total_length_;
+
+  // Return the bigram at "text[i]" and "text[i + 1]".
+  static uint16_t get_bigram(const Text &text, size_t i) {
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(text.raw_data());
+    return static_cast<uint16_t>((data[i] << 8) | data[i + 1]);
+  }
+  // Return the bigrams of "text" and their positions in the upper 16 bits
+  // and the lower 48 bits respectively, in ascending order.
+  //
+  // On failure, throws an exception.
+  static void get_bigrams(const Text &text, Array<uint64_t> *bigrams);
+
+  // Set rows whose values contain "text" to "*iterator".
+  //
+  // On failure, throws an exception.
+  void find_rows(const Text &text, TextIterator *iterator) const;
+  // Find rows whose values contain "text" and store the row IDs into
+  // "*row_ids" in ascending order.
+  //
+  // On failure, throws an exception.
+  void find_rows(const Text &text, Array<Int> *row_ids) const;
+  // Scan the column to find rows whose values contain "text".
+  //
+  // On failure, throws an exception.
+  void scan_rows(const Text &text,
+                 Array<Int> *row_ids,
+                 Array<uint32_t> *frequencies) const;
+  // Find the top "k" rows of "terms" in descending order of scores.
+  //
+  // On failure, throws an exception.
+  void find_top_k(ArrayRef<RelevanceTerm> terms,
+                  size_t k,
+                  Array<Record> *records) const;
 };
 
-HashIndex<Text>::HashIndex(ColumnBase *column,
-                           const String &name,
-                           const IndexOptions &)
+FullTextIndex::FullTextIndex(ColumnBase *column,
+                             const String &name,
+                             const IndexOptions &)
     : Index(column, name),
       map_(),
-      num_entries_(0) {
+      num_entries_(0),
+      total_length_(0) {
   auto cursor = column->table()->create_cursor();
   auto typed_column = static_cast<Column<Text> *>(column);
   Array<Record> records;
@@ -1248,45 +3687,144 @@ HashIndex<Text>::HashIndex(ColumnBase *column,
   }
 }
 
-bool HashIndex<Text>::test_uniqueness() const {
-  for (const auto &it : map_) {
-    if (it.second.size() > 1) {
-      return false;
+bool FullTextIndex::test_uniqueness() const try {
+  struct Hash {
+    uint64_t operator()(const String &value) const {
+      return Text(value).hash();
+    }
+  };
+  std::unordered_set<String, Hash> set;
+  auto cursor = _column()->table()->create_cursor();
+  auto typed_column = static_cast<const Column<Text> *>(_column());
+  Array<Record> records;
+  Array<Value> values;
+  for ( ; ; ) {
+    size_t count = cursor->read(1024, &records);
+    if (count == 0) {
+      break;
+    }
+    values.resize(records.size());
+    typed_column->read(records, values.ref());
+    for (size_t i = 0; i < count; ++i) {
+      if (!values[i].is_na()) {
+        String string;
+        string.assign(values[i].raw_data(), values[i].raw_size());
+        if (!set.insert(std::move(string)).second) {
+          return false;
+        }
+      }
     }
+    records.clear();
   }
   return true;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
 }
 
-void HashIndex<Text>::insert(Int row_id, const Datum &value) {
+void FullTextIndex::insert(Int row_id, const Datum &value) try {
   Text text = value.as_text();
-  String string;
-  string.assign(text.raw_data(), text.raw_size());
-  auto result = map_[std::move(string)].insert(row_id);
-  if (!result.second) {
-    throw "Entry already exists";  // TODO
+  Array<uint64_t> bigrams;
+  get_bigrams(text, &bigrams);
+  Array<uint64_t> positions;
+  for (size_t i = 0; i < bigrams.size(); ) {
+    uint16_t bigram = static_cast<uint16_t>(bigrams[i] >> 48);
+    positions.clear();
+    for ( ; (i < bigrams.size()) && ((bigrams[i] >> 48) == bigram); ++i) {
+      positions.push_back(bigrams[i] & ((uint64_t(1) << 48) - 1));
+    }
+    map_[bigram].insert(row_id, positions);
   }
   ++num_entries_;
+  total_length_ += text.raw_size();
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
 }
 
-void HashIndex<Text>::remove(Int row_id, const Datum &value) {
+void FullTextIndex::remove(Int row_id, const Datum &value) {
   Text text = value.as_text();
-  String string(text.raw_data(), text.raw_size());
-  auto map_it = map_.find(string);
-  if (map_it == map_.end()) {
-    throw "Entry not found";  // TODO
+  Array<uint64_t> bigrams;
+  get_bigrams(text, &bigrams);
+  for (size_t i = 0; i < bigrams.size(); ++i) {
+    uint16_t bigram = static_cast<uint16_t>(bigrams[i] >> 48);
+    if ((i != 0) && ((bigrams[i - 1] >> 48) == bigram)) {
+      continue;
+    }
+    auto it = map_.find(bigram);
+    if ((it == map_.end()) || !it->second.remove(row_id)) {
+      throw "Entry not found";  // TODO
+    }
+    if (it->second.size() == 0) {
+      map_.erase(it);
+    }
   }
-  auto set_it = map_it->second.find(row_id);
-  if (set_it == map_it->second.end()) {
-    throw "Entry not found";  // TODO
+  --num_entries_;
+  total_length_ -= text.raw_size();
+}
+
+void FullTextIndex::remove_rows(ArrayCRef<Int> row_ids) try {
+  // Row IDs are grouped by posting lists, so that each posting list is
+  // updated in one pass.
+  struct Group {
+    Map::iterator it;
+    Array<Int> row_ids;
+  };
+  std::unordered_map<const PositionalPostingList *, Group> groups;
+  auto typed_column = static_cast<const Column<Text> *>(_column());
+  Array<Record> records;
+  Array<Text> values;
+  Array<uint64_t> bigrams;
+  size_t num_removed = 0;
+  uint64_t removed_length = 0;
+  for (size_t offset = 0; offset < row_ids.size(); offset += 1024) {
+    size_t block_size = row_ids.size() - offset;
+    if (block_size > 1024) {
+      block_size = 1024;
+    }
+    records.resize(block_size);
+    for (size_t i = 0; i < block_size; ++i) {
+      records[i] = Record(row_ids[offset + i], Float(0.0));
+    }
+    values.resize(block_size);
+    typed_column->read(records, values.ref());
+    for (size_t i = 0; i < block_size; ++i) {
+      if (values[i].is_na()) {
+        continue;
+      }
+      get_bigrams(values[i], &bigrams);
+      for (size_t j = 0; j < bigrams.size(); ++j) {
+        uint16_t bigram = static_cast<uint16_t>(bigrams[j] >> 48);
+        if ((j != 0) && ((bigrams[j - 1] >> 48) == bigram)) {
+          continue;
+        }
+        auto it = map_.find(bigram);
+        if (it == map_.end()) {
+          throw "Entry not found";  // TODO
+        }
+        Group &group = groups[&it->second];
+        group.it = it;
+        group.row_ids.push_back(records[i].row_id);
+      }
+      ++num_removed;
+      removed_length += values[i].raw_size();
+    }
   }
-  map_it->second.erase(set_it);
-  if (map_it->second.size() == 0) {
-    map_.erase(map_it);
+  for (auto &it : groups) {
+    Group &group = it.second;
+    if (group.it->second.remove_rows(group.row_ids) !=
+        group.row_ids.size()) {
+      throw "Entry not found";  // TODO
+    }
+    if (group.it->second.size() == 0) {
+      map_.erase(group.it);
+    }
   }
-  --num_entries_;
+  num_entries_ -= num_removed;
+  total_length_ -= removed_length;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
 }
 
-std::unique_ptr<Cursor> HashIndex<Text>::find(
+std::unique_ptr<Cursor> FullTextIndex::find(
     const Datum &value,
     const CursorOptions &options) const {
   if (value.type() == GRNXX_NA) {
@@ -1295,19 +3833,286 @@ std::unique_ptr<Cursor> HashIndex<Text>::find(
     throw "Data type conflict";  // TODO
   }
   Text text = value.as_text();
-  String string(text.raw_data(), text.raw_size());
-  auto map_it = map_.find(string);
-  if (map_it == map_.end()) {
+  if (text.is_na()) {
     return create_empty_cursor();
-  } else {
-    auto set_begin = map_it->second.begin();
-    auto set_end = map_it->second.end();
-    if (options.order_type == GRNXX_REGULAR_ORDER) {
-      return create_exact_match_cursor(
-          set_begin, set_end, options.offset, options.limit);
-    } else {
-      return create_reverse_exact_match_cursor(
-          set_begin, set_end, options.offset, options.limit);
+  }
+  // Texts containing "text" are verified.
+  Array<Int> row_ids;
+  find_rows(text, &row_ids);
+  auto typed_column = static_cast<const Column<Text> *>(_column());
+  size_t count = 0;
+  for (size_t i = 0; i < row_ids.size(); ++i) {
+    if (typed_column->get(row_ids[i]).match(text)) {
+      row_ids[count] = row_ids[i];
+      ++count;
+    }
+  }
+  row_ids.resize(count);
+  return create_row_id_array_cursor(&row_ids, options);
+}
+
+std::unique_ptr<Cursor> FullTextIndex::find_contains(
+    const Datum &value,
+    const CursorOptions &options) const {
+  if (value.type() == GRNXX_NA) {
+    return create_empty_cursor();
+  } else if (value.type() != GRNXX_TEXT) {
+    throw "Data type conflict";  // TODO
+  }
+  Text text = value.as_text();
+  if (text.is_na()) {
+    return create_empty_cursor();
+  }
+  Array<Int> row_ids;
+  find_rows(text, &row_ids);
+  return create_row_id_array_cursor(&row_ids, options);
+}
+
+void FullTextIndex::get_bigrams(const Text &text,
+                                Array<uint64_t> *bigrams) try {
+  size_t size = text.raw_size();
+  if (size < 2) {
+    bigrams->clear();
+    return;
+  }
+  bigrams->resize(size - 1);
+  for (size_t i = 0; i < (size - 1); ++i) {
+    (*bigrams)[i] = (uint64_t(get_bigram(text, i)) << 48) | i;
+  }
+  std::sort(bigrams->buffer(), bigrams->buffer() + bigrams->size());
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void FullTextIndex::find_rows(const Text &text,
+                              TextIterator *iterator) const try {
+  size_t size = text.raw_size();
+  if (size < 2) {
+    Array<Int> row_ids;
+    Array<uint32_t> frequencies;
+    scan_rows(text, &row_ids, &frequencies);
+    iterator->reset(std::move(row_ids), std::move(frequencies));
+    return;
+  }
+  Array<const PositionalPostingList *> lists;
+  Array<size_t> offsets;
+  lists.resize(size - 1);
+  offsets.resize(size - 1);
+  for (size_t i = 0; i < (size - 1); ++i) {
+    auto it = map_.find(get_bigram(text, i));
+    if (it == map_.end()) {
+      iterator->reset(Array<Int>(), Array<uint32_t>());
+      return;
+    }
+    lists[i] = &it->second;
+    offsets[i] = i;
+  }
+  iterator->reset(lists.cref(), offsets.cref());
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void FullTextIndex::find_rows(const Text &text,
+                              Array<Int> *row_ids) const try {
+  if (text.raw_size() < 2) {
+    scan_rows(text, row_ids, nullptr);
+    return;
+  }
+  TextIterator iterator;
+  find_rows(text, &iterator);
+  row_ids->clear();
+  for ( ; iterator.row_id() != std::numeric_limits<int64_t>::max();
+        iterator.next()) {
+    row_ids->push_back(Int(iterator.row_id()));
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void FullTextIndex::scan_rows(const Text &text,
+                              Array<Int> *row_ids,
+                              Array<uint32_t> *frequencies) const {
+  row_ids->clear();
+  auto cursor = _column()->table()->create_cursor();
+  auto typed_column = static_cast<const Column<Text> *>(_column());
+  Array<Record> records;
+  Array<Value> values;
+  for ( ; ; ) {
+    size_t count = cursor->read(1024, &records);
+    if (count == 0) {
+      break;
+    }
+    values.resize(records.size());
+    typed_column->read(records, values.ref());
+    for (size_t i = 0; i < count; ++i) {
+      if (values[i].contains(text).is_true()) {
+        row_ids->push_back(records[i].row_id);
+      }
+    }
+    records.clear();
+  }
+  // NOTE: Rows are not always read in row ID order.
+  std::sort(row_ids->buffer(), row_ids->buffer() + row_ids->size(),
+            RowIDLess());
+  if (frequencies) {
+    frequencies->resize(row_ids->size());
+    for (size_t i = 0; i < row_ids->size(); ++i) {
+      Text value = typed_column->get((*row_ids)[i]);
+      size_t end = value.raw_size() - text.raw_size() + 1;
+      uint32_t frequency = 0;
+      for (size_t j = 0; j < end; ++j) {
+        if (std::memcmp(value.raw_data() + j, text.raw_data(),
+                        text.raw_size()) == 0) {
+          ++frequency;
+        }
+      }
+      (*frequencies)[i] = frequency;
+    }
+  }
+}
+
+std::unique_ptr<Cursor> FullTextIndex::find_relevant(
+    const Datum &query,
+    const CursorOptions &options) const try {
+  Array<Text> texts;
+  switch (query.type()) {
+    case GRNXX_NA: {
+      return create_empty_cursor();
+    }
+    case GRNXX_TEXT: {
+      texts.push_back(query.as_text());
+      break;
+    }
+    case GRNXX_TEXT_VECTOR: {
+      const Vector<Text> &vector = query.as_text_vector();
+      if (!vector.is_na()) {
+        for (size_t i = 0; i < vector.raw_size(); ++i) {
+          texts.push_back(vector[Int(i)]);
+        }
+      }
+      break;
+    }
+    default: {
+      throw "Data type conflict";  // TODO
+    }
+  }
+  // Empty terms and terms without matches are ignored.
+  Array<RelevanceTerm> terms;
+  for (size_t i = 0; i < texts.size(); ++i) {
+    if (texts[i].is_na() || (texts[i].raw_size() == 0)) {
+      continue;
+    }
+    RelevanceTerm term;
+    find_rows(texts[i], &term.iterator);
+    if (term.row_id() == std::numeric_limits<int64_t>::max()) {
+      continue;
+    }
+    // Rows are found lazily, so the document frequency of a term longer
+    // than a bigram is estimated by the shortest posting list of its
+    // bigrams.
+    double num_rows = static_cast<double>(num_entries_);
+    double df = static_cast<double>(term.iterator.max_size());
+    term.idf = std::log(1.0 + ((num_rows - df + 0.5) / (df + 0.5)));
+    // A term score is less than "idf * (BM25_K1 + 1)" for any frequency.
+    term.max_score = term.idf * (BM25_K1 + 1.0);
+    terms.push_back(std::move(term));
+  }
+  if (terms.size() == 0) {
+    return create_empty_cursor();
+  }
+  // Rows are pruned only if the top records are read.
+  size_t k = std::numeric_limits<size_t>::max();
+  if ((options.order_type == GRNXX_REGULAR_ORDER) &&
+      (options.limit <= (k - options.offset))) {
+    k = options.offset + options.limit;
+  }
+  Array<Record> records;
+  find_top_k(terms.ref(), k, &records);
+  std::sort(records.buffer(), records.buffer() + records.size(),
+            RelevanceGreater());
+  if (options.order_type == GRNXX_REVERSE_ORDER) {
+    std::reverse(records.buffer(), records.buffer() + records.size());
+  }
+  return std::unique_ptr<Cursor>(new RecordArrayCursor(
+      std::move(records), options.offset, options.limit));
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void FullTextIndex::find_top_k(ArrayRef<RelevanceTerm> terms,
+                               size_t k,
+                               Array<Record> *records) const {
+  auto typed_column = static_cast<const Column<Text> *>(_column());
+  double average_length = static_cast<double>(total_length_) / num_entries_;
+  if (average_length == 0.0) {
+    average_length = 1.0;
+  }
+  // "order" keeps terms in ascending order of the current row IDs.
+  Array<RelevanceTerm *> order;
+  order.resize(terms.size());
+  for (size_t i = 0; i < terms.size(); ++i) {
+    order[i] = &terms[i];
+  }
+  // "*records" is a heap whose top is the lowest ranked record.
+  records->clear();
+  RelevanceGreater greater;
+  constexpr int64_t END = std::numeric_limits<int64_t>::max();
+  for ( ; ; ) {
+    for (size_t i = 1; i < order.size(); ++i) {
+      for (size_t j = i; (j > 0) &&
+           (order[j - 1]->row_id() > order[j]->row_id()); --j) {
+        std::swap(order[j - 1], order[j]);
+      }
+    }
+    // Find the pivot, the first term such that the sum of the upper bounds
+    // up to the term may exceed the lowest score in the top records.
+    bool is_full = records->size() >= k;
+    double threshold = is_full ? (*records)[0].score.raw() : 0.0;
+    double bound = 0.0;
+    size_t pivot = order.size();
+    for (size_t i = 0; i < order.size(); ++i) {
+      if (order[i]->row_id() == END) {
+        break;
+      }
+      bound += order[i]->max_score;
+      if (!is_full || (bound > threshold)) {
+        pivot = i;
+        break;
+      }
+    }
+    if (pivot == order.size()) {
+      break;
+    }
+    int64_t row_id = order[pivot]->row_id();
+    if (order[0]->row_id() != row_id) {
+      // Rows before the pivot row cannot enter the top records.
+      for (size_t i = 0; i < pivot; ++i) {
+        order[i]->iterator.seek(row_id);
+      }
+      continue;
+    }
+    double length = static_cast<double>(
+        typed_column->get(Int(row_id)).raw_size());
+    double norm = BM25_K1 * (1.0 - BM25_B + (BM25_B * length / average_length));
+    double score = 0.0;
+    for (size_t i = 0; (i < order.size()) &&
+                       (order[i]->row_id() == row_id); ++i) {
+      double frequency = order[i]->iterator.frequency();
+      score += order[i]->idf * frequency * (BM25_K1 + 1.0) /
+               (frequency + norm);
+      order[i]->iterator.next();
+    }
+    Record record = Record(Int(row_id), Float(score));
+    if (!is_full) {
+      records->push_back(record);
+      std::push_heap(records->buffer(),
+                     records->buffer() + records->size(), greater);
+    } else if (greater(record, (*records)[0])) {
+      std::pop_heap(records->buffer(),
+                    records->buffer() + records->size(), greater);
+      records->back() = record;
+      std::push_heap(records->buffer(),
+                     records->buffer() + records->size(), greater);
     }
   }
 }
@@ -1353,6 +4158,16 @@ std::unique_ptr<Cursor> Index::find_in_range(
   throw "Not supported yet";  // TODO
 }
 
+std::unique_ptr<Cursor> Index::find_with_prefix(
+    ArrayCRef<Datum> prefix,
+    const IndexRange &range,
+    const CursorOptions &options) const {
+  if (prefix.size() != 0) {
+    throw "Not supported yet";  // TODO
+  }
+  return find_in_range(range, options);
+}
+
 std::unique_ptr<Cursor> Index::find_starts_with(
     const EndPoint &,
     const CursorOptions &) const {
@@ -1365,12 +4180,50 @@ std::unique_ptr<Cursor> Index::find_prefixes(
   throw "Not supported yet";  // TODO
 }
 
+std::unique_ptr<Cursor> Index::find_relevant(
+    const Datum &,
+    const CursorOptions &) const {
+  throw "Not supported yet";  // TODO
+}
+
+std::unique_ptr<Cursor> Index::find_within_rectangle(
+    const GeoPoint &,
+    const GeoPoint &,
+    const CursorOptions &) const {
+  throw "Not supported yet";  // TODO
+}
+
+std::unique_ptr<Cursor> Index::find_within_circle(
+    const GeoPoint &,
+    Float,
+    const CursorOptions &) const {
+  throw "Not supported yet";  // TODO
+}
+
+std::unique_ptr<Cursor> Index::find_contains(
+    const Datum &,
+    const CursorOptions &) const {
+  throw "Not supported yet";  // TODO
+}
+
 Index *Index::create(ColumnBase *column,
                      const String &name,
                      IndexType type,
                      const IndexOptions &options) try {
   switch (type) {
     case GRNXX_TREE_INDEX: {
+      if (!options.secondary_column_names.is_empty()) {
+        switch (column->data_type()) {
+          case GRNXX_INT:
+          case GRNXX_FLOAT:
+          case GRNXX_TEXT: {
+            return new CompositeTreeIndex(column, name, options);
+          }
+          default: {
+            throw "Not supported yet";  // TODO
+          }
+        }
+      }
       switch (column->data_type()) {
         case GRNXX_BOOL: {
           throw "Not supported yet";  // TODO
@@ -1382,7 +4235,7 @@ Index *Index::create(ColumnBase *column,
           return new TreeIndex<Float>(column, name, options);
         }
         case GRNXX_GEO_POINT: {
-          throw "Not supported yet";  // TODO
+          return new TreeIndex<GeoPoint>(column, name, options);
         }
         case GRNXX_TEXT: {
           return new TreeIndex<Text>(column, name, options);
@@ -1414,11 +4267,25 @@ Index *Index::create(ColumnBase *column,
         case GRNXX_TEXT: {
           return new HashIndex<Text>(column, name, options);
         }
+        case GRNXX_INT_VECTOR: {
+          return new InvertedIndex<Int>(column, name, options);
+        }
+        case GRNXX_TEXT_VECTOR: {
+          return new InvertedIndex<Text>(column, name, options);
+        }
         case GRNXX_BOOL_VECTOR:
-        case GRNXX_INT_VECTOR:
         case GRNXX_FLOAT_VECTOR:
         case GRNXX_GEO_POINT_VECTOR:
-        case GRNXX_TEXT_VECTOR:
+        default: {
+          throw "Not supported yet";  // TODO
+        }
+      }
+    }
+    case GRNXX_FULL_TEXT_INDEX: {
+      switch (column->data_type()) {
+        case GRNXX_TEXT: {
+          return new FullTextIndex(column, name, options);
+        }
         default: {
           throw "Not supported yet";  // TODO
         }
@@ -1440,5 +4307,25 @@ bool Index::is_removable() const {
   return true;
 }
 
+IndexOptions Index::options() const {
+  return IndexOptions();
+}
+
+bool Index::depends_on(const ColumnBase *column) const {
+  return column == column_;
+}
+
+void Index::remove_rows(ArrayCRef<Int> row_ids) {
+  Datum value;
+  for (size_t i = 0; i < row_ids.size(); ++i) {
+    column_->get(row_ids[i], &value);
+    if (!is_na_datum(value)) {
+      remove(row_ids[i], value);
+    }
+  }
+}
+
+void Index::update_row(const ColumnBase *, Int) {}
+
 }  // namespace impl
 }  // namespace grnxx
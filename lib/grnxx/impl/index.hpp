@@ -39,12 +39,30 @@ class Index : public IndexInterface {
   virtual std::unique_ptr<Cursor> find_in_range(
       const IndexRange &range = IndexRange(),
       const CursorOptions &options = CursorOptions()) const;
+  virtual std::unique_ptr<Cursor> find_with_prefix(
+      ArrayCRef<Datum> prefix,
+      const IndexRange &range = IndexRange(),
+      const CursorOptions &options = CursorOptions()) const;
   virtual std::unique_ptr<Cursor> find_starts_with(
       const EndPoint &prefix,
       const CursorOptions &options = CursorOptions()) const;
   virtual std::unique_ptr<Cursor> find_prefixes(
       const Datum &value,
       const CursorOptions &options = CursorOptions()) const;
+  virtual std::unique_ptr<Cursor> find_contains(
+      const Datum &value,
+      const CursorOptions &options = CursorOptions()) const;
+  virtual std::unique_ptr<Cursor> find_relevant(
+      const Datum &query,
+      const CursorOptions &options = CursorOptions()) const;
+  virtual std::unique_ptr<Cursor> find_within_rectangle(
+      const GeoPoint &corner,
+      const GeoPoint &opposite_corner,
+      const CursorOptions &options = CursorOptions()) const;
+  virtual std::unique_ptr<Cursor> find_within_circle(
+      const GeoPoint &center,
+      Float radius,
+      const CursorOptions &options = CursorOptions()) const;
 
   // -- Internal API --
 
@@ -70,6 +88,29 @@ class Index : public IndexInterface {
   // Return whether the index is removable or not.
   bool is_removable() const;
 
+  // Return options to create an index of the same kind.
+  virtual IndexOptions options() const;
+
+  // Return whether the index depends on values of "column" or not.
+  virtual bool depends_on(const ColumnBase *column) const;
+
+  // Remove the entries of "row_ids".
+  //
+  // "row_ids" must be sorted in ascending order without duplicates, and the
+  // values must not be unset yet because they are read from the column.
+  // The default implementation calls remove() for each row.
+  //
+  // On failure, throws an exception.
+  virtual void remove_rows(ArrayCRef<Int> row_ids);
+
+  // Update the entry of "row_id" after the value of "column" is changed.
+  //
+  // Only composite indexes depend on values of columns other than the owner
+  // column, and the default implementation does nothing.
+  //
+  // On failure, throws an exception.
+  virtual void update_row(const ColumnBase *column, Int row_id);
+
  private:
   ColumnBase *column_;
   String name_;
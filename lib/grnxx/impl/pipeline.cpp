@@ -1,9 +1,49 @@
 #include "grnxx/impl/pipeline.hpp"
 
+#include <iterator>
+#include <limits>
+
+#include "grnxx/impl/cursor.hpp"
+#include "grnxx/impl/expression.hpp"
+#include "grnxx/impl/sorter.hpp"
+
 namespace grnxx {
 namespace impl {
 namespace pipeline {
 
+// The block size used if no expression prefers another one.
+constexpr size_t DEFAULT_BLOCK_SIZE = 1024;
+
+// Return the smaller block size, where 0 means no preference.
+size_t min_block_size(size_t lhs, size_t rhs) {
+  if (lhs == 0) {
+    return rhs;
+  } else if (rhs == 0) {
+    return lhs;
+  }
+  return (lhs < rhs) ? lhs : rhs;
+}
+
+// Append the bytes of "value" to "description".
+template <typename T>
+void append_bytes(const T &value, String *description) {
+  description->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// Append the description of "expression" to "description" and the columns
+// read by "expression" to "columns".
+void append_expression(const ExpressionInterface *expression,
+                       String *description,
+                       Array<const ColumnBase *> *columns) {
+  const Expression *impl_expression =
+      static_cast<const Expression *>(expression);
+  append_bytes(impl_expression->description().size(), description);
+  description->append(impl_expression->description());
+  for (size_t i = 0; i < impl_expression->columns().size(); ++i) {
+    columns->push_back(impl_expression->columns()[i]);
+  }
+}
+
 // -- Node --
 
 class Node {
@@ -11,6 +51,13 @@ class Node {
   Node() = default;
   virtual ~Node() = default;
 
+  // Return the block size preferred by the subtree.
+  //
+  // If there is no preference, returns 0.
+  virtual size_t preferred_block_size() const = 0;
+  // Set the block size of the subtree.
+  virtual void set_block_size(size_t block_size) = 0;
+
   // Read the next block of records.
   //
   // On success, returns the number of records read.
@@ -22,6 +69,35 @@ class Node {
   // On success, returns the number of records read.
   // On failure, throws an exception.
   virtual size_t read_all(Array<Record> *records);
+
+  // Tell that "expression" filters all the records read from the subtree.
+  //
+  // NOTE: This is only a hint and the default implementation does nothing.
+  virtual void set_zone_filter(const ExpressionInterface *) {}
+
+  // Return whether the subtree reads all the rows of "table" through a table
+  // cursor and processes records one by one, so that the cursor can be
+  // replaced with a cursor which reads the rows in another order.
+  virtual bool can_reorder(const Table *) const {
+    return false;
+  }
+  // Replace the table cursor of the subtree with "cursor".
+  //
+  // Available only if can_reorder() returns true.
+  virtual void replace_cursor(std::unique_ptr<Cursor> &&) {}
+
+  // Append the description of the subtree to "description" and the columns
+  // read by the subtree to "columns".
+  //
+  // Subtrees with the same description return the same records unless
+  // "table" or the columns are changed.
+  //
+  // On success, returns true.
+  // If the subtree is not cacheable, returns false.
+  // On failure, throws an exception.
+  virtual bool describe(const Table *table,
+                        String *description,
+                        Array<const ColumnBase *> *columns) const = 0;
 };
 
 size_t Node::read_all(Array<Record> *records) {
@@ -42,19 +118,67 @@ class CursorNode : public Node {
  public:
   explicit CursorNode(std::unique_ptr<Cursor> &&cursor)
       : Node(),
-        cursor_(std::move(cursor)) {}
+        cursor_(std::move(cursor)),
+        block_size_(DEFAULT_BLOCK_SIZE),
+        is_reordered_(false) {}
   ~CursorNode() = default;
 
+  size_t preferred_block_size() const {
+    return 0;
+  }
+  void set_block_size(size_t block_size) {
+    block_size_ = block_size;
+  }
+
   size_t read_next(Array<Record> *records);
   size_t read_all(Array<Record> *records);
 
+  void set_zone_filter(const ExpressionInterface *expression) {
+    // Only table cursors can skip zones.
+    TableCursor *cursor = dynamic_cast<TableCursor *>(cursor_.get());
+    if (cursor) {
+      cursor->set_zone_filter(expression);
+    }
+  }
+  bool can_reorder(const Table *table) const {
+    TableCursor *cursor = dynamic_cast<TableCursor *>(cursor_.get());
+    return cursor && cursor->reads_all_rows(table);
+  }
+  void replace_cursor(std::unique_ptr<Cursor> &&cursor) {
+    cursor_ = std::move(cursor);
+    is_reordered_ = true;
+  }
+  bool describe(const Table *table,
+                String *description,
+                Array<const ColumnBase *> *columns) const;
+
  private:
   std::unique_ptr<Cursor> cursor_;
+  size_t block_size_;
+  bool is_reordered_;
 };
 
+bool CursorNode::describe(const Table *table,
+                          String *description,
+                          Array<const ColumnBase *> *) const {
+  // A replaced cursor reads all the rows in the order of its parent.
+  if (is_reordered_) {
+    description->append('R');
+    return true;
+  }
+  // Only table cursors reading all the rows are cacheable, because the
+  // state of other cursors is not described.
+  TableCursor *cursor = dynamic_cast<TableCursor *>(cursor_.get());
+  if (!cursor || !cursor->reads_all_rows(table)) {
+    return false;
+  }
+  description->append('T');
+  append_bytes(cursor->order_type(), description);
+  return true;
+}
+
 size_t CursorNode::read_next(Array<Record> *records) {
-  // TODO: The following block size (1024) should be optimized.
-  return cursor_->read(1024, records);
+  return cursor_->read(block_size_, records);
 }
 
 size_t CursorNode::read_all(Array<Record> *records) {
@@ -66,27 +190,70 @@ size_t CursorNode::read_all(Array<Record> *records) {
 class FilterNode : public Node {
  public:
   FilterNode(std::unique_ptr<Node> &&arg,
-             std::unique_ptr<Expression> &&expression,
+             std::unique_ptr<ExpressionInterface> &&expression,
              size_t offset,
              size_t limit)
       : Node(),
         arg_(std::move(arg)),
         expression_(std::move(expression)),
         offset_(offset),
-        limit_(limit) {}
+        limit_(limit),
+        block_size_(DEFAULT_BLOCK_SIZE),
+        is_satisfied_(false) {}
   ~FilterNode() = default;
 
+  // Return the expression.
+  const ExpressionInterface *expression() const {
+    return expression_.get();
+  }
+  // Tell that all the records read from the subtree satisfy the expression,
+  // so that the expression is not evaluated.
+  void set_satisfied() {
+    is_satisfied_ = true;
+  }
+
+  size_t preferred_block_size() const {
+    return min_block_size(expression_->block_size(),
+                          arg_->preferred_block_size());
+  }
+  void set_block_size(size_t block_size) {
+    block_size_ = block_size;
+    arg_->set_block_size(block_size);
+  }
+  bool can_reorder(const Table *table) const {
+    // An offset and a limit depend on the order of records.
+    return (offset_ == 0) &&
+           (limit_ == std::numeric_limits<size_t>::max()) &&
+           arg_->can_reorder(table);
+  }
+  void replace_cursor(std::unique_ptr<Cursor> &&cursor) {
+    arg_->replace_cursor(std::move(cursor));
+  }
+  bool describe(const Table *table,
+                String *description,
+                Array<const ColumnBase *> *columns) const {
+    if (!arg_->describe(table, description, columns)) {
+      return false;
+    }
+    description->append('F');
+    append_bytes(offset_, description);
+    append_bytes(limit_, description);
+    append_expression(expression_.get(), description, columns);
+    return true;
+  }
+
   size_t read_next(Array<Record> *records);
 
  private:
   std::unique_ptr<Node> arg_;
-  std::unique_ptr<Expression> expression_;
+  std::unique_ptr<ExpressionInterface> expression_;
   size_t offset_;
   size_t limit_;
+  size_t block_size_;
+  bool is_satisfied_;
 };
 
 size_t FilterNode::read_next(Array<Record> *records) {
-  // TODO: The following threshold (1024) should be optimized.
   size_t offset = records->size();
   while (limit_ > 0) {
     size_t count = arg_->read_next(records);
@@ -94,7 +261,9 @@ size_t FilterNode::read_next(Array<Record> *records) {
       break;
     }
     ArrayRef<Record> ref = records->ref(records->size() - count, count);
-    expression_->filter(ref, &ref);
+    if (!is_satisfied_) {
+      expression_->filter(ref, &ref);
+    }
     if (offset_ > 0) {
       if (offset_ >= ref.size()) {
         offset_ -= ref.size();
@@ -112,7 +281,7 @@ size_t FilterNode::read_next(Array<Record> *records) {
     }
     limit_ -= ref.size();
     records->resize(records->size() - count + ref.size());
-    if ((records->size() - offset) >= 1024) {
+    if ((records->size() - offset) >= block_size_) {
       break;
     }
   }
@@ -124,17 +293,41 @@ size_t FilterNode::read_next(Array<Record> *records) {
 class AdjusterNode : public Node {
  public:
   explicit AdjusterNode(std::unique_ptr<Node> &&arg,
-                        std::unique_ptr<Expression> &&expression)
+                        std::unique_ptr<ExpressionInterface> &&expression)
       : Node(),
         arg_(std::move(arg)),
         expression_(std::move(expression)) {}
   ~AdjusterNode() = default;
 
+  size_t preferred_block_size() const {
+    return min_block_size(expression_->block_size(),
+                          arg_->preferred_block_size());
+  }
+  void set_block_size(size_t block_size) {
+    arg_->set_block_size(block_size);
+  }
+  bool can_reorder(const Table *table) const {
+    return arg_->can_reorder(table);
+  }
+  void replace_cursor(std::unique_ptr<Cursor> &&cursor) {
+    arg_->replace_cursor(std::move(cursor));
+  }
+  bool describe(const Table *table,
+                String *description,
+                Array<const ColumnBase *> *columns) const {
+    if (!arg_->describe(table, description, columns)) {
+      return false;
+    }
+    description->append('A');
+    append_expression(expression_.get(), description, columns);
+    return true;
+  }
+
   size_t read_next(Array<Record> *records);
 
  private:
   std::unique_ptr<Node> arg_;
-  std::unique_ptr<Expression> expression_;
+  std::unique_ptr<ExpressionInterface> expression_;
 };
 
 size_t AdjusterNode::read_next(Array<Record> *records) {
@@ -149,17 +342,35 @@ size_t AdjusterNode::read_next(Array<Record> *records) {
 class SorterNode : public Node {
  public:
   explicit SorterNode(std::unique_ptr<Node> &&arg,
-                      std::unique_ptr<Sorter> &&sorter)
+                      std::unique_ptr<SorterInterface> &&sorter)
       : Node(),
         arg_(std::move(arg)),
         sorter_(std::move(sorter)) {}
   ~SorterNode() = default;
 
+  size_t preferred_block_size() const {
+    return arg_->preferred_block_size();
+  }
+  void set_block_size(size_t block_size) {
+    arg_->set_block_size(block_size);
+  }
+  bool describe(const Table *table,
+                String *description,
+                Array<const ColumnBase *> *columns) const {
+    if (!arg_->describe(table, description, columns)) {
+      return false;
+    }
+    description->append('S');
+    static_cast<const Sorter *>(sorter_.get())->describe(description,
+                                                         columns);
+    return true;
+  }
+
   size_t read_next(Array<Record> *records);
 
  private:
   std::unique_ptr<Node> arg_;
-  std::unique_ptr<Sorter> sorter_;
+  std::unique_ptr<SorterInterface> sorter_;
 };
 
 size_t SorterNode::read_next(Array<Record> *records) {
@@ -174,25 +385,141 @@ size_t SorterNode::read_next(Array<Record> *records) {
   return records->size();
 }
 
+// --- LimitNode ---
+
+// Node to skip the first "offset" records and read at most "limit" records.
+//
+// A sorter is replaced with this node if records are read in the sorted
+// order, so that records after the limit are never read.
+// The sorter is kept only to describe the node.
+class LimitNode : public Node {
+ public:
+  explicit LimitNode(std::unique_ptr<Node> &&arg,
+                     std::unique_ptr<SorterInterface> &&sorter)
+      : Node(),
+        arg_(std::move(arg)),
+        sorter_(std::move(sorter)),
+        offset_(0),
+        limit_(0),
+        block_size_(DEFAULT_BLOCK_SIZE),
+        max_block_size_(DEFAULT_BLOCK_SIZE) {
+    const Sorter *impl_sorter = static_cast<const Sorter *>(sorter_.get());
+    offset_ = impl_sorter->offset();
+    limit_ = impl_sorter->limit();
+  }
+  ~LimitNode() = default;
+
+  size_t preferred_block_size() const {
+    return arg_->preferred_block_size();
+  }
+  void set_block_size(size_t block_size) {
+    // Blocks larger than the required records waste reads, so the first
+    // block is limited and the following blocks grow up to "block_size".
+    max_block_size_ = block_size;
+    if ((offset_ + limit_) < block_size) {
+      block_size = offset_ + limit_;
+    }
+    block_size_ = (block_size != 0) ? block_size : 1;
+    arg_->set_block_size(block_size_);
+  }
+  bool describe(const Table *table,
+                String *description,
+                Array<const ColumnBase *> *columns) const {
+    if (!arg_->describe(table, description, columns)) {
+      return false;
+    }
+    description->append('L');
+    static_cast<const Sorter *>(sorter_.get())->describe(description,
+                                                         columns);
+    return true;
+  }
+
+  size_t read_next(Array<Record> *records);
+
+ private:
+  std::unique_ptr<Node> arg_;
+  std::unique_ptr<SorterInterface> sorter_;
+  size_t offset_;
+  size_t limit_;
+  size_t block_size_;
+  size_t max_block_size_;
+};
+
+size_t LimitNode::read_next(Array<Record> *records) {
+  size_t offset = records->size();
+  while ((limit_ > 0) && (records->size() == offset)) {
+    size_t count = arg_->read_next(records);
+    if (count == 0) {
+      break;
+    }
+    size_t begin = records->size() - count;
+    size_t num_skips = (offset_ < count) ? offset_ : count;
+    offset_ -= num_skips;
+    size_t size = count - num_skips;
+    if (size > limit_) {
+      size = limit_;
+    }
+    for (size_t i = 0; i < size; ++i) {
+      (*records)[begin + i] = (*records)[begin + num_skips + i];
+    }
+    records->resize(begin + size);
+    limit_ -= size;
+    if ((limit_ > 0) && (block_size_ < max_block_size_)) {
+      // Records have been filtered out, so the next block is made larger.
+      block_size_ = ((block_size_ * 2) < max_block_size_) ?
+                    (block_size_ * 2) : max_block_size_;
+      arg_->set_block_size(block_size_);
+    }
+  }
+  return records->size() - offset;
+}
+
 // --- MergerNode ---
 
 class MergerNode : public Node {
  public:
   explicit MergerNode(std::unique_ptr<Node> &&arg1,
                       std::unique_ptr<Node> &&arg2,
-                      std::unique_ptr<Merger> &&merger)
+                      std::unique_ptr<Merger> &&merger,
+                      const MergerOptions &options)
       : Node(),
         arg1_(std::move(arg1)),
         arg2_(std::move(arg2)),
-        merger_(std::move(merger)) {}
+        merger_(std::move(merger)),
+        options_(options) {}
   ~MergerNode() = default;
 
+  size_t preferred_block_size() const {
+    return min_block_size(arg1_->preferred_block_size(),
+                          arg2_->preferred_block_size());
+  }
+  void set_block_size(size_t block_size) {
+    arg1_->set_block_size(block_size);
+    arg2_->set_block_size(block_size);
+  }
+  bool describe(const Table *table,
+                String *description,
+                Array<const ColumnBase *> *columns) const {
+    if (!arg1_->describe(table, description, columns) ||
+        !arg2_->describe(table, description, columns)) {
+      return false;
+    }
+    description->append('M');
+    append_bytes(options_.logical_operator_type, description);
+    append_bytes(options_.score_operator_type, description);
+    append_bytes(options_.missing_score.raw(), description);
+    append_bytes(options_.offset, description);
+    append_bytes(options_.limit, description);
+    return true;
+  }
+
   size_t read_next(Array<Record> *records);
 
  private:
   std::unique_ptr<Node> arg1_;
   std::unique_ptr<Node> arg2_;
   std::unique_ptr<Merger> merger_;
+  MergerOptions options_;
 };
 
 size_t MergerNode::read_next(Array<Record> *records) {
@@ -211,15 +538,165 @@ size_t MergerNode::read_next(Array<Record> *records) {
 
 using namespace pipeline;
 
+// -- PipelineCache --
+
+PipelineCache::PipelineCache(const PipelineCacheOptions &options)
+    : PipelineCacheInterface(),
+      mutex_(),
+      max_size_(options.max_size),
+      size_(0),
+      entries_(),
+      map_() {}
+
+size_t PipelineCache::num_entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t PipelineCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+void PipelineCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  map_.clear();
+  entries_.clear();
+  size_ = 0;
+}
+
+std::shared_ptr<const Array<Record>> PipelineCache::find(
+    const String &key,
+    ArrayCRef<uint64_t> revisions) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto map_it = map_.find(key);
+  if (map_it == map_.end()) {
+    return nullptr;
+  }
+  EntryList::iterator it = map_it->second;
+  bool is_outdated = (it->revisions.size() != revisions.size());
+  for (size_t i = 0; !is_outdated && (i < revisions.size()); ++i) {
+    is_outdated = (it->revisions[i] != revisions[i]);
+  }
+  if (is_outdated) {
+    remove(it);
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it);
+  return it->records;
+}
+
+void PipelineCache::insert(
+    const String &key,
+    ArrayCRef<uint64_t> revisions,
+    const std::shared_ptr<const Array<Record>> &records) try {
+  size_t entry_size = (sizeof(Record) * records->size()) + key.size() +
+                      (sizeof(uint64_t) * revisions.size());
+  if (entry_size > max_size_) {
+    return;
+  }
+  Entry entry;
+  entry.key = key.clone();
+  entry.revisions.resize(revisions.size());
+  for (size_t i = 0; i < revisions.size(); ++i) {
+    entry.revisions[i] = revisions[i];
+  }
+  entry.records = records;
+  entry.size = entry_size;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto map_it = map_.find(key);
+  if (map_it != map_.end()) {
+    remove(map_it->second);
+  }
+  // The least recently used entries are removed to make room.
+  while ((size_ + entry_size) > max_size_) {
+    remove(std::prev(entries_.end()));
+  }
+  entries_.push_front(std::move(entry));
+  map_[entries_.front().key] = entries_.begin();
+  size_ += entry_size;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void PipelineCache::remove(EntryList::iterator it) {
+  map_.erase(it->key);
+  size_ -= it->size;
+  entries_.erase(it);
+}
+
+// -- Pipeline --
+
 Pipeline::Pipeline(const Table *table,
                    std::unique_ptr<Node> &&root,
-                   const PipelineOptions &)
+                   const PipelineOptions &options)
     : PipelineInterface(),
       table_(table),
-      root_(std::move(root)) {}
+      root_(std::move(root)),
+      block_size_(options.block_size),
+      cache_(static_cast<PipelineCache *>(options.cache)),
+      cache_key_(),
+      columns_() {
+  if (block_size_ == 0) {
+    block_size_ = root_->preferred_block_size();
+    if (block_size_ == 0) {
+      block_size_ = DEFAULT_BLOCK_SIZE;
+    }
+  }
+  root_->set_block_size(block_size_);
+  if (cache_) {
+    // The table address distinguishes tables, and an address reused by
+    // another table is detected by revisions.
+    append_bytes(table_, &cache_key_);
+    if (!root_->describe(table_, &cache_key_, &columns_)) {
+      cache_ = nullptr;
+    }
+  }
+}
 
 void Pipeline::flush(Array<Record> *records) {
-  root_->read_all(records);
+  if (!cache_) {
+    root_->read_all(records);
+    return;
+  }
+  std::shared_ptr<const Array<Record>> result = flush_shared();
+  size_t offset = records->size();
+  records->resize(offset + result->size());
+  for (size_t i = 0; i < result->size(); ++i) {
+    (*records)[offset + i] = (*result)[i];
+  }
+}
+
+std::shared_ptr<const Array<Record>> Pipeline::flush_shared() try {
+  Array<uint64_t> revisions;
+  if (cache_) {
+    // Revisions are taken before reading records, so that changes during
+    // the reading make the result outdated.
+    get_revisions(&revisions);
+    std::shared_ptr<const Array<Record>> records =
+        cache_->find(cache_key_, revisions.cref());
+    if (records) {
+      return records;
+    }
+  }
+  std::shared_ptr<Array<Record>> records(new Array<Record>);
+  root_->read_all(records.get());
+  if (cache_) {
+    cache_->insert(cache_key_, revisions.cref(), records);
+  }
+  return records;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void Pipeline::get_revisions(Array<uint64_t> *revisions) const {
+  revisions->reserve(1 + (2 * columns_.size()));
+  revisions->push_back(table_->revision());
+  // Dereferenced columns depend on the rows of their tables.
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    revisions->push_back(columns_[i]->_table()->revision());
+    revisions->push_back(columns_[i]->revision());
+  }
 }
 
 PipelineBuilder::PipelineBuilder(const Table *table)
@@ -232,14 +709,16 @@ void PipelineBuilder::push_cursor(std::unique_ptr<Cursor> &&cursor) try {
   throw "Memory allocation failed";  // TODO
 }
 
-void PipelineBuilder::push_filter(std::unique_ptr<Expression> &&expression,
-                                  size_t offset,
-                                  size_t limit) try {
+void PipelineBuilder::push_filter(
+    std::unique_ptr<ExpressionInterface> &&expression,
+    size_t offset,
+    size_t limit) try {
   if (node_stack_.size() < 1) {
     throw "Not enough nodes";  // TODO
   }
   std::unique_ptr<Node> arg = std::move(node_stack_[node_stack_.size() - 1]);
   node_stack_.resize(node_stack_.size() - 1);
+  arg->set_zone_filter(expression.get());
   std::unique_ptr<Node> node(
       new FilterNode(std::move(arg), std::move(expression), offset, limit));
   node_stack_.push_back(std::move(node));
@@ -248,7 +727,7 @@ void PipelineBuilder::push_filter(std::unique_ptr<Expression> &&expression,
 }
 
 void PipelineBuilder::push_adjuster(
-    std::unique_ptr<Expression> &&expression) try {
+    std::unique_ptr<ExpressionInterface> &&expression) try {
   if (node_stack_.size() < 1) {
     throw "Not enough nodes";  // TODO
   }
@@ -261,12 +740,53 @@ void PipelineBuilder::push_adjuster(
   throw "Memory allocation failed";  // TODO
 }
 
-void PipelineBuilder::push_sorter(std::unique_ptr<Sorter> &&sorter) try {
+void PipelineBuilder::push_sorter(
+    std::unique_ptr<SorterInterface> &&sorter) try {
   if (node_stack_.size() < 1) {
     throw "Not enough nodes";  // TODO
   }
   std::unique_ptr<Node> arg = std::move(node_stack_[node_stack_.size() - 1]);
   node_stack_.resize(node_stack_.size() - 1);
+  // If records are read in the sorted order through an index, the sorter is
+  // replaced with a limit.
+  // NOTE: An index is used only if the sorter has a limit, because reading
+  //       all the rows in the order of an index is slower than sorting them.
+  const Sorter *impl_sorter = static_cast<const Sorter *>(sorter.get());
+  // If the records are filtered by comparisons with constants, a composite
+  // index may read only the rows satisfying some of them in the sorted
+  // order, and the filter is not evaluated if it is satisfied by the rows.
+  FilterNode *filter_node = dynamic_cast<FilterNode *>(arg.get());
+  if (filter_node && arg->can_reorder(table_)) {
+    Array<ExpressionCondition> conditions;
+    const Expression *expression =
+        static_cast<const Expression *>(filter_node->expression());
+    if (expression->get_conditions(&conditions)) {
+      bool is_exact = false;
+      std::unique_ptr<Cursor> cursor =
+          impl_sorter->create_prefix_cursor(conditions.cref(), &is_exact);
+      if (cursor) {
+        arg->replace_cursor(std::move(cursor));
+        if (is_exact) {
+          filter_node->set_satisfied();
+        }
+        std::unique_ptr<Node> node(
+            new LimitNode(std::move(arg), std::move(sorter)));
+        node_stack_.push_back(std::move(node));
+        return;
+      }
+    }
+  }
+  if (((impl_sorter->offset() + impl_sorter->limit()) < table_->num_rows()) &&
+      arg->can_reorder(table_)) {
+    std::unique_ptr<Cursor> cursor = impl_sorter->create_ordered_cursor();
+    if (cursor) {
+      arg->replace_cursor(std::move(cursor));
+      std::unique_ptr<Node> node(
+          new LimitNode(std::move(arg), std::move(sorter)));
+      node_stack_.push_back(std::move(node));
+      return;
+    }
+  }
   std::unique_ptr<Node> node(
       new SorterNode(std::move(arg), std::move(sorter)));
   node_stack_.push_back(std::move(node));
@@ -282,8 +802,8 @@ void PipelineBuilder::push_merger(const MergerOptions &options) try {
   std::unique_ptr<Node> arg2 = std::move(node_stack_[node_stack_.size() - 2]);
   std::unique_ptr<Node> arg1 = std::move(node_stack_[node_stack_.size() - 1]);
   node_stack_.resize(node_stack_.size() - 2);
-  std::unique_ptr<Node> node(
-      new MergerNode(std::move(arg1), std::move(arg2), std::move(merger)));
+  std::unique_ptr<Node> node(new MergerNode(
+      std::move(arg1), std::move(arg2), std::move(merger), options));
   node_stack_.push_back(std::move(node));
 } catch (const std::bad_alloc &) {
   throw "Memory allocation failed";  // TODO
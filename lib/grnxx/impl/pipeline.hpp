@@ -1,7 +1,10 @@
 #ifndef GRNXX_IMPL_PIPELINE_HPP
 #define GRNXX_IMPL_PIPELINE_HPP
 
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 
 #include "grnxx/array.hpp"
 #include "grnxx/impl/table.hpp"
@@ -15,9 +18,65 @@ class Node;
 
 }  // namespace pipeline
 
+using PipelineCacheInterface = grnxx::PipelineCache;
 using PipelineInterface = grnxx::Pipeline;
 using PipelineBuilderInterface = grnxx::PipelineBuilder;
 
+class PipelineCache : public PipelineCacheInterface {
+ public:
+  // -- Public API (grnxx/pipeline.hpp) --
+
+  explicit PipelineCache(const PipelineCacheOptions &options);
+  ~PipelineCache() = default;
+
+  size_t num_entries() const;
+  size_t size() const;
+
+  void clear();
+
+  // -- Internal API --
+
+  // Find the records cached with "key" and "revisions".
+  //
+  // "revisions" must be the current revisions of the tables and the columns
+  // read by the pipeline, and an entry with other revisions is removed
+  // because it is outdated.
+  //
+  // If found, returns the records.
+  // If not found, returns nullptr.
+  std::shared_ptr<const Array<Record>> find(const String &key,
+                                            ArrayCRef<uint64_t> revisions);
+
+  // Cache "records" with "key" and "revisions".
+  //
+  // Records larger than the maximum size are not cached.
+  //
+  // On failure, throws an exception.
+  void insert(const String &key,
+              ArrayCRef<uint64_t> revisions,
+              const std::shared_ptr<const Array<Record>> &records);
+
+ private:
+  struct Entry {
+    String key;
+    Array<uint64_t> revisions;
+    std::shared_ptr<const Array<Record>> records;
+    size_t size;
+  };
+  using EntryList = std::list<Entry>;
+
+  mutable std::mutex mutex_;
+  size_t max_size_;
+  size_t size_;
+  // Entries in most recently used order.
+  EntryList entries_;
+  // NOTE: Keys of "map_" refer to the keys owned by "entries_".
+  std::map<String, EntryList::iterator> map_;
+
+  // Remove an entry.
+  void remove(EntryList::iterator it);
+};
+
 class Pipeline : public PipelineInterface {
  public:
   using Node = pipeline::Node;
@@ -31,12 +90,26 @@ class Pipeline : public PipelineInterface {
   const Table *table() const {
     return table_;
   }
+  size_t block_size() const {
+    return block_size_;
+  }
 
   void flush(Array<Record> *records);
+  std::shared_ptr<const Array<Record>> flush_shared();
 
  private:
   const Table *table_;
   std::unique_ptr<Node> root_;
+  size_t block_size_;
+  PipelineCache *cache_;
+  String cache_key_;
+  Array<const ColumnBase *> columns_;
+
+  // Get the current revisions of the tables and the columns read by the
+  // pipeline.
+  //
+  // On failure, throws an exception.
+  void get_revisions(Array<uint64_t> *revisions) const;
 };
 
 class PipelineBuilder : public PipelineBuilderInterface {
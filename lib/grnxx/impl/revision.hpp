@@ -0,0 +1,25 @@
+#ifndef GRNXX_IMPL_REVISION_HPP
+#define GRNXX_IMPL_REVISION_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace grnxx {
+namespace impl {
+
+// A revision identifies the state of a table or a column.
+//
+// Tables and columns get a new revision whenever their contents change, and
+// revisions are never reused in a process, so that an unchanged revision
+// guarantees that the object is the same and has not been modified.
+
+// Return a new revision.
+inline uint64_t generate_revision() {
+  static std::atomic<uint64_t> last_revision(0);
+  return ++last_revision;
+}
+
+}  // namespace impl
+}  // namespace grnxx
+
+#endif  // GRNXX_IMPL_REVISION_HPP
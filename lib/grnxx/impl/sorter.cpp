@@ -1,9 +1,21 @@
 #include "grnxx/impl/sorter.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <new>
+
+#include "grnxx/impl/expression.hpp"
+
 namespace grnxx {
 namespace impl {
 namespace sorter {
 
+// Append the bytes of "value" to "description".
+template <typename T>
+void append_bytes(const T &value, String *description) {
+  description->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
 // -- Node --
 
 class Node {
@@ -13,6 +25,10 @@ class Node {
         next_(nullptr) {}
   virtual ~Node() = default;
 
+  // Return the order.
+  const SorterOrder &order() const {
+    return order_;
+  }
   // Set the next node.
   void set_next(Node *next) {
     next_ = next;
@@ -533,7 +549,7 @@ class ConvertNode : public Node {
 
   void sort(ArrayRef<Record> records, size_t begin, size_t end);
 
- private:
+ protected:
   Converter converter_;
   Array<Value> values_;
   Array<uint64_t> internal_values_;
@@ -1073,6 +1089,97 @@ void TextNode<T>::move_pivot_first(ArrayRef<Record> records, Text *values) {
   }
 }
 
+// --- TextCodeNode ---
+
+// Return whether "expression" is a dictionary-encoded Text column or not.
+bool is_dictionary_encoded_column(const ExpressionInterface *expression) {
+  const ColumnBase *column =
+      static_cast<const Expression *>(expression)->column();
+  return column && (column->data_type() == GRNXX_TEXT) &&
+         static_cast<const Column<Text> *>(column)->is_dictionary_encoded();
+}
+
+// Sorter for a dictionary-encoded Text column.
+//
+// Distinct codes are sorted by their values, and then records are sorted by
+// the ranks of their codes with the quick sort for integers.
+template <typename T>
+class TextCodeNode : public ConvertNode<Int, RegularIntConverter> {
+ public:
+  // "order.expression" must be a dictionary-encoded Text column.
+  explicit TextCodeNode(SorterOrder &&order)
+      : ConvertNode<Int, RegularIntConverter>(std::move(order)),
+        column_(static_cast<const Column<Text> *>(
+            static_cast<const Expression *>(
+                this->order_.expression.get())->column())),
+        comparer_(),
+        codes_(),
+        distinct_codes_(),
+        ranked_codes_(),
+        ranks_() {}
+  ~TextCodeNode() = default;
+
+  void sort(ArrayRef<Record> records, size_t begin, size_t end);
+
+ private:
+  const Column<Text> *column_;
+  T comparer_;
+  Array<uint32_t> codes_;
+  Array<uint32_t> distinct_codes_;
+  Array<uint32_t> ranked_codes_;
+  Array<uint64_t> ranks_;
+};
+
+template <typename T>
+void TextCodeNode<T>::sort(ArrayRef<Record> records,
+                           size_t begin,
+                           size_t end) try {
+  codes_.resize(records.size());
+  column_->read_codes(records, codes_.ref());
+
+  // "distinct_codes_" is sorted by codes and "ranked_codes_" is sorted by
+  // values, and "ranks_[i]" is the rank of "distinct_codes_[i]".
+  // N/A is the last because na_code() is the maximum code.
+  distinct_codes_.resize(codes_.size());
+  std::copy(codes_.buffer(), codes_.buffer() + codes_.size(),
+            distinct_codes_.buffer());
+  uint32_t *codes_begin = distinct_codes_.buffer();
+  uint32_t *codes_end = codes_begin + distinct_codes_.size();
+  std::sort(codes_begin, codes_end);
+  codes_end = std::unique(codes_begin, codes_end);
+  if ((codes_end != codes_begin) &&
+      (codes_end[-1] == Column<Text>::na_code())) {
+    --codes_end;
+  }
+  distinct_codes_.resize(codes_end - codes_begin);
+  ranked_codes_.resize(distinct_codes_.size());
+  std::copy(codes_begin, codes_end, ranked_codes_.buffer());
+  std::sort(ranked_codes_.buffer(),
+            ranked_codes_.buffer() + ranked_codes_.size(),
+            [this](uint32_t lhs, uint32_t rhs) {
+              return comparer_(column_->decode(lhs), column_->decode(rhs));
+            });
+  ranks_.resize(distinct_codes_.size());
+  for (size_t i = 0; i < ranked_codes_.size(); ++i) {
+    ranks_[std::lower_bound(codes_begin, codes_end, ranked_codes_[i]) -
+           codes_begin] = i;
+  }
+
+  this->internal_values_.resize(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (codes_[i] == Column<Text>::na_code()) {
+      this->internal_values_[i] = std::numeric_limits<uint64_t>::max();
+    } else {
+      this->internal_values_[i] =
+          ranks_[std::lower_bound(codes_begin, codes_end, codes_[i]) -
+                 codes_begin];
+    }
+  }
+  this->quick_sort(records, this->internal_values_.buffer(), begin, end);
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
 // --- RowIDNodeS ---
 
 template <typename T>
@@ -1470,6 +1577,79 @@ void TextNodeS<T>::sort(ArrayRef<Record> ref, size_t begin, size_t end) {
   // TODO: Same values can be dropped if "!this->next_".
 }
 
+// -- IndexOrderCursor --
+
+// Cursor to read records in order of values of a column through an index.
+//
+// Rows whose values are N/A are not indexed, so that they are read through a
+// table cursor after the indexed rows, in the same way as nodes put N/A last.
+class IndexOrderCursor : public Cursor {
+ public:
+  // If "table_cursor" is nullptr, there are no N/A.
+  IndexOrderCursor(const ColumnBase *column,
+                   std::unique_ptr<Cursor> &&index_cursor,
+                   std::unique_ptr<Cursor> &&table_cursor)
+      : Cursor(),
+        column_(column),
+        index_cursor_(std::move(index_cursor)),
+        table_cursor_(std::move(table_cursor)) {}
+  ~IndexOrderCursor() = default;
+
+  size_t read(ArrayRef<Record> records);
+
+ private:
+  const ColumnBase *column_;
+  std::unique_ptr<Cursor> index_cursor_;
+  std::unique_ptr<Cursor> table_cursor_;
+
+  // Return whether the value of "row_id" is N/A or not.
+  bool is_na(Int row_id) const;
+};
+
+size_t IndexOrderCursor::read(ArrayRef<Record> records) {
+  if (index_cursor_) {
+    size_t count = index_cursor_->read(records);
+    if (count != 0) {
+      return count;
+    }
+    index_cursor_.reset();
+  }
+  size_t count = 0;
+  while (table_cursor_ && (count == 0)) {
+    size_t num_records = table_cursor_->read(records);
+    if (num_records == 0) {
+      table_cursor_.reset();
+      break;
+    }
+    for (size_t i = 0; i < num_records; ++i) {
+      if (is_na(records[i].row_id)) {
+        records[count] = records[i];
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+bool IndexOrderCursor::is_na(Int row_id) const {
+  Datum datum;
+  column_->get(row_id, &datum);
+  switch (datum.type()) {
+    case GRNXX_INT: {
+      return datum.as_int().is_na();
+    }
+    case GRNXX_FLOAT: {
+      return datum.as_float().is_na();
+    }
+    case GRNXX_TEXT: {
+      return datum.as_text().is_na();
+    }
+    default: {
+      return true;
+    }
+  }
+}
+
 }  // namespace sorter
 
 using namespace sorter;
@@ -1558,6 +1738,203 @@ void Sorter::sort(Array<Record> *records) {
   finish();
 }
 
+std::unique_ptr<Cursor> Sorter::create_ordered_cursor() const try {
+  if (nodes_.size() > 2) {
+    return nullptr;
+  }
+  bool has_row_id_order = (nodes_.size() == 2);
+  if (has_row_id_order) {
+    const SorterOrder &order = nodes_[1]->order();
+    if (!order.expression->is_row_id() ||
+        (order.type != GRNXX_REGULAR_ORDER)) {
+      return nullptr;
+    }
+  }
+  const SorterOrder &order = nodes_[0]->order();
+  const ColumnBase *column =
+      static_cast<const Expression *>(order.expression.get())->column();
+  if (!column) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < column->num_indexes(); ++i) {
+    Index *index = column->get_index(i);
+    if (index->type() != GRNXX_TREE_INDEX) {
+      continue;
+    }
+    // A tree index returns rows with the same value in ascending order of
+    // row IDs, but a composite index orders them by the other columns.
+    if (has_row_id_order &&
+        !index->options().secondary_column_names.is_empty()) {
+      continue;
+    }
+    CursorOptions options;
+    options.order_type = order.type;
+    std::unique_ptr<Cursor> index_cursor =
+        index->find_in_range(IndexRange(), options);
+    std::unique_ptr<Cursor> table_cursor;
+    if (index->num_entries() != table_->num_rows()) {
+      table_cursor = table_->create_cursor(CursorOptions());
+    }
+    return std::unique_ptr<Cursor>(new IndexOrderCursor(
+        column, std::move(index_cursor), std::move(table_cursor)));
+  }
+  return nullptr;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+std::unique_ptr<Cursor> Sorter::create_prefix_cursor(
+    ArrayCRef<ExpressionCondition> conditions,
+    bool *is_exact) const try {
+  if (nodes_.size() > 2) {
+    return nullptr;
+  }
+  bool has_row_id_order = (nodes_.size() == 2);
+  if (has_row_id_order) {
+    const SorterOrder &order = nodes_[1]->order();
+    if (!order.expression->is_row_id() ||
+        (order.type != GRNXX_REGULAR_ORDER)) {
+      return nullptr;
+    }
+  }
+  const SorterOrder &order = nodes_[0]->order();
+  const ColumnBase *column =
+      static_cast<const Expression *>(order.expression.get())->column();
+  if (!column || (column->_table() != table_)) {
+    return nullptr;
+  }
+  Array<const ColumnBase *> columns;
+  Array<bool> is_used;
+  is_used.resize(conditions.size(), false);
+  for (size_t i = 0; i < table_->num_columns(); ++i) {
+    const ColumnBase *owner_column = table_->get_column(i);
+    for (size_t j = 0; j < owner_column->num_indexes(); ++j) {
+      Index *index = owner_column->get_index(j);
+      if (index->type() != GRNXX_TREE_INDEX) {
+        continue;
+      }
+      IndexOptions index_options = index->options();
+      if (index_options.secondary_column_names.is_empty()) {
+        continue;
+      }
+      // "columns" are the columns of the tuples.
+      columns.clear();
+      columns.push_back(owner_column);
+      for (size_t k = 0; k < index_options.secondary_column_names.size();
+           ++k) {
+        columns.push_back(
+            table_->find_column(index_options.secondary_column_names[k]));
+      }
+      size_t order_id = 0;
+      while ((order_id < columns.size()) && (columns[order_id] != column)) {
+        ++order_id;
+      }
+      if ((order_id == columns.size()) ||
+          (has_row_id_order && (order_id != (columns.size() - 1)))) {
+        continue;
+      }
+      // The preceding columns must be equal to constants.
+      Array<Datum> prefix;
+      prefix.resize(order_id);
+      for (size_t k = 0; k < conditions.size(); ++k) {
+        is_used[k] = false;
+      }
+      size_t num_matches = 0;
+      for (size_t k = 0; k < order_id; ++k) {
+        for (size_t l = 0; l < conditions.size(); ++l) {
+          if ((conditions[l].column == columns[k]) &&
+              (conditions[l].operator_type == GRNXX_EQUAL)) {
+            prefix[k] = conditions[l].value;
+            is_used[l] = true;
+            ++num_matches;
+            break;
+          }
+        }
+      }
+      if (num_matches != order_id) {
+        continue;
+      }
+      // The first lower and upper bounds of the order column form the range
+      // and the others are left to the filter.
+      IndexRange range;
+      bool has_lower_bound = false;
+      bool has_upper_bound = false;
+      for (size_t l = 0; l < conditions.size(); ++l) {
+        if (conditions[l].column != column) {
+          continue;
+        }
+        OperatorType operator_type = conditions[l].operator_type;
+        bool is_lower_bound = (operator_type == GRNXX_EQUAL) ||
+                              (operator_type == GRNXX_GREATER) ||
+                              (operator_type == GRNXX_GREATER_EQUAL);
+        bool is_upper_bound = (operator_type == GRNXX_EQUAL) ||
+                              (operator_type == GRNXX_LESS) ||
+                              (operator_type == GRNXX_LESS_EQUAL);
+        if ((is_lower_bound && has_lower_bound) ||
+            (is_upper_bound && has_upper_bound)) {
+          continue;
+        }
+        if (is_lower_bound) {
+          range.set_lower_bound(conditions[l].value,
+                                (operator_type == GRNXX_GREATER) ?
+                                EXCLUSIVE_END_POINT : INCLUSIVE_END_POINT);
+          has_lower_bound = true;
+        }
+        if (is_upper_bound) {
+          range.set_upper_bound(conditions[l].value,
+                                (operator_type == GRNXX_LESS) ?
+                                EXCLUSIVE_END_POINT : INCLUSIVE_END_POINT);
+          has_upper_bound = true;
+        }
+        is_used[l] = true;
+      }
+      // Rows whose owner values are N/A are not indexed.
+      bool has_range = has_lower_bound || has_upper_bound;
+      if ((order_id == 0) && !has_range) {
+        continue;
+      }
+      // N/A follows the other values in the index, but nodes put N/A last
+      // in both orders.
+      if ((order.type != GRNXX_REGULAR_ORDER) && !has_range) {
+        continue;
+      }
+      *is_exact = true;
+      for (size_t k = 0; k < conditions.size(); ++k) {
+        if (!is_used[k]) {
+          *is_exact = false;
+          break;
+        }
+      }
+      CursorOptions options;
+      options.order_type = order.type;
+      return index->find_with_prefix(prefix.cref(), range, options);
+    }
+  }
+  return nullptr;
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void Sorter::describe(String *description,
+                      Array<const ColumnBase *> *columns) const try {
+  append_bytes(offset_, description);
+  append_bytes(limit_, description);
+  append_bytes(nodes_.size(), description);
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    const SorterOrder &order = nodes_[i]->order();
+    const Expression *expression =
+        static_cast<const Expression *>(order.expression.get());
+    append_bytes(order.type, description);
+    append_bytes(expression->description().size(), description);
+    description->append(expression->description());
+    for (size_t j = 0; j < expression->columns().size(); ++j) {
+      columns->push_back(expression->columns()[j]);
+    }
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
 Node *Sorter::create_node(SorterOrder &&order) try {
   if (order.expression->is_row_id()) {
     if (nodes_.is_empty() && ((offset_ + limit_) < 1000)) {
@@ -1624,6 +2001,12 @@ Node *Sorter::create_node(SorterOrder &&order) try {
         } else {
           return new TextNodeS<ReverseTextComparer>(std::move(order));
         }
+      } else if (is_dictionary_encoded_column(order.expression.get())) {
+        if (order.type == GRNXX_REGULAR_ORDER) {
+          return new TextCodeNode<RegularTextComparer>(std::move(order));
+        } else {
+          return new TextCodeNode<ReverseTextComparer>(std::move(order));
+        }
       } else {
         if (order.type == GRNXX_REGULAR_ORDER) {
           return new TextNode<RegularTextComparer>(std::move(order));
@@ -1,6 +1,7 @@
 #ifndef GRNXX_IMPL_SORTER_HPP
 #define GRNXX_IMPL_SORTER_HPP
 
+#include "grnxx/impl/expression.hpp"
 #include "grnxx/impl/table.hpp"
 #include "grnxx/sorter.hpp"
 
@@ -31,6 +32,52 @@ class Sorter : public SorterInterface {
   void finish();
   void sort(Array<Record> *records);
 
+  // -- Internal API --
+
+  // Return the number of records to be skipped.
+  size_t offset() const {
+    return offset_;
+  }
+  // Return the maximum number of result records.
+  size_t limit() const {
+    return limit_;
+  }
+
+  // Create a cursor to read all the rows of the table in the sorted order.
+  //
+  // A cursor is available if the first order is an Int, Float or Text
+  // column with a tree index and the next order, if exists, is row IDs in
+  // regular order.
+  //
+  // On success, returns the cursor or nullptr if not available.
+  // On failure, throws an exception.
+  std::unique_ptr<Cursor> create_ordered_cursor() const;
+  // Create a cursor to read rows satisfying "conditions" in the sorted order
+  // through a composite index.
+  //
+  // A cursor is available if the first order is a column of a composite
+  // index, "conditions" have equalities for the preceding columns of the
+  // index, and the next order, if exists, is row IDs in regular order and
+  // the column is the last one of the index. Unless "conditions" bound the
+  // first order, it must be in regular order, because N/A is indexed.
+  // "*is_exact" is set to whether all the "conditions" are used, so that
+  // the cursor reads only rows satisfying them.
+  //
+  // On success, returns the cursor or nullptr if not available.
+  // On failure, throws an exception.
+  std::unique_ptr<Cursor> create_prefix_cursor(
+      ArrayCRef<ExpressionCondition> conditions,
+      bool *is_exact) const;
+
+  // Append the description of the sorter to "description" and the columns
+  // read by the sorter to "columns".
+  //
+  // Sorters with the same description sort records in the same way.
+  //
+  // On failure, throws an exception.
+  void describe(String *description,
+                Array<const ColumnBase *> *columns) const;
+
  private:
   const Table *table_;
   Array<std::unique_ptr<Node>> nodes_;
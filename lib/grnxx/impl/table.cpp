@@ -1,14 +1,145 @@
 #include "grnxx/impl/table.hpp"
 
+#include <algorithm>
+#include <limits>
+
+#include "grnxx/impl/column/scalar/zone_map.hpp"
 #include "grnxx/impl/cursor.hpp"
 #include "grnxx/impl/db.hpp"
+#include "grnxx/impl/expression.hpp"
+#include "grnxx/impl/revision.hpp"
 
 namespace grnxx {
 namespace impl {
+namespace table {
+
+// Compare row IDs.
+struct RowIDLess {
+  bool operator()(Int lhs, Int rhs) const {
+    return lhs.raw() < rhs.raw();
+  }
+};
+
+// Test whether row IDs are the same or not.
+struct RowIDEqual {
+  bool operator()(Int lhs, Int rhs) const {
+    return lhs.raw() == rhs.raw();
+  }
+};
+
+// Set "value" to "column" as a reference or a vector of references.
+//
+// On failure, throws an exception.
+void set_references(ColumnBase *column, Int row_id, ArrayCRef<Int> value) {
+  if (column->data_type() == GRNXX_INT_VECTOR) {
+    column->set(row_id, IntVector(value.data(), value.size()));
+  } else {
+    column->set(row_id, value[0]);
+  }
+}
+
+// Replace references to renumbered rows with their new row IDs.
+//
+// New values are prepared before any value is replaced, and replaced values
+// are restored on failure.
+//
+// On failure, throws an exception.
+void rewrite_references(ColumnBase *column, ArrayCRef<Int> row_id_map) {
+  auto cursor = column->table()->create_cursor();
+  Array<Record> records;
+  cursor->read_all(&records);
+  // The value of "row_ids[i]" is replaced from "values[j]" with
+  // "new_values[j]" for "j" in [offsets[i], offsets[i + 1]).
+  Array<Int> row_ids;
+  Array<size_t> offsets;
+  Array<Int> values;
+  Array<Int> new_values;
+  offsets.push_back(0);
+  Datum datum;
+  for (size_t i = 0; i < records.size(); ++i) {
+    Int row_id = records[i].row_id;
+    column->get(row_id, &datum);
+    size_t offset = values.size();
+    bool is_changed = false;
+    switch (datum.type()) {
+      case GRNXX_INT: {
+        Int value = datum.as_int();
+        if (!value.is_na()) {
+          values.push_back(value);
+          new_values.push_back(row_id_map[value.raw()]);
+          is_changed = !new_values.back().match(value);
+        }
+        break;
+      }
+      case GRNXX_INT_VECTOR: {
+        const IntVector &value = datum.as_int_vector();
+        if (value.is_na()) {
+          break;
+        }
+        for (size_t j = 0; j < value.raw_size(); ++j) {
+          values.push_back(value[j]);
+          new_values.push_back(value[j]);
+          if (!value[j].is_na()) {
+            new_values.back() = row_id_map[value[j].raw()];
+            is_changed |= !new_values.back().match(value[j]);
+          }
+        }
+        break;
+      }
+      default: {
+        throw "Wrong referrer column";  // TODO
+      }
+    }
+    if (is_changed) {
+      row_ids.push_back(row_id);
+      offsets.push_back(values.size());
+    } else {
+      values.resize(offset);
+      new_values.resize(offset);
+    }
+  }
+  size_t num_replaced_values = 0;
+  try {
+    for ( ; num_replaced_values < row_ids.size(); ++num_replaced_values) {
+      size_t offset = offsets[num_replaced_values];
+      size_t size = offsets[num_replaced_values + 1] - offset;
+      set_references(column, row_ids[num_replaced_values],
+                     new_values.cref(offset, size));
+    }
+  } catch (...) {
+    while (num_replaced_values > 0) {
+      --num_replaced_values;
+      size_t offset = offsets[num_replaced_values];
+      size_t size = offsets[num_replaced_values + 1] - offset;
+      set_references(column, row_ids[num_replaced_values],
+                     values.cref(offset, size));
+    }
+    throw;
+  }
+}
+
+// Detach composite indexes from a table and attach them again on
+// destruction, so that the indexes are restored even if an exception is
+// thrown.
+class CompositeIndexDetacher {
+ public:
+  explicit CompositeIndexDetacher(Array<Index *> *indexes)
+      : indexes_(indexes),
+        detached_indexes_(std::move(*indexes)) {}
+  ~CompositeIndexDetacher() {
+    *indexes_ = std::move(detached_indexes_);
+  }
+
+ private:
+  Array<Index *> *indexes_;
+  Array<Index *> detached_indexes_;
+};
+
+}  // namespace table
 
 // -- TableRegularCursor --
 
-class TableRegularCursor : public Cursor {
+class TableRegularCursor : public TableCursor {
  public:
   // -- Public API (grnxx/cursor.hpp) --
 
@@ -16,6 +147,17 @@ class TableRegularCursor : public Cursor {
 
   size_t read(ArrayRef<Record> records);
 
+  // -- Internal API (grnxx/impl/cursor.hpp) --
+
+  void set_zone_filter(const ExpressionInterface *expression);
+  bool reads_all_rows(const TableInterface *table) const {
+    return (table == table_) && (offset_left_ == 0) &&
+           (limit_left_ == std::numeric_limits<size_t>::max());
+  }
+  CursorOrderType order_type() const {
+    return GRNXX_REGULAR_ORDER;
+  }
+
   // -- Internal API --
 
   static std::unique_ptr<Cursor> create(const Table *table,
@@ -28,14 +170,21 @@ class TableRegularCursor : public Cursor {
   size_t offset_left_;
   size_t limit_left_;
   int64_t next_row_id_;
+  const Expression *zone_filter_;
 
   TableRegularCursor(const Table *table, const CursorOptions &options);
+
+  // Read records with skipping zones.
+  size_t read_with_zone_filter(ArrayRef<Record> records);
 };
 
 size_t TableRegularCursor::read(ArrayRef<Record> records) {
   if (records.size() <= 0) {
     return 0;
   }
+  if (zone_filter_) {
+    return read_with_zone_filter(records);
+  }
   size_t count = 0;
   if (is_full_) {
     // There are no false bits in the bitmap and bit checks are not required.
@@ -63,25 +212,80 @@ size_t TableRegularCursor::read(ArrayRef<Record> records) {
       ++next_row_id_;
       --limit_left_;
     }
-  } else {
-    // There exist false bits in the bitmap and bit checks are required.
+  } else if (limit_left_ > 0) {
+    // There exist false bits in the bitmap and words are tested at once.
+    // Words without valid rows are skipped, and "offset_left_" is consumed
+    // per word with popcount.
+    ArrayCRef<uint64_t> bitmap = table_->_bitmap();
+    size_t max_word_id = max_row_id_ / 64;
     while (next_row_id_ <= max_row_id_) {
-      if (!table_->_test_row(next_row_id_)) {
-        ++next_row_id_;
+      size_t word_id = next_row_id_ / 64;
+      // Bits for rows before "next_row_id_" and after "max_row_id_" are
+      // cleared.
+      uint64_t word = bitmap[word_id] & (~uint64_t(0) << (next_row_id_ % 64));
+      if (word_id == max_word_id) {
+        word &= ~uint64_t(0) >> (63 - (max_row_id_ % 64));
+      }
+      next_row_id_ = (word_id + 1) * 64;
+      if (word == 0) {
         continue;
       }
       if (offset_left_ > 0) {
-        --offset_left_;
-        ++next_row_id_;
-      } else {
-        records.set(count, Record(Int(next_row_id_), Float(0.0)));
+        // TODO: ::__builtin_popcountll() is not available on VC++.
+        size_t num_bits = ::__builtin_popcountll(word);
+        if (num_bits <= offset_left_) {
+          offset_left_ -= num_bits;
+          continue;
+        }
+        for ( ; offset_left_ > 0; --offset_left_) {
+          word &= word - 1;
+        }
+      }
+      do {
+        // TODO: ::__builtin_ctzll() is not available on VC++.
+        int64_t row_id = (word_id * 64) + ::__builtin_ctzll(word);
+        records.set(count, Record(Int(row_id), Float(0.0)));
         --limit_left_;
         ++count;
-        ++next_row_id_;
+        word &= word - 1;
         if ((limit_left_ <= 0) || (count >= records.size())) {
-          break;
+          next_row_id_ = row_id + 1;
+          return count;
         }
+      } while (word != 0);
+    }
+  }
+  return count;
+}
+
+void TableRegularCursor::set_zone_filter(
+    const ExpressionInterface *expression) {
+  const Expression *zone_filter = static_cast<const Expression *>(expression);
+  if ((zone_filter->table() == table_) && (offset_left_ == 0) &&
+      (limit_left_ == std::numeric_limits<size_t>::max())) {
+    zone_filter_ = zone_filter;
+  }
+}
+
+size_t TableRegularCursor::read_with_zone_filter(ArrayRef<Record> records) {
+  // NOTE: There are no offset and limit.
+  size_t count = 0;
+  while ((next_row_id_ <= max_row_id_) && (count < records.size())) {
+    size_t zone_id = next_row_id_ / ZONE_SIZE;
+    int64_t zone_end = (zone_id + 1) * ZONE_SIZE;
+    if (zone_filter_->can_skip_zone(zone_id)) {
+      next_row_id_ = zone_end;
+      continue;
+    }
+    if (zone_end > (max_row_id_ + 1)) {
+      zone_end = max_row_id_ + 1;
+    }
+    while ((next_row_id_ < zone_end) && (count < records.size())) {
+      if (is_full_ || table_->_test_row(next_row_id_)) {
+        records.set(count, Record(Int(next_row_id_), Float(0.0)));
+        ++count;
       }
+      ++next_row_id_;
     }
   }
   return count;
@@ -105,11 +309,12 @@ TableRegularCursor::TableRegularCursor(const Table *table,
       is_full_(table->is_full()),
       offset_left_(options.offset),
       limit_left_(options.limit),
-      next_row_id_(0) {}
+      next_row_id_(0),
+      zone_filter_(nullptr) {}
 
 // -- TableReverseCursor --
 
-class TableReverseCursor : public Cursor {
+class TableReverseCursor : public TableCursor {
  public:
   // -- Public API (grnxx/cursor.hpp) --
 
@@ -117,6 +322,17 @@ class TableReverseCursor : public Cursor {
 
   size_t read(ArrayRef<Record> records);
 
+  // -- Internal API (grnxx/impl/cursor.hpp) --
+
+  void set_zone_filter(const ExpressionInterface *expression);
+  bool reads_all_rows(const TableInterface *table) const {
+    return (table == table_) && (offset_left_ == 0) &&
+           (limit_left_ == std::numeric_limits<size_t>::max());
+  }
+  CursorOrderType order_type() const {
+    return GRNXX_REVERSE_ORDER;
+  }
+
   // -- Internal API --
 
   static std::unique_ptr<Cursor> create(const Table *table,
@@ -128,14 +344,21 @@ class TableReverseCursor : public Cursor {
   size_t offset_left_;
   size_t limit_left_;
   int64_t next_row_id_;
+  const Expression *zone_filter_;
 
   TableReverseCursor(const Table *table, const CursorOptions &options);
+
+  // Read records with skipping zones.
+  size_t read_with_zone_filter(ArrayRef<Record> records);
 };
 
 size_t TableReverseCursor::read(ArrayRef<Record> records) {
   if (records.size() <= 0) {
     return 0;
   }
+  if (zone_filter_) {
+    return read_with_zone_filter(records);
+  }
   size_t count = 0;
   if (is_full_) {
     // There are no false bits in the bitmap and bit checks are not required.
@@ -163,25 +386,75 @@ size_t TableReverseCursor::read(ArrayRef<Record> records) {
       --next_row_id_;
       --limit_left_;
     }
-  } else {
+  } else if (limit_left_ > 0) {
+    // There exist false bits in the bitmap and words are tested at once.
+    // Words without valid rows are skipped, and "offset_left_" is consumed
+    // per word with popcount.
+    ArrayCRef<uint64_t> bitmap = table_->_bitmap();
     while (next_row_id_ >= 0) {
-      // There exist false bits in the bitmap and bit checks are required.
-      if (!table_->_test_row(next_row_id_)) {
-        --next_row_id_;
+      size_t word_id = next_row_id_ / 64;
+      // Bits for rows after "next_row_id_" are cleared.
+      uint64_t word =
+          bitmap[word_id] & (~uint64_t(0) >> (63 - (next_row_id_ % 64)));
+      next_row_id_ = static_cast<int64_t>(word_id * 64) - 1;
+      if (word == 0) {
         continue;
       }
       if (offset_left_ > 0) {
-        --offset_left_;
-        --next_row_id_;
-      } else {
-        records.set(count, Record(Int(next_row_id_), Float(0.0)));
+        // TODO: ::__builtin_popcountll() is not available on VC++.
+        size_t num_bits = ::__builtin_popcountll(word);
+        if (num_bits <= offset_left_) {
+          offset_left_ -= num_bits;
+          continue;
+        }
+        for ( ; offset_left_ > 0; --offset_left_) {
+          // TODO: ::__builtin_clzll() is not available on VC++.
+          word &= ~(uint64_t(1) << (63 - ::__builtin_clzll(word)));
+        }
+      }
+      do {
+        // TODO: ::__builtin_clzll() is not available on VC++.
+        size_t bit_id = 63 - ::__builtin_clzll(word);
+        int64_t row_id = (word_id * 64) + bit_id;
+        records.set(count, Record(Int(row_id), Float(0.0)));
         --limit_left_;
         ++count;
-        --next_row_id_;
+        word &= ~(uint64_t(1) << bit_id);
         if ((limit_left_ <= 0) || (count >= records.size())) {
-          break;
+          next_row_id_ = row_id - 1;
+          return count;
         }
+      } while (word != 0);
+    }
+  }
+  return count;
+}
+
+void TableReverseCursor::set_zone_filter(
+    const ExpressionInterface *expression) {
+  const Expression *zone_filter = static_cast<const Expression *>(expression);
+  if ((zone_filter->table() == table_) && (offset_left_ == 0) &&
+      (limit_left_ == std::numeric_limits<size_t>::max())) {
+    zone_filter_ = zone_filter;
+  }
+}
+
+size_t TableReverseCursor::read_with_zone_filter(ArrayRef<Record> records) {
+  // NOTE: There are no offset and limit.
+  size_t count = 0;
+  while ((next_row_id_ >= 0) && (count < records.size())) {
+    size_t zone_id = next_row_id_ / ZONE_SIZE;
+    int64_t zone_begin = zone_id * ZONE_SIZE;
+    if (zone_filter_->can_skip_zone(zone_id)) {
+      next_row_id_ = zone_begin - 1;
+      continue;
+    }
+    while ((next_row_id_ >= zone_begin) && (count < records.size())) {
+      if (is_full_ || table_->_test_row(next_row_id_)) {
+        records.set(count, Record(Int(next_row_id_), Float(0.0)));
+        ++count;
       }
+      --next_row_id_;
     }
   }
   return count;
@@ -204,7 +477,8 @@ TableReverseCursor::TableReverseCursor(const Table *table,
       is_full_(table->is_full()),
       offset_left_(options.offset),
       limit_left_(options.limit),
-      next_row_id_(table->max_row_id().raw()) {}
+      next_row_id_(table->max_row_id().raw()),
+      zone_filter_(nullptr) {}
 
 // -- Table --
 
@@ -212,13 +486,15 @@ Table::Table(DB *db, const String &name)
     : TableInterface(),
       db_(db),
       name_(name.clone()),
+      composite_indexes_(),
       columns_(),
       referrer_columns_(),
       key_column_(nullptr),
       num_rows_(0),
       max_row_id_(NA()),
       bitmap_(),
-      bitmap_indexes_() {}
+      bitmap_indexes_(),
+      revision_(generate_revision()) {}
 
 Table::~Table() {}
 
@@ -251,6 +527,12 @@ void Table::remove_column(const String &name) {
     throw "Column not removable";  // TODO
   }
   ColumnBase *column = columns_[column_id].get();
+  for (size_t i = 0; i < composite_indexes_.size(); ++i) {
+    if ((composite_indexes_[i]->_column() != column) &&
+        composite_indexes_[i]->depends_on(column)) {
+      throw "Referred to from a composite index";  // TODO
+    }
+  }
   if (column == key_column_) {
     key_column_ = nullptr;
   }
@@ -407,10 +689,157 @@ void Table::remove_row(Int row_id) {
   }
   invalidate_row(row_id);
 
-  // TODO: Clear referrers.
-//  for (size_t i = 0; i < referrer_columns_.size(); ++i) {
-//    referrer_columns_[i]->clear_references(row_id);
-//  }
+  // Clear referrers.
+  for (size_t i = 0; i < referrer_columns_.size(); ++i) {
+    referrer_columns_[i]->clear_references(row_id);
+  }
+}
+
+void Table::remove_rows(ArrayCRef<Int> row_ids) try {
+  // Row IDs are validated before any row is removed.
+  Array<Int> sorted_row_ids;
+  sorted_row_ids.resize(row_ids.size());
+  for (size_t i = 0; i < row_ids.size(); ++i) {
+    if (!test_row(row_ids[i])) {
+      throw "Invalid row ID";  // TODO
+    }
+    sorted_row_ids[i] = row_ids[i];
+  }
+  if (sorted_row_ids.is_empty()) {
+    return;
+  }
+  // TODO: Check removability.
+  for (size_t i = 0; i < referrer_columns_.size(); ++i) {
+    if (referrer_columns_[i]->is_key()) {
+      throw "Referred to from a key column";  // TODO
+    }
+  }
+  // Rows are processed in ascending order of row IDs, so that column values
+  // and bitmap words are accessed sequentially.
+  Int *begin = sorted_row_ids.buffer();
+  Int *end = begin + sorted_row_ids.size();
+  std::sort(begin, end, table::RowIDLess());
+  end = std::unique(begin, end, table::RowIDEqual());
+  sorted_row_ids.resize(end - begin);
+
+  // Unset column values.
+  for (size_t i = 0; i < num_columns(); ++i) {
+    columns_[i]->unset_rows(sorted_row_ids);
+  }
+  invalidate_rows(sorted_row_ids);
+
+  // Clear referrers.
+  for (size_t i = 0; i < referrer_columns_.size(); ++i) {
+    for (size_t j = 0; j < sorted_row_ids.size(); ++j) {
+      referrer_columns_[i]->clear_references(sorted_row_ids[j]);
+    }
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
+void Table::vacuum(Array<Int> *row_id_map) try {
+  // "new_row_ids[i]" is the new row ID of the "i"-th row.
+  size_t num_rows = num_rows_;
+  size_t map_size = is_empty() ? 0 : (max_row_id_.raw() + 1);
+  Array<Int> new_row_ids;
+  new_row_ids.resize(map_size, Int::na());
+  for (size_t i = 0, new_row_id = 0; i < map_size; ++i) {
+    if (_test_row(i)) {
+      new_row_ids[i] = Int(new_row_id);
+      ++new_row_id;
+    }
+  }
+  if (!is_full()) {
+    for (size_t i = 0; i < referrer_columns_.size(); ++i) {
+      if (referrer_columns_[i]->is_key()) {
+        throw "Referred to from a key column";  // TODO
+      }
+    }
+    // Everything except column values and indexes is prepared before the
+    // table is changed.
+    // "old_row_ids[i]" is the old row ID of the "i"-th row after renumbering
+    // and "added_row_ids" are new row IDs which are invalid now.
+    Array<Int> old_row_ids;
+    Array<Int> added_row_ids;
+    old_row_ids.resize(map_size, Int::na());
+    for (size_t i = 0; i < map_size; ++i) {
+      if (!new_row_ids[i].is_na()) {
+        old_row_ids[new_row_ids[i].raw()] = Int(i);
+      }
+      if ((i < num_rows) && !_test_row(i)) {
+        added_row_ids.push_back(Int(i));
+      }
+    }
+    // The bitmap of the dense rows is built by a temporary table.
+    Table dense_table(db_, name_);
+    dense_table.reserve_row(Int(num_rows - 1));
+    for (size_t i = 0; i < num_rows; ++i) {
+      dense_table.validate_row(Int(i));
+    }
+
+    // Validate all the new row IDs, so that both old and new row IDs are
+    // valid while values are moved.
+    for (size_t i = 0; i < added_row_ids.size(); ++i) {
+      validate_row(added_row_ids[i]);
+    }
+    // Changes are undone in reverse order on failure.
+    size_t num_renumbered_columns = 0;
+    bool is_dense = false;
+    size_t num_rebuilt_columns = 0;
+    size_t num_rewritten_columns = 0;
+    try {
+      {
+        // Composite indexes are detached while values are moved, because
+        // they are rebuilt with the other indexes.
+        table::CompositeIndexDetacher detacher(&composite_indexes_);
+        for ( ; num_renumbered_columns < num_columns();
+             ++num_renumbered_columns) {
+          columns_[num_renumbered_columns]->renumber_rows(new_row_ids);
+        }
+      }
+      // Replace the bitmap with the dense one, which keeps the current one.
+      swap_bitmap(&dense_table);
+      is_dense = true;
+      for ( ; num_rebuilt_columns < num_columns(); ++num_rebuilt_columns) {
+        columns_[num_rebuilt_columns]->rebuild_indexes();
+      }
+      for ( ; num_rewritten_columns < referrer_columns_.size();
+           ++num_rewritten_columns) {
+        table::rewrite_references(referrer_columns_[num_rewritten_columns],
+                                  new_row_ids);
+      }
+    } catch (...) {
+      // NOTE: If an undo fails, the table may be left inconsistent.
+      if (is_dense) {
+        swap_bitmap(&dense_table);
+      }
+      while (num_rewritten_columns > 0) {
+        --num_rewritten_columns;
+        table::rewrite_references(referrer_columns_[num_rewritten_columns],
+                                  old_row_ids);
+      }
+      {
+        table::CompositeIndexDetacher detacher(&composite_indexes_);
+        while (num_renumbered_columns > 0) {
+          --num_renumbered_columns;
+          columns_[num_renumbered_columns]->renumber_rows(old_row_ids);
+        }
+      }
+      for (size_t i = 0; i < num_rebuilt_columns; ++i) {
+        columns_[i]->rebuild_indexes();
+      }
+      for (size_t i = 0; i < added_row_ids.size(); ++i) {
+        invalidate_row(added_row_ids[i]);
+      }
+      throw;
+    }
+  }
+  if (row_id_map) {
+    *row_id_map = std::move(new_row_ids);
+  }
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
 }
 
 Int Table::find_row(const Datum &key) const {
@@ -477,6 +906,29 @@ void Table::remove_referrer_column(ColumnBase *column) {
   throw "Referrer column not found";  // TODO
 }
 
+void Table::append_composite_index(Index *index) {
+  composite_indexes_.push_back(index);
+}
+
+void Table::remove_composite_index(Index *index) {
+  for (size_t i = 0; i < composite_indexes_.size(); ++i) {
+    if (index == composite_indexes_[i]) {
+      composite_indexes_.erase(i);
+      return;
+    }
+  }
+  throw "Composite index not found";  // TODO
+}
+
+void Table::swap_bitmap(Table *table) {
+  std::swap(num_rows_, table->num_rows_);
+  std::swap(max_row_id_, table->max_row_id_);
+  std::swap(bitmap_, table->bitmap_);
+  std::swap(bitmap_indexes_, table->bitmap_indexes_);
+  revision_ = generate_revision();
+  table->revision_ = generate_revision();
+}
+
 Int Table::find_next_row_id() const {
   if (is_empty()) {
     return Int(0);
@@ -541,6 +993,7 @@ void Table::validate_row(Int row_id) {
     max_row_id_ = row_id;
   }
   ++num_rows_;
+  revision_ = generate_revision();
 }
 
 void Table::invalidate_row(Int row_id) {
@@ -560,6 +1013,7 @@ void Table::invalidate_row(Int row_id) {
     }
   }
   --num_rows_;
+  revision_ = generate_revision();
   if (is_empty()) {
     max_row_id_ = Int::na();
   } else if (row_id.match(max_row_id_)) {
@@ -576,6 +1030,45 @@ void Table::invalidate_row(Int row_id) {
   }
 }
 
+void Table::invalidate_rows(ArrayCRef<Int> row_ids) {
+  // Bits are cleared per word and bitmap indexes are updated only for words
+  // which were full.
+  for (size_t i = 0; i < row_ids.size(); ) {
+    size_t block_id = row_ids[i].raw() / 64;
+    uint64_t mask = 0;
+    for ( ; (i < row_ids.size()) &&
+            (static_cast<size_t>(row_ids[i].raw() / 64) == block_id); ++i) {
+      mask |= uint64_t(1) << (row_ids[i].raw() % 64);
+    }
+    bool is_full = (bitmap_[block_id] == ~uint64_t(0));
+    bitmap_[block_id] &= ~mask;
+    for (size_t index_id = 0; is_full && (index_id < bitmap_indexes_.size());
+         ++index_id) {
+      size_t bit_id = block_id;
+      block_id /= 64;
+      is_full = bitmap_indexes_[index_id][block_id] == ~uint64_t(0);
+      bitmap_indexes_[index_id][block_id] &= ~(uint64_t(1) << (bit_id % 64));
+    }
+  }
+  num_rows_ -= row_ids.size();
+  revision_ = generate_revision();
+  // "max_row_id_" is updated at once.
+  if (is_empty()) {
+    max_row_id_ = Int::na();
+  } else if (!_test_row(max_row_id_.raw())) {
+    int64_t block_id = max_row_id_.raw() / 64;
+    while (block_id >= 0) {
+      if (bitmap_[block_id] != 0) {
+        break;
+      }
+      --block_id;
+    }
+    // TODO: ::__builtin_clzll() is not available on VC++.
+    max_row_id_ = Int((block_id * 64) + 63 -
+                      ::__builtin_clzll(bitmap_[block_id]));
+  }
+}
+
 ColumnBase *Table::find_column_with_id(const String &name,
                                        size_t *column_id) const {
   for (size_t i = 0; i < num_columns(); ++i) {
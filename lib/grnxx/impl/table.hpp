@@ -67,6 +67,8 @@ class Table : public TableInterface {
   void insert_row_at(Int row_id, const Datum &key);
 
   void remove_row(Int row_id);
+  void remove_rows(ArrayCRef<Int> row_ids);
+  void vacuum(Array<Int> *row_id_map);
 
   bool test_row(Int row_id) const {
     size_t bit_id = row_id.raw();
@@ -101,6 +103,20 @@ class Table : public TableInterface {
     return (bitmap_[row_id / 64] & (uint64_t(1) << (row_id % 64))) != 0;
   }
 
+  // Return the bitmap of valid rows.
+  //
+  // The "i"-th row is valid if the "(i % 64)"-th bit of the "(i / 64)"-th
+  // word is set.
+  ArrayCRef<uint64_t> _bitmap() const {
+    return bitmap_.cref();
+  }
+
+  // Return the revision, which is changed whenever a row is inserted or
+  // removed.
+  uint64_t revision() const {
+    return revision_;
+  }
+
   // Change the table name.
   //
   // On failure, throws an exception.
@@ -119,9 +135,32 @@ class Table : public TableInterface {
   // On failure, throws an exception.
   void remove_referrer_column(ColumnBase *column);
 
+  // Append a composite index, which depends on columns of "this".
+  //
+  // On failure, throws an exception.
+  void append_composite_index(Index *index);
+
+  // Remove a composite index.
+  //
+  // On failure, throws an exception.
+  void remove_composite_index(Index *index);
+
+  // Update composite indexes after the value of "column" in "row_id" is
+  // changed.
+  //
+  // On failure, throws an exception.
+  void update_composite_indexes(const ColumnBase *column, Int row_id) {
+    for (size_t i = 0; i < composite_indexes_.size(); ++i) {
+      composite_indexes_[i]->update_row(column, row_id);
+    }
+  }
+
  private:
   DB *db_;
   String name_;
+  // NOTE: "composite_indexes_" must be destroyed after "columns_", because
+  //       composite indexes are removed with their owner columns.
+  Array<Index *> composite_indexes_;
   Array<std::unique_ptr<ColumnBase>> columns_;
   Array<ColumnBase *> referrer_columns_;
   ColumnBase *key_column_;
@@ -129,7 +168,10 @@ class Table : public TableInterface {
   Int max_row_id_;
   Array<uint64_t> bitmap_;
   Array<Array<uint64_t>> bitmap_indexes_;
+  uint64_t revision_;
 
+  // Swap the valid rows with "*table".
+  void swap_bitmap(Table *table);
   // Find the next row ID candidate.
   Int find_next_row_id() const;
   // Reserve a row.
@@ -140,6 +182,10 @@ class Table : public TableInterface {
   void validate_row(Int row_id);
   // Invalidate a row.
   void invalidate_row(Int row_id);
+  // Invalidate rows.
+  //
+  // "row_ids" must be sorted in ascending order without duplicates.
+  void invalidate_rows(ArrayCRef<Int> row_ids);
 
   // Find a column with its ID.
   //
@@ -0,0 +1,44 @@
+#ifndef GRNXX_IMPL_VARINT_HPP
+#define GRNXX_IMPL_VARINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace grnxx {
+namespace impl {
+
+// A varint stores an unsigned integer in 7-bit groups, least significant
+// group first, and the most significant bit of each byte tells whether the
+// next byte follows or not.
+
+// The maximum number of bytes of a varint.
+constexpr size_t MAX_VARINT_SIZE = 10;
+
+// Write "value" as a varint and return the number of bytes.
+inline size_t write_varint(uint64_t value, uint8_t *buf) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    buf[size++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  buf[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+// Read a varint and return the next position.
+inline const uint8_t *read_varint(const uint8_t *buf, uint64_t *value) {
+  uint64_t result = *buf & 0x7F;
+  size_t shift = 7;
+  while ((*buf & 0x80) != 0) {
+    ++buf;
+    result |= static_cast<uint64_t>(*buf & 0x7F) << shift;
+    shift += 7;
+  }
+  *value = result;
+  return buf + 1;
+}
+
+}  // namespace impl
+}  // namespace grnxx
+
+#endif  // GRNXX_IMPL_VARINT_HPP
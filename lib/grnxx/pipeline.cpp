@@ -6,6 +6,13 @@
 
 namespace grnxx {
 
+std::unique_ptr<PipelineCache> PipelineCache::create(
+    const PipelineCacheOptions &options) try {
+  return std::unique_ptr<PipelineCache>(new impl::PipelineCache(options));
+} catch (const std::bad_alloc &) {
+  throw "Memory allocation failed";  // TODO
+}
+
 std::unique_ptr<PipelineBuilder> PipelineBuilder::create(
     const Table *table) try {
   return std::unique_ptr<PipelineBuilder>(
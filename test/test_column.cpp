@@ -18,9 +18,13 @@
 #include <cassert>
 #include <iostream>
 #include <random>
+#include <string>
+#include <vector>
 
 #include "grnxx/column.hpp"
+#include "grnxx/cursor.hpp"
 #include "grnxx/db.hpp"
+#include "grnxx/expression.hpp"
 #include "grnxx/table.hpp"
 
 std::mt19937_64 rng;
@@ -539,6 +543,693 @@ void test_find_one() {
   assert(!column->find_one(grnxx::Int::na()).is_na());
 }
 
+void test_dictionary_encoding() {
+  constexpr size_t NUM_ROWS = 1 << 17;
+
+  // Create a table and insert rows.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    table->insert_row();
+  }
+
+  grnxx::ColumnOptions options;
+  options.dictionary_encoding = true;
+  auto column = table->create_column("Text", GRNXX_TEXT, options);
+
+  // Distinct values make codes wider.
+  std::vector<std::string> values(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    values[i] = std::to_string(i);
+    column->set(grnxx::Int(i), grnxx::Text(values[i].data(),
+                                           values[i].size()));
+  }
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Datum datum;
+    column->get(grnxx::Int(i), &datum);
+    assert(datum.type() == GRNXX_TEXT);
+    assert(datum.as_text().match(grnxx::Text(values[i].data(),
+                                             values[i].size())));
+  }
+
+  // Repeated values share codes.
+  const char *colors[] = { "red", "green", "blue" };
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    column->set(grnxx::Int(i), grnxx::Text(colors[i % 3]));
+  }
+  column->set(grnxx::Int(0), grnxx::Text::na());
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Datum datum;
+    column->get(grnxx::Int(i), &datum);
+    if (i == 0) {
+      assert(datum.as_text().is_na());
+    } else {
+      assert(datum.as_text().match(grnxx::Text(colors[i % 3])));
+    }
+  }
+  assert(column->contains(grnxx::Text("red")));
+  assert(column->contains(grnxx::Text("green")));
+  assert(!column->contains(grnxx::Text("yellow")));
+  assert(column->contains(grnxx::Text::na()));
+  assert(column->find_one(grnxx::Text("green")).raw() == 1);
+  assert(column->find_one(grnxx::Text("yellow")).is_na());
+  assert(column->find_one(grnxx::Text::na()).raw() == 0);
+  column->set(grnxx::Int(0), grnxx::Text("red"));
+  assert(!column->contains(grnxx::Text::na()));
+
+  // Test an expression (Text == "blue").
+  auto builder = grnxx::ExpressionBuilder::create(table);
+  builder->push_constant(grnxx::Text("blue"));
+  builder->push_column("Text");
+  builder->push_operator(GRNXX_EQUAL);
+  auto expression = builder->release();
+  grnxx::Array<grnxx::Record> records;
+  table->create_cursor()->read_all(&records);
+  expression->filter(&records);
+  assert(records.size() == (NUM_ROWS / 3));
+  for (size_t i = 0; i < records.size(); ++i) {
+    assert((records[i].row_id.raw() % 3) == 2);
+  }
+
+  // Test an expression (Text != "yellow").
+  builder->push_column("Text");
+  builder->push_constant(grnxx::Text("yellow"));
+  builder->push_operator(GRNXX_NOT_EQUAL);
+  expression = builder->release();
+  records.clear();
+  table->create_cursor()->read_all(&records);
+  grnxx::Array<grnxx::Bool> results;
+  expression->evaluate(records, &results);
+  for (size_t i = 0; i < results.size(); ++i) {
+    assert(results[i].is_true());
+  }
+  expression->filter(&records);
+  assert(records.size() == NUM_ROWS);
+
+  // Values which are no longer referenced are discarded and their codes are
+  // reused for new values.
+  auto index = column->create_index("Index", GRNXX_HASH_INDEX);
+  for (size_t i = 0; i < NUM_ROWS; i += 2) {
+    values[i] = "new" + std::to_string(i);
+    column->set(grnxx::Int(i), grnxx::Text(values[i].data(),
+                                           values[i].size()));
+  }
+  column->compact();
+  size_t num_greens = 0;
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Text value = ((i % 2) == 0) ?
+        grnxx::Text(values[i].data(), values[i].size()) :
+        grnxx::Text(colors[i % 3]);
+    grnxx::Datum datum;
+    column->get(grnxx::Int(i), &datum);
+    assert(datum.as_text().match(value));
+    if ((i % 6) == 1) {
+      ++num_greens;
+    }
+  }
+  assert(column->find_one(grnxx::Text("new2")).raw() == 2);
+
+  // Test a hash index, which is keyed on codes.
+  records.clear();
+  auto cursor = index->find(grnxx::Text("new4"));
+  assert(cursor->read_all(&records) == 1);
+  assert(records[0].row_id.raw() == 4);
+  records.clear();
+  cursor = index->find(grnxx::Text("green"));
+  assert(cursor->read_all(&records) == num_greens);
+  for (size_t i = 0; i < records.size(); ++i) {
+    assert((records[i].row_id.raw() % 6) == 1);
+  }
+  records.clear();
+  cursor = index->find(grnxx::Text("yellow"));
+  assert(cursor->read_all(&records) == 0);
+  column->set(grnxx::Int(4), grnxx::Text("yellow"));
+  column->set(grnxx::Int(1), grnxx::Text::na());
+  records.clear();
+  cursor = index->find(grnxx::Text("new4"));
+  assert(cursor->read_all(&records) == 0);
+  cursor = index->find(grnxx::Text("yellow"));
+  assert(cursor->read_all(&records) == 1);
+  assert(records[0].row_id.raw() == 4);
+  records.clear();
+  cursor = index->find(grnxx::Text("green"));
+  assert(cursor->read_all(&records) == (num_greens - 1));
+  assert(index->num_entries() == (NUM_ROWS - 1));
+}
+
+void test_compaction() {
+  constexpr size_t NUM_ROWS = 1024;
+
+  // Create a table and insert rows.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    table->insert_row();
+  }
+  auto text_column = table->create_column("Text", GRNXX_TEXT);
+  auto int_vector_column =
+      table->create_column("IntVector", GRNXX_INT_VECTOR);
+  auto text_vector_column =
+      table->create_column("TextVector", GRNXX_TEXT_VECTOR);
+
+  // Overwrite values so that compaction runs incrementally.
+  std::vector<std::string> texts(NUM_ROWS);
+  std::vector<std::vector<grnxx::Int>> int_vectors(NUM_ROWS);
+  std::vector<std::string> vector_texts(NUM_ROWS);
+  std::vector<std::vector<grnxx::Text>> text_vectors(NUM_ROWS);
+  for (size_t round = 0; round < 8; ++round) {
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+      texts[i].assign(1024 + (rng() % 256), 'A' + (rng() % 26));
+      grnxx::Text text(texts[i].data(), texts[i].size());
+      text_column->set(grnxx::Int(i), text);
+      int_vectors[i].resize(128 + (rng() % 128));
+      for (size_t j = 0; j < int_vectors[i].size(); ++j) {
+        int_vectors[i][j] = grnxx::Int(rng() % 1000);
+      }
+      int_vector_column->set(
+          grnxx::Int(i),
+          grnxx::Vector<grnxx::Int>(int_vectors[i].data(),
+                                    int_vectors[i].size()));
+      vector_texts[i] = texts[i];
+      text_vectors[i].assign(rng() % 4,
+                             grnxx::Text(vector_texts[i].data(),
+                                         vector_texts[i].size()));
+      text_vector_column->set(
+          grnxx::Int(i),
+          grnxx::Vector<grnxx::Text>(text_vectors[i].data(),
+                                     text_vectors[i].size()));
+      if ((rng() % 16) == 0) {
+        text_column->set(grnxx::Int(i), grnxx::Text::na());
+        texts[i].clear();
+      }
+    }
+  }
+  // A long vector has its size in front of the body.
+  int_vectors[0].assign(0x10000, grnxx::Int(123));
+  int_vector_column->set(
+      grnxx::Int(0),
+      grnxx::Vector<grnxx::Int>(int_vectors[0].data(),
+                                int_vectors[0].size()));
+  text_column->compact();
+  int_vector_column->compact();
+  text_vector_column->compact();
+
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Datum datum;
+    text_column->get(grnxx::Int(i), &datum);
+    if (texts[i].empty()) {
+      assert(datum.as_text().is_na());
+    } else {
+      assert(datum.as_text().match(grnxx::Text(texts[i].data(),
+                                               texts[i].size())));
+    }
+    int_vector_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_int_vector().match(
+        grnxx::Vector<grnxx::Int>(int_vectors[i].data(),
+                                  int_vectors[i].size())));
+    text_vector_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_text_vector().match(
+        grnxx::Vector<grnxx::Text>(text_vectors[i].data(),
+                                   text_vectors[i].size())));
+  }
+}
+
+void test_frame_of_reference_encoding() {
+  constexpr size_t NUM_ROWS = 5000;
+
+  // Create a table and insert rows.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    table->insert_row();
+  }
+
+  grnxx::ColumnOptions options;
+  options.frame_of_reference_encoding = true;
+  auto column = table->create_column("Int", GRNXX_INT, options);
+
+  // Timestamp-like values, a few outliers and N/A.
+  std::vector<grnxx::Int> values(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    switch (rng() % 64) {
+      case 0: {
+        values[i] = grnxx::Int::na();
+        break;
+      }
+      case 1: {
+        values[i] = grnxx::Int(static_cast<int64_t>(rng() >> 1));
+        break;
+      }
+      case 2: {
+        values[i] = grnxx::Int(-static_cast<int64_t>(rng() >> 1));
+        break;
+      }
+      default: {
+        values[i] = grnxx::Int(1400000000000 + (i * 1000) + (rng() % 1000));
+        break;
+      }
+    }
+    column->set(grnxx::Int(i), values[i]);
+  }
+  // Overwrite some values.
+  for (size_t i = 0; i < NUM_ROWS; i += 7) {
+    values[i] = (i % 2) ? grnxx::Int::na() : grnxx::Int(i);
+    column->set(grnxx::Int(i), values[i]);
+  }
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Datum datum;
+    column->get(grnxx::Int(i), &datum);
+    assert(datum.type() == GRNXX_INT);
+    assert(datum.as_int().match(values[i]));
+  }
+  for (size_t i = 0; i < NUM_ROWS; i += 97) {
+    if (!values[i].is_na()) {
+      assert(column->contains(values[i]));
+      assert(values[column->find_one(values[i]).raw()].match(values[i]));
+    }
+  }
+  assert(column->contains(grnxx::Int::na()));
+  assert(!column->contains(grnxx::Int(-1)));
+
+  // Read values through an expression.
+  auto builder = grnxx::ExpressionBuilder::create(table);
+  builder->push_column("Int");
+  auto expression = builder->release();
+  grnxx::Array<grnxx::Record> records;
+  table->create_cursor()->read_all(&records);
+  // Some records are read one by one.
+  records.erase(3);
+  grnxx::Array<grnxx::Int> results;
+  expression->evaluate(records, &results);
+  assert(results.size() == records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    assert(results[i].match(values[records[i].row_id.raw()]));
+  }
+}
+
+void test_bool_bitmaps() {
+  constexpr size_t NUM_ROWS = 5000;
+
+  // Create a table and insert rows.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    table->insert_row();
+  }
+  auto column = table->create_column("Bool", GRNXX_BOOL);
+
+  // All the values are N/A.
+  assert(!column->contains(grnxx::Bool(true)));
+  assert(!column->contains(grnxx::Bool(false)));
+  assert(column->contains(grnxx::Bool::na()));
+
+  std::vector<grnxx::Bool> values(NUM_ROWS, grnxx::Bool::na());
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    switch (rng() % 3) {
+      case 0: {
+        values[i] = grnxx::Bool(false);
+        break;
+      }
+      case 1: {
+        values[i] = grnxx::Bool(true);
+        break;
+      }
+      default: {
+        values[i] = grnxx::Bool::na();
+        break;
+      }
+    }
+    column->set(grnxx::Int(i), values[i]);
+  }
+  // Overwrite and unset some values.
+  for (size_t i = 0; i < NUM_ROWS; i += 5) {
+    values[i] = values[i].is_na() ? grnxx::Bool(true) : grnxx::Bool::na();
+    column->set(grnxx::Int(i), values[i]);
+  }
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Datum datum;
+    column->get(grnxx::Int(i), &datum);
+    assert(datum.type() == GRNXX_BOOL);
+    assert(datum.as_bool().match(values[i]));
+  }
+  grnxx::Bool targets[] = {
+    grnxx::Bool(true), grnxx::Bool(false), grnxx::Bool::na()
+  };
+  for (grnxx::Bool target : targets) {
+    size_t row_id = 0;
+    while (!values[row_id].match(target)) {
+      ++row_id;
+    }
+    assert(column->find_one(target).match(grnxx::Int(row_id)));
+  }
+
+  // Filter records through an expression.
+  auto builder = grnxx::ExpressionBuilder::create(table);
+  builder->push_column("Bool");
+  auto expression = builder->release();
+  grnxx::Array<grnxx::Record> records;
+  table->create_cursor()->read_all(&records);
+  // Row IDs are not consecutive around the removed records.
+  records.erase(100);
+  records.erase(1000);
+  grnxx::Array<grnxx::Record> input_records;
+  input_records.resize(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    input_records[i] = records[i];
+  }
+  expression->filter(&records);
+  size_t count = 0;
+  for (size_t i = 0; i < input_records.size(); ++i) {
+    if (values[input_records[i].row_id.raw()].is_true()) {
+      assert(records[count].row_id.match(input_records[i].row_id));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+}
+
+void test_delta_encoding() {
+  constexpr size_t NUM_ROWS = 1000;
+  constexpr size_t NUM_TAGS = 150000;
+
+  // Create tables and insert rows.
+  auto db = grnxx::open_db("");
+  auto tag_table = db->create_table("Tag");
+  auto tag_column = tag_table->create_column("Value", GRNXX_INT);
+  for (size_t i = 0; i < NUM_TAGS; ++i) {
+    grnxx::Int row_id = tag_table->insert_row();
+    tag_column->set(row_id, grnxx::Int(i * 10));
+  }
+  auto table = db->create_table("Table");
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    table->insert_row();
+  }
+
+  grnxx::ColumnOptions options;
+  options.delta_encoding = true;
+  options.reference_table_name = "Tag";
+  auto column = table->create_column("Tags", GRNXX_INT_VECTOR, options);
+
+  // Sorted tag IDs, empty vectors, N/A and a few long vectors.
+  std::vector<std::vector<grnxx::Int>> values(NUM_ROWS);
+  std::vector<bool> is_na(NUM_ROWS, false);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    size_t size;
+    switch (rng() % 16) {
+      case 0: {
+        is_na[i] = true;
+        column->set(grnxx::Int(i), grnxx::IntVector::na());
+        continue;
+      }
+      case 1: {
+        size = 0;
+        break;
+      }
+      case 2: {
+        size = 70000 + (rng() % 1000);
+        break;
+      }
+      default: {
+        size = rng() % 32;
+        break;
+      }
+    }
+    int64_t tag_id = rng() % 100;
+    for (size_t j = 0; j < size; ++j) {
+      values[i].push_back(grnxx::Int(tag_id));
+      tag_id += (size < 100) ? (rng() % 100) : (1 + (rng() % 2));
+    }
+    // Unsorted vectors are also supported.
+    if ((size > 2) && ((i % 10) == 0)) {
+      std::swap(values[i][0], values[i][size - 1]);
+    }
+    column->set(grnxx::Int(i),
+                grnxx::IntVector(values[i].data(), values[i].size()));
+  }
+  // Overwrite and unset some values.
+  for (size_t i = 0; i < NUM_ROWS; i += 7) {
+    if ((i % 2) == 0) {
+      is_na[i] = true;
+      values[i].clear();
+      column->set(grnxx::Int(i), grnxx::IntVector::na());
+    } else {
+      is_na[i] = false;
+      values[i].assign(3, grnxx::Int(NUM_TAGS - 1 - i));
+      column->set(grnxx::Int(i),
+                  grnxx::IntVector(values[i].data(), values[i].size()));
+    }
+  }
+  column->compact();
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Datum datum;
+    column->get(grnxx::Int(i), &datum);
+    assert(datum.type() == GRNXX_INT_VECTOR);
+    grnxx::IntVector value = datum.as_int_vector();
+    if (is_na[i]) {
+      assert(value.is_na());
+    } else {
+      assert(value.match(
+          grnxx::IntVector(values[i].data(), values[i].size())));
+    }
+  }
+  for (size_t i = 1; i < NUM_ROWS; i += 97) {
+    if (!is_na[i]) {
+      grnxx::IntVector value(values[i].data(), values[i].size());
+      assert(column->contains(value));
+      grnxx::Int row_id = column->find_one(value);
+      assert(!is_na[row_id.raw()]);
+      assert(value.match(grnxx::IntVector(values[row_id.raw()].data(),
+                                           values[row_id.raw()].size())));
+    }
+  }
+  assert(column->contains(grnxx::IntVector::na()));
+
+  // A datum owns its decoded value, so that other values of the same or
+  // another delta-encoded column do not overwrite it.
+  auto column2 = table->create_column("Tags2", GRNXX_INT_VECTOR, options);
+  grnxx::Int values2[] = { grnxx::Int(1), grnxx::Int(2), grnxx::Int(3) };
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    column2->set(grnxx::Int(i), grnxx::IntVector(values2, 3));
+  }
+  for (size_t i = 0; i < (NUM_ROWS - 1); ++i) {
+    grnxx::Datum datum;
+    grnxx::Datum next_datum;
+    grnxx::Datum datum2;
+    column->get(grnxx::Int(i), &datum);
+    column->get(grnxx::Int(i + 1), &next_datum);
+    column2->get(grnxx::Int(i), &datum2);
+    grnxx::Datum copy = datum;
+    datum = grnxx::Datum();
+    assert(datum2.as_int_vector().match(grnxx::IntVector(values2, 3)));
+    if (!is_na[i]) {
+      assert(copy.as_int_vector().match(
+          grnxx::IntVector(values[i].data(), values[i].size())));
+    }
+    if (!is_na[i + 1]) {
+      assert(next_datum.as_int_vector().match(
+          grnxx::IntVector(values[i + 1].data(), values[i + 1].size())));
+    }
+  }
+  table->remove_column("Tags2");
+
+  // Read elements through an expression (Tags[Int]).
+  auto builder = grnxx::ExpressionBuilder::create(table);
+  builder->push_column("Tags");
+  builder->push_constant(grnxx::Int(2));
+  builder->push_operator(GRNXX_SUBSCRIPT);
+  auto expression = builder->release();
+  grnxx::Array<grnxx::Record> records;
+  table->create_cursor()->read_all(&records);
+  grnxx::Array<grnxx::Int> elements;
+  expression->evaluate(records, &elements);
+  assert(elements.size() == NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    if (values[i].size() > 2) {
+      assert(elements[i].match(values[i][2]));
+    } else {
+      assert(elements[i].is_na());
+    }
+  }
+
+  // Read values through an expression (Tags.Value).
+  builder->push_column("Tags");
+  builder->begin_subexpression();
+  builder->push_column("Value");
+  builder->end_subexpression();
+  expression = builder->release();
+  grnxx::Array<grnxx::IntVector> results;
+  expression->evaluate(records, &results);
+  assert(results.size() == NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    if (is_na[i]) {
+      assert(results[i].is_na());
+    } else {
+      assert(results[i].raw_size() == values[i].size());
+      for (size_t j = 0; j < values[i].size(); ++j) {
+        assert(results[i][j].match(values[i][j] * grnxx::Int(10)));
+      }
+    }
+  }
+
+  // Unsupported data types.
+  try {
+    table->create_column("Int", GRNXX_INT, options);
+    assert(false);
+  } catch (const char *) {
+  }
+}
+
+void test_chunked_values() {
+  // Values are stored in chunks of 65536 values.
+  constexpr size_t NUM_ROWS = (65536 * 3) + 100;
+
+  // Create a table and insert rows.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto float_column = table->create_column("Float", GRNXX_FLOAT);
+  auto geo_point_column = table->create_column("GeoPoint", GRNXX_GEO_POINT);
+  std::vector<grnxx::Float> float_values(NUM_ROWS);
+  std::vector<grnxx::GeoPoint> geo_point_values(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    // Values are N/A at the head of each chunk.
+    if ((i % 65536) < 10) {
+      float_values[i] = grnxx::Float::na();
+      geo_point_values[i] = grnxx::GeoPoint::na();
+    } else {
+      float_values[i] = grnxx::Float(i / 2.0);
+      geo_point_values[i] = grnxx::GeoPoint(grnxx::Int(i / 8), grnxx::Int(i));
+    }
+    float_column->set(row_id, float_values[i]);
+    geo_point_column->set(row_id, geo_point_values[i]);
+  }
+  for (size_t i = 0; i < NUM_ROWS; i += 97) {
+    grnxx::Datum datum;
+    float_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_float().match(float_values[i]));
+    geo_point_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_geo_point().match(geo_point_values[i]));
+  }
+
+  // Headers of Text and vector columns are also chunked, and compaction
+  // moves bodies referred to from all the chunks.
+  auto text_column = table->create_column("Text", GRNXX_TEXT);
+  auto int_vector_column =
+      table->create_column("IntVector", GRNXX_INT_VECTOR);
+  std::vector<std::string> texts(NUM_ROWS);
+  std::vector<std::vector<grnxx::Int>> int_vectors(NUM_ROWS);
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = pass; i < NUM_ROWS; i += (pass + 1)) {
+      texts[i] = std::to_string(i * (pass + 1));
+      int_vectors[i].assign(i % 4, grnxx::Int(i * (pass + 1)));
+      text_column->set(grnxx::Int(i),
+                       grnxx::Text(texts[i].data(), texts[i].size()));
+      int_vector_column->set(
+          grnxx::Int(i),
+          grnxx::IntVector(int_vectors[i].data(), int_vectors[i].size()));
+    }
+  }
+  text_column->compact();
+  int_vector_column->compact();
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Datum datum;
+    text_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_text().match(
+        grnxx::Text(texts[i].data(), texts[i].size())));
+    int_vector_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_int_vector().match(
+        grnxx::IntVector(int_vectors[i].data(), int_vectors[i].size())));
+  }
+
+  // Find values in the last chunk.
+  size_t row_id = (65536 * 3) + 50;
+  assert(float_column->find_one(float_values[row_id]).match(
+      grnxx::Int(row_id)));
+  assert(geo_point_column->find_one(geo_point_values[row_id]).match(
+      grnxx::Int(row_id)));
+  assert(!float_column->contains(grnxx::Float(NUM_ROWS)));
+
+  // Find N/A in chunks after removing rows.
+  for (size_t i = 0; i < (65536 + 10); ++i) {
+    if ((i % 65536) < 10) {
+      table->remove_row(grnxx::Int(i));
+    }
+  }
+  assert(float_column->find_one(grnxx::Float::na()).match(
+      grnxx::Int((65536 * 2))));
+  assert(geo_point_column->find_one(grnxx::GeoPoint::na()).match(
+      grnxx::Int((65536 * 2))));
+}
+
+void test_compaction_options() {
+  constexpr size_t NUM_ROWS = 64;
+
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    table->insert_row();
+  }
+
+  // A negative ratio is rejected.
+  grnxx::ColumnOptions options;
+  options.compaction_garbage_ratio = -1.0;
+  bool is_thrown = false;
+  try {
+    table->create_column("Invalid", GRNXX_TEXT, options);
+  } catch (...) {
+    is_thrown = true;
+  }
+  assert(is_thrown);
+
+  // Compact on every update.
+  options.compaction_min_garbage_size = 0;
+  options.compaction_garbage_ratio = 0.0;
+  auto text_column = table->create_column("Text", GRNXX_TEXT, options);
+  auto float_vector_column =
+      table->create_column("FloatVector", GRNXX_FLOAT_VECTOR, options);
+  auto text_vector_column =
+      table->create_column("TextVector", GRNXX_TEXT_VECTOR, options);
+
+  std::vector<std::string> texts(NUM_ROWS);
+  std::vector<std::vector<grnxx::Float>> float_vectors(NUM_ROWS);
+  std::vector<std::vector<grnxx::Text>> text_vectors(NUM_ROWS);
+  for (size_t round = 0; round < 16; ++round) {
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+      texts[i].assign(rng() % 64, 'A' + (rng() % 26));
+      grnxx::Text text(texts[i].data(), texts[i].size());
+      text_column->set(grnxx::Int(i), text);
+      float_vectors[i].resize(rng() % 16);
+      for (size_t j = 0; j < float_vectors[i].size(); ++j) {
+        float_vectors[i][j] = grnxx::Float(rng() % 1000);
+      }
+      float_vector_column->set(
+          grnxx::Int(i),
+          grnxx::Vector<grnxx::Float>(float_vectors[i].data(),
+                                      float_vectors[i].size()));
+      text_vectors[i].assign(rng() % 4, text);
+      text_vector_column->set(
+          grnxx::Int(i),
+          grnxx::Vector<grnxx::Text>(text_vectors[i].data(),
+                                     text_vectors[i].size()));
+    }
+  }
+
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Datum datum;
+    text_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_text().match(grnxx::Text(texts[i].data(),
+                                             texts[i].size())));
+    float_vector_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_float_vector().match(
+        grnxx::Vector<grnxx::Float>(float_vectors[i].data(),
+                                    float_vectors[i].size())));
+    text_vector_column->get(grnxx::Int(i), &datum);
+    assert(datum.as_text_vector().match(
+        grnxx::Vector<grnxx::Text>(text_vectors[i].data(),
+                                   text_vectors[i].size())));
+  }
+}
+
 int main() {
   test_basic_operations();
 
@@ -549,5 +1240,13 @@ int main() {
   test_contains();
   test_find_one();
 
+  test_dictionary_encoding();
+  test_compaction();
+  test_compaction_options();
+  test_frame_of_reference_encoding();
+  test_bool_bitmaps();
+  test_delta_encoding();
+  test_chunked_values();
+
   return 0;
 }
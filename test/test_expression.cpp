@@ -15,7 +15,9 @@
   License along with this library; if not, write to the Free Software
   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <random>
@@ -2429,6 +2431,20 @@ void test_ends_with() {
   assert(records.size() == count);
 }
 
+// Return whether "vector" contains "value" or not.
+template <typename T>
+grnxx::Bool contains_element(const grnxx::Vector<T> &vector, const T &value) {
+  if (vector.is_na() || value.is_na()) {
+    return grnxx::Bool::na();
+  }
+  for (size_t i = 0; i < vector.raw_size(); ++i) {
+    if (vector[grnxx::Int(i)].match(value)) {
+      return grnxx::Bool(true);
+    }
+  }
+  return grnxx::Bool(false);
+}
+
 void test_contains() {
   // Create an object for building expressions.
   auto builder = grnxx::ExpressionBuilder::create(test.table);
@@ -2459,6 +2475,455 @@ void test_contains() {
     }
   }
   assert(records.size() == count);
+
+  // Test an expression (IntVector @ Int).
+  builder->push_column("IntVector");
+  builder->push_column("Int");
+  builder->push_operator(GRNXX_CONTAINS);
+  expression = builder->release();
+
+  records = create_input_records();
+
+  expression->evaluate(records, &results);
+  assert(results.size() == test.table->num_rows());
+  for (size_t i = 0; i < results.size(); ++i) {
+    size_t row_id = records[i].row_id.raw();
+    assert(results[i].match(contains_element(test.int_vector_values[row_id],
+                                             test.int_values[row_id])));
+  }
+
+  expression->filter(&records);
+  count = 0;
+  for (size_t i = 0; i < test.int_vector_values.size(); ++i) {
+    if (contains_element(test.int_vector_values[i],
+                         test.int_values[i]).is_true()) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+
+  // Test an expression (TextVector @ Text).
+  builder->push_column("TextVector");
+  builder->push_column("Text");
+  builder->push_operator(GRNXX_CONTAINS);
+  expression = builder->release();
+
+  records = create_input_records();
+
+  expression->evaluate(records, &results);
+  assert(results.size() == test.table->num_rows());
+  for (size_t i = 0; i < results.size(); ++i) {
+    size_t row_id = records[i].row_id.raw();
+    assert(results[i].match(contains_element(test.text_vector_values[row_id],
+                                             test.text_values[row_id])));
+  }
+
+  expression->filter(&records);
+  count = 0;
+  for (size_t i = 0; i < test.text_vector_values.size(); ++i) {
+    if (contains_element(test.text_vector_values[i],
+                         test.text_values[i]).is_true()) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+
+  // Test an expression (IntVector @ 50) with and without an index.
+  auto int_vector_column = test.table->find_column("IntVector");
+  for (int i = 0; i < 2; ++i) {
+    builder->push_column("IntVector");
+    builder->push_constant(grnxx::Int(50));
+    builder->push_operator(GRNXX_CONTAINS);
+    expression = builder->release();
+    if (i == 1) {
+      int_vector_column->create_index("Index", GRNXX_HASH_INDEX);
+    }
+
+    records = create_input_records();
+    // Row IDs are not in ascending order.
+    std::reverse(records.buffer(), records.buffer() + (records.size() / 2));
+
+    grnxx::Array<grnxx::Record> expected_records;
+    for (size_t j = 0; j < records.size(); ++j) {
+      size_t row_id = records[j].row_id.raw();
+      if (contains_element(test.int_vector_values[row_id],
+                           grnxx::Int(50)).is_true()) {
+        expected_records.push_back(records[j]);
+      }
+    }
+    expression->filter(&records);
+    assert(records.size() == expected_records.size());
+    for (size_t j = 0; j < records.size(); ++j) {
+      assert(records[j].row_id.match(expected_records[j].row_id));
+    }
+  }
+  int_vector_column->remove_index("Index");
+
+  // Test expressions (Text @ Text, Text @^ Text and Text @$ Text) with and
+  // without a full-text index.
+  auto text_column = test.table->find_column("Text");
+  grnxx::OperatorType operator_types[] = {
+    GRNXX_CONTAINS, GRNXX_STARTS_WITH, GRNXX_ENDS_WITH
+  };
+  const char *queries[] = { "1", "23" };
+  for (int i = 0; i < 2; ++i) {
+    if (i == 1) {
+      text_column->create_index("Index", GRNXX_FULL_TEXT_INDEX);
+    }
+    for (auto operator_type : operator_types) {
+      for (auto query : queries) {
+        grnxx::Text value(query);
+        builder->push_column("Text");
+        builder->push_constant(value);
+        builder->push_operator(operator_type);
+        expression = builder->release();
+
+        records = create_input_records();
+        grnxx::Array<grnxx::Record> expected_records;
+        for (size_t j = 0; j < records.size(); ++j) {
+          const grnxx::Text &text =
+              test.text_values[records[j].row_id.raw()];
+          grnxx::Bool result;
+          if (operator_type == GRNXX_CONTAINS) {
+            result = text.contains(value);
+          } else if (operator_type == GRNXX_STARTS_WITH) {
+            result = text.starts_with(value);
+          } else {
+            result = text.ends_with(value);
+          }
+          if (result.is_true()) {
+            expected_records.push_back(records[j]);
+          }
+        }
+        expression->filter(&records);
+        assert(records.size() == expected_records.size());
+        for (size_t j = 0; j < records.size(); ++j) {
+          assert(records[j].row_id.match(expected_records[j].row_id));
+        }
+      }
+    }
+  }
+  text_column->remove_index("Index");
+}
+
+void test_indexed_filter() {
+  // Create a table with an indexed IntVector column.
+  constexpr size_t NUM_INDEXED_ROWS = 4096;
+  auto table = test.db->create_table("Indexed");
+  auto column = table->create_column("IntVector", GRNXX_INT_VECTOR);
+  column->create_index("Index", GRNXX_HASH_INDEX);
+  grnxx::Int values[] = { grnxx::Int(1), grnxx::Int(2) };
+  for (size_t i = 0; i < NUM_INDEXED_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    column->set(row_id, grnxx::IntVector(&values[i % 2], 1));
+  }
+
+  // Test an expression (IntVector @ 1), which is filtered block by block
+  // and must see updates between blocks.
+  auto builder = grnxx::ExpressionBuilder::create(table);
+  builder->push_column("IntVector");
+  builder->push_constant(grnxx::Int(1));
+  builder->push_operator(GRNXX_CONTAINS);
+  auto expression = builder->release();
+
+  grnxx::Array<grnxx::Record> records;
+  auto cursor = table->create_cursor();
+  cursor->read_all(&records);
+  constexpr size_t BLOCK_SIZE = 256;
+  for (size_t offset = 0; offset < records.size(); offset += BLOCK_SIZE) {
+    if (offset == (NUM_INDEXED_ROWS / 2)) {
+      // Swap the values of the remaining rows.
+      for (size_t i = offset; i < NUM_INDEXED_ROWS; ++i) {
+        column->set(grnxx::Int(i), grnxx::IntVector(&values[(i + 1) % 2], 1));
+      }
+    }
+    grnxx::ArrayRef<grnxx::Record> output = records.ref(offset, BLOCK_SIZE);
+    expression->filter(records.cref(offset, BLOCK_SIZE), &output);
+    assert(output.size() == (BLOCK_SIZE / 2));
+    for (size_t i = 0; i < output.size(); ++i) {
+      size_t row_id = output[i].row_id.raw();
+      if (offset < (NUM_INDEXED_ROWS / 2)) {
+        assert((row_id % 2) == 0);
+      } else {
+        assert((row_id % 2) == 1);
+      }
+    }
+  }
+  test.db->remove_table("Indexed");
+}
+
+void test_text_pattern() {
+  // Create a table with a Text column and a dictionary-encoded Text column.
+  // Values are long enough to be searched in blocks.
+  constexpr size_t NUM_PATTERN_ROWS = 4096;
+  auto table = test.db->create_table("Pattern");
+  auto text_column = table->create_column("Text", GRNXX_TEXT);
+  grnxx::ColumnOptions options;
+  options.dictionary_encoding = true;
+  auto dict_text_column =
+      table->create_column("DictText", GRNXX_TEXT, options);
+  grnxx::Array<std::string> bodies;
+  grnxx::Array<grnxx::Text> values;
+  bodies.resize(NUM_PATTERN_ROWS);
+  values.resize(NUM_PATTERN_ROWS);
+  for (size_t i = 0; i < NUM_PATTERN_ROWS; ++i) {
+    size_t size = mersenne_twister() % 48;
+    for (size_t j = 0; j < size; ++j) {
+      bodies[i].push_back("ab"[(mersenne_twister() % 8) == 0]);
+    }
+    if ((mersenne_twister() % 64) != 0) {
+      values[i] = grnxx::Text(bodies[i].data(), bodies[i].size());
+    } else {
+      values[i] = grnxx::Text::na();
+    }
+    grnxx::Int row_id = table->insert_row();
+    text_column->set(row_id, values[i]);
+    // Dictionary-encoded values are drawn from a few distinct values.
+    dict_text_column->set(row_id, values[i % 64]);
+  }
+
+  // Test expressions (Text @ constant, Text @^ constant and
+  // Text @$ constant) against Text::contains(), starts_with() and
+  // ends_with().
+  auto builder = grnxx::ExpressionBuilder::create(table);
+  grnxx::OperatorType operator_types[] = {
+    GRNXX_CONTAINS, GRNXX_STARTS_WITH, GRNXX_ENDS_WITH
+  };
+  const char *column_names[] = { "Text", "DictText" };
+  const char *queries[] = {
+    "", "a", "b", "ab", "ba", "aaaaaaab", "abaaaaaaaa", "bab", "aaaaaaaaaaaa"
+  };
+  for (auto column_name : column_names) {
+    for (auto operator_type : operator_types) {
+      for (auto query : queries) {
+        grnxx::Text value(query);
+        builder->push_column(column_name);
+        builder->push_constant(value);
+        builder->push_operator(operator_type);
+        auto expression = builder->release();
+
+        grnxx::Array<grnxx::Record> records;
+        auto cursor = table->create_cursor();
+        cursor->read_all(&records);
+        grnxx::Array<grnxx::Bool> expected_results;
+        expected_results.resize(records.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+          size_t row_id = records[i].row_id.raw();
+          const grnxx::Text &text =
+              (column_name[0] == 'T') ? values[row_id] : values[row_id % 64];
+          if (operator_type == GRNXX_CONTAINS) {
+            expected_results[i] = text.contains(value);
+          } else if (operator_type == GRNXX_STARTS_WITH) {
+            expected_results[i] = text.starts_with(value);
+          } else {
+            expected_results[i] = text.ends_with(value);
+          }
+        }
+
+        grnxx::Array<grnxx::Bool> results;
+        expression->evaluate(records, &results);
+        assert(results.size() == records.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+          assert(results[i].match(expected_results[i]));
+        }
+
+        expression->filter(&records);
+        size_t count = 0;
+        for (size_t i = 0; i < expected_results.size(); ++i) {
+          if (expected_results[i].is_true()) {
+            assert(records[count].row_id.match(grnxx::Int(i)));
+            ++count;
+          }
+        }
+        assert(records.size() == count);
+      }
+    }
+  }
+  test.db->remove_table("Pattern");
+}
+
+void test_geo() {
+  // Create a table with a GeoPoint column and an indexed GeoPoint column.
+  // Values are spread over a sphere.
+  constexpr size_t NUM_GEO_ROWS = 4096;
+  constexpr int64_t DEGREE = 60 * 60 * 1000;
+  auto table = test.db->create_table("Geo");
+  auto point_column = table->create_column("Point", GRNXX_GEO_POINT);
+  auto indexed_point_column =
+      table->create_column("IndexedPoint", GRNXX_GEO_POINT);
+  indexed_point_column->create_index("Index", GRNXX_TREE_INDEX);
+  grnxx::Array<grnxx::GeoPoint> values;
+  values.resize(NUM_GEO_ROWS);
+  for (size_t i = 0; i < NUM_GEO_ROWS; ++i) {
+    if ((mersenne_twister() % 64) != 0) {
+      int64_t latitude =
+          int64_t(mersenne_twister() % (180 * DEGREE)) - (90 * DEGREE);
+      int64_t longitude =
+          int64_t(mersenne_twister() % (360 * DEGREE)) - (180 * DEGREE);
+      values[i] = grnxx::GeoPoint(grnxx::Int(latitude), grnxx::Int(longitude));
+    } else {
+      values[i] = grnxx::GeoPoint::na();
+    }
+    grnxx::Int row_id = table->insert_row();
+    point_column->set(row_id, values[i]);
+    indexed_point_column->set(row_id, values[i]);
+  }
+
+  // Test an expression (Point <-> constant).
+  auto builder = grnxx::ExpressionBuilder::create(table);
+  grnxx::GeoPoint center =
+      grnxx::GeoPoint(grnxx::Float(35.0), grnxx::Float(139.0));
+  builder->push_column("Point");
+  builder->push_constant(center);
+  builder->push_operator(GRNXX_GEO_DISTANCE);
+  auto expression = builder->release();
+
+  grnxx::Array<grnxx::Record> records;
+  auto cursor = table->create_cursor();
+  cursor->read_all(&records);
+  grnxx::Array<grnxx::Float> distances;
+  expression->evaluate(records, &distances);
+  assert(distances.size() == records.size());
+  for (size_t i = 0; i < distances.size(); ++i) {
+    size_t row_id = records[i].row_id.raw();
+    assert(distances[i].match(values[row_id].distance(center)));
+  }
+  assert(center.distance(center).raw() == 0.0);
+  // The distance between the poles is a half of the circumference.
+  grnxx::GeoPoint north_pole =
+      grnxx::GeoPoint(grnxx::Float(90.0), grnxx::Float(0.0));
+  grnxx::GeoPoint south_pole =
+      grnxx::GeoPoint(grnxx::Float(-90.0), grnxx::Float(0.0));
+  double half = 3.14159265358979323846 * grnxx::GeoPoint::earth_radius();
+  assert(std::fabs(north_pole.distance(south_pole).raw() - half) < 1.0);
+  assert(center.distance(grnxx::GeoPoint::na()).is_na());
+
+  // Test expressions (within_rectangle(Point, constant, constant) and
+  // within_circle(Point, constant, constant)) with and without an index.
+  grnxx::GeoPoint corners[] = {
+    grnxx::GeoPoint(grnxx::Float(20.0), grnxx::Float(120.0)),
+    grnxx::GeoPoint(grnxx::Float(-30.0), grnxx::Float(-60.0)),
+    grnxx::GeoPoint::na()
+  };
+  grnxx::Float radiuses[] = {
+    grnxx::Float(500000.0), grnxx::Float(3000000.0), grnxx::Float::na()
+  };
+  const char *column_names[] = { "Point", "IndexedPoint" };
+  for (auto column_name : column_names) {
+    for (size_t i = 0; i < 3; ++i) {
+      for (size_t j = 0; j < 2; ++j) {
+        builder->push_column(column_name);
+        builder->push_constant(center);
+        if (j == 0) {
+          builder->push_constant(corners[i]);
+          builder->push_operator(GRNXX_GEO_WITHIN_RECTANGLE);
+        } else {
+          builder->push_constant(radiuses[i]);
+          builder->push_operator(GRNXX_GEO_WITHIN_CIRCLE);
+        }
+        expression = builder->release();
+
+        records.clear();
+        cursor = table->create_cursor();
+        cursor->read_all(&records);
+        grnxx::Array<grnxx::Bool> expected_results;
+        expected_results.resize(records.size());
+        for (size_t k = 0; k < records.size(); ++k) {
+          const grnxx::GeoPoint &value = values[records[k].row_id.raw()];
+          if (value.is_na() || ((j == 0) && corners[i].is_na()) ||
+              ((j != 0) && radiuses[i].is_na())) {
+            expected_results[k] = grnxx::Bool::na();
+          } else if (j == 0) {
+            expected_results[k] = grnxx::Bool(
+                (value.raw_latitude() >=
+                 std::min(center.raw_latitude(), corners[i].raw_latitude())) &&
+                (value.raw_latitude() <=
+                 std::max(center.raw_latitude(), corners[i].raw_latitude())) &&
+                (value.raw_longitude() >=
+                 std::min(center.raw_longitude(),
+                          corners[i].raw_longitude())) &&
+                (value.raw_longitude() <=
+                 std::max(center.raw_longitude(),
+                          corners[i].raw_longitude())));
+          } else {
+            expected_results[k] =
+                grnxx::Bool(value.distance(center).raw() <= radiuses[i].raw());
+          }
+        }
+
+        grnxx::Array<grnxx::Bool> results;
+        expression->evaluate(records, &results);
+        assert(results.size() == records.size());
+        for (size_t k = 0; k < results.size(); ++k) {
+          assert(results[k].match(expected_results[k]));
+        }
+
+        expression->filter(&records);
+        size_t count = 0;
+        for (size_t k = 0; k < expected_results.size(); ++k) {
+          if (expected_results[k].is_true()) {
+            assert(records[count].row_id.match(grnxx::Int(k)));
+            ++count;
+          }
+        }
+        assert(records.size() == count);
+      }
+    }
+  }
+
+  // Test expressions (within_circle(Point, constant, constant)) filtered
+  // block by block, where values are updated between blocks.
+  std::unique_ptr<grnxx::Expression> expressions[2];
+  for (size_t i = 0; i < 2; ++i) {
+    builder->push_column(column_names[i]);
+    builder->push_constant(center);
+    builder->push_constant(radiuses[1]);
+    builder->push_operator(GRNXX_GEO_WITHIN_CIRCLE);
+    expressions[i] = builder->release();
+  }
+  records.clear();
+  cursor = table->create_cursor();
+  cursor->read_all(&records);
+  constexpr size_t BLOCK_SIZE = 256;
+  for (size_t offset = 0; offset < records.size(); offset += BLOCK_SIZE) {
+    if (offset == (NUM_GEO_ROWS / 2)) {
+      // Move the remaining points to the center.
+      for (size_t i = offset; i < NUM_GEO_ROWS; i += 2) {
+        point_column->set(grnxx::Int(i), center);
+        indexed_point_column->set(grnxx::Int(i), center);
+      }
+    }
+    grnxx::Array<grnxx::Record> outputs[2];
+    for (size_t i = 0; i < 2; ++i) {
+      outputs[i].resize(BLOCK_SIZE);
+      grnxx::ArrayRef<grnxx::Record> output = outputs[i].ref();
+      expressions[i]->filter(records.cref(offset, BLOCK_SIZE), &output);
+      outputs[i].resize(output.size());
+    }
+    assert(outputs[0].size() == outputs[1].size());
+    for (size_t i = 0; i < outputs[0].size(); ++i) {
+      assert(outputs[0][i].row_id.match(outputs[1][i].row_id));
+    }
+    if (offset >= (NUM_GEO_ROWS / 2)) {
+      assert(outputs[1].size() >= (BLOCK_SIZE / 2));
+    }
+  }
+
+  // Test invalid data types.
+  builder->push_column("Point");
+  builder->push_constant(center);
+  builder->push_constant(grnxx::Int(100));
+  bool is_thrown = false;
+  try {
+    builder->push_operator(GRNXX_GEO_WITHIN_CIRCLE);
+  } catch (...) {
+    is_thrown = true;
+  }
+  assert(is_thrown);
+  builder->clear();
+  test.db->remove_table("Geo");
 }
 
 void test_subscript() {
@@ -2748,6 +3213,163 @@ void test_subexpression() {
   }
 }
 
+void test_dereference_with_scores() {
+  // Create an object for building expressions.
+  auto builder = grnxx::ExpressionBuilder::create(test.table);
+
+  // Test an expression (Ref.(_score + Ref.Float)).
+  builder->push_column("Ref");
+  builder->begin_subexpression();
+  builder->push_score();
+  builder->push_column("Ref");
+  builder->begin_subexpression();
+  builder->push_column("Float");
+  builder->end_subexpression();
+  builder->push_operator(GRNXX_PLUS);
+  builder->end_subexpression();
+  auto expression = builder->release();
+
+  // Records referring to the same row have different scores.
+  auto records = create_input_records();
+  for (size_t i = 0; i < records.size(); ++i) {
+    records[i].score = grnxx::Float(static_cast<double>(i % 7));
+  }
+
+  grnxx::Array<grnxx::Float> float_results;
+  expression->evaluate(records, &float_results);
+  assert(float_results.size() == test.table->num_rows());
+  for (size_t i = 0; i < float_results.size(); ++i) {
+    const auto ref_value = test.ref_values[i];
+    const auto ref_ref_value = test.ref_values[ref_value.raw()];
+    const auto float_value = test.float_values[ref_ref_value.raw()];
+    assert(float_results[i].match(records[i].score + float_value));
+  }
+}
+
+void test_semi_join() {
+  // Create a small parent table and a large child table.
+  auto parent_table = test.db->create_table("Parent");
+  auto parent_int_column =
+      parent_table->create_column("Int", GRNXX_INT);
+  constexpr size_t NUM_PARENT_ROWS = 100;
+  for (size_t i = 0; i < NUM_PARENT_ROWS; ++i) {
+    grnxx::Int row_id = parent_table->insert_row();
+    parent_int_column->set(row_id, grnxx::Int(i % 10));
+  }
+
+  auto child_table = test.db->create_table("Child");
+  grnxx::ColumnOptions options;
+  options.reference_table_name = "Parent";
+  auto ref_column = child_table->create_column("Ref", GRNXX_INT, options);
+  constexpr size_t NUM_CHILD_ROWS = 10000;
+  grnxx::Array<grnxx::Int> ref_values;
+  ref_values.resize(NUM_CHILD_ROWS);
+  for (size_t i = 0; i < NUM_CHILD_ROWS; ++i) {
+    grnxx::Int row_id = child_table->insert_row();
+    if ((mersenne_twister() % 16) == 0) {
+      ref_values[i] = grnxx::Int::na();
+    } else {
+      ref_values[i] = grnxx::Int(mersenne_twister() % NUM_PARENT_ROWS);
+    }
+    ref_column->set(row_id, ref_values[i]);
+  }
+
+  // Test an expression (Ref.(Int < 3)).
+  auto builder = grnxx::ExpressionBuilder::create(child_table);
+  builder->push_column("Ref");
+  builder->begin_subexpression();
+  builder->push_column("Int");
+  builder->push_constant(grnxx::Int(3));
+  builder->push_operator(GRNXX_LESS);
+  builder->end_subexpression();
+  auto expression = builder->release();
+
+  grnxx::Array<grnxx::Record> records;
+  auto cursor = child_table->create_cursor();
+  cursor->read_all(&records);
+  expression->filter(&records);
+  size_t count = 0;
+  for (size_t i = 0; i < NUM_CHILD_ROWS; ++i) {
+    if (!ref_values[i].is_na() && ((ref_values[i].raw() % 10) < 3)) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+
+  // Test an expression (Ref.(Int.is_na)) for N/A references.
+  builder->push_column("Ref");
+  builder->begin_subexpression();
+  builder->push_column("Int");
+  builder->push_constant(grnxx::Int::na());
+  builder->push_operator(GRNXX_EQUAL);
+  builder->push_operator(GRNXX_LOGICAL_NOT);
+  builder->push_operator(GRNXX_LOGICAL_NOT);
+  builder->end_subexpression();
+  expression = builder->release();
+
+  records.clear();
+  cursor = child_table->create_cursor();
+  cursor->read_all(&records);
+  grnxx::Array<grnxx::Bool> results;
+  expression->evaluate(records, &results);
+  expression->filter(&records);
+  count = 0;
+  for (size_t i = 0; i < NUM_CHILD_ROWS; ++i) {
+    if (results[i].is_true()) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+
+  // Test an expression (Ref.Int == 3) filtered block by block, where the
+  // parent table is updated between blocks.
+  builder->push_column("Ref");
+  builder->begin_subexpression();
+  builder->push_column("Int");
+  builder->end_subexpression();
+  builder->push_constant(grnxx::Int(3));
+  builder->push_operator(GRNXX_EQUAL);
+  expression = builder->release();
+
+  records.clear();
+  cursor = child_table->create_cursor();
+  cursor->read_all(&records);
+  constexpr size_t BLOCK_SIZE = 64;
+  constexpr size_t UPDATE_OFFSET = BLOCK_SIZE * 64;
+  count = 0;
+  for (size_t offset = 0; offset < NUM_CHILD_ROWS; offset += BLOCK_SIZE) {
+    if (offset == UPDATE_OFFSET) {
+      // Int of the parent rows becomes (row_id % 10) + 1.
+      for (size_t i = 0; i < NUM_PARENT_ROWS; ++i) {
+        parent_int_column->set(grnxx::Int(i), grnxx::Int((i % 10) + 1));
+      }
+    }
+    size_t block_size = NUM_CHILD_ROWS - offset;
+    if (block_size > BLOCK_SIZE) {
+      block_size = BLOCK_SIZE;
+    }
+    grnxx::ArrayRef<grnxx::Record> output = records.ref(count, block_size);
+    expression->filter(records.cref(offset, block_size), &output);
+    count += output.size();
+  }
+  records.resize(count);
+  count = 0;
+  for (size_t i = 0; i < NUM_CHILD_ROWS; ++i) {
+    size_t value = (i < UPDATE_OFFSET) ? 3 : 2;
+    if (!ref_values[i].is_na() && ((ref_values[i].raw() % 10) == value)) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+
+  child_table->remove_column("Ref");
+  test.db->remove_table("Child");
+  test.db->remove_table("Parent");
+}
+
 void test_parser() try {
   // Test an expression (_id % 2 == 0).
   auto expression = grnxx::Expression::parse(test.table, "_id % 2 == 0");
@@ -3021,10 +3643,15 @@ int main() {
   test_starts_with();
   test_ends_with();
   test_contains();
+  test_indexed_filter();
+  test_text_pattern();
+  test_geo();
   test_subscript();
 
   // Subexpression.
   test_subexpression();
+  test_dereference_with_scores();
+  test_semi_join();
 
   // Parser.
   test_parser();
@@ -15,9 +15,16 @@
   License along with this library; if not, write to the Free Software
   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <string>
+#include <vector>
 
 #include "grnxx/column.hpp"
 #include "grnxx/cursor.hpp"
@@ -663,6 +670,148 @@ void test_text_find_prefixes() {
   }
 }
 
+void test_geo_point_find_within() {
+  // Create a column.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto column = table->create_column("Column", GRNXX_GEO_POINT);
+
+  // Create an index before storing values.
+  auto index = column->create_index("Index", GRNXX_TREE_INDEX);
+
+  // Generate random values.
+  // GeoPoint: latitude = [-90, 90), longitude = [-180, 180) in degrees,
+  //           or N/A.
+  constexpr int64_t DEGREE = 60 * 60 * 1000;
+  grnxx::Array<grnxx::GeoPoint> values;
+  values.resize(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    if ((rng() % 64) != 0) {
+      int64_t latitude = int64_t(rng() % (180 * DEGREE)) - (90 * DEGREE);
+      int64_t longitude = int64_t(rng() % (360 * DEGREE)) - (180 * DEGREE);
+      values[i] = grnxx::GeoPoint(grnxx::Int(latitude), grnxx::Int(longitude));
+    } else {
+      values[i] = grnxx::GeoPoint::na();
+    }
+  }
+
+  // Store generated values into columns.
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    column->set(row_id, values[i]);
+  }
+
+  // Overwrite some values and remove some rows.
+  for (size_t i = 0; i < NUM_ROWS; i += 17) {
+    values[i] = values[i / 2];
+    column->set(grnxx::Int(i), values[i]);
+  }
+  for (size_t i = 0; i < NUM_ROWS; i += 31) {
+    table->remove_row(grnxx::Int(i));
+  }
+
+  // Test exact match.
+  for (size_t i = 0; i < NUM_ROWS; i += 101) {
+    auto cursor = index->find(values[i]);
+    grnxx::Array<grnxx::Record> records;
+    size_t count = cursor->read_all(&records);
+    size_t total_count = 0;
+    for (size_t j = 0; j < NUM_ROWS; ++j) {
+      if (table->test_row(grnxx::Int(j)) && values[j].match(values[i])) {
+        ++total_count;
+      }
+    }
+    if (values[i].is_na()) {
+      assert(count == 0);
+    } else {
+      assert(count == total_count);
+    }
+  }
+
+  // Test rectangles and circles, including circles which cross the
+  // antimeridian or contain a pole.
+  grnxx::GeoPoint points[] = {
+    grnxx::GeoPoint(grnxx::Float(35.0), grnxx::Float(139.0)),
+    grnxx::GeoPoint(grnxx::Float(-20.0), grnxx::Float(179.5)),
+    grnxx::GeoPoint(grnxx::Float(0.0), grnxx::Float(-180.0)),
+    grnxx::GeoPoint(grnxx::Float(88.0), grnxx::Float(10.0)),
+    grnxx::GeoPoint(grnxx::Float(-60.0), grnxx::Float(-45.0))
+  };
+  double radiuses[] = { 100000.0, 1000000.0, 5000000.0 };
+  for (size_t i = 0; i < (sizeof(points) / sizeof(points[0])); ++i) {
+    for (size_t j = 0; j < (sizeof(radiuses) / sizeof(radiuses[0])); ++j) {
+      grnxx::CursorOptions options;
+      if ((j % 2) != 0) {
+        options.order_type = GRNXX_REVERSE_ORDER;
+      }
+      grnxx::Float radius(radiuses[j]);
+      auto cursor = index->find_within_circle(points[i], radius, options);
+      grnxx::Array<grnxx::Record> records;
+      size_t count = cursor->read_all(&records);
+      for (size_t k = 1; k < records.size(); ++k) {
+        if ((j % 2) != 0) {
+          assert(records[k - 1].row_id.raw() > records[k].row_id.raw());
+        } else {
+          assert(records[k - 1].row_id.raw() < records[k].row_id.raw());
+        }
+      }
+      size_t total_count = 0;
+      for (size_t k = 0; k < NUM_ROWS; ++k) {
+        if (table->test_row(grnxx::Int(k)) && !values[k].is_na() &&
+            (values[k].distance(points[i]).raw() <= radius.raw())) {
+          ++total_count;
+        }
+      }
+      assert(count == total_count);
+      for (size_t k = 0; k < records.size(); ++k) {
+        const grnxx::GeoPoint &value = values[records[k].row_id.raw()];
+        assert(value.distance(points[i]).raw() <= radius.raw());
+      }
+
+      // The rectangle is given by the center and a point on the diagonal.
+      int64_t diff = (j + 1) * 5 * DEGREE;
+      grnxx::GeoPoint corner = grnxx::GeoPoint(
+          grnxx::Int(std::max(points[i].raw_latitude() - diff,
+                              -90 * DEGREE)),
+          grnxx::Int(std::max(points[i].raw_longitude() - diff,
+                              -180 * DEGREE)));
+      cursor = index->find_within_rectangle(points[i], corner, options);
+      records.clear();
+      count = cursor->read_all(&records);
+      for (size_t k = 1; k < records.size(); ++k) {
+        if ((j % 2) != 0) {
+          assert(records[k - 1].row_id.raw() > records[k].row_id.raw());
+        } else {
+          assert(records[k - 1].row_id.raw() < records[k].row_id.raw());
+        }
+      }
+      total_count = 0;
+      for (size_t k = 0; k < NUM_ROWS; ++k) {
+        if (table->test_row(grnxx::Int(k)) && !values[k].is_na() &&
+            (values[k].raw_latitude() >= corner.raw_latitude()) &&
+            (values[k].raw_latitude() <= points[i].raw_latitude()) &&
+            (values[k].raw_longitude() >= corner.raw_longitude()) &&
+            (values[k].raw_longitude() <= points[i].raw_longitude())) {
+          ++total_count;
+        }
+      }
+      assert(count == total_count);
+    }
+  }
+
+  // Test invalid queries.
+  grnxx::Array<grnxx::Record> records;
+  auto cursor = index->find_within_circle(grnxx::GeoPoint::na(),
+                                          grnxx::Float(1000.0));
+  assert(cursor->read_all(&records) == 0);
+  cursor = index->find_within_circle(points[0], grnxx::Float(-1.0));
+  assert(cursor->read_all(&records) == 0);
+  cursor = index->find_within_circle(points[0], grnxx::Float::na());
+  assert(cursor->read_all(&records) == 0);
+  cursor = index->find_within_rectangle(points[0], grnxx::GeoPoint::na());
+  assert(cursor->read_all(&records) == 0);
+}
+
 void test_reverse() {
   // Create a column.
   auto db = grnxx::open_db("");
@@ -828,6 +977,837 @@ void test_uniqueness() {
   assert(index->test_uniqueness());
 }
 
+void test_vector_element_match() {
+  // Create columns.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto int_vector_column = table->create_column("IntVector", GRNXX_INT_VECTOR);
+  auto text_vector_column =
+      table->create_column("TextVector", GRNXX_TEXT_VECTOR);
+
+  // Create an index before storing values.
+  auto int_vector_index =
+      int_vector_column->create_index("Index", GRNXX_HASH_INDEX);
+
+  // Generate random values.
+  // IntVector: value = [0, 100), size = [0, 4] or N/A.
+  // TextVector: value = ["0", "9"], size = [0, 4].
+  grnxx::Array<grnxx::Array<grnxx::Int>> int_bodies;
+  grnxx::Array<grnxx::IntVector> int_values;
+  grnxx::Array<grnxx::Array<grnxx::Text>> text_bodies;
+  grnxx::Array<grnxx::TextVector> text_values;
+  const char *digits = "0123456789";
+  int_bodies.resize(NUM_ROWS);
+  int_values.resize(NUM_ROWS);
+  text_bodies.resize(NUM_ROWS);
+  text_values.resize(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    size_t size = rng() % 5;
+    int_bodies[i].resize(size);
+    for (size_t j = 0; j < size; ++j) {
+      int_bodies[i][j] = grnxx::Int(rng() % 100);
+    }
+    if ((rng() % 128) != 0) {
+      int_values[i] = grnxx::IntVector(int_bodies[i].data(), size);
+    } else {
+      int_values[i] = grnxx::IntVector::na();
+    }
+    size = rng() % 5;
+    text_bodies[i].resize(size);
+    for (size_t j = 0; j < size; ++j) {
+      text_bodies[i][j] = grnxx::Text(&digits[rng() % 10], 1);
+    }
+    text_values[i] = grnxx::TextVector(text_bodies[i].data(), size);
+  }
+
+  // Store generated values into columns.
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    int_vector_column->set(row_id, int_values[i]);
+    text_vector_column->set(row_id, text_values[i]);
+  }
+
+  // Overwrite some values and remove some rows.
+  for (size_t i = 0; i < NUM_ROWS; i += 17) {
+    int_values[i] = grnxx::IntVector(int_bodies[i / 2].data(),
+                                     int_bodies[i / 2].size());
+    int_vector_column->set(grnxx::Int(i), int_values[i]);
+  }
+  for (size_t i = 0; i < NUM_ROWS; i += 31) {
+    table->remove_row(grnxx::Int(i));
+  }
+
+  // Create an index after storing values.
+  auto text_vector_index =
+      text_vector_column->create_index("Index", GRNXX_HASH_INDEX);
+
+  // Test cursors for each value.
+  for (int int_value = 0; int_value < 100; ++int_value) {
+    auto cursor = int_vector_index->find(grnxx::Int(int_value));
+
+    grnxx::Array<grnxx::Record> records;
+    size_t count = cursor->read_all(&records);
+    for (size_t i = 1; i < records.size(); ++i) {
+      assert(records[i - 1].row_id.raw() < records[i].row_id.raw());
+    }
+    size_t total_count = 0;
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+      if (!table->test_row(grnxx::Int(i)) || int_values[i].is_na()) {
+        continue;
+      }
+      for (size_t j = 0; j < int_values[i].raw_size(); ++j) {
+        if (int_values[i][j].raw() == int_value) {
+          assert(records[total_count].row_id.match(grnxx::Int(i)));
+          ++total_count;
+          break;
+        }
+      }
+    }
+    assert(count == total_count);
+  }
+  for (size_t digit = 0; digit < 10; ++digit) {
+    grnxx::Text text_value(&digits[digit], 1);
+    grnxx::CursorOptions options;
+    options.order_type = GRNXX_REVERSE_ORDER;
+    auto cursor = text_vector_index->find(text_value, options);
+
+    grnxx::Array<grnxx::Record> records;
+    size_t count = cursor->read_all(&records);
+    for (size_t i = 1; i < records.size(); ++i) {
+      assert(records[i - 1].row_id.raw() > records[i].row_id.raw());
+    }
+    size_t total_count = 0;
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+      if (!table->test_row(grnxx::Int(i))) {
+        continue;
+      }
+      for (size_t j = 0; j < text_values[i].raw_size(); ++j) {
+        if (text_values[i][j].match(text_value)) {
+          ++total_count;
+          break;
+        }
+      }
+    }
+    assert(count == total_count);
+  }
+  assert(!int_vector_index->test_uniqueness());
+  assert(!int_vector_index->contains(grnxx::Int(100)));
+  assert(int_vector_index->find_one(grnxx::Int::na()).is_na());
+}
+
+void test_posting_list_updates() {
+  // Create a column and an index.
+  constexpr size_t NUM_UPDATED_ROWS = 4096;
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto column = table->create_column("IntVector", GRNXX_INT_VECTOR);
+  auto index = column->create_index("Index", GRNXX_HASH_INDEX);
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; ++i) {
+    table->insert_row();
+  }
+
+  // Store values in random order, so that posting lists are updated in the
+  // middle and split into blocks, and then remove some of them.
+  std::vector<size_t> row_ids(NUM_UPDATED_ROWS);
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; ++i) {
+    row_ids[i] = i;
+  }
+  std::shuffle(row_ids.begin(), row_ids.end(), rng);
+  grnxx::Int values[] = { grnxx::Int(0), grnxx::Int(1) };
+  std::vector<bool> expected_rows(NUM_UPDATED_ROWS);
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; ++i) {
+    size_t row_id = row_ids[i];
+    column->set(grnxx::Int(row_id),
+                grnxx::IntVector(values, 1 + (row_id % 2)));
+    expected_rows[row_id] = true;
+  }
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; i += 3) {
+    column->set(grnxx::Int(row_ids[i]), grnxx::IntVector(&values[1], 1));
+    expected_rows[row_ids[i]] = false;
+  }
+
+  grnxx::Array<grnxx::Record> records;
+  index->find(grnxx::Int(0))->read_all(&records);
+  size_t count = 0;
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; ++i) {
+    if (expected_rows[i]) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+}
+
+void test_text_find_contains() {
+  // Create a column.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto column = table->create_column("Column", GRNXX_TEXT);
+
+  // Create an index before storing values.
+  auto index = column->create_index("Index", GRNXX_FULL_TEXT_INDEX);
+
+  // Generate random values.
+  // Text: length = [0, 8], each byte = 'a' or 'b', or N/A.
+  grnxx::Array<grnxx::String> bodies;
+  grnxx::Array<grnxx::Text> values;
+  bodies.resize(NUM_ROWS);
+  values.resize(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    size_t size = rng() % 9;
+    for (size_t j = 0; j < size; ++j) {
+      bodies[i].append("ab"[rng() % 2]);
+    }
+    if ((rng() % 64) != 0) {
+      values[i] = grnxx::Text(bodies[i].data(), bodies[i].size());
+    } else {
+      values[i] = grnxx::Text::na();
+    }
+  }
+
+  // Store generated values into columns.
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    column->set(row_id, values[i]);
+  }
+
+  // Overwrite some values and remove some rows.
+  for (size_t i = 0; i < NUM_ROWS; i += 17) {
+    values[i] = values[i / 2];
+    column->set(grnxx::Int(i), values[i]);
+  }
+  for (size_t i = 0; i < NUM_ROWS; i += 31) {
+    table->remove_row(grnxx::Int(i));
+  }
+  assert(!index->test_uniqueness());
+
+  // Test cursors for queries of length [1, 4].
+  for (size_t size = 1; size <= 4; ++size) {
+    for (size_t bits = 0; bits < (size_t(1) << size); ++bits) {
+      char body[4];
+      for (size_t j = 0; j < size; ++j) {
+        body[j] = "ab"[(bits >> j) & 1];
+      }
+      grnxx::Text value(body, size);
+      grnxx::CursorOptions options;
+      if ((bits % 2) != 0) {
+        options.order_type = GRNXX_REVERSE_ORDER;
+      }
+      auto cursor = index->find_contains(value, options);
+
+      grnxx::Array<grnxx::Record> records;
+      size_t count = cursor->read_all(&records);
+      for (size_t i = 1; i < records.size(); ++i) {
+        if ((bits % 2) != 0) {
+          assert(records[i - 1].row_id.raw() > records[i].row_id.raw());
+        } else {
+          assert(records[i - 1].row_id.raw() < records[i].row_id.raw());
+        }
+      }
+      size_t total_count = 0;
+      for (size_t i = 0; i < NUM_ROWS; ++i) {
+        if (table->test_row(grnxx::Int(i)) &&
+            values[i].contains(value).is_true()) {
+          ++total_count;
+        }
+      }
+      assert(count == total_count);
+      for (size_t i = 0; i < records.size(); ++i) {
+        assert(values[records[i].row_id.raw()].contains(value).is_true());
+      }
+
+      // Test exact match.
+      cursor = index->find(value);
+      count = cursor->read_all(&records);
+      total_count = 0;
+      for (size_t i = 0; i < NUM_ROWS; ++i) {
+        if (table->test_row(grnxx::Int(i)) && values[i].match(value)) {
+          ++total_count;
+        }
+      }
+      assert(count == total_count);
+    }
+  }
+
+  // Test a query which does not appear.
+  auto cursor = index->find_contains(grnxx::Text("abc"));
+  grnxx::Array<grnxx::Record> records;
+  assert(cursor->read_all(&records) == 0);
+  cursor = index->find_contains(grnxx::Text::na());
+  assert(cursor->read_all(&records) == 0);
+}
+
+void test_full_text_index_updates() {
+  // Create a column and a full-text index.
+  constexpr size_t NUM_UPDATED_ROWS = 4096;
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto column = table->create_column("Text", GRNXX_TEXT);
+  auto index = column->create_index("Index", GRNXX_FULL_TEXT_INDEX);
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; ++i) {
+    table->insert_row();
+  }
+
+  // Store values in random order, so that posting lists are updated in the
+  // middle and split into blocks, and then overwrite some of them.
+  std::vector<size_t> row_ids(NUM_UPDATED_ROWS);
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; ++i) {
+    row_ids[i] = i;
+  }
+  std::shuffle(row_ids.begin(), row_ids.end(), rng);
+  std::vector<bool> expected_rows(NUM_UPDATED_ROWS);
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; ++i) {
+    column->set(grnxx::Int(row_ids[i]), grnxx::Text("abcabc"));
+    expected_rows[row_ids[i]] = true;
+  }
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; i += 3) {
+    column->set(grnxx::Int(row_ids[i]), grnxx::Text("bcd"));
+    expected_rows[row_ids[i]] = false;
+  }
+
+  grnxx::Array<grnxx::Record> records;
+  index->find_contains(grnxx::Text("cab"))->read_all(&records);
+  size_t count = 0;
+  for (size_t i = 0; i < NUM_UPDATED_ROWS; ++i) {
+    if (expected_rows[i]) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+  records.clear();
+  index->find_contains(grnxx::Text("bc"))->read_all(&records);
+  assert(records.size() == NUM_UPDATED_ROWS);
+}
+
+void test_text_find_relevant() {
+  // Create a column.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto column = table->create_column("Column", GRNXX_TEXT);
+
+  // Generate random values.
+  // Text: length = [0, 16], each byte = 'a', 'b' or 'c', or N/A.
+  grnxx::Array<grnxx::String> bodies;
+  grnxx::Array<grnxx::Text> values;
+  bodies.resize(NUM_ROWS);
+  values.resize(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    size_t size = rng() % 17;
+    for (size_t j = 0; j < size; ++j) {
+      bodies[i].append("abc"[rng() % 3]);
+    }
+    if ((rng() % 64) != 0) {
+      values[i] = grnxx::Text(bodies[i].data(), bodies[i].size());
+    } else {
+      values[i] = grnxx::Text::na();
+    }
+  }
+
+  // Store generated values into columns.
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    column->set(row_id, values[i]);
+  }
+  for (size_t i = 0; i < NUM_ROWS; i += 31) {
+    table->remove_row(grnxx::Int(i));
+  }
+
+  // Create an index after storing values.
+  auto index = column->create_index("Index", GRNXX_FULL_TEXT_INDEX);
+
+  // Compute BM25 scores of terms ("ab", "c" and "bcab") by brute force.
+  // The document frequency of "bcab" is that of its rarest bigram.
+  grnxx::Text terms[] = {
+    grnxx::Text("ab"), grnxx::Text("c"), grnxx::Text("bcab")
+  };
+  constexpr size_t NUM_TERMS = 3;
+  grnxx::Array<grnxx::Array<uint32_t>> frequencies;
+  frequencies.resize(NUM_TERMS);
+  double dfs[NUM_TERMS] = { 0.0, 0.0, 0.0 };
+  grnxx::Text bigrams[] = {
+    grnxx::Text("bc"), grnxx::Text("ca"), grnxx::Text("ab")
+  };
+  constexpr size_t NUM_BIGRAMS = 3;
+  double bigram_dfs[NUM_BIGRAMS] = { 0.0, 0.0, 0.0 };
+  double num_texts = 0.0;
+  double total_length = 0.0;
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    bool is_valid = table->test_row(grnxx::Int(i)) && !values[i].is_na();
+    if (is_valid) {
+      num_texts += 1.0;
+      total_length += values[i].raw_size();
+    }
+    for (size_t j = 0; j < NUM_TERMS; ++j) {
+      uint32_t frequency = 0;
+      if (is_valid && (values[i].raw_size() >= terms[j].raw_size())) {
+        size_t end = values[i].raw_size() - terms[j].raw_size() + 1;
+        for (size_t k = 0; k < end; ++k) {
+          if (std::memcmp(values[i].raw_data() + k, terms[j].raw_data(),
+                          terms[j].raw_size()) == 0) {
+            ++frequency;
+          }
+        }
+      }
+      frequencies[j].push_back(frequency);
+      if (frequency != 0) {
+        dfs[j] += 1.0;
+      }
+    }
+    for (size_t j = 0; j < NUM_BIGRAMS; ++j) {
+      if (is_valid && values[i].contains(bigrams[j]).is_true()) {
+        bigram_dfs[j] += 1.0;
+      }
+    }
+  }
+  dfs[2] = *std::min_element(bigram_dfs, bigram_dfs + NUM_BIGRAMS);
+  auto get_score = [&](size_t row_id, size_t begin, size_t end) {
+    double score = 0.0;
+    double length = values[row_id].raw_size();
+    for (size_t j = begin; j < end; ++j) {
+      double idf = std::log(1.0 + (num_texts - dfs[j] + 0.5) / (dfs[j] + 0.5));
+      double frequency = frequencies[j][row_id];
+      score += idf * frequency * 2.2 /
+               (frequency + 1.2 * (0.25 + 0.75 * length /
+                                  (total_length / num_texts)));
+    }
+    return score;
+  };
+
+  // Test a single term and multiple terms with and without a limit.
+  grnxx::TextVector vector(terms, NUM_TERMS);
+  for (int i = 0; i < 2; ++i) {
+    size_t begin = 0;
+    size_t end = (i == 0) ? 1 : NUM_TERMS;
+    grnxx::Array<double> expected_scores;
+    for (size_t j = 0; j < NUM_ROWS; ++j) {
+      double score = get_score(j, begin, end);
+      if (score > 0.0) {
+        expected_scores.push_back(score);
+      }
+    }
+    std::sort(expected_scores.buffer(),
+              expected_scores.buffer() + expected_scores.size(),
+              std::greater<double>());
+
+    grnxx::Datum query;
+    if (i == 0) {
+      query = terms[0];
+    } else {
+      query = vector;
+    }
+    grnxx::CursorOptions options;
+    for (int j = 0; j < 3; ++j) {
+      if (j == 1) {
+        options.offset = 5;
+        options.limit = 10;
+      } else if (j == 2) {
+        options.offset = 0;
+        options.limit = std::numeric_limits<size_t>::max();
+        options.order_type = GRNXX_REVERSE_ORDER;
+      }
+      auto cursor = index->find_relevant(query, options);
+      grnxx::Array<grnxx::Record> records;
+      size_t count = cursor->read_all(&records);
+      size_t expected_count = expected_scores.size() - options.offset;
+      if (expected_count > options.limit) {
+        expected_count = options.limit;
+      }
+      assert(count == expected_count);
+      for (size_t k = 0; k < count; ++k) {
+        size_t row_id = records[k].row_id.raw();
+        double score = records[k].score.raw();
+        assert(std::fabs(score - get_score(row_id, begin, end)) < 1e-9);
+        double expected_score = (j == 2) ?
+            expected_scores[expected_scores.size() - 1 - k] :
+            expected_scores[options.offset + k];
+        assert(std::fabs(score - expected_score) < 1e-9);
+      }
+    }
+  }
+
+  // Test queries without matches.
+  auto cursor = index->find_relevant(grnxx::Text("abcabcabcabcabcab"));
+  grnxx::Array<grnxx::Record> records;
+  assert(cursor->read_all(&records) == 0);
+  cursor = index->find_relevant(grnxx::Text::na());
+  assert(cursor->read_all(&records) == 0);
+}
+
+void test_bulk_build() {
+  // Create columns with values, N/A and removed rows.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto int_column = table->create_column("Int", GRNXX_INT);
+  auto text_column = table->create_column("Text", GRNXX_TEXT);
+
+  // Indexes created before values are stored are the expected results.
+  int_column->create_index("Tree", GRNXX_TREE_INDEX);
+  int_column->create_index("Hash", GRNXX_HASH_INDEX);
+  text_column->create_index("Tree", GRNXX_TREE_INDEX);
+
+  std::vector<std::string> bodies(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    if ((rng() % 16) != 0) {
+      int_column->set(row_id, grnxx::Int(rng() % 256));
+      bodies[i] = std::to_string(rng() % 256);
+      text_column->set(row_id, grnxx::Text(bodies[i].c_str()));
+    }
+  }
+  for (size_t i = 0; i < NUM_ROWS; i += 7) {
+    table->remove_row(grnxx::Int(i));
+  }
+
+  // Build indexes with different numbers of threads.
+  size_t thread_counts[] = { 1, 2, 3, 7 };
+  for (size_t num_threads : thread_counts) {
+    grnxx::IndexOptions options;
+    options.num_threads = num_threads;
+    auto int_tree_index =
+        int_column->create_index("BulkTree", GRNXX_TREE_INDEX, options);
+    auto int_hash_index =
+        int_column->create_index("BulkHash", GRNXX_HASH_INDEX, options);
+    auto text_tree_index =
+        text_column->create_index("BulkTree", GRNXX_TREE_INDEX, options);
+
+    // Tree indexes must return the same records in the same order.
+    grnxx::Index *pairs[][2] = {
+      { int_column->find_index("Tree"), int_tree_index },
+      { text_column->find_index("Tree"), text_tree_index }
+    };
+    for (auto pair : pairs) {
+      assert(pair[0]->num_entries() == pair[1]->num_entries());
+      grnxx::Array<grnxx::Record> records[2];
+      for (size_t i = 0; i < 2; ++i) {
+        auto cursor = pair[i]->find_in_range(grnxx::IndexRange());
+        cursor->read_all(&records[i]);
+      }
+      assert(records[0].size() == pair[0]->num_entries());
+      assert(records[0].size() == records[1].size());
+      for (size_t i = 0; i < records[0].size(); ++i) {
+        assert(records[0][i].row_id.match(records[1][i].row_id));
+      }
+    }
+
+    // Hash indexes must return the same records for each value.
+    auto int_hash_expected = int_column->find_index("Hash");
+    assert(int_hash_index->num_entries() == int_hash_expected->num_entries());
+    for (size_t i = 0; i < 256; ++i) {
+      grnxx::Array<grnxx::Record> records[2];
+      int_hash_expected->find(grnxx::Int(i))->read_all(&records[0]);
+      int_hash_index->find(grnxx::Int(i))->read_all(&records[1]);
+      assert(records[0].size() == records[1].size());
+      for (size_t j = 0; j < records[0].size(); ++j) {
+        assert(records[0][j].row_id.match(records[1][j].row_id));
+      }
+    }
+
+    int_column->remove_index("BulkTree");
+    int_column->remove_index("BulkHash");
+    text_column->remove_index("BulkTree");
+  }
+}
+
+// Compare values in order of composite indexes, where N/A follows any other
+// value.
+int compare_composite_values(const grnxx::Datum &lhs,
+                             const grnxx::Datum &rhs) {
+  bool lhs_is_na = (lhs.type() == GRNXX_NA);
+  bool rhs_is_na = (rhs.type() == GRNXX_NA);
+  if (!lhs_is_na) {
+    switch (lhs.type()) {
+      case GRNXX_BOOL: {
+        lhs_is_na = lhs.as_bool().is_na();
+        break;
+      }
+      case GRNXX_INT: {
+        lhs_is_na = lhs.as_int().is_na();
+        break;
+      }
+      case GRNXX_FLOAT: {
+        lhs_is_na = lhs.as_float().is_na();
+        break;
+      }
+      default: {
+        lhs_is_na = lhs.as_text().is_na();
+        break;
+      }
+    }
+  }
+  if (!rhs_is_na) {
+    switch (rhs.type()) {
+      case GRNXX_BOOL: {
+        rhs_is_na = rhs.as_bool().is_na();
+        break;
+      }
+      case GRNXX_INT: {
+        rhs_is_na = rhs.as_int().is_na();
+        break;
+      }
+      case GRNXX_FLOAT: {
+        rhs_is_na = rhs.as_float().is_na();
+        break;
+      }
+      default: {
+        rhs_is_na = rhs.as_text().is_na();
+        break;
+      }
+    }
+  }
+  if (lhs_is_na || rhs_is_na) {
+    return int(lhs_is_na) - int(rhs_is_na);
+  }
+  switch (lhs.type()) {
+    case GRNXX_BOOL: {
+      return int(lhs.as_bool().is_true()) - int(rhs.as_bool().is_true());
+    }
+    case GRNXX_INT: {
+      int64_t l = lhs.as_int().raw();
+      int64_t r = rhs.as_int().raw();
+      return (l < r) ? -1 : ((l > r) ? 1 : 0);
+    }
+    case GRNXX_FLOAT: {
+      double l = lhs.as_float().raw();
+      double r = rhs.as_float().raw();
+      return (l < r) ? -1 : ((l > r) ? 1 : 0);
+    }
+    default: {
+      std::string l(lhs.as_text().raw_data(), lhs.as_text().raw_size());
+      std::string r(rhs.as_text().raw_data(), rhs.as_text().raw_size());
+      return l.compare(r);
+    }
+  }
+}
+
+// Check records of a composite index on "columns" against a scan.
+void check_composite_index(const grnxx::Table *table,
+                           const std::vector<grnxx::Column *> &columns,
+                           const grnxx::Index *index,
+                           const std::vector<grnxx::Datum> &prefix,
+                           const grnxx::IndexRange &range,
+                           const grnxx::CursorOptions &options =
+                               grnxx::CursorOptions()) {
+  // Read tuples of all the rows.
+  grnxx::Array<grnxx::Record> all_records;
+  table->create_cursor()->read_all(&all_records);
+  std::vector<std::vector<grnxx::Datum>> tuples(all_records.size());
+  for (size_t i = 0; i < all_records.size(); ++i) {
+    tuples[i].resize(columns.size());
+    for (size_t j = 0; j < columns.size(); ++j) {
+      columns[j]->get(all_records[i].row_id, &tuples[i][j]);
+    }
+  }
+
+  // Filter and sort rows.
+  const grnxx::EndPoint &lower_bound = range.lower_bound();
+  const grnxx::EndPoint &upper_bound = range.upper_bound();
+  grnxx::Datum na;
+  std::vector<size_t> expected;
+  for (size_t i = 0; i < tuples.size(); ++i) {
+    const std::vector<grnxx::Datum> &tuple = tuples[i];
+    if (compare_composite_values(tuple[0], na) == 0) {
+      continue;
+    }
+    bool is_matched = true;
+    for (size_t j = 0; j < prefix.size(); ++j) {
+      if (compare_composite_values(tuple[j], prefix[j]) != 0) {
+        is_matched = false;
+      }
+    }
+    if (lower_bound.value.type() != GRNXX_NA) {
+      int result = compare_composite_values(tuple[prefix.size()],
+                                            lower_bound.value);
+      if ((result < 0) || ((result == 0) &&
+                           (lower_bound.type == grnxx::EXCLUSIVE_END_POINT))) {
+        is_matched = false;
+      }
+    }
+    if (upper_bound.value.type() != GRNXX_NA) {
+      int result = compare_composite_values(tuple[prefix.size()],
+                                            upper_bound.value);
+      if ((result > 0) || ((result == 0) &&
+                           (upper_bound.type == grnxx::EXCLUSIVE_END_POINT))) {
+        is_matched = false;
+      }
+    }
+    if (((lower_bound.value.type() != GRNXX_NA) ||
+         (upper_bound.value.type() != GRNXX_NA)) &&
+        (compare_composite_values(tuple[prefix.size()], na) == 0)) {
+      is_matched = false;
+    }
+    if (is_matched) {
+      expected.push_back(i);
+    }
+  }
+  std::sort(expected.begin(), expected.end(), [&](size_t lhs, size_t rhs) {
+    for (size_t j = 0; j < columns.size(); ++j) {
+      int result = compare_composite_values(tuples[lhs][j], tuples[rhs][j]);
+      if (result != 0) {
+        return result < 0;
+      }
+    }
+    return all_records[lhs].row_id.raw() < all_records[rhs].row_id.raw();
+  });
+
+  // Apply "options".
+  size_t begin = options.offset;
+  if (begin > expected.size()) {
+    begin = expected.size();
+  }
+  size_t end = expected.size();
+  if ((end - begin) > options.limit) {
+    end = begin + options.limit;
+  }
+
+  grnxx::Array<grnxx::Record> records;
+  auto cursor = index->find_with_prefix(
+      grnxx::ArrayCRef<grnxx::Datum>(prefix.data(), prefix.size()),
+      range, options);
+  cursor->read_all(&records);
+  assert(records.size() == (end - begin));
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t row_id = all_records[expected[begin + i]].row_id.raw();
+    assert(records[i].row_id.raw() == static_cast<int64_t>(row_id));
+  }
+}
+
+void test_composite_index() {
+  // Create columns.
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto category_column = table->create_column("Category", GRNXX_TEXT);
+  auto price_column = table->create_column("Price", GRNXX_FLOAT);
+  auto stock_column = table->create_column("Stock", GRNXX_INT);
+  auto flag_column = table->create_column("Flag", GRNXX_BOOL);
+  std::vector<grnxx::Column *> columns =
+      { category_column, price_column, stock_column, flag_column };
+
+  // Values include N/A, negative numbers and texts with '\0'.
+  grnxx::Text categories[] = {
+    grnxx::Text(""), grnxx::Text("a"), grnxx::Text("a\0", 2),
+    grnxx::Text("a\0b", 3), grnxx::Text("ab"), grnxx::Text("\xFF"),
+    grnxx::Text::na()
+  };
+  grnxx::Float prices[] = {
+    grnxx::Float(-2.5), grnxx::Float(0.0), grnxx::Float(1.0),
+    grnxx::Float(1.5), grnxx::Float::na()
+  };
+  grnxx::Int stocks[] = {
+    grnxx::Int(-100), grnxx::Int(0), grnxx::Int(7), grnxx::Int::na()
+  };
+  grnxx::Bool flags[] = {
+    grnxx::Bool(false), grnxx::Bool(true), grnxx::Bool::na()
+  };
+  auto set_random_values = [&](grnxx::Int row_id) {
+    category_column->set(row_id, categories[rng() % 7]);
+    price_column->set(row_id, prices[rng() % 5]);
+    stock_column->set(row_id, stocks[rng() % 4]);
+    flag_column->set(row_id, flags[rng() % 3]);
+  };
+  constexpr size_t NUM_COMPOSITE_ROWS = 1024;
+  for (size_t i = 0; i < (NUM_COMPOSITE_ROWS / 2); ++i) {
+    set_random_values(table->insert_row());
+  }
+
+  // Create a composite index on existing values.
+  grnxx::IndexOptions options;
+  options.secondary_column_names.push_back(grnxx::String("Price"));
+  options.secondary_column_names.push_back(grnxx::String("Stock"));
+  options.secondary_column_names.push_back(grnxx::String("Flag"));
+  auto index = category_column->create_index(
+      "Composite", GRNXX_TREE_INDEX, options);
+  for (size_t i = (NUM_COMPOSITE_ROWS / 2); i < NUM_COMPOSITE_ROWS; ++i) {
+    set_random_values(table->insert_row());
+  }
+
+  auto check_all = [&] {
+    std::vector<grnxx::Datum> prefix;
+    grnxx::IndexRange range;
+    check_composite_index(table, columns, index, prefix, range);
+    grnxx::CursorOptions cursor_options;
+    cursor_options.offset = 100;
+    cursor_options.limit = 50;
+    check_composite_index(table, columns, index, prefix, range,
+                          cursor_options);
+    for (const grnxx::Text &category : categories) {
+      prefix.assign(1, category);
+      range = grnxx::IndexRange();
+      check_composite_index(table, columns, index, prefix, range);
+      range.set_lower_bound(grnxx::Float(0.0), grnxx::INCLUSIVE_END_POINT);
+      range.set_upper_bound(grnxx::Float(1.5), grnxx::EXCLUSIVE_END_POINT);
+      check_composite_index(table, columns, index, prefix, range);
+      range.set_lower_bound(grnxx::Float(0.0), grnxx::EXCLUSIVE_END_POINT);
+      range.set_upper_bound(grnxx::Float(1.5), grnxx::INCLUSIVE_END_POINT);
+      check_composite_index(table, columns, index, prefix, range);
+      range.unset_upper_bound();
+      check_composite_index(table, columns, index, prefix, range);
+      range.unset_lower_bound();
+      range.set_upper_bound(grnxx::Float(1.0), grnxx::INCLUSIVE_END_POINT);
+      check_composite_index(table, columns, index, prefix, range);
+      for (const grnxx::Float &price : prices) {
+        prefix.resize(1);
+        prefix.push_back(price);
+        range = grnxx::IndexRange();
+        check_composite_index(table, columns, index, prefix, range);
+        range.set_lower_bound(grnxx::Int(0), grnxx::INCLUSIVE_END_POINT);
+        check_composite_index(table, columns, index, prefix, range);
+        range.set_upper_bound(grnxx::Int(7), grnxx::EXCLUSIVE_END_POINT);
+        check_composite_index(table, columns, index, prefix, range);
+        prefix.push_back(grnxx::Int(7));
+        prefix.push_back(grnxx::Bool(true));
+        range = grnxx::IndexRange();
+        check_composite_index(table, columns, index, prefix, range);
+      }
+    }
+    // A range on the owner column.
+    prefix.clear();
+    range.set_lower_bound(grnxx::Text("a"), grnxx::EXCLUSIVE_END_POINT);
+    range.set_upper_bound(grnxx::Text("ab"), grnxx::INCLUSIVE_END_POINT);
+    check_composite_index(table, columns, index, prefix, range);
+  };
+  check_all();
+
+  // find() and find_in_range() are for the owner column.
+  grnxx::Array<grnxx::Record> records;
+  index->find(grnxx::Text("a"))->read_all(&records);
+  for (size_t i = 0; i < records.size(); ++i) {
+    grnxx::Datum datum;
+    category_column->get(records[i].row_id, &datum);
+    assert(datum.as_text().match(grnxx::Text("a")));
+  }
+  records.clear();
+  index->find_in_range()->read_all(&records);
+  assert(records.size() == index->num_entries());
+  assert(!index->test_uniqueness());
+
+  // Update values of secondary columns.
+  for (size_t i = 0; i < NUM_COMPOSITE_ROWS; i += 3) {
+    set_random_values(grnxx::Int(i));
+  }
+  check_all();
+
+  // Remove rows and renumber the rest.
+  for (size_t i = 0; i < NUM_COMPOSITE_ROWS; i += 5) {
+    table->remove_row(grnxx::Int(i));
+  }
+  check_all();
+  table->vacuum();
+  index = category_column->find_index("Composite");
+  check_all();
+
+  // Secondary columns cannot be removed while the index exists.
+  bool is_thrown = false;
+  try {
+    table->remove_column("Stock");
+  } catch (...) {
+    is_thrown = true;
+  }
+  assert(is_thrown);
+  category_column->remove_index("Composite");
+  table->remove_column("Stock");
+}
+
 int main() {
   test_index();
 
@@ -845,11 +1825,23 @@ int main() {
 
   test_text_find_starts_with();
   test_text_find_prefixes();
+  test_text_find_contains();
+  test_full_text_index_updates();
+  test_text_find_relevant();
+
+  test_geo_point_find_within();
 
   test_reverse();
   test_offset_and_limit();
 
   test_uniqueness();
 
+  test_vector_element_match();
+  test_posting_list_updates();
+
+  test_bulk_build();
+
+  test_composite_index();
+
   return 0;
 }
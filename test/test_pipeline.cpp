@@ -15,14 +15,20 @@
   License along with this library; if not, write to the Free Software
   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <random>
+#include <vector>
 
 #include "grnxx/column.hpp"
 #include "grnxx/cursor.hpp"
 #include "grnxx/db.hpp"
 #include "grnxx/expression.hpp"
+#include "grnxx/index.hpp"
 #include "grnxx/pipeline.hpp"
 #include "grnxx/sorter.hpp"
 #include "grnxx/table.hpp"
@@ -377,6 +383,589 @@ void test_merger() {
   }
 }
 
+void test_block_size() {
+  // Create an object for building a pipeline.
+  auto pipeline_builder = grnxx::PipelineBuilder::create(test.table);
+  auto expression_builder = grnxx::ExpressionBuilder::create(test.table);
+
+  // An automatic block size must be a power of two.
+  expression_builder->push_column("Int");
+  expression_builder->push_constant(grnxx::Int(50));
+  expression_builder->push_operator(GRNXX_LESS);
+  auto expression = expression_builder->release();
+  size_t block_size = expression->block_size();
+  assert(block_size != 0);
+  assert((block_size & (block_size - 1)) == 0);
+
+  // The pipeline must use the block size of the filter.
+  pipeline_builder->push_cursor(test.table->create_cursor());
+  pipeline_builder->push_filter(std::move(expression));
+  auto pipeline = pipeline_builder->release();
+  assert(pipeline->block_size() == block_size);
+
+  grnxx::Array<grnxx::Record> records;
+  pipeline->flush(&records);
+  size_t count = 0;
+  for (size_t i = 0; i < test.int_values.size(); ++i) {
+    if ((test.int_values[i] < grnxx::Int(50)).is_true()) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+
+  // An explicit block size must be kept as is.
+  grnxx::ExpressionOptions expression_options;
+  expression_options.block_size = 100;
+  expression_builder->push_column("Bool");
+  expression = expression_builder->release(expression_options);
+  assert(expression->block_size() == 100);
+
+  grnxx::PipelineOptions pipeline_options;
+  pipeline_options.block_size = 300;
+  pipeline_builder->push_cursor(test.table->create_cursor());
+  pipeline_builder->push_filter(std::move(expression));
+  pipeline = pipeline_builder->release(pipeline_options);
+  assert(pipeline->block_size() == 300);
+
+  records.clear();
+  pipeline->flush(&records);
+  count = 0;
+  for (size_t i = 0; i < test.bool_values.size(); ++i) {
+    if (test.bool_values[i].is_true()) {
+      assert(records[count].row_id.match(grnxx::Int(i)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+}
+
+void check_zone_map_filter(grnxx::Table *table,
+                           std::unique_ptr<grnxx::Expression> &&expression) {
+  // Evaluation never skips zones, so the results are used as answers.
+  grnxx::Array<grnxx::Record> all_records;
+  auto cursor = table->create_cursor();
+  cursor->read_all(&all_records);
+  grnxx::Array<grnxx::Bool> results;
+  expression->evaluate(all_records, &results);
+  grnxx::Array<grnxx::Int> answers;
+  for (size_t i = 0; i < all_records.size(); ++i) {
+    if (results[i].is_true()) {
+      answers.push_back(all_records[i].row_id);
+    }
+  }
+
+  // Expression::filter() may skip zones.
+  grnxx::Array<grnxx::Record> records;
+  records.resize(all_records.size());
+  for (size_t i = 0; i < all_records.size(); ++i) {
+    records[i] = all_records[i];
+  }
+  expression->filter(&records);
+  assert(records.size() == answers.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    assert(records[i].row_id.match(answers[i]));
+  }
+
+  // A table cursor may skip zones in a pipeline.
+  auto pipeline_builder = grnxx::PipelineBuilder::create(table);
+  pipeline_builder->push_cursor(table->create_cursor());
+  pipeline_builder->push_filter(std::move(expression));
+  auto pipeline = pipeline_builder->release();
+  records.clear();
+  pipeline->flush(&records);
+  assert(records.size() == answers.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    assert(records[i].row_id.match(answers[i]));
+  }
+}
+
+void test_zone_map() {
+  // Create a table whose values correlate with row IDs.
+  auto table = test.db->create_table("ZoneMap");
+  auto time_column = table->create_column("Time", GRNXX_INT);
+  auto score_column = table->create_column("Score", GRNXX_FLOAT);
+  auto name_column = table->create_column("Name", GRNXX_TEXT);
+  constexpr size_t NUM_ROWS = 10000;
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    if ((i % 100) != 99) {
+      time_column->set(row_id, grnxx::Int(i));
+      score_column->set(row_id, grnxx::Float(i * 0.5));
+    }
+    char name[16];
+    std::sprintf(name, "%08d", static_cast<int>(i));
+    name_column->set(row_id, grnxx::Text(name));
+  }
+  // Updates and removals must be reflected.
+  time_column->set(grnxx::Int(5), grnxx::Int(9000));
+  time_column->set(grnxx::Int(9000), grnxx::Int(-1));
+  score_column->set(grnxx::Int(7), grnxx::Float(4000.0));
+  name_column->set(grnxx::Int(3000), grnxx::Text("zzz"));
+  time_column->set(grnxx::Int(8200), grnxx::Int::na());
+  table->remove_row(grnxx::Int(8100));
+
+  auto expression_builder = grnxx::ExpressionBuilder::create(table);
+
+  // (Time >= 8000) && (Time < 8500).
+  expression_builder->push_column("Time");
+  expression_builder->push_constant(grnxx::Int(8000));
+  expression_builder->push_operator(GRNXX_GREATER_EQUAL);
+  expression_builder->push_column("Time");
+  expression_builder->push_constant(grnxx::Int(8500));
+  expression_builder->push_operator(GRNXX_LESS);
+  expression_builder->push_operator(GRNXX_LOGICAL_AND);
+  check_zone_map_filter(table, expression_builder->release());
+
+  // (100 > Time) || (Time == 9000).
+  expression_builder->push_constant(grnxx::Int(100));
+  expression_builder->push_column("Time");
+  expression_builder->push_operator(GRNXX_GREATER);
+  expression_builder->push_column("Time");
+  expression_builder->push_constant(grnxx::Int(9000));
+  expression_builder->push_operator(GRNXX_EQUAL);
+  expression_builder->push_operator(GRNXX_LOGICAL_OR);
+  check_zone_map_filter(table, expression_builder->release());
+
+  // (Time != 0) && (Score >= 4000.0).
+  expression_builder->push_column("Time");
+  expression_builder->push_constant(grnxx::Int(0));
+  expression_builder->push_operator(GRNXX_NOT_EQUAL);
+  expression_builder->push_column("Score");
+  expression_builder->push_constant(grnxx::Float(4000.0));
+  expression_builder->push_operator(GRNXX_GREATER_EQUAL);
+  expression_builder->push_operator(GRNXX_LOGICAL_AND);
+  check_zone_map_filter(table, expression_builder->release());
+
+  // (Name <= "00001234") || (Name > "0000999").
+  expression_builder->push_column("Name");
+  expression_builder->push_constant(grnxx::Text("00001234"));
+  expression_builder->push_operator(GRNXX_LESS_EQUAL);
+  expression_builder->push_column("Name");
+  expression_builder->push_constant(grnxx::Text("0000999"));
+  expression_builder->push_operator(GRNXX_GREATER);
+  expression_builder->push_operator(GRNXX_LOGICAL_OR);
+  check_zone_map_filter(table, expression_builder->release());
+
+  // Name == "zzz".
+  expression_builder->push_column("Name");
+  expression_builder->push_constant(grnxx::Text("zzz"));
+  expression_builder->push_operator(GRNXX_EQUAL);
+  check_zone_map_filter(table, expression_builder->release());
+
+  // A reverse cursor may also skip zones.
+  expression_builder->push_column("Time");
+  expression_builder->push_constant(grnxx::Int(2000));
+  expression_builder->push_operator(GRNXX_LESS);
+  auto expression = expression_builder->release();
+  auto pipeline_builder = grnxx::PipelineBuilder::create(table);
+  grnxx::CursorOptions cursor_options;
+  cursor_options.order_type = GRNXX_REVERSE_ORDER;
+  pipeline_builder->push_cursor(table->create_cursor(cursor_options));
+  pipeline_builder->push_filter(std::move(expression));
+  auto pipeline = pipeline_builder->release();
+  grnxx::Array<grnxx::Record> records;
+  pipeline->flush(&records);
+  size_t count = 0;
+  for (size_t i = NUM_ROWS; i > 0; --i) {
+    grnxx::Datum datum;
+    time_column->get(grnxx::Int(i - 1), &datum);
+    if ((datum.as_int() < grnxx::Int(2000)).is_true()) {
+      assert(records[count].row_id.match(grnxx::Int(i - 1)));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+}
+
+// Read records filtered by Bool and sorted by Int and row ID.
+void read_sorted_records(grnxx::SorterOrderType int_order_type,
+                         bool has_row_id_order,
+                         size_t offset,
+                         size_t limit,
+                         grnxx::Array<grnxx::Record> *records) {
+  auto pipeline_builder = grnxx::PipelineBuilder::create(test.table);
+  pipeline_builder->push_cursor(test.table->create_cursor());
+  auto expression_builder = grnxx::ExpressionBuilder::create(test.table);
+  expression_builder->push_column("Bool");
+  pipeline_builder->push_filter(expression_builder->release());
+  expression_builder->push_column("Float");
+  pipeline_builder->push_adjuster(expression_builder->release());
+  grnxx::Array<grnxx::SorterOrder> orders;
+  orders.resize(has_row_id_order ? 2 : 1);
+  expression_builder->push_column("Int");
+  orders[0].expression = expression_builder->release();
+  orders[0].type = int_order_type;
+  if (has_row_id_order) {
+    expression_builder->push_row_id();
+    orders[1].expression = expression_builder->release();
+    orders[1].type = GRNXX_REGULAR_ORDER;
+  }
+  grnxx::SorterOptions options;
+  options.offset = offset;
+  options.limit = limit;
+  pipeline_builder->push_sorter(
+      grnxx::Sorter::create(std::move(orders), options));
+  auto pipeline = pipeline_builder->release();
+  pipeline->flush(records);
+}
+
+void test_index_order() {
+  // Create an index, so that a pipeline reads records in order of Int
+  // through the index instead of sorting them.
+  auto int_column = test.table->find_column("Int");
+  int_column->create_index("Index", GRNXX_TREE_INDEX);
+
+  // Get the expected order: Int (N/A last) and row ID.
+  std::vector<size_t> row_ids;
+  for (size_t i = 0; i < test.bool_values.size(); ++i) {
+    if (test.bool_values[i].is_true()) {
+      row_ids.push_back(i);
+    }
+  }
+  grnxx::SorterOrderType order_types[] = {
+    GRNXX_REGULAR_ORDER, GRNXX_REVERSE_ORDER
+  };
+  for (grnxx::SorterOrderType order_type : order_types) {
+    std::vector<size_t> expected = row_ids;
+    std::sort(expected.begin(), expected.end(), [&](size_t lhs, size_t rhs) {
+      grnxx::Int lhs_value = test.int_values[lhs];
+      grnxx::Int rhs_value = test.int_values[rhs];
+      if (lhs_value.is_na() || rhs_value.is_na()) {
+        if (lhs_value.is_na() != rhs_value.is_na()) {
+          return rhs_value.is_na();
+        }
+      } else if (!lhs_value.match(rhs_value)) {
+        return (order_type == GRNXX_REGULAR_ORDER) ?
+               (lhs_value < rhs_value).is_true() :
+               (lhs_value > rhs_value).is_true();
+      }
+      return lhs < rhs;
+    });
+
+    // Offsets and limits include ranges over N/A.
+    size_t ranges[][2] = {
+      { 0, 20 }, { 100, 1 }, { 5000, 3000 },
+      { expected.size() - 10, 20 }, { expected.size() + 10, 20 }
+    };
+    for (auto range : ranges) {
+      size_t offset = range[0];
+      size_t limit = range[1];
+      size_t begin = (offset < expected.size()) ? offset : expected.size();
+      size_t end = ((expected.size() - begin) > limit) ?
+                   (begin + limit) : expected.size();
+
+      // With a row ID order, records must be the same.
+      grnxx::Array<grnxx::Record> records;
+      read_sorted_records(order_type, true, offset, limit, &records);
+      assert(records.size() == (end - begin));
+      for (size_t i = 0; i < records.size(); ++i) {
+        size_t row_id = records[i].row_id.raw();
+        assert(row_id == expected[begin + i]);
+        assert(records[i].score.match(test.float_values[row_id]));
+      }
+
+      // Without a row ID order, values must be the same.
+      records.clear();
+      read_sorted_records(order_type, false, offset, limit, &records);
+      assert(records.size() == (end - begin));
+      for (size_t i = 0; i < records.size(); ++i) {
+        size_t row_id = records[i].row_id.raw();
+        assert(test.bool_values[row_id].is_true());
+        assert(test.int_values[row_id].match(
+            test.int_values[expected[begin + i]]));
+      }
+    }
+  }
+
+  int_column->remove_index("Index");
+}
+
+void test_composite_index_order() {
+  // Create a composite index, so that a pipeline reads records satisfying
+  // a filter in order of Float through the index.
+  auto int_column = test.table->find_column("Int");
+  grnxx::IndexOptions index_options;
+  index_options.secondary_column_names.push_back(grnxx::String("Float"));
+  int_column->create_index("Index", GRNXX_TREE_INDEX, index_options);
+
+  // Queries use the index, with and without filters on other conditions,
+  // or fall back to a sorter.
+  struct Query {
+    const char *query;
+    bool (*filter)(size_t row_id);
+  };
+  Query queries[] = {
+    { "Int == 3 && Float < 0.5", [](size_t row_id) {
+        return test.int_values[row_id].match(grnxx::Int(3)) &&
+               (test.float_values[row_id] < grnxx::Float(0.5)).is_true();
+      } },
+    { "Float >= 0.25 && Int == 5 && Float <= 0.75 && Float > 0.5",
+      [](size_t row_id) {
+        return test.int_values[row_id].match(grnxx::Int(5)) &&
+               (test.float_values[row_id] > grnxx::Float(0.5)).is_true() &&
+               (test.float_values[row_id] <= grnxx::Float(0.75)).is_true();
+      } },
+    { "Int == 7", [](size_t row_id) {
+        return test.int_values[row_id].match(grnxx::Int(7));
+      } },
+    { "Int == 7 && Bool", [](size_t row_id) {
+        return test.int_values[row_id].match(grnxx::Int(7)) &&
+               test.bool_values[row_id].is_true();
+      } }
+  };
+  grnxx::SorterOrderType order_types[] = {
+    GRNXX_REGULAR_ORDER, GRNXX_REVERSE_ORDER
+  };
+  for (const Query &query : queries) {
+    for (grnxx::SorterOrderType order_type : order_types) {
+      // Get the expected order: Float (N/A last) and row ID.
+      std::vector<size_t> expected;
+      for (size_t i = 0; i < test.int_values.size(); ++i) {
+        if (query.filter(i)) {
+          expected.push_back(i);
+        }
+      }
+      std::sort(expected.begin(), expected.end(),
+                [&](size_t lhs, size_t rhs) {
+        grnxx::Float lhs_value = test.float_values[lhs];
+        grnxx::Float rhs_value = test.float_values[rhs];
+        if (lhs_value.is_na() || rhs_value.is_na()) {
+          if (lhs_value.is_na() != rhs_value.is_na()) {
+            return rhs_value.is_na();
+          }
+        } else if (!lhs_value.match(rhs_value)) {
+          return (order_type == GRNXX_REGULAR_ORDER) ?
+                 (lhs_value < rhs_value).is_true() :
+                 (lhs_value > rhs_value).is_true();
+        }
+        return lhs < rhs;
+      });
+
+      size_t ranges[][2] = {
+        { 0, std::numeric_limits<size_t>::max() }, { 0, 10 }, { 50, 20 }
+      };
+      for (auto range : ranges) {
+        size_t offset = range[0];
+        size_t limit = range[1];
+        size_t begin = (offset < expected.size()) ? offset : expected.size();
+        size_t end = ((expected.size() - begin) > limit) ?
+                     (begin + limit) : expected.size();
+        for (int has_row_id_order = 0; has_row_id_order < 2;
+             ++has_row_id_order) {
+          auto pipeline_builder = grnxx::PipelineBuilder::create(test.table);
+          pipeline_builder->push_cursor(test.table->create_cursor());
+          pipeline_builder->push_filter(
+              grnxx::Expression::parse(test.table, query.query));
+          auto expression_builder =
+              grnxx::ExpressionBuilder::create(test.table);
+          grnxx::Array<grnxx::SorterOrder> orders;
+          orders.resize(has_row_id_order ? 2 : 1);
+          expression_builder->push_column("Float");
+          orders[0].expression = expression_builder->release();
+          orders[0].type = order_type;
+          if (has_row_id_order) {
+            expression_builder->push_row_id();
+            orders[1].expression = expression_builder->release();
+            orders[1].type = GRNXX_REGULAR_ORDER;
+          }
+          grnxx::SorterOptions options;
+          options.offset = offset;
+          options.limit = limit;
+          pipeline_builder->push_sorter(
+              grnxx::Sorter::create(std::move(orders), options));
+          auto pipeline = pipeline_builder->release();
+          grnxx::Array<grnxx::Record> records;
+          pipeline->flush(&records);
+          assert(records.size() == (end - begin));
+          for (size_t i = 0; i < records.size(); ++i) {
+            size_t row_id = records[i].row_id.raw();
+            if (has_row_id_order) {
+              assert(row_id == expected[begin + i]);
+            } else {
+              assert(query.filter(row_id));
+              assert(test.float_values[row_id].match(
+                  test.float_values[expected[begin + i]]));
+            }
+          }
+        }
+      }
+    }
+  }
+
+  int_column->remove_index("Index");
+}
+
+// Filter records with "query", adjust scores with Value and sort records by
+// score and row ID.
+std::shared_ptr<const grnxx::Array<grnxx::Record>> run_cached_pipeline(
+    grnxx::Table *table,
+    const char *query,
+    grnxx::PipelineCache *cache) {
+  auto pipeline_builder = grnxx::PipelineBuilder::create(table);
+  pipeline_builder->push_cursor(table->create_cursor());
+  pipeline_builder->push_filter(grnxx::Expression::parse(table, query));
+  auto expression_builder = grnxx::ExpressionBuilder::create(table);
+  expression_builder->push_column("Value");
+  expression_builder->push_operator(GRNXX_TO_FLOAT);
+  pipeline_builder->push_adjuster(expression_builder->release());
+  grnxx::Array<grnxx::SorterOrder> orders;
+  orders.resize(2);
+  expression_builder->push_score();
+  orders[0].expression = expression_builder->release();
+  orders[0].type = GRNXX_REVERSE_ORDER;
+  expression_builder->push_row_id();
+  orders[1].expression = expression_builder->release();
+  orders[1].type = GRNXX_REGULAR_ORDER;
+  pipeline_builder->push_sorter(grnxx::Sorter::create(std::move(orders)));
+  grnxx::PipelineOptions options;
+  options.cache = cache;
+  auto pipeline = pipeline_builder->release(options);
+  return pipeline->flush_shared();
+}
+
+// Check that "records" are rows with Value < "threshold" in descending
+// order of Value.
+void check_cached_records(const grnxx::Table *table,
+                          const grnxx::Array<grnxx::Record> &records,
+                          int64_t threshold) {
+  auto column = table->find_column("Value");
+  size_t count = 0;
+  auto cursor = table->create_cursor();
+  grnxx::Array<grnxx::Record> rows;
+  cursor->read_all(&rows);
+  grnxx::Datum datum;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    column->get(rows[i].row_id, &datum);
+    if (!datum.as_int().is_na() && (datum.as_int().raw() < threshold)) {
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+  for (size_t i = 0; i < records.size(); ++i) {
+    column->get(records[i].row_id, &datum);
+    assert(datum.as_int().raw() < threshold);
+    assert(records[i].score.raw() == datum.as_int().raw());
+    if (i != 0) {
+      assert(records[i - 1].score.raw() >= records[i].score.raw());
+    }
+  }
+}
+
+void test_cache() {
+  constexpr size_t NUM_ROWS = 1024;
+  auto table = test.db->create_table("Cache");
+  auto value_column = table->create_column("Value", GRNXX_INT);
+  auto other_column = table->create_column("Other", GRNXX_INT);
+  std::mt19937_64 mersenne_twister;
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = table->insert_row();
+    value_column->set(row_id, grnxx::Int(mersenne_twister() % 256));
+  }
+  auto cache = grnxx::PipelineCache::create();
+  assert(cache->num_entries() == 0);
+  assert(cache->size() == 0);
+
+  // The second run shares the cached records.
+  auto records = run_cached_pipeline(table, "Value < 100", cache.get());
+  check_cached_records(table, *records, 100);
+  assert(cache->num_entries() == 1);
+  assert(cache->size() >= (sizeof(grnxx::Record) * records->size()));
+  auto cached_records =
+      run_cached_pipeline(table, "(Value<100)", cache.get());
+  assert(cached_records == records);
+  auto other_records = run_cached_pipeline(table, "Value < 50", cache.get());
+  assert(other_records != records);
+  check_cached_records(table, *other_records, 50);
+  assert(cache->num_entries() == 2);
+
+  // flush() copies the cached records.
+  {
+    auto pipeline_builder = grnxx::PipelineBuilder::create(table);
+    pipeline_builder->push_cursor(table->create_cursor());
+    pipeline_builder->push_filter(
+        grnxx::Expression::parse(table, "Value < 50"));
+    grnxx::PipelineOptions options;
+    options.cache = cache.get();
+    auto pipeline = pipeline_builder->release(options);
+    grnxx::Array<grnxx::Record> flushed_records;
+    pipeline->flush(&flushed_records);
+    assert(cache->num_entries() == 3);
+    pipeline_builder->push_cursor(table->create_cursor());
+    pipeline_builder->push_filter(
+        grnxx::Expression::parse(table, "Value < 50"));
+    pipeline = pipeline_builder->release(options);
+    grnxx::Array<grnxx::Record> cached_flushed_records;
+    pipeline->flush(&cached_flushed_records);
+    assert(cached_flushed_records.size() == flushed_records.size());
+    for (size_t i = 0; i < flushed_records.size(); ++i) {
+      assert(cached_flushed_records[i].row_id.match(
+          flushed_records[i].row_id));
+    }
+  }
+
+  // A cursor with an offset is not cacheable.
+  {
+    auto pipeline_builder = grnxx::PipelineBuilder::create(table);
+    grnxx::CursorOptions cursor_options;
+    cursor_options.offset = 1;
+    pipeline_builder->push_cursor(table->create_cursor(cursor_options));
+    grnxx::PipelineOptions options;
+    options.cache = cache.get();
+    auto pipeline = pipeline_builder->release(options);
+    assert(pipeline->flush_shared()->size() == (NUM_ROWS - 1));
+    assert(cache->num_entries() == 3);
+  }
+
+  // Changes of other columns keep the cached records.
+  other_column->set(grnxx::Int(0), grnxx::Int(1));
+  cached_records = run_cached_pipeline(table, "Value < 100", cache.get());
+  assert(cached_records == records);
+
+  // Changes of the table or the involved columns invalidate the cache.
+  value_column->set(grnxx::Int(0), grnxx::Int(0));
+  cached_records = run_cached_pipeline(table, "Value < 100", cache.get());
+  assert(cached_records != records);
+  check_cached_records(table, *cached_records, 100);
+  records = cached_records;
+  grnxx::Int row_id = table->insert_row();
+  value_column->set(row_id, grnxx::Int(99));
+  cached_records = run_cached_pipeline(table, "Value < 100", cache.get());
+  assert(cached_records != records);
+  check_cached_records(table, *cached_records, 100);
+  records = cached_records;
+  table->remove_row(grnxx::Int(0));
+  cached_records = run_cached_pipeline(table, "Value < 100", cache.get());
+  assert(cached_records != records);
+  check_cached_records(table, *cached_records, 100);
+  assert(cache->num_entries() == 3);
+
+  cache->clear();
+  assert(cache->num_entries() == 0);
+  assert(cache->size() == 0);
+
+  // The least recently used records are removed.
+  grnxx::PipelineCacheOptions cache_options;
+  cache_options.max_size = sizeof(grnxx::Record) * NUM_ROWS;
+  cache = grnxx::PipelineCache::create(cache_options);
+  records = run_cached_pipeline(table, "Value < 100", cache.get());
+  other_records = run_cached_pipeline(table, "Value < 80", cache.get());
+  assert(cache->num_entries() == 2);
+  assert(run_cached_pipeline(table, "Value < 100", cache.get()) == records);
+  run_cached_pipeline(table, "Value < 120", cache.get());
+  assert(cache->size() <= cache_options.max_size);
+  assert(cache->num_entries() == 2);
+  assert(run_cached_pipeline(table, "Value < 100", cache.get()) == records);
+  assert(run_cached_pipeline(table, "Value < 80", cache.get()) !=
+         other_records);
+
+  // Records larger than the limit are not cached.
+  run_cached_pipeline(table, "Value < 256", cache.get());
+  assert(cache->size() <= cache_options.max_size);
+
+  test.db->remove_table("Cache");
+}
+
 int main() {
   init_test();
   test_cursor();
@@ -384,5 +973,10 @@ int main() {
   test_adjuster();
   test_sorter();
   test_merger();
+  test_block_size();
+  test_zone_map();
+  test_index_order();
+  test_composite_index_order();
+  test_cache();
   return 0;
 }
@@ -298,11 +298,12 @@ void test_score() {
 }
 
 template <typename T>
-void test_value() {
+void test_value(
+    const grnxx::ColumnOptions &column_options = grnxx::ColumnOptions()) {
   // Create a table.
   auto db = grnxx::open_db("");
   auto table = db->create_table("Table");
-  auto column = table->create_column("Column", T::type());
+  auto column = table->create_column("Column", T::type(), column_options);
   for (size_t i = 0; i < NUM_ROWS; ++i) {
     table->insert_row();
   }
@@ -581,6 +582,9 @@ int main() {
   test_value<grnxx::Int>();
   test_value<grnxx::Float>();
   test_value<grnxx::Text>();
+  grnxx::ColumnOptions options;
+  options.dictionary_encoding = true;
+  test_value<grnxx::Text>(options);
   test_composite();
   return 0;
 }
@@ -18,11 +18,14 @@
 #include <cassert>
 #include <iostream>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "grnxx/column.hpp"
 #include "grnxx/cursor.hpp"
 #include "grnxx/db.hpp"
+#include "grnxx/expression.hpp"
+#include "grnxx/index.hpp"
 #include "grnxx/table.hpp"
 
 void test_table() {
@@ -413,6 +416,40 @@ void test_cursor() {
     assert(records[i].row_id.match(row_ids[row_ids.size() - i - 1]));
   }
   records.clear();
+
+  // Test cursors with offsets and limits, which read records in batches.
+  size_t offsets[] = { 0, 1, 63, 64, 100, row_ids.size() - 1, row_ids.size() };
+  size_t limits[] = { 0, 1, 65, 300, row_ids.size() };
+  for (size_t offset : offsets) {
+    for (size_t limit : limits) {
+      for (int reverse = 0; reverse < 2; ++reverse) {
+        cursor_options = grnxx::CursorOptions();
+        cursor_options.offset = offset;
+        cursor_options.limit = limit;
+        if (reverse) {
+          cursor_options.order_type = GRNXX_REVERSE_ORDER;
+        }
+        cursor = table->create_cursor(cursor_options);
+        while (cursor->read(7, &records) != 0) {}
+        size_t expected_size = 0;
+        if (offset < row_ids.size()) {
+          expected_size = row_ids.size() - offset;
+          if (expected_size > limit) {
+            expected_size = limit;
+          }
+        }
+        assert(records.size() == expected_size);
+        for (size_t i = 0; i < records.size(); ++i) {
+          size_t j = offset + i;
+          if (reverse) {
+            j = row_ids.size() - j - 1;
+          }
+          assert(records[i].row_id.match(row_ids[j]));
+        }
+        records.clear();
+      }
+    }
+  }
 }
 
 void test_reference() {
@@ -438,14 +475,51 @@ void test_reference() {
   ref_column->set(grnxx::Int(1), grnxx::Int(1));
   ref_column->set(grnxx::Int(2), grnxx::Int(1));
 
-  // TODO: "from_table" may be updated in "to_table->remove_row()".
+  // Find rows referring to each row.
+  grnxx::Array<grnxx::Record> records;
+  auto cursor = ref_column->find_referrers(grnxx::Int(0));
+  assert(cursor->read_all(&records) == 1);
+  assert(records[0].row_id.raw() == 0);
+  records.clear();
+  cursor = ref_column->find_referrers(grnxx::Int(1));
+  assert(cursor->read_all(&records) == 2);
+  assert(records[0].row_id.raw() == 1);
+  assert(records[1].row_id.raw() == 2);
+  records.clear();
+  grnxx::CursorOptions cursor_options;
+  cursor_options.order_type = GRNXX_REVERSE_ORDER;
+  cursor = ref_column->find_referrers(grnxx::Int(1), cursor_options);
+  assert(cursor->read_all(&records) == 2);
+  assert(records[0].row_id.raw() == 2);
+  assert(records[1].row_id.raw() == 1);
+  records.clear();
+  cursor = ref_column->find_referrers(grnxx::Int(2));
+  assert(cursor->read_all(&records) == 0);
+
+  // Referrers are kept sorted even if they are not set in order.
+  ref_column->set(grnxx::Int(0), grnxx::Int(1));
+  cursor = ref_column->find_referrers(grnxx::Int(1));
+  assert(cursor->read_all(&records) == 3);
+  for (size_t i = 0; i < records.size(); ++i) {
+    assert(records[i].row_id.raw() == static_cast<int64_t>(i));
+  }
+  records.clear();
+  ref_column->set(grnxx::Int(1), grnxx::Int::na());
+  cursor = ref_column->find_referrers(grnxx::Int(1));
+  assert(cursor->read_all(&records) == 2);
+  assert(records[0].row_id.raw() == 0);
+  assert(records[1].row_id.raw() == 2);
+  records.clear();
+  ref_column->set(grnxx::Int(0), grnxx::Int(0));
+  ref_column->set(grnxx::Int(1), grnxx::Int(1));
 
+  // References to a removed row are replaced with N/A.
   to_table->remove_row(grnxx::Int(0));
 
   grnxx::Datum datum;
   ref_column->get(grnxx::Int(0), &datum);
   assert(datum.type() == GRNXX_INT);
-  assert(datum.as_int().raw() == 0);
+  assert(datum.as_int().is_na());
   ref_column->get(grnxx::Int(1), &datum);
   assert(datum.type() == GRNXX_INT);
   assert(datum.as_int().raw() == 1);
@@ -457,13 +531,361 @@ void test_reference() {
 
   ref_column->get(grnxx::Int(0), &datum);
   assert(datum.type() == GRNXX_INT);
-  assert(datum.as_int().raw() == 0);
+  assert(datum.as_int().is_na());
   ref_column->get(grnxx::Int(1), &datum);
   assert(datum.type() == GRNXX_INT);
-  assert(datum.as_int().raw() == 1);
+  assert(datum.as_int().is_na());
   ref_column->get(grnxx::Int(2), &datum);
   assert(datum.type() == GRNXX_INT);
-  assert(datum.as_int().raw() == 1);
+  assert(datum.as_int().is_na());
+
+  cursor = ref_column->find_referrers(grnxx::Int(1));
+  assert(cursor->read_all(&records) == 0);
+}
+
+void test_vector_reference() {
+  // Create tables.
+  auto db = grnxx::open_db("");
+  auto to_table = db->create_table("To");
+  auto from_table = db->create_table("From");
+
+  // Create a column named "Ref".
+  grnxx::ColumnOptions options;
+  options.reference_table_name = "To";
+  auto ref_column =
+      from_table->create_column("Ref", GRNXX_INT_VECTOR, options);
+
+  // Append rows.
+  to_table->insert_row();
+  to_table->insert_row();
+  from_table->insert_row();
+  from_table->insert_row();
+
+  grnxx::Int values[] = { grnxx::Int(0), grnxx::Int(1), grnxx::Int(0) };
+  ref_column->set(grnxx::Int(0), grnxx::IntVector(values, 3));
+  ref_column->set(grnxx::Int(1), grnxx::IntVector(values + 1, 1));
+
+  grnxx::Array<grnxx::Record> records;
+  auto cursor = ref_column->find_referrers(grnxx::Int(0));
+  assert(cursor->read_all(&records) == 1);
+  assert(records[0].row_id.raw() == 0);
+  records.clear();
+  cursor = ref_column->find_referrers(grnxx::Int(1));
+  assert(cursor->read_all(&records) == 2);
+
+  // References to a removed row are removed from vectors.
+  to_table->remove_row(grnxx::Int(0));
+
+  grnxx::Datum datum;
+  ref_column->get(grnxx::Int(0), &datum);
+  assert(datum.type() == GRNXX_INT_VECTOR);
+  assert(datum.as_int_vector().raw_size() == 1);
+  assert(datum.as_int_vector()[0].raw() == 1);
+  ref_column->get(grnxx::Int(1), &datum);
+  assert(datum.type() == GRNXX_INT_VECTOR);
+  assert(datum.as_int_vector().raw_size() == 1);
+
+  records.clear();
+  cursor = ref_column->find_referrers(grnxx::Int(0));
+  assert(cursor->read_all(&records) == 0);
+}
+
+void test_remove_rows() {
+  // Rows span the bitmap and two levels of its indexes.
+  constexpr size_t NUM_ROWS = (1 << 18) + 100;
+
+  // Create two tables with the same rows, indexed columns and a reference
+  // column. Rows are removed from "Batch" at once and from "Single" one by
+  // one.
+  std::mt19937_64 rng;
+  auto db = grnxx::open_db("");
+  const char *table_names[] = { "Batch", "Single" };
+  grnxx::Table *tables[2];
+  grnxx::Column *columns[2];
+  grnxx::Column *text_columns[2];
+  grnxx::Column *vector_columns[2];
+  for (size_t i = 0; i < 2; ++i) {
+    tables[i] = db->create_table(table_names[i]);
+    columns[i] = tables[i]->create_column("Int", GRNXX_INT);
+    columns[i]->create_index("Index", GRNXX_TREE_INDEX);
+    text_columns[i] = tables[i]->create_column("Text", GRNXX_TEXT);
+    text_columns[i]->create_index("Index", GRNXX_FULL_TEXT_INDEX);
+    grnxx::ColumnOptions options;
+    options.delta_encoding = true;
+    vector_columns[i] =
+        tables[i]->create_column("IntVector", GRNXX_INT_VECTOR, options);
+    vector_columns[i]->create_index("Index", GRNXX_HASH_INDEX);
+  }
+  auto from_table = db->create_table("From");
+  grnxx::Column *ref_columns[2];
+  for (size_t i = 0; i < 2; ++i) {
+    grnxx::ColumnOptions options;
+    options.reference_table_name = table_names[i];
+    ref_columns[i] =
+        from_table->create_column(table_names[i], GRNXX_INT, options);
+  }
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int value(rng() % 1000);
+    char text[4];
+    for (size_t j = 0; j < 4; ++j) {
+      text[j] = "ab"[rng() % 2];
+    }
+    grnxx::Int elements[3];
+    for (size_t j = 0; j < 3; ++j) {
+      elements[j] = grnxx::Int(rng() % 100);
+    }
+    for (size_t j = 0; j < 2; ++j) {
+      grnxx::Int row_id = tables[j]->insert_row();
+      columns[j]->set(row_id, value);
+      text_columns[j]->set(row_id, grnxx::Text(text, 4));
+      vector_columns[j]->set(row_id, grnxx::IntVector(elements, 3));
+    }
+  }
+  for (size_t i = 0; i < 1000; ++i) {
+    grnxx::Int row_id = from_table->insert_row();
+    grnxx::Int value(rng() % NUM_ROWS);
+    for (size_t j = 0; j < 2; ++j) {
+      ref_columns[j]->set(row_id, value);
+    }
+  }
+
+  // An invalid row ID makes the whole operation fail.
+  grnxx::Array<grnxx::Int> row_ids;
+  row_ids.push_back(grnxx::Int(0));
+  row_ids.push_back(grnxx::Int(NUM_ROWS));
+  try {
+    tables[0]->remove_rows(row_ids);
+    assert(false);
+  } catch (...) {
+  }
+  assert(tables[0]->num_rows() == NUM_ROWS);
+
+  // Remove dense and sparse rows, including duplicates and the last row.
+  row_ids.clear();
+  for (size_t i = 0; i < (64 * 64 * 2); ++i) {
+    row_ids.push_back(grnxx::Int(64 * 64 + i));
+  }
+  for (size_t i = 0; i < 10000; ++i) {
+    row_ids.push_back(grnxx::Int(rng() % NUM_ROWS));
+  }
+  row_ids.push_back(grnxx::Int(NUM_ROWS - 1));
+  row_ids.push_back(grnxx::Int(NUM_ROWS - 1));
+  for (size_t i = 0; i < row_ids.size(); ++i) {
+    if (tables[1]->test_row(row_ids[i])) {
+      tables[1]->remove_row(row_ids[i]);
+    }
+  }
+  tables[0]->remove_rows(row_ids);
+
+  // The tables must be the same.
+  assert(tables[0]->num_rows() == tables[1]->num_rows());
+  assert(tables[0]->max_row_id().match(tables[1]->max_row_id()));
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    assert(tables[0]->test_row(grnxx::Int(i)) ==
+           tables[1]->test_row(grnxx::Int(i)));
+  }
+  for (size_t i = 0; i < 1000; ++i) {
+    grnxx::Datum datum[2];
+    for (size_t j = 0; j < 2; ++j) {
+      ref_columns[j]->get(grnxx::Int(i), &datum[j]);
+    }
+    assert(datum[0].as_int().match(datum[1].as_int()));
+  }
+  for (size_t i = 0; i < 10; ++i) {
+    grnxx::Array<grnxx::Record> records[2];
+    for (size_t j = 0; j < 2; ++j) {
+      auto cursor = columns[j]->find_index("Index")->find(grnxx::Int(i));
+      cursor->read_all(&records[j]);
+      cursor = text_columns[j]->find_index("Index")->find_contains(
+          grnxx::Text("ba"));
+      cursor->read_all(&records[j]);
+      cursor = vector_columns[j]->find_index("Index")->find(grnxx::Int(i));
+      cursor->read_all(&records[j]);
+    }
+    assert(records[0].size() == records[1].size());
+    for (size_t j = 0; j < records[0].size(); ++j) {
+      assert(records[0][j].row_id.match(records[1][j].row_id));
+    }
+  }
+  for (size_t i = 0; i < 2; ++i) {
+    auto index = text_columns[i]->find_index("Index");
+    assert(index->num_entries() == tables[i]->num_rows());
+  }
+
+  // Removed rows are reused in the same order.
+  for (size_t i = 0; i < (64 * 64 * 3); ++i) {
+    assert(tables[0]->insert_row().match(tables[1]->insert_row()));
+  }
+
+  // Remove all the rows.
+  row_ids.clear();
+  for (size_t i = 0; i <= size_t(tables[0]->max_row_id().raw()); ++i) {
+    if (tables[0]->test_row(grnxx::Int(i))) {
+      row_ids.push_back(grnxx::Int(i));
+    }
+  }
+  tables[0]->remove_rows(row_ids);
+  assert(tables[0]->num_rows() == 0);
+  assert(tables[0]->max_row_id().is_na());
+  assert(tables[0]->insert_row().match(grnxx::Int(0)));
+}
+
+void test_vacuum() {
+  constexpr size_t NUM_ROWS = 5000;
+
+  // Create a table with a key column, an indexed column and a reference
+  // column referring to itself, and a table referring to it.
+  std::mt19937_64 rng;
+  auto db = grnxx::open_db("");
+  auto table = db->create_table("Table");
+  auto key_column = table->create_column("Key", GRNXX_TEXT);
+  table->set_key_column("Key");
+  auto int_column = table->create_column("Int", GRNXX_INT);
+  int_column->create_index("Index", GRNXX_TREE_INDEX);
+  grnxx::ColumnOptions options;
+  options.reference_table_name = "Table";
+  auto self_column = table->create_column("Self", GRNXX_INT, options);
+  auto from_table = db->create_table("From");
+  auto ref_column = from_table->create_column("Ref", GRNXX_INT, options);
+  auto ref_vector_column =
+      from_table->create_column("RefVector", GRNXX_INT_VECTOR, options);
+
+  std::vector<std::string> keys(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    keys[i] = std::to_string(i);
+    grnxx::Int row_id = table->insert_row(grnxx::Text(keys[i].c_str()));
+    int_column->set(row_id, grnxx::Int(i));
+  }
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    self_column->set(grnxx::Int(i), grnxx::Int(rng() % NUM_ROWS));
+    grnxx::Int row_id = from_table->insert_row();
+    ref_column->set(row_id, grnxx::Int(rng() % NUM_ROWS));
+    grnxx::Int values[] = {
+      grnxx::Int(rng() % NUM_ROWS), grnxx::Int(rng() % NUM_ROWS)
+    };
+    ref_vector_column->set(row_id, grnxx::IntVector(values, 2));
+  }
+
+  // A full table is not changed.
+  grnxx::Array<grnxx::Int> row_id_map;
+  table->vacuum(&row_id_map);
+  assert(row_id_map.size() == NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    assert(row_id_map[i].match(grnxx::Int(i)));
+  }
+
+  // Remove rows and keep the referenced keys.
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    if ((rng() % 3) == 0) {
+      table->remove_row(grnxx::Int(i));
+    }
+  }
+  assert(!table->is_full());
+  size_t num_rows = table->num_rows();
+  auto get_key = [&](grnxx::Int row_id) {
+    if (row_id.is_na()) {
+      return std::string("N/A");
+    }
+    grnxx::Datum datum;
+    key_column->get(row_id, &datum);
+    grnxx::Text key = datum.as_text();
+    return key.is_na() ? std::string("N/A") :
+           std::string(key.raw_data(), key.raw_size());
+  };
+  auto get_ref_key = [&](grnxx::Column *column, grnxx::Int row_id) {
+    grnxx::Datum datum;
+    column->get(row_id, &datum);
+    return get_key(datum.as_int());
+  };
+  std::vector<std::string> self_keys(NUM_ROWS);
+  std::vector<std::string> ref_keys(NUM_ROWS);
+  std::vector<std::string> ref_vector_keys(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    if (table->test_row(grnxx::Int(i))) {
+      self_keys[i] = get_ref_key(self_column, grnxx::Int(i));
+    }
+    ref_keys[i] = get_ref_key(ref_column, grnxx::Int(i));
+    grnxx::Datum datum;
+    ref_vector_column->get(grnxx::Int(i), &datum);
+    grnxx::IntVector values = datum.as_int_vector();
+    for (size_t j = 0; j < values.raw_size(); ++j) {
+      ref_vector_keys[i] += get_key(values[j]) + ",";
+    }
+  }
+
+  // Vacuum the table.
+  table->vacuum(&row_id_map);
+  assert(table->is_full());
+  assert(table->num_rows() == num_rows);
+  assert(table->max_row_id().match(grnxx::Int(num_rows - 1)));
+  assert(row_id_map.size() <= NUM_ROWS);
+  size_t count = 0;
+  for (size_t i = 0; i < row_id_map.size(); ++i) {
+    if (row_id_map[i].is_na()) {
+      continue;
+    }
+    grnxx::Int row_id = row_id_map[i];
+    assert(row_id.match(grnxx::Int(count)));
+    ++count;
+    assert(get_key(row_id) == keys[i]);
+    assert(table->find_row(grnxx::Text(keys[i].c_str())).match(row_id));
+    grnxx::Datum datum;
+    int_column->get(row_id, &datum);
+    assert(datum.as_int().match(grnxx::Int(i)));
+    grnxx::Array<grnxx::Record> records;
+    auto cursor = int_column->find_index("Index")->find(grnxx::Int(i));
+    cursor->read_all(&records);
+    assert(records.size() == 1);
+    assert(records[0].row_id.match(row_id));
+    assert(get_ref_key(self_column, row_id) == self_keys[i]);
+  }
+  assert(count == num_rows);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    assert(get_ref_key(ref_column, grnxx::Int(i)) == ref_keys[i]);
+    grnxx::Datum datum;
+    ref_vector_column->get(grnxx::Int(i), &datum);
+    grnxx::IntVector values = datum.as_int_vector();
+    std::string keys;
+    for (size_t j = 0; j < values.raw_size(); ++j) {
+      keys += get_key(values[j]) + ",";
+    }
+    assert(keys == ref_vector_keys[i]);
+  }
+
+  // Filters which may skip zones work on the moved values.
+  auto expression_builder = grnxx::ExpressionBuilder::create(table);
+  expression_builder->push_column("Int");
+  expression_builder->push_constant(grnxx::Int(NUM_ROWS / 2));
+  expression_builder->push_operator(GRNXX_LESS);
+  auto expression = expression_builder->release();
+  grnxx::Array<grnxx::Record> records;
+  table->create_cursor()->read_all(&records);
+  expression->filter(&records);
+  count = 0;
+  for (size_t i = 0; i < (NUM_ROWS / 2); ++i) {
+    if ((i < row_id_map.size()) && !row_id_map[i].is_na()) {
+      assert(records[count].row_id.match(row_id_map[i]));
+      ++count;
+    }
+  }
+  assert(records.size() == count);
+
+  // New rows are appended to the dense rows.
+  grnxx::Int row_id = table->insert_row(grnxx::Text("New"));
+  assert(row_id.match(grnxx::Int(num_rows)));
+
+  // A failed vacuum does not change the table.
+  table->remove_row(grnxx::Int(0));
+  auto key_table = db->create_table("Key");
+  key_table->create_column("Ref", GRNXX_INT, options);
+  key_table->set_key_column("Ref");
+  try {
+    table->vacuum();
+    assert(false);
+  } catch (...) {
+  }
+  assert(!table->is_full());
+  assert(table->num_rows() == num_rows);
 }
 
 int main() {
@@ -474,5 +896,8 @@ int main() {
   test_text_key();
   test_cursor();
   test_reference();
+  test_vector_reference();
+  test_remove_rows();
+  test_vacuum();
   return 0;
 }
@@ -0,0 +1,221 @@
+/*
+  Copyright (C) 2012-2014  Brazil, Inc.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "grnxx/column.hpp"
+#include "grnxx/cursor.hpp"
+#include "grnxx/db.hpp"
+#include "grnxx/expression.hpp"
+#include "grnxx/index.hpp"
+#include "grnxx/pipeline.hpp"
+#include "grnxx/sorter.hpp"
+#include "grnxx/table.hpp"
+
+constexpr size_t NUM_ROWS = 1 << 14;
+constexpr size_t NUM_THREADS = 4;
+constexpr size_t NUM_LOOPS = 8;
+
+std::mt19937_64 rng;
+
+struct {
+  std::unique_ptr<grnxx::DB> db;
+  grnxx::Table *table;
+  grnxx::Table *ref_table;
+  std::vector<std::string> text_bodies;
+  std::vector<std::vector<grnxx::Int>> int_vector_bodies;
+} test;
+
+void init_test() {
+  // Create a table with an encoded Int column, a Float column, a
+  // dictionary-encoded Text column, a delta-encoded Int vector column and a
+  // reference column, and indexes.
+  test.db = grnxx::open_db("");
+  test.ref_table = test.db->create_table("Ref");
+  test.table = test.db->create_table("Table");
+  grnxx::ColumnOptions options;
+  options.frame_of_reference_encoding = true;
+  auto int_column = test.table->create_column("Int", GRNXX_INT, options);
+  auto float_column = test.table->create_column("Float", GRNXX_FLOAT);
+  options = grnxx::ColumnOptions();
+  options.dictionary_encoding = true;
+  auto text_column = test.table->create_column("Text", GRNXX_TEXT, options);
+  options = grnxx::ColumnOptions();
+  options.delta_encoding = true;
+  auto int_vector_column =
+      test.table->create_column("IntVector", GRNXX_INT_VECTOR, options);
+  options = grnxx::ColumnOptions();
+  options.reference_table_name = "Table";
+  auto ref_column = test.ref_table->create_column("Ref", GRNXX_INT, options);
+
+  test.text_bodies.resize(NUM_ROWS);
+  test.int_vector_bodies.resize(NUM_ROWS);
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = test.table->insert_row();
+    int_column->set(row_id, grnxx::Int(rng() % 256));
+    float_column->set(row_id, grnxx::Float((rng() % 1024) / 8.0));
+    size_t size = rng() % 4;
+    for (size_t j = 0; j < size; ++j) {
+      test.text_bodies[i].push_back("ab"[rng() % 2]);
+    }
+    text_column->set(row_id, grnxx::Text(test.text_bodies[i].data(),
+                                         test.text_bodies[i].size()));
+    size = rng() % 8;
+    int64_t value = 0;
+    for (size_t j = 0; j < size; ++j) {
+      value += rng() % 100;
+      test.int_vector_bodies[i].push_back(grnxx::Int(value));
+    }
+    int_vector_column->set(
+        row_id, grnxx::IntVector(test.int_vector_bodies[i].data(), size));
+  }
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    grnxx::Int row_id = test.ref_table->insert_row();
+    ref_column->set(row_id, grnxx::Int(rng() % NUM_ROWS));
+  }
+  int_column->create_index("Index", GRNXX_TREE_INDEX);
+  text_column->create_index("FullTextIndex", GRNXX_FULL_TEXT_INDEX);
+}
+
+// Filter records with (Int < 128) && (Text @^ "a"), adjust scores with Float
+// and sort records by score and row ID.
+void run_pipeline(grnxx::Array<grnxx::Record> *records) {
+  auto pipeline_builder = grnxx::PipelineBuilder::create(test.table);
+  pipeline_builder->push_cursor(test.table->create_cursor());
+  auto expression_builder = grnxx::ExpressionBuilder::create(test.table);
+  expression_builder->push_column("Int");
+  expression_builder->push_constant(grnxx::Int(128));
+  expression_builder->push_operator(GRNXX_LESS);
+  expression_builder->push_column("Text");
+  expression_builder->push_constant(grnxx::Text("a"));
+  expression_builder->push_operator(GRNXX_STARTS_WITH);
+  expression_builder->push_operator(GRNXX_LOGICAL_AND);
+  pipeline_builder->push_filter(expression_builder->release());
+  expression_builder->push_column("Float");
+  pipeline_builder->push_adjuster(expression_builder->release());
+  grnxx::Array<grnxx::SorterOrder> orders;
+  orders.resize(2);
+  expression_builder->push_score();
+  orders[0].expression = expression_builder->release();
+  orders[0].type = GRNXX_REVERSE_ORDER;
+  expression_builder->push_row_id();
+  orders[1].expression = expression_builder->release();
+  orders[1].type = GRNXX_REGULAR_ORDER;
+  pipeline_builder->push_sorter(grnxx::Sorter::create(std::move(orders)));
+  auto pipeline = pipeline_builder->release();
+  pipeline->flush(records);
+}
+
+// Filter records with Ref.Int >= 128 and IntVector[1] < 100.
+void run_dereference(grnxx::Array<grnxx::Record> *records) {
+  auto builder = grnxx::ExpressionBuilder::create(test.ref_table);
+  builder->push_column("Ref");
+  builder->begin_subexpression();
+  builder->push_column("Int");
+  builder->push_constant(grnxx::Int(128));
+  builder->push_operator(GRNXX_GREATER_EQUAL);
+  builder->push_column("IntVector");
+  builder->push_constant(grnxx::Int(1));
+  builder->push_operator(GRNXX_SUBSCRIPT);
+  builder->push_constant(grnxx::Int(100));
+  builder->push_operator(GRNXX_LESS);
+  builder->push_operator(GRNXX_LOGICAL_AND);
+  builder->end_subexpression();
+  auto expression = builder->release();
+  auto cursor = test.ref_table->create_cursor();
+  cursor->read_all(records);
+  expression->filter(records);
+}
+
+// Read records through indexes.
+void run_indexes(grnxx::Array<grnxx::Record> *records) {
+  auto column = test.table->find_column("Int");
+  grnxx::IndexRange range;
+  range.set_lower_bound(grnxx::Int(10), grnxx::INCLUSIVE_END_POINT);
+  range.set_upper_bound(grnxx::Int(20), grnxx::EXCLUSIVE_END_POINT);
+  auto cursor = column->find_index("Index")->find_in_range(range);
+  cursor->read_all(records);
+  column = test.table->find_column("Text");
+  cursor = column->find_index("FullTextIndex")->find_contains(
+      grnxx::Text("ba"));
+  cursor->read_all(records);
+}
+
+// Read delta-encoded vectors through Column::get().
+void run_get(grnxx::Array<grnxx::Record> *records) {
+  auto column = test.table->find_column("IntVector");
+  grnxx::Datum datum;
+  for (size_t i = 0; i < NUM_ROWS; ++i) {
+    column->get(grnxx::Int(i), &datum);
+    grnxx::IntVector value = datum.as_int_vector();
+    const std::vector<grnxx::Int> &body = test.int_vector_bodies[i];
+    assert(value.raw_size() == body.size());
+    for (size_t j = 0; j < body.size(); ++j) {
+      assert(value[j].match(body[j]));
+    }
+    if (value.raw_size() != 0) {
+      records->push_back(grnxx::Record(grnxx::Int(i), grnxx::Float(0.0)));
+    }
+  }
+}
+
+using Query = void (*)(grnxx::Array<grnxx::Record> *records);
+
+void test_concurrent_queries() {
+  Query queries[] = { run_pipeline, run_dereference, run_indexes, run_get };
+  size_t num_queries = sizeof(queries) / sizeof(queries[0]);
+
+  // Run queries in a thread to get the expected results.
+  std::vector<grnxx::Array<grnxx::Record>> expected_results(num_queries);
+  for (size_t i = 0; i < num_queries; ++i) {
+    queries[i](&expected_results[i]);
+    assert(expected_results[i].size() != 0);
+  }
+
+  // Run queries in threads at the same time.
+  // Each thread runs the queries in a different order.
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < NUM_THREADS; ++i) {
+    threads.push_back(std::thread([&, i] {
+      for (size_t j = 0; j < (NUM_LOOPS * num_queries); ++j) {
+        size_t query_id = (i + j) % num_queries;
+        grnxx::Array<grnxx::Record> records;
+        queries[query_id](&records);
+        const grnxx::Array<grnxx::Record> &expected = expected_results[query_id];
+        assert(records.size() == expected.size());
+        for (size_t k = 0; k < records.size(); ++k) {
+          assert(records[k].row_id.match(expected[k].row_id));
+          assert(records[k].score.match(expected[k].score));
+        }
+      }
+    }));
+  }
+  for (size_t i = 0; i < NUM_THREADS; ++i) {
+    threads[i].join();
+  }
+}
+
+int main() {
+  init_test();
+  test_concurrent_queries();
+  return 0;
+}